@@ -21,6 +21,8 @@
 #ifndef SUSHI_CONTROL_INTERFACE_H
 #define SUSHI_CONTROL_INTERFACE_H
 
+#include <cstdint>
+#include <string>
 #include <utility>
 #include <optional>
 #include <vector>
@@ -102,6 +104,21 @@ struct ProgramInfo
     std::string name;
 };
 
+struct EventQueueInfo
+{
+    std::string name;
+    int         capacity;
+    uint64_t    dropped_events;
+};
+
+struct EventPoolInfo
+{
+    int         block_size;
+    int         blocks;
+    int         blocks_in_use;
+    int         peak_blocks_in_use;
+};
+
 struct TrackInfo
 {
     int         id;
@@ -121,6 +138,7 @@ public:
 
     // Main engine controls
     virtual float                               get_samplerate() const = 0;
+    virtual int                                 get_latency() const = 0;
     virtual PlayingMode                         get_playing_mode() const = 0;
     virtual void                                set_playing_mode(PlayingMode playing_mode) = 0;
     virtual SyncMode                            get_sync_mode() const = 0;
@@ -132,6 +150,8 @@ public:
     virtual bool                                get_timing_statistics_enabled() const = 0;
     virtual void                                set_timing_statistics_enabled(bool enabled) = 0;
     virtual std::vector<TrackInfo>              get_tracks() const = 0;
+    virtual std::vector<EventQueueInfo>         get_event_queues() const = 0;
+    virtual std::vector<EventPoolInfo>          get_event_pools() const = 0;
 
     // Keyboard control
     virtual ControlStatus                       send_note_on(int track_id, int channel, int note, float velocity) = 0;
@@ -177,6 +197,12 @@ public:
     virtual ControlStatus                              set_parameter_value(int processor_id, int parameter_id, float value) = 0;
     virtual ControlStatus                              set_string_property_value(int processor_id, int parameter_id, const std::string& value) = 0;
 
+    // Transactions, all changes made between begin and commit are applied in the same audio chunk.
+    // There is only one transaction at a time, changes made by other clients while it is open
+    // are applied together with it
+    virtual ControlStatus                              begin_transaction() = 0;
+    virtual ControlStatus                              commit_transaction() = 0;
+
 
 protected:
     SushiControl() = default;
@@ -16,6 +16,7 @@ async def call_function(function, **kwargs):
 async def main():
     # Call all functions with some reasonable arguments and print the response
     await call_function("GetSamplerate")
+    await call_function("GetLatency")
     await call_function("GetPlayingMode")
     await call_function("SetPlayingMode", mode = "PLAYING")
     await call_function("GetSyncMode")
@@ -70,6 +71,8 @@ async def main():
     await call_function("SetParameterValue", processor_id = 1, parameter_id = 2, value = 0.5)
     await call_function("SetParameterValueNormalised", processor_id = 1, parameter_id = 2, value = 0.5)
     await call_function("SetStringPropertyValue", processor_id = 1, property_id = 2, value = "string")
+    await call_function("BeginTransaction")
+    await call_function("CommitTransaction")
 
    
 asyncio.get_event_loop().run_until_complete(main())
\ No newline at end of file
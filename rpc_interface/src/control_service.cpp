@@ -173,6 +173,14 @@ grpc::Status SushiControlService::GetSamplerate(grpc::ServerContext* /*context*/
     return grpc::Status::OK;
 }
 
+grpc::Status SushiControlService::GetLatency(grpc::ServerContext* /*context*/,
+                                             const sushi_rpc::GenericVoidValue* /*request*/,
+                                             sushi_rpc::GenericIntValue* response)
+{
+    response->set_value(_controller->get_latency());
+    return grpc::Status::OK;
+}
+
 grpc::Status SushiControlService::GetPlayingMode(grpc::ServerContext* /*context*/,
                                                  const sushi_rpc::GenericVoidValue* /*request*/,
                                                  sushi_rpc::PlayingMode* response)
@@ -639,4 +647,20 @@ grpc::Status SushiControlService::SetStringPropertyValue(grpc::ServerContext* /*
     return to_grpc_status(status);
 }
 
+grpc::Status SushiControlService::BeginTransaction(grpc::ServerContext* /*context*/,
+                                                   const sushi_rpc::GenericVoidValue* /*request*/,
+                                                   sushi_rpc::GenericVoidValue* /*response*/)
+{
+    auto status = _controller->begin_transaction();
+    return to_grpc_status(status);
+}
+
+grpc::Status SushiControlService::CommitTransaction(grpc::ServerContext* /*context*/,
+                                                    const sushi_rpc::GenericVoidValue* /*request*/,
+                                                    sushi_rpc::GenericVoidValue* /*response*/)
+{
+    auto status = _controller->commit_transaction();
+    return to_grpc_status(status);
+}
+
 } // sushi_rpc
@@ -268,7 +268,7 @@ AudioFrontendStatus JackFrontend::connect_ports()
 int JackFrontend::internal_process_callback(jack_nframes_t framecount)
 {
     set_flush_denormals_to_zero();
-    if (framecount < 64 || framecount % 64)
+    if (framecount < AUDIO_CHUNK_SIZE || framecount % AUDIO_CHUNK_SIZE)
     {
         SUSHI_LOG_CRITICAL("Chunk size not a multiple of AUDIO_CHUNK_SIZE. Skipping.");
         return 0;
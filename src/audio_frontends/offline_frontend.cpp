@@ -18,6 +18,7 @@
 * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
 */
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
 #include <random>
@@ -33,6 +34,8 @@ SUSHI_GET_LOGGER_WITH_MODULE_NAME("offline audio");
 
 constexpr float INPUT_NOISE_LEVEL = powf(10, (-24.0f/20.0f)); // -24 dB input noise
 constexpr int   NOISE_SEED = 5; // Using a constant seed makes potential errors reproducible
+/* Offline processing has no deadline, so always convert sample rates with the best quality */
+constexpr auto  RESAMPLER_QUALITY = dsp::resampler::Quality::HIGH;
 
 template<class random_device, class random_dist>
 void fill_buffer_with_noise(ChunkSampleBuffer& buffer, random_device& dev, random_dist& dist)
@@ -56,6 +59,24 @@ void fill_cv_buffer_with_noise(engine::ControlBuffer& buffer, random_device& dev
     }
 }
 
+/* Integer files are read without converting to float in libsndfile, so that
+ * conversion and deinterleaving is done in the same pass */
+SampleFormat file_sample_format(int sndfile_format)
+{
+    switch (sndfile_format & SF_FORMAT_SUBMASK)
+    {
+        case SF_FORMAT_PCM_16:
+            return SampleFormat::INT16;
+
+        case SF_FORMAT_PCM_24:
+        case SF_FORMAT_PCM_32:
+            return SampleFormat::INT32;
+
+        default:
+            return SampleFormat::FLOAT32;
+    }
+}
+
 AudioFrontendStatus OfflineFrontend::init(BaseAudioFrontendConfiguration* config)
 {
     auto ret_code = BaseAudioFrontend::init(config);
@@ -77,13 +98,27 @@ AudioFrontendStatus OfflineFrontend::init(BaseAudioFrontendConfiguration* config
             SUSHI_LOG_ERROR("Unable to open input file {}", off_config->input_filename);
             return AudioFrontendStatus::INVALID_INPUT_FILE;
         }
-        _mono = _soundfile_info.channels == 1;
+        _file_channels = _soundfile_info.channels;
+        if (_file_channels > DUMMY_FRONTEND_CHANNELS)
+        {
+            cleanup();
+            SUSHI_LOG_ERROR("Input file has {} channels, max is {}", _file_channels, DUMMY_FRONTEND_CHANNELS);
+            return AudioFrontendStatus::INVALID_N_CHANNELS;
+        }
+        _file_format = file_sample_format(_soundfile_info.format);
         auto sample_rate_file = _soundfile_info.samplerate;
-        if (sample_rate_file != _engine->sample_rate())
+        auto sample_rate_engine = static_cast<int>(_engine->sample_rate());
+        if (sample_rate_file != sample_rate_engine)
         {
-            SUSHI_LOG_WARNING("Sample rate mismatch between file ({}) and engine ({})",
-                              sample_rate_file,
-                              _engine->sample_rate());
+            /* The input is converted to the engine rate and the output is written in
+             * the engine rate, so it is only resampled once */
+            SUSHI_LOG_INFO("Converting sample rate of input file ({}) to engine sample rate ({})",
+                           sample_rate_file,
+                           sample_rate_engine);
+            _resampler = std::make_unique<dsp::resampler::Resampler>(_file_channels, sample_rate_file,
+                                                                     sample_rate_engine, RESAMPLER_QUALITY);
+            _resampler_buffer.resize(_file_channels * AUDIO_CHUNK_SIZE);
+            _soundfile_info.samplerate = sample_rate_engine;
         }
 
         // Open output file with same format as input file
@@ -93,8 +128,9 @@ AudioFrontendStatus OfflineFrontend::init(BaseAudioFrontendConfiguration* config
             SUSHI_LOG_ERROR("Unable to open output file {}", off_config->output_filename);
             return AudioFrontendStatus::INVALID_OUTPUT_FILE;
         }
-        _engine->set_audio_input_channels(OFFLINE_FRONTEND_CHANNELS);
-        _engine->set_audio_output_channels(OFFLINE_FRONTEND_CHANNELS);
+        int engine_channels = std::max(_file_channels, OFFLINE_FRONTEND_CHANNELS);
+        _engine->set_audio_input_channels(engine_channels);
+        _engine->set_audio_output_channels(engine_channels);
     }
     else
     {
@@ -218,10 +254,14 @@ void OfflineFrontend::_run_blocking()
     double usec_time = 0.0f;
     Time start_time = std::chrono::microseconds(0);
 
-    float file_buffer[OFFLINE_FRONTEND_CHANNELS * AUDIO_CHUNK_SIZE];
-    while ( (readcount = static_cast<int>(sf_readf_float(_input_file,
-                                                         file_buffer,
-                                                         static_cast<sf_count_t>(AUDIO_CHUNK_SIZE)))) )
+    /* Large enough for the maximum number of channels in any supported format */
+    int32_t file_buffer[DUMMY_FRONTEND_CHANNELS * AUDIO_CHUNK_SIZE]{};
+    auto buffer = ChunkSampleBuffer::create_non_owning_buffer(_buffer, 0, _file_channels);
+    /* Resampled input is always float */
+    auto input_format = _resampler ? SampleFormat::FLOAT32 : _file_format;
+
+    while ((readcount = _resampler ? _read_resampled(reinterpret_cast<float*>(file_buffer), AUDIO_CHUNK_SIZE) :
+                                     _read_file(file_buffer, AUDIO_CHUNK_SIZE)))
     {
         auto process_time = start_time + std::chrono::microseconds(static_cast<uint64_t>(usec_time));
 
@@ -232,36 +272,69 @@ void OfflineFrontend::_run_blocking()
         _process_events(chunk_end_time);
 
         _buffer.clear();
+        buffer.from_interleaved(file_buffer, input_format);
 
-        if (_mono)
-        {
-            std::copy(file_buffer, file_buffer + AUDIO_CHUNK_SIZE, _buffer.channel(0));
-        }
-        else
-        {
-            auto buffer = ChunkSampleBuffer::create_non_owning_buffer(_buffer, 0, 2);
-            buffer.from_interleaved(file_buffer);
-        }
         /* Gate and CV are ignored when using file frontend */
         _engine->process_chunk(&_buffer, &_buffer, &_control_buffer, &_control_buffer, process_time, samplecount);
 
-        if (_mono)
+        buffer.to_interleaved(file_buffer, _file_format);
+
+        // Write to file
+        // Should we check the number of samples effectively written?
+        // Not done in libsndfile's example
+        _write_file(file_buffer, readcount);
+    }
+}
+
+
+int OfflineFrontend::_read_file(void* data, int frames)
+{
+    switch (_file_format)
+    {
+        case SampleFormat::INT16:
+            return static_cast<int>(sf_readf_short(_input_file, static_cast<short*>(data), frames));
+
+        case SampleFormat::INT32:
+            return static_cast<int>(sf_readf_int(_input_file, static_cast<int*>(data), frames));
+
+        default:
+            return static_cast<int>(sf_readf_float(_input_file, static_cast<float*>(data), frames));
+    }
+}
+
+int OfflineFrontend::_read_resampled(float* data, int frames)
+{
+    while (_resampler->available() < frames && !_resampler->flushed())
+    {
+        int readcount = static_cast<int>(sf_readf_float(_input_file, _resampler_buffer.data(), AUDIO_CHUNK_SIZE));
+        if (readcount > 0)
         {
-            std::copy(_buffer.channel(0), _buffer.channel(0) + AUDIO_CHUNK_SIZE, file_buffer );
+            _resampler->push(_resampler_buffer.data(), readcount);
         }
         else
         {
-            auto buffer = ChunkSampleBuffer::create_non_owning_buffer(_buffer, 0, 2);
-            buffer.to_interleaved(file_buffer);
+            _resampler->flush();
         }
-
-        // Write to file
-        // Should we check the number of samples effectively written?
-        // Not done in libsndfile's example
-        sf_writef_float(_output_file, file_buffer, static_cast<sf_count_t>(readcount));
     }
+    return _resampler->pull(data, frames);
 }
 
+void OfflineFrontend::_write_file(const void* data, int frames)
+{
+    switch (_file_format)
+    {
+        case SampleFormat::INT16:
+            sf_writef_short(_output_file, static_cast<const short*>(data), frames);
+            break;
+
+        case SampleFormat::INT32:
+            sf_writef_int(_output_file, static_cast<const int*>(data), frames);
+            break;
+
+        default:
+            sf_writef_float(_output_file, static_cast<const float*>(data), frames);
+    }
+}
 
 }; // end namespace audio_frontend
 
@@ -24,12 +24,15 @@
 #include <string>
 #include <vector>
 #include <atomic>
+#include <memory>
 #include <thread>
 
 #include <sndfile.h>
 
 #include "base_audio_frontend.h"
 #include "library/rt_event.h"
+#include "library/interleaving.h"
+#include "dsp_library/resampler.h"
 
 namespace sushi {
 
@@ -90,15 +93,23 @@ private:
     void _process_events(Time end_time);
     void _process_dummy();
     void _run_blocking();
+    int _read_file(void* data, int frames);
+    int _read_resampled(float* data, int frames);
+    void _write_file(const void* data, int frames);
 
     SNDFILE*            _input_file;
     SNDFILE*            _output_file;
     SF_INFO             _soundfile_info;
-    bool                _mono;
+    int                 _file_channels;
+    SampleFormat        _file_format;
     bool                _dummy_mode;
     std::atomic_bool    _running;
     std::thread         _worker;
 
+    /* Converts the input file to the engine sample rate, only used when they differ */
+    std::unique_ptr<dsp::resampler::Resampler> _resampler;
+    std::vector<float>  _resampler_buffer;
+
     SampleBuffer<AUDIO_CHUNK_SIZE> _buffer{DUMMY_FRONTEND_CHANNELS};
     engine::ControlBuffer _control_buffer;
 
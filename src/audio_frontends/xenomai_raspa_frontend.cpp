@@ -52,6 +52,14 @@ AudioFrontendStatus XenomaiRaspaFrontend::init(BaseAudioFrontendConfiguration* c
 
     auto raspa_config = static_cast<const XenomaiRaspaFrontendConfiguration*>(_config);
 
+    if (raspa_config->buffer_size < AUDIO_CHUNK_SIZE || raspa_config->buffer_size % AUDIO_CHUNK_SIZE)
+    {
+        SUSHI_LOG_ERROR("Buffer size {} is not a multiple of the engine chunk size ({})",
+                        raspa_config->buffer_size, AUDIO_CHUNK_SIZE);
+        return AudioFrontendStatus::INVALID_CHUNK_SIZE;
+    }
+    _buffer_size = raspa_config->buffer_size;
+
     auto cv_audio_status = config_audio_channels(raspa_config);
     if (cv_audio_status != AudioFrontendStatus::OK)
     {
@@ -65,7 +73,7 @@ AudioFrontendStatus XenomaiRaspaFrontend::init(BaseAudioFrontendConfiguration* c
         debug_flags |= RASPA_DEBUG_SIGNAL_ON_MODE_SW;
     }
 
-    auto raspa_ret = raspa_open(AUDIO_CHUNK_SIZE, rt_process_callback, this, debug_flags);
+    auto raspa_ret = raspa_open(_buffer_size, rt_process_callback, this, debug_flags);
     if (raspa_ret < 0)
     {
         SUSHI_LOG_ERROR("Error opening RASPA: {}", raspa_get_error_msg(-raspa_ret));
@@ -78,6 +86,7 @@ AudioFrontendStatus XenomaiRaspaFrontend::init(BaseAudioFrontendConfiguration* c
         SUSHI_LOG_WARNING("Sample rate mismatch between engine ({}) and Raspa ({})", _engine->sample_rate(), raspa_sample_rate);
         _engine->set_sample_rate(raspa_sample_rate);
     }
+    _sample_rate = raspa_sample_rate;
     _engine->set_output_latency(std::chrono::microseconds(raspa_get_output_latency()));
 
     return AudioFrontendStatus::OK;
@@ -114,19 +123,39 @@ void XenomaiRaspaFrontend::_internal_process_callback(float* input, float* outpu
     // Gate in signals from the Sika board are inverted, hence invert all bits
     _in_controls.gate_values = ~engine::BitSet32(raspa_get_gate_values());
 
-    ChunkSampleBuffer in_buffer = ChunkSampleBuffer::create_from_raw_pointer(input, 0, _audio_input_channels);
-    ChunkSampleBuffer out_buffer = ChunkSampleBuffer::create_from_raw_pointer(output, 0, _audio_output_channels);
+    /* Process in chunks of AUDIO_CHUNK_SIZE, the Raspa buffers are laid out with all
+     * samples of a channel contiguous, i.e. with a stride of _buffer_size between channels */
+    for (int frame = 0; frame < _buffer_size; frame += AUDIO_CHUNK_SIZE)
+    {
+        Time delta_time = std::chrono::microseconds((frame * 1'000'000ll) / static_cast<int64_t>(_sample_rate));
+        _process_audio(input, output, frame, timestamp + delta_time, samplecount + frame);
+    }
+}
+
+void XenomaiRaspaFrontend::_process_audio(float* input, float* output, int start_frame, Time timestamp, int64_t samplecount)
+{
+    for (int i = 0; i < _audio_input_channels; ++i)
+    {
+        const float* in_data = input + i * _buffer_size + start_frame;
+        std::copy(in_data, in_data + AUDIO_CHUNK_SIZE, _in_buffer.channel(i));
+    }
     for (int i = 0; i < _cv_input_channels; ++i)
     {
-        _in_controls.cv_values[i] = map_audio_to_cv(input[(_audio_input_channels + i + 1) * AUDIO_CHUNK_SIZE - 1] * CV_IN_CORR);
+        const float* in_data = input + (_audio_input_channels + i) * _buffer_size + start_frame;
+        _in_controls.cv_values[i] = map_audio_to_cv(in_data[AUDIO_CHUNK_SIZE - 1] * CV_IN_CORR);
+    }
+    _out_buffer.clear();
+    _engine->process_chunk(&_in_buffer, &_out_buffer, &_in_controls, &_out_controls, timestamp, samplecount);
+    for (int i = 0; i < _audio_output_channels; ++i)
+    {
+        float* out_data = output + i * _buffer_size + start_frame;
+        std::copy(_out_buffer.channel(i), _out_buffer.channel(i) + AUDIO_CHUNK_SIZE, out_data);
     }
-    out_buffer.clear();
-    _engine->process_chunk(&in_buffer, &out_buffer, &_in_controls, &_out_controls, timestamp, samplecount);
     raspa_set_gate_values(static_cast<uint32_t>(_out_controls.gate_values.to_ulong()));
     /* Sika board outputs only positive cv */
     for (int i = 0; i < _cv_output_channels; ++i)
     {
-        float* out_data = output + (_audio_output_channels + i) * AUDIO_CHUNK_SIZE;
+        float* out_data = output + (_audio_output_channels + i) * _buffer_size + start_frame;
         _cv_output_hist[i] = ramp_cv_output(out_data, _cv_output_hist[i], _out_controls.cv_values[i] * CV_OUT_CORR);
     }
 }
@@ -150,6 +179,8 @@ AudioFrontendStatus XenomaiRaspaFrontend::config_audio_channels(const XenomaiRas
     _cv_output_channels = config->cv_outputs;
     _audio_input_channels = raspa_get_num_input_channels() - _cv_input_channels;
     _audio_output_channels = raspa_get_num_output_channels() - _cv_output_channels;
+    _in_buffer = ChunkSampleBuffer(_audio_input_channels);
+    _out_buffer = ChunkSampleBuffer(_audio_output_channels);
     _engine->set_audio_input_channels(_audio_input_channels);
     _engine->set_audio_output_channels(_audio_output_channels);
     auto status = _engine->set_cv_input_channels(_cv_input_channels);
@@ -32,12 +32,15 @@ namespace audio_frontend {
 struct XenomaiRaspaFrontendConfiguration : public BaseAudioFrontendConfiguration
 {
     XenomaiRaspaFrontendConfiguration(bool break_on_mode_sw,
+                                      int buffer_size,
                                       int cv_inputs,
                                       int cv_outputs) : BaseAudioFrontendConfiguration(cv_inputs, cv_outputs),
-                                                        break_on_mode_sw(break_on_mode_sw) {}
+                                                        break_on_mode_sw(break_on_mode_sw),
+                                                        buffer_size(buffer_size) {}
 
     virtual ~XenomaiRaspaFrontendConfiguration() = default;
     bool break_on_mode_sw;
+    int buffer_size;
 };
 
 class XenomaiRaspaFrontend : public BaseAudioFrontend
@@ -90,6 +93,9 @@ private:
     /* Internal process callback function */
     void _internal_process_callback(float* input, float* output);
 
+    /* Process one engine chunk starting at start_frame of the current driver buffer */
+    void _process_audio(float* input, float* output, int start_frame, Time timestamp, int64_t samplecount);
+
     AudioFrontendStatus config_audio_channels(const XenomaiRaspaFrontendConfiguration* config);
 
     static bool _raspa_initialised;
@@ -97,6 +103,10 @@ private:
     int _audio_output_channels;
     int _cv_input_channels;
     int _cv_output_channels;
+    int _buffer_size;
+    float _sample_rate;
+    ChunkSampleBuffer _in_buffer;
+    ChunkSampleBuffer _out_buffer;
     engine::ControlBuffer _in_controls;
     engine::ControlBuffer _out_controls;
     std::array<float, MAX_ENGINE_CV_IO_PORTS> _cv_output_hist{0};
@@ -114,7 +124,7 @@ namespace sushi {
 namespace audio_frontend {
 struct XenomaiRaspaFrontendConfiguration : public BaseAudioFrontendConfiguration
 {
-    XenomaiRaspaFrontendConfiguration(bool, int, int) : BaseAudioFrontendConfiguration(0, 0) {}
+    XenomaiRaspaFrontendConfiguration(bool, int, int, int) : BaseAudioFrontendConfiguration(0, 0) {}
 };
 
 class XenomaiRaspaFrontend : public BaseAudioFrontend
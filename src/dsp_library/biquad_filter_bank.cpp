@@ -0,0 +1,267 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Multichannel biquad filter bank
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <algorithm>
+#include <cassert>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#include "biquad_filter_bank.h"
+
+namespace dsp {
+namespace biquad {
+
+namespace {
+
+constexpr int TIME_CONSTANTS_IN_SMOOTHING_FILTER = 3;
+constexpr int BLOCK_SIZE = 64;
+constexpr float SMOOTHING_THRESHOLD = 1.0e-6f;
+constexpr Coefficients UNITY_COEFFICIENTS = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+
+/* A minimal 4 lane vector abstraction, SSE2 and NEON are part of the base
+ * instruction sets of x86_64 and aarch64 so no runtime dispatch is needed */
+#if defined(__SSE2__)
+using Vector = __m128;
+inline Vector load(const float* data) {return _mm_load_ps(data);}
+inline void store(float* data, Vector v) {_mm_store_ps(data, v);}
+inline Vector broadcast(float value) {return _mm_set1_ps(value);}
+inline Vector add(Vector a, Vector b) {return _mm_add_ps(a, b);}
+inline Vector sub(Vector a, Vector b) {return _mm_sub_ps(a, b);}
+inline Vector mul(Vector a, Vector b) {return _mm_mul_ps(a, b);}
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+using Vector = float32x4_t;
+inline Vector load(const float* data) {return vld1q_f32(data);}
+inline void store(float* data, Vector v) {vst1q_f32(data, v);}
+inline Vector broadcast(float value) {return vdupq_n_f32(value);}
+inline Vector add(Vector a, Vector b) {return vaddq_f32(a, b);}
+inline Vector sub(Vector a, Vector b) {return vsubq_f32(a, b);}
+inline Vector mul(Vector a, Vector b) {return vmulq_f32(a, b);}
+#else
+struct Vector
+{
+    float v[FILTER_BANK_LANES];
+};
+inline Vector load(const float* data) {Vector r; std::copy(data, data + FILTER_BANK_LANES, r.v); return r;}
+inline void store(float* data, Vector v) {std::copy(v.v, v.v + FILTER_BANK_LANES, data);}
+inline Vector broadcast(float value) {Vector r; std::fill(r.v, r.v + FILTER_BANK_LANES, value); return r;}
+template <typename Op>
+inline Vector apply(Vector a, Vector b, Op op)
+{
+    for (int i = 0; i < FILTER_BANK_LANES; ++i)
+    {
+        a.v[i] = op(a.v[i], b.v[i]);
+    }
+    return a;
+}
+inline Vector add(Vector a, Vector b) {return apply(a, b, [](float x, float y) {return x + y;});}
+inline Vector sub(Vector a, Vector b) {return apply(a, b, [](float x, float y) {return x - y;});}
+inline Vector mul(Vector a, Vector b) {return apply(a, b, [](float x, float y) {return x * y;});}
+#endif
+
+inline void set_lane(float (&lanes)[NUMBER_OF_BIQUAD_COEF][FILTER_BANK_LANES], int lane, const Coefficients& c)
+{
+    lanes[0][lane] = c.b0;
+    lanes[1][lane] = c.b1;
+    lanes[2][lane] = c.b2;
+    lanes[3][lane] = c.a1;
+    lanes[4][lane] = c.a2;
+}
+
+} // anonymous namespace
+
+BiquadFilterBank::BiquadFilterBank(int sections)
+{
+    for (auto& section : _sections)
+    {
+        for (int lane = 0; lane < FILTER_BANK_LANES; ++lane)
+        {
+            set_lane(section.targets, lane, UNITY_COEFFICIENTS);
+        }
+    }
+    set_sections(sections);
+    reset();
+}
+
+void BiquadFilterBank::set_sections(int sections)
+{
+    _section_count = std::clamp(sections, 0, MAX_FILTER_BANK_SECTIONS);
+}
+
+void BiquadFilterBank::reset()
+{
+    for (auto& section : _sections)
+    {
+        std::copy(&section.targets[0][0], &section.targets[0][0] + NUMBER_OF_BIQUAD_COEF * FILTER_BANK_LANES,
+                  &section.coefficients[0][0]);
+        std::fill(section.z1, section.z1 + FILTER_BANK_LANES, 0.0f);
+        std::fill(section.z2, section.z2 + FILTER_BANK_LANES, 0.0f);
+    }
+    _smoothing = false;
+}
+
+void BiquadFilterBank::set_smoothing(int buffer_size)
+{
+    /* Same time constant as the smoothing in BiquadFilter */
+    _smoothing_coefficient = 1.0f - std::exp(-2 * M_PI * (1.0f / buffer_size) * TIME_CONSTANTS_IN_SMOOTHING_FILTER);
+}
+
+void BiquadFilterBank::set_coefficients(int section, const Coefficients& coefficients)
+{
+    for (int lane = 0; lane < FILTER_BANK_LANES; ++lane)
+    {
+        set_coefficients(section, lane, coefficients);
+    }
+}
+
+void BiquadFilterBank::set_coefficients(int section, int lane, const Coefficients& coefficients)
+{
+    assert(section < MAX_FILTER_BANK_SECTIONS && lane < FILTER_BANK_LANES);
+    set_lane(_sections[section].targets, lane, coefficients);
+    _smoothing = true;
+}
+
+void BiquadFilterBank::process(const float* const* input, float* const* output, int lanes, int samples)
+{
+    assert(lanes <= FILTER_BANK_LANES);
+    alignas(16) float buffer[BLOCK_SIZE * FILTER_BANK_LANES];
+
+    for (int start = 0; start < samples; start += BLOCK_SIZE)
+    {
+        int block_size = std::min(BLOCK_SIZE, samples - start);
+        /* Interleave so that one vector holds one sample from every lane, unused
+         * lanes are kept silent so they don't produce denormals or nans */
+        for (int n = 0; n < block_size; ++n)
+        {
+            for (int lane = 0; lane < FILTER_BANK_LANES; ++lane)
+            {
+                buffer[n * FILTER_BANK_LANES + lane] = lane < lanes ? input[lane][start + n] : 0.0f;
+            }
+        }
+
+        /* Sections are processed one at a time over the whole block, keeping the
+         * coefficients and state of the section in registers */
+        for (int section = 0; section < _section_count; ++section)
+        {
+            if (_smoothing)
+            {
+                _process_section<true>(section, buffer, block_size);
+            }
+            else
+            {
+                _process_section<false>(section, buffer, block_size);
+            }
+        }
+        if (_smoothing && _smoothing_finished())
+        {
+            for (auto& section : _sections)
+            {
+                std::copy(&section.targets[0][0], &section.targets[0][0] + NUMBER_OF_BIQUAD_COEF * FILTER_BANK_LANES,
+                          &section.coefficients[0][0]);
+            }
+            _smoothing = false;
+        }
+
+        for (int lane = 0; lane < lanes; ++lane)
+        {
+            for (int n = 0; n < block_size; ++n)
+            {
+                output[lane][start + n] = buffer[n * FILTER_BANK_LANES + lane];
+            }
+        }
+    }
+}
+
+template <bool smoothing>
+void BiquadFilterBank::_process_section(int section, float* buffer, int samples)
+{
+    Section& s = _sections[section];
+    Vector b0 = load(s.coefficients[0]);
+    Vector b1 = load(s.coefficients[1]);
+    Vector b2 = load(s.coefficients[2]);
+    Vector a1 = load(s.coefficients[3]);
+    Vector a2 = load(s.coefficients[4]);
+    Vector z1 = load(s.z1);
+    Vector z2 = load(s.z2);
+
+    [[maybe_unused]] Vector k = broadcast(_smoothing_coefficient);
+    [[maybe_unused]] Vector b0_target = load(s.targets[0]);
+    [[maybe_unused]] Vector b1_target = load(s.targets[1]);
+    [[maybe_unused]] Vector b2_target = load(s.targets[2]);
+    [[maybe_unused]] Vector a1_target = load(s.targets[3]);
+    [[maybe_unused]] Vector a2_target = load(s.targets[4]);
+
+    for (int n = 0; n < samples; ++n)
+    {
+        if constexpr (smoothing)
+        {
+            // Process the coefficients through a one pole smoothing filter
+            b0 = add(b0, mul(k, sub(b0_target, b0)));
+            b1 = add(b1, mul(k, sub(b1_target, b1)));
+            b2 = add(b2, mul(k, sub(b2_target, b2)));
+            a1 = add(a1, mul(k, sub(a1_target, a1)));
+            a2 = add(a2, mul(k, sub(a2_target, a2)));
+        }
+        // Transposed direct form II, same as BiquadFilter
+        Vector x = load(buffer + n * FILTER_BANK_LANES);
+        Vector y = add(mul(b0, x), z1);
+        z1 = add(sub(mul(b1, x), mul(a1, y)), z2);
+        z2 = sub(mul(b2, x), mul(a2, y));
+        store(buffer + n * FILTER_BANK_LANES, y);
+    }
+
+    if constexpr (smoothing)
+    {
+        store(s.coefficients[0], b0);
+        store(s.coefficients[1], b1);
+        store(s.coefficients[2], b2);
+        store(s.coefficients[3], a1);
+        store(s.coefficients[4], a2);
+    }
+    store(s.z1, z1);
+    store(s.z2, z2);
+}
+
+bool BiquadFilterBank::_smoothing_finished() const
+{
+    for (int section = 0; section < _section_count; ++section)
+    {
+        const auto& s = _sections[section];
+        for (int i = 0; i < NUMBER_OF_BIQUAD_COEF; ++i)
+        {
+            for (int lane = 0; lane < FILTER_BANK_LANES; ++lane)
+            {
+                if (std::abs(s.targets[i][lane] - s.coefficients[i][lane]) > SMOOTHING_THRESHOLD)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // end namespace biquad
+} // end namespace dsp
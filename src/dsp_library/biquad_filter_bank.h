@@ -0,0 +1,105 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Multichannel biquad filter bank
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ *
+ * Runs up to FILTER_BANK_LANES channels through a cascade of biquad sections in
+ * parallel, with one channel in every simd lane. Every section of every lane has its
+ * own set of coefficients, which are smoothed per sample when changed.
+ */
+
+#ifndef SUSHI_BIQUAD_FILTER_BANK_H
+#define SUSHI_BIQUAD_FILTER_BANK_H
+
+#include "biquad_filter.h"
+
+namespace dsp {
+namespace biquad {
+
+constexpr int FILTER_BANK_LANES = 4;
+constexpr int MAX_FILTER_BANK_SECTIONS = 8;
+
+class BiquadFilterBank
+{
+public:
+    explicit BiquadFilterBank(int sections = 1);
+
+    ~BiquadFilterBank() = default;
+
+    /**
+     * @brief Set the number of cascaded sections, clamped to MAX_FILTER_BANK_SECTIONS.
+     *        Not safe to call during processing.
+     */
+    void set_sections(int sections);
+
+    int sections() const {return _section_count;}
+
+    /**
+     * @brief Resets the processing state and sets all coefficients to their targets
+     */
+    void reset();
+
+    /**
+     * @brief Sets the parameters for smoothing coefficient changes
+     */
+    void set_smoothing(int buffer_size);
+
+    /**
+     * @brief Set the coefficients of one section in all lanes
+     */
+    void set_coefficients(int section, const Coefficients& coefficients);
+
+    /**
+     * @brief Set the coefficients of one section in one lane
+     */
+    void set_coefficients(int section, int lane, const Coefficients& coefficients);
+
+    /**
+     * @brief Filter lanes channels through all sections. Input and output may point
+     *        to the same channel data.
+     * @param input An array of lanes input channels
+     * @param output An array of lanes output channels
+     * @param lanes The number of channels to process, at most FILTER_BANK_LANES
+     * @param samples The number of samples in every channel
+     */
+    void process(const float* const* input, float* const* output, int lanes, int samples);
+
+private:
+    template <bool smoothing>
+    void _process_section(int section, float* buffer, int samples);
+
+    bool _smoothing_finished() const;
+
+    struct alignas(16) Section
+    {
+        /* Coefficients are stored in Coefficients member order, b0, b1, b2, a1, a2 */
+        float targets[NUMBER_OF_BIQUAD_COEF][FILTER_BANK_LANES];
+        float coefficients[NUMBER_OF_BIQUAD_COEF][FILTER_BANK_LANES];
+        float z1[FILTER_BANK_LANES];
+        float z2[FILTER_BANK_LANES];
+    };
+
+    Section _sections[MAX_FILTER_BANK_SECTIONS];
+    int _section_count;
+    float _smoothing_coefficient{1.0f};
+    bool _smoothing{false};
+};
+
+} // end namespace biquad
+} // end namespace dsp
+
+#endif //SUSHI_BIQUAD_FILTER_BANK_H
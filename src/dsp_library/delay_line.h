@@ -0,0 +1,102 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Fixed capacity delay line for delaying audio by a whole number of samples
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_DELAY_LINE_H
+#define SUSHI_DELAY_LINE_H
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+#include "library/constants.h"
+#include "library/sample_buffer.h"
+
+namespace dsp {
+
+/**
+ * @brief A mono delay line working on whole chunks. All memory is allocated when
+ *        constructed and the delay can be changed from any thread while audio is
+ *        processed, the new delay is used from the next call to process().
+ */
+class DelayLine
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(DelayLine);
+
+    /**
+     * @brief Create a delay line.
+     * @param max_delay The longest delay in samples the delay line can be set to
+     */
+    explicit DelayLine(int max_delay) : _size(max_delay + AUDIO_CHUNK_SIZE),
+                                        _buffer(std::make_unique<float[]>(_size)),
+                                        _output(1)
+    {
+        std::fill(_buffer.get(), _buffer.get() + _size, 0.0f);
+    }
+
+    /**
+     * @brief Set the delay.
+     * @param delay The delay in samples, limited to the max delay of the delay line
+     */
+    void set_delay(int delay)
+    {
+        _delay.store(std::clamp(delay, 0, max_delay()), std::memory_order_relaxed);
+    }
+
+    int delay() const {return _delay.load(std::memory_order_relaxed);}
+
+    int max_delay() const {return _size - AUDIO_CHUNK_SIZE;}
+
+    /**
+     * @brief Write one chunk to the delay line and read one chunk delayed by the current delay
+     * @param input The first channel of this buffer is written to the delay line
+     * @return A mono buffer with the delayed audio, valid until the next call to process()
+     */
+    const sushi::ChunkSampleBuffer& process(const sushi::ChunkSampleBuffer& input)
+    {
+        const float* in = input.channel(0);
+        float* out = _output.channel(0);
+        int delay = _delay.load(std::memory_order_relaxed);
+        int read_pos = _write_pos - delay;
+        if (read_pos < 0)
+        {
+            read_pos += _size;
+        }
+        for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+        {
+            _buffer[_write_pos] = in[i];
+            out[i] = _buffer[read_pos];
+            _write_pos = _write_pos + 1 < _size ? _write_pos + 1 : 0;
+            read_pos = read_pos + 1 < _size ? read_pos + 1 : 0;
+        }
+        return _output;
+    }
+
+private:
+    int _size;
+    std::unique_ptr<float[]> _buffer;
+    sushi::ChunkSampleBuffer _output;
+    int _write_pos{0};
+    std::atomic<int> _delay{0};
+};
+
+} // namespace dsp
+
+#endif //SUSHI_DELAY_LINE_H
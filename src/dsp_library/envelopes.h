@@ -21,6 +21,9 @@
 #ifndef SUSHI_ENVELOPES_H
 #define SUSHI_ENVELOPES_H
 
+#include <algorithm>
+#include <cmath>
+
 #include "library/constants.h"
 
 namespace dsp {
@@ -125,6 +128,71 @@ public:
         return _current_level;
     }
 
+    /**
+     * @brief Advance the envelope a number of samples and write its level after every
+     *        sample, the same as calling tick(1) for every sample. The levels of each
+     *        stage are computed in one pass without branches so they can be vectorised.
+     * @param output Array of at least samples levels
+     * @param samples The number of samples to render
+     */
+    void render(float* output, int samples)
+    {
+        int i = 0;
+        while (i < samples)
+        {
+            int count = samples - i;
+            float* out = output + i;
+            float start = _current_level;
+            switch (_state)
+            {
+                case EnvelopeState::ATTACK:
+                    count = std::min(count, _steps_to(1.0f - start, _attack_factor));
+                    for (int n = 0; n < count; ++n)
+                    {
+                        out[n] = std::min(start + (n + 1) * _attack_factor, 1.0f);
+                    }
+                    _current_level = out[count - 1];
+                    if (_current_level >= 1.0f)
+                    {
+                        _state = EnvelopeState::DECAY;
+                    }
+                    break;
+
+                case EnvelopeState::DECAY:
+                    count = std::min(count, _steps_to(start - _sustain_level, _decay_factor));
+                    for (int n = 0; n < count; ++n)
+                    {
+                        out[n] = std::max(start - (n + 1) * _decay_factor, _sustain_level);
+                    }
+                    _current_level = out[count - 1];
+                    if (_current_level <= _sustain_level)
+                    {
+                        _state = EnvelopeState::SUSTAIN;
+                    }
+                    break;
+
+                case EnvelopeState::RELEASE:
+                    count = std::min(count, _steps_to(start, _release_factor));
+                    for (int n = 0; n < count; ++n)
+                    {
+                        out[n] = std::max(start - (n + 1) * _release_factor, 0.0f);
+                    }
+                    _current_level = out[count - 1];
+                    if (_current_level <= 0.0f)
+                    {
+                        _state = EnvelopeState::OFF;
+                    }
+                    break;
+
+                default:
+                    /* Off or sustain, the level doesn't change */
+                    std::fill(out, out + count, _current_level);
+                    break;
+            }
+            i += count;
+        }
+    }
+
     /**
      * @brief Get the envelopes current level without advancing it.
      * @return The current envelope level.
@@ -174,6 +242,22 @@ public:
     }
 
 private:
+    /* The number of samples needed to move distance at rate per sample, at least 1 */
+    static int _steps_to(float distance, float rate)
+    {
+        if (distance <= 0.0f)
+        {
+            return 1;
+        }
+        if (rate <= 0.0f || distance / rate > MAX_STEPS)
+        {
+            return MAX_STEPS;
+        }
+        return std::max(static_cast<int>(std::ceil(distance / rate)), 1);
+    }
+
+    static constexpr int MAX_STEPS = 1 << 30;
+
     float _attack_factor{0};
     float _decay_factor{0};
     float _sustain_level{1};
@@ -0,0 +1,131 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Fast fourier transform of real signals
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cassert>
+
+#include "fft.h"
+
+namespace dsp {
+
+RealFft::RealFft(int size) : _size(size)
+{
+    assert(size >= 4 && (size & (size - 1)) == 0);
+    int n = size / 2;
+    int bits = 0;
+    while ((1 << bits) < n)
+    {
+        ++bits;
+    }
+    _bit_reverse.resize(n);
+    for (int i = 0; i < n; ++i)
+    {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b)
+        {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        _bit_reverse[i] = reversed;
+    }
+    _twiddles.resize(n / 2);
+    for (int k = 0; k < n / 2; ++k)
+    {
+        _twiddles[k] = std::polar(1.0f, static_cast<float>(-2 * M_PI * k / n));
+    }
+    _real_twiddles.resize(n + 1);
+    for (int k = 0; k <= n; ++k)
+    {
+        _real_twiddles[k] = std::polar(1.0f, static_cast<float>(-2 * M_PI * k / size));
+    }
+    _work.resize(n);
+}
+
+void RealFft::forward(const float* input, std::complex<float>* output)
+{
+    int n = _size / 2;
+    for (int i = 0; i < n; ++i)
+    {
+        _work[_bit_reverse[i]] = {input[2 * i], input[2 * i + 1]};
+    }
+    _transform(false);
+
+    /* The spectra of the even and odd samples, e and o, are separated using the
+     * symmetry of the spectra of real signals and combined as e + o * e^(-2 pi i k / size) */
+    output[0] = {_work[0].real() + _work[0].imag(), 0.0f};
+    output[n] = {_work[0].real() - _work[0].imag(), 0.0f};
+    for (int k = 1; k < n; ++k)
+    {
+        auto a = _work[k];
+        auto b = std::conj(_work[n - k]);
+        std::complex<float> even = 0.5f * (a + b);
+        std::complex<float> odd = complex_multiply(a - b, {0.0f, -0.5f});
+        output[k] = even + complex_multiply(odd, _real_twiddles[k]);
+    }
+}
+
+void RealFft::inverse(const std::complex<float>* input, float* output)
+{
+    int n = _size / 2;
+    /* The reverse of the separation in forward(), with the normalisation folded in */
+    float scale = 1.0f / n;
+    for (int k = 0; k < n; ++k)
+    {
+        auto a = input[k];
+        auto b = std::conj(input[n - k]);
+        std::complex<float> even = 0.5f * (a + b);
+        std::complex<float> odd = complex_multiply(0.5f * (a - b), std::conj(_real_twiddles[k]));
+        _work[_bit_reverse[k]] = scale * (even + complex_multiply(odd, {0.0f, 1.0f}));
+    }
+    _transform(true);
+    for (int i = 0; i < n; ++i)
+    {
+        output[2 * i] = _work[i].real();
+        output[2 * i + 1] = _work[i].imag();
+    }
+}
+
+void RealFft::_transform(bool inverse)
+{
+    int n = _size / 2;
+    std::complex<float>* data = _work.data();
+    for (int length = 2; length <= n; length *= 2)
+    {
+        int half = length / 2;
+        int stride = n / length;
+        for (int start = 0; start < n; start += length)
+        {
+            for (int i = 0; i < half; ++i)
+            {
+                auto twiddle = _twiddles[i * stride];
+                if (inverse)
+                {
+                    twiddle = std::conj(twiddle);
+                }
+                auto even = data[start + i];
+                auto odd = complex_multiply(data[start + i + half], twiddle);
+                data[start + i] = even + odd;
+                data[start + i + half] = even - odd;
+            }
+        }
+    }
+}
+
+} // end namespace dsp
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Fast fourier transform of real signals
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ *
+ * A real signal of N samples is transformed as a complex signal of N / 2 samples, with
+ * the even samples as real parts and the odd samples as imaginary parts, followed by a
+ * pass that separates the spectra of the two. The complex transform is an iterative
+ * radix 2 fft with precalculated twiddle factors and bit reversal indices.
+ */
+
+#ifndef SUSHI_FFT_H
+#define SUSHI_FFT_H
+
+#include <complex>
+#include <vector>
+
+namespace dsp {
+
+/**
+ * @brief Complex multiplication without the nan and inf checks of std::complex, which
+ *        keep compilers from vectorising loops of complex multiplications.
+ */
+inline std::complex<float> complex_multiply(std::complex<float> a, std::complex<float> b)
+{
+    return {a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real()};
+}
+
+/**
+ * @brief Multiply two spectra bin by bin and add the result to an accumulator
+ * @param accumulator Array of bins values that the products are added to
+ * @param a Array of bins values
+ * @param b Array of bins values
+ * @param bins The number of bins
+ */
+inline void complex_multiply_add(std::complex<float>* accumulator,
+                                 const std::complex<float>* a,
+                                 const std::complex<float>* b,
+                                 int bins)
+{
+    for (int i = 0; i < bins; ++i)
+    {
+        accumulator[i] += complex_multiply(a[i], b[i]);
+    }
+}
+
+/**
+ * @brief Fft of a fixed size. All memory is allocated when constructed so transforms
+ *        are realtime safe, though not thread safe as they share a work buffer.
+ */
+class RealFft
+{
+public:
+    /**
+     * @brief Create an fft
+     * @param size The number of real samples to transform, a power of 2 and at least 4
+     */
+    explicit RealFft(int size);
+
+    int size() const {return _size;}
+
+    /**
+     * @brief The number of complex bins of the spectrum, from dc to nyquist
+     */
+    int bins() const {return _size / 2 + 1;}
+
+    /**
+     * @brief Transform a real signal to its spectrum
+     * @param input Array of size() samples
+     * @param output Array of bins() values, may not overlap input
+     */
+    void forward(const float* input, std::complex<float>* output);
+
+    /**
+     * @brief Transform a spectrum back to a real signal, normalised so that forward
+     *        followed by inverse gives back the original signal
+     * @param input Array of bins() values
+     * @param output Array of size() samples, may not overlap input
+     */
+    void inverse(const std::complex<float>* input, float* output);
+
+private:
+    /* Complex fft of size / 2 values in _work, which are already in bit reversed order */
+    void _transform(bool inverse);
+
+    int _size;
+    std::vector<int> _bit_reverse;
+    /* e^(-2 pi i k / (size / 2)) for the complex fft */
+    std::vector<std::complex<float>> _twiddles;
+    /* e^(-2 pi i k / size) for separating the spectra of the even and odd samples */
+    std::vector<std::complex<float>> _real_twiddles;
+    std::vector<std::complex<float>> _work;
+};
+
+} // end namespace dsp
+
+#endif //SUSHI_FFT_H
@@ -0,0 +1,166 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Low frequency oscillator that renders a block of modulation values at a time
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_LFO_H
+#define SUSHI_LFO_H
+
+#include <cmath>
+
+#include "library/constants.h"
+
+namespace dsp {
+
+enum class LfoWaveform : int
+{
+    SINE = 0,
+    TRIANGLE,
+    SAW,
+    SQUARE,
+    WAVEFORM_COUNT
+};
+
+/**
+ * @brief Sine approximation for a phase in the range -0.5 to 0.5, with an error below
+ *        1.0e-5. Branch free so that it can be vectorised, unlike std::sin.
+ */
+inline float fast_sine(float phase)
+{
+    /* Fold to -0.25 to 0.25, where sin is symmetric around 0.25 and -0.25 */
+    float folded = phase > 0.25f ? 0.5f - phase : (phase < -0.25f ? -0.5f - phase : phase);
+    float x = folded * static_cast<float>(2 * M_PI);
+    float x2 = x * x;
+    /* Taylor series up to the 9th order */
+    return x * (1.0f + x2 * (-1.0f / 6 + x2 * (1.0f / 120 + x2 * (-1.0f / 5040 + x2 * (1.0f / 362880)))));
+}
+
+/**
+ * @brief A basic, non band limited, LFO with a few classic waveforms. Every value in a
+ *        block is computed directly from its phase, without a dependency on the value
+ *        before it, so the loops can be vectorised.
+ */
+class Lfo
+{
+    SUSHI_DECLARE_NON_COPYABLE(Lfo);
+public:
+    Lfo() {}
+
+    /**
+     * @brief Set the current samplerate
+     * @param samplerate The samplerate in samples/second.
+     */
+    void set_samplerate(float samplerate)
+    {
+        _samplerate = samplerate;
+        _increment = _frequency / _samplerate;
+    }
+
+    /**
+     * @brief Set the frequency of the lfo
+     * @param frequency The frequency in Hz
+     */
+    void set_frequency(float frequency)
+    {
+        _frequency = frequency;
+        _increment = _frequency / _samplerate;
+    }
+
+    void set_waveform(LfoWaveform waveform) {_waveform = waveform;}
+
+    /**
+     * @brief Restart the lfo from a given phase
+     * @param phase The phase in periods, 0 - 1
+     */
+    void reset(float phase = 0.0f) {_phase = phase;}
+
+    /**
+     * @brief Get the current phase in periods, 0 - 1
+     */
+    float phase() const {return _phase;}
+
+    /**
+     * @brief Render the lfo output for a number of samples and advance its phase
+     * @param output Array of at least samples values, set to values from -1 to 1
+     * @param samples The number of samples to render
+     */
+    void render(float* output, int samples)
+    {
+        switch (_waveform)
+        {
+            case LfoWaveform::SINE:
+                _render(output, samples, [](float p) {return fast_sine(p < 0.5f ? p : p - 1.0f);});
+                break;
+
+            case LfoWaveform::TRIANGLE:
+                _render(output, samples, [](float p) {return 1.0f - 4.0f * std::abs(p - 0.5f);});
+                break;
+
+            case LfoWaveform::SAW:
+                _render(output, samples, [](float p) {return 2.0f * p - 1.0f;});
+                break;
+
+            case LfoWaveform::SQUARE:
+                _render(output, samples, [](float p) {return p < 0.5f ? 1.0f : -1.0f;});
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    /**
+     * @brief Advance the phase by a number of samples without rendering all of them
+     * @param samples The number of samples to advance, at least 1
+     * @return The value of the last sample, the same value render() would have given it
+     */
+    float advance(int samples)
+    {
+        _phase += (samples - 1) * _increment;
+        _phase -= static_cast<int>(_phase);
+        float value = 0.0f;
+        render(&value, 1);
+        return value;
+    }
+
+private:
+    template <typename Shape>
+    void _render(float* output, int samples, Shape shape)
+    {
+        float start = _phase;
+        for (int i = 0; i < samples; ++i)
+        {
+            float phase = start + i * _increment;
+            /* Phase is never negative, so truncation is the same as floor */
+            phase -= static_cast<int>(phase);
+            output[i] = shape(phase);
+        }
+        _phase = start + samples * _increment;
+        _phase -= static_cast<int>(_phase);
+    }
+
+    float _samplerate{44100};
+    float _frequency{1.0f};
+    float _increment{1.0f / 44100};
+    float _phase{0.0f};
+    LfoWaveform _waveform{LfoWaveform::SINE};
+};
+
+} // end namespace dsp
+
+#endif //SUSHI_LFO_H
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Uniformly partitioned fft convolution
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "partitioned_convolver.h"
+
+namespace dsp {
+
+PartitionedConvolver::PartitionedConvolver(int block_size,
+                                           const float* impulse_response,
+                                           int length) : _block_size(block_size),
+                                                         _partitions(std::max(1, (length + block_size - 1) / block_size)),
+                                                         _fft(2 * block_size),
+                                                         _bins(_fft.bins())
+{
+    assert(length >= 0);
+    _partition_spectra.resize(static_cast<size_t>(_partitions) * _bins);
+    _input_spectra.resize(static_cast<size_t>(_partitions) * _bins);
+    _input_buffer.resize(2 * _block_size);
+    _accumulator.resize(_bins);
+    _output_buffer.resize(2 * _block_size);
+
+    /* Every partition is zero padded to the fft size */
+    std::vector<float> partition(2 * _block_size, 0.0f);
+    for (int p = 0; p < _partitions; ++p)
+    {
+        int start = p * _block_size;
+        int samples = std::max(0, std::min(_block_size, length - start));
+        std::fill(partition.begin(), partition.end(), 0.0f);
+        std::copy(impulse_response + start, impulse_response + start + samples, partition.begin());
+        _fft.forward(partition.data(), _partition_spectra.data() + p * _bins);
+    }
+    reset();
+}
+
+void PartitionedConvolver::process(const float* input, float* output)
+{
+    std::copy(_input_buffer.begin() + _block_size, _input_buffer.end(), _input_buffer.begin());
+    std::copy(input, input + _block_size, _input_buffer.begin() + _block_size);
+    _fft.forward(_input_buffer.data(), _input_spectra.data() + _input_position * _bins);
+
+    std::fill(_accumulator.begin(), _accumulator.end(), std::complex<float>(0.0f, 0.0f));
+    int position = _input_position;
+    for (int p = 0; p < _partitions; ++p)
+    {
+        complex_multiply_add(_accumulator.data(),
+                             _input_spectra.data() + position * _bins,
+                             _partition_spectra.data() + p * _bins,
+                             _bins);
+        position = position == 0 ? _partitions - 1 : position - 1;
+    }
+    _input_position = _input_position + 1 == _partitions ? 0 : _input_position + 1;
+
+    /* The first half is circular convolution wrapped around and discarded */
+    _fft.inverse(_accumulator.data(), _output_buffer.data());
+    std::copy(_output_buffer.begin() + _block_size, _output_buffer.end(), output);
+}
+
+void PartitionedConvolver::reset()
+{
+    std::fill(_input_spectra.begin(), _input_spectra.end(), std::complex<float>(0.0f, 0.0f));
+    std::fill(_input_buffer.begin(), _input_buffer.end(), 0.0f);
+    _input_position = 0;
+}
+
+} // end namespace dsp
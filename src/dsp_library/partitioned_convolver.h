@@ -0,0 +1,90 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Uniformly partitioned fft convolution
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ *
+ * The impulse response is split into partitions of one block each, which are
+ * transformed once when the convolver is created. Every input block is transformed
+ * together with the block before it and the spectra of the latest input blocks are kept
+ * in a frequency domain delay line, so that a block of output is the inverse transform
+ * of the sum of every partition multiplied with the input spectrum as many blocks back
+ * (overlap-save). Long impulse responses are convolved with several convolvers of
+ * increasing block sizes, each covering a later part of the impulse response.
+ */
+
+#ifndef SUSHI_PARTITIONED_CONVOLVER_H
+#define SUSHI_PARTITIONED_CONVOLVER_H
+
+#include <complex>
+#include <vector>
+
+#include "library/constants.h"
+#include "fft.h"
+
+namespace dsp {
+
+class PartitionedConvolver
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(PartitionedConvolver);
+
+    /**
+     * @brief Create a convolver. Not realtime safe.
+     * @param block_size The number of samples processed at a time, a power of 2
+     * @param impulse_response Array of length samples
+     * @param length The length of the impulse response
+     */
+    PartitionedConvolver(int block_size, const float* impulse_response, int length);
+
+    int block_size() const {return _block_size;}
+
+    int partitions() const {return _partitions;}
+
+    /**
+     * @brief Convolve the next block of input. The output is not delayed, the first
+     *        output sample is the response to the first input sample of the block.
+     * @param input Array of block_size() samples
+     * @param output Array of block_size() samples, may be the same as input
+     */
+    void process(const float* input, float* output);
+
+    /**
+     * @brief Clear the input history
+     */
+    void reset();
+
+private:
+    int _block_size;
+    int _partitions;
+    RealFft _fft;
+    int _bins;
+
+    /* Spectra of every partition of the impulse response, _bins values each */
+    std::vector<std::complex<float>> _partition_spectra;
+    /* Spectra of the last _partitions input blocks, used as a ring buffer */
+    std::vector<std::complex<float>> _input_spectra;
+    int _input_position{0};
+
+    /* The previous and the current input block */
+    std::vector<float> _input_buffer;
+    std::vector<std::complex<float>> _accumulator;
+    std::vector<float> _output_buffer;
+};
+
+} // end namespace dsp
+
+#endif //SUSHI_PARTITIONED_CONVOLVER_H
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Band limited interpolation and sample rate conversion
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <cassert>
+
+#include "resampler.h"
+
+namespace dsp {
+namespace resampler {
+
+namespace {
+
+/* Consumed input is removed from the buffers when this many frames have been used */
+constexpr int DISCARD_THRESHOLD = 4096;
+
+/* Sinc scaled to cutoff and tapered with a Blackman window that reaches 0 at +-half */
+double windowed_sinc(double x, double cutoff, int half)
+{
+    double t = x / half;
+    if (std::abs(t) >= 1.0)
+    {
+        return 0.0;
+    }
+    double window = 0.42 + 0.5 * std::cos(M_PI * t) + 0.08 * std::cos(2 * M_PI * t);
+    double arg = M_PI * cutoff * x;
+    double sinc = std::abs(arg) < 1.0e-9 ? 1.0 : std::sin(arg) / arg;
+    return cutoff * sinc * window;
+}
+
+} // anonymous namespace
+
+int taps(Quality quality)
+{
+    switch (quality)
+    {
+        case Quality::LINEAR:   return 2;
+        case Quality::LOW:      return 8;
+        case Quality::MEDIUM:   return 16;
+        default:                return MAX_INTERPOLATION_TAPS;
+    }
+}
+
+PolyphaseTable::PolyphaseTable(Quality quality, float cutoff) : _taps(resampler::taps(quality))
+{
+    _coefficients.resize((INTERPOLATION_PHASES + 1) * _taps);
+    int half = _taps / 2;
+    for (int phase = 0; phase <= INTERPOLATION_PHASES; ++phase)
+    {
+        double fraction = static_cast<double>(phase) / INTERPOLATION_PHASES;
+        float* row = _coefficients.data() + phase * _taps;
+        double sum = 0.0;
+        for (int i = 0; i < _taps; ++i)
+        {
+            /* Distance from the interpolated position to the sample at i */
+            double x = i - history() - fraction;
+            double value = quality == Quality::LINEAR ? std::max(0.0, 1.0 - std::abs(x)) :
+                                                        windowed_sinc(x, cutoff, half);
+            row[i] = static_cast<float>(value);
+            sum += value;
+        }
+        /* Normalise every phase to unity gain at DC, otherwise the ripple of the
+         * truncated kernel modulates constant signals with the phase */
+        for (int i = 0; i < _taps; ++i)
+        {
+            row[i] = static_cast<float>(row[i] / sum);
+        }
+    }
+}
+
+Resampler::Resampler(int channels,
+                     double input_rate,
+                     double output_rate,
+                     Quality quality) : _table(quality, static_cast<float>(std::min(1.0, output_rate / input_rate))),
+                                        _channels(channels),
+                                        _step(input_rate / output_rate),
+                                        _position(_table.history()),
+                                        _buffers(channels)
+{
+    assert(channels > 0 && input_rate > 0 && output_rate > 0);
+}
+
+void Resampler::push(const float* input, int frames)
+{
+    if (frames <= 0 || _flushed)
+    {
+        return;
+    }
+    if (_input_frames == 0)
+    {
+        /* Repeat the first frame before the start, so that the output starts
+         * smoothly instead of fading in from silence */
+        _append_frame(input, _table.history());
+    }
+    for (int c = 0; c < _channels; ++c)
+    {
+        auto& buffer = _buffers[c];
+        buffer.resize(_buffered_frames + frames);
+        float* dest = buffer.data() + _buffered_frames;
+        for (int i = 0; i < frames; ++i)
+        {
+            dest[i] = input[i * _channels + c];
+        }
+    }
+    _buffered_frames += frames;
+    _input_frames += frames;
+}
+
+void Resampler::flush()
+{
+    if (_flushed)
+    {
+        return;
+    }
+    if (_input_frames > 0)
+    {
+        /* Likewise repeat the last frame after the end */
+        std::vector<float> last_frame(_channels);
+        for (int c = 0; c < _channels; ++c)
+        {
+            last_frame[c] = _buffers[c][_buffered_frames - 1];
+        }
+        _append_frame(last_frame.data(), _table.taps() / 2);
+    }
+    _flushed = true;
+}
+
+int Resampler::available() const
+{
+    /* The kernel reads taps / 2 frames after the interpolated position */
+    double span = _buffered_frames - _table.taps() / 2 - _position;
+    if (span <= 0.0)
+    {
+        return 0;
+    }
+    auto frames = static_cast<long long>(std::ceil(span / _step));
+    if (_flushed)
+    {
+        auto total_frames = static_cast<long long>(std::ceil(_input_frames / _step));
+        frames = std::min(frames, total_frames - _output_frames);
+    }
+    return static_cast<int>(std::max(frames, 0LL));
+}
+
+int Resampler::pull(float* output, int frames)
+{
+    frames = std::min(frames, available());
+    int history = _table.history();
+    for (int c = 0; c < _channels; ++c)
+    {
+        const float* buffer = _buffers[c].data();
+        for (int i = 0; i < frames; ++i)
+        {
+            double position = _position + i * _step;
+            int index = static_cast<int>(position);
+            float fraction = static_cast<float>(position - index);
+            output[i * _channels + c] = _table.interpolate(buffer + index - history, fraction);
+        }
+    }
+    _position += frames * _step;
+    _output_frames += frames;
+
+    int consumed = static_cast<int>(_position) - history;
+    if (consumed >= DISCARD_THRESHOLD)
+    {
+        for (auto& buffer : _buffers)
+        {
+            buffer.erase(buffer.begin(), buffer.begin() + consumed);
+        }
+        _buffered_frames -= consumed;
+        _position -= consumed;
+    }
+    return frames;
+}
+
+void Resampler::_append_frame(const float* frame, int count)
+{
+    for (int c = 0; c < _channels; ++c)
+    {
+        _buffers[c].insert(_buffers[c].end(), count, frame[c]);
+    }
+    _buffered_frames += count;
+}
+
+} // end namespace resampler
+} // end namespace dsp
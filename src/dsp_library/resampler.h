@@ -0,0 +1,167 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Band limited interpolation and sample rate conversion
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ *
+ * Both are built on a polyphase table of a windowed sinc kernel. The kernel is tabulated
+ * at INTERPOLATION_PHASES fractional positions between two samples and the coefficients
+ * for positions in between are interpolated linearly from the two closest phases.
+ */
+
+#ifndef SUSHI_RESAMPLER_H
+#define SUSHI_RESAMPLER_H
+
+#include <algorithm>
+#include <vector>
+
+namespace dsp {
+namespace resampler {
+
+constexpr int INTERPOLATION_PHASES = 256;
+constexpr int MAX_INTERPOLATION_TAPS = 32;
+
+enum class Quality : int
+{
+    LINEAR = 0,     // 2 taps, plain linear interpolation
+    LOW,            // 8 taps
+    MEDIUM,         // 16 taps
+    HIGH,           // 32 taps, MAX_INTERPOLATION_TAPS
+    QUALITY_COUNT
+};
+
+/**
+ * @brief Get the number of taps of the interpolation kernel of a quality tier
+ */
+int taps(Quality quality);
+
+/**
+ * @brief Coefficients of the interpolation kernel for every phase
+ */
+class PolyphaseTable
+{
+public:
+    /**
+     * @brief Create a table
+     * @param quality The quality tier, which sets the length of the kernel
+     * @param cutoff The cutoff of the kernel relative to the nyquist frequency of the
+     *        input. Set below 1 to band limit the output when decimating.
+     */
+    explicit PolyphaseTable(Quality quality, float cutoff = 1.0f);
+
+    int taps() const {return _taps;}
+
+    /**
+     * @brief The number of samples before the interpolated position that the kernel
+     *        reads, taps() / 2 - 1. The kernel reads taps() / 2 samples after it.
+     */
+    int history() const {return _taps / 2 - 1;}
+
+    /**
+     * @brief Interpolate a value between two samples.
+     * @param data Pointer to the first sample read by the kernel, which is history()
+     *        samples before the sample before the interpolated position. taps()
+     *        samples are read.
+     * @param fraction The position between the sample at data[history()] and the
+     *        following sample, 0 - 1.
+     * @return The interpolated value
+     */
+    float interpolate(const float* data, float fraction) const
+    {
+        float phase = fraction * INTERPOLATION_PHASES;
+        /* Rounding can give a fraction of exactly 1, which is handled by the last row */
+        int index = std::min(static_cast<int>(phase), INTERPOLATION_PHASES - 1);
+        float weight = phase - index;
+        const float* low = _coefficients.data() + index * _taps;
+        const float* high = low + _taps;
+        /* Independent sums so that the loop vectorises as two dot products */
+        float low_sum = 0.0f;
+        float high_sum = 0.0f;
+        for (int i = 0; i < _taps; ++i)
+        {
+            low_sum += data[i] * low[i];
+            high_sum += data[i] * high[i];
+        }
+        return low_sum + weight * (high_sum - low_sum);
+    }
+
+private:
+    int _taps;
+    /* INTERPOLATION_PHASES + 1 rows of taps coefficients, the last row is the
+     * first one shifted one sample so that every phase can be interpolated */
+    std::vector<float> _coefficients;
+};
+
+/**
+ * @brief Converts a stream of interleaved multichannel audio between two sample rates.
+ *        Input is pushed in blocks of any size and output pulled when available, so
+ *        input and output can be read and written in the block sizes that suit the
+ *        caller. Not realtime safe, as the input buffer grows to fit what is pushed.
+ */
+class Resampler
+{
+public:
+    Resampler(int channels, double input_rate, double output_rate, Quality quality = Quality::HIGH);
+
+    /**
+     * @brief Add input frames
+     * @param input Interleaved input
+     * @param frames The number of frames in input
+     */
+    void push(const float* input, int frames);
+
+    /**
+     * @brief Signal the end of the input, so that the last frames can be pulled. The
+     *        total output is then the length of the input converted to the output rate.
+     */
+    void flush();
+
+    bool flushed() const {return _flushed;}
+
+    /**
+     * @brief Get the number of output frames that can be pulled
+     */
+    int available() const;
+
+    /**
+     * @brief Get output frames
+     * @param output Interleaved output, with room for frames frames
+     * @param frames The maximum number of frames to get
+     * @return The number of frames written to output
+     */
+    int pull(float* output, int frames);
+
+private:
+    /* Append copies of one interleaved frame, to pad the edges of the input */
+    void _append_frame(const float* frame, int count);
+
+    PolyphaseTable _table;
+    int _channels;
+    /* Input frames per output frame */
+    double _step;
+    /* Position of the next output frame in the input buffers */
+    double _position;
+    std::vector<std::vector<float>> _buffers;
+    int _buffered_frames{0};
+    long long _input_frames{0};
+    long long _output_frames{0};
+    bool _flushed{false};
+};
+
+} // end namespace resampler
+} // end namespace dsp
+
+#endif //SUSHI_RESAMPLER_H
@@ -47,6 +47,16 @@ public:
         _length = length;
     }
 
+    /**
+     * @brief Return the number of samples in the data
+     */
+    int length() const {return _length;}
+
+    /**
+     * @brief Return the wrapped sample data
+     */
+    const float* data() const {return _data;}
+
     /**
      * @brief Return the value at sample position. Does linear interpolation
      * @param position The position in the sample buffer.
@@ -21,6 +21,8 @@
 #ifndef SUSHI_VALUE_SMOOTHER_H
 #define SUSHI_VALUE_SMOOTHER_H
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cmath>
 #include <cassert>
@@ -119,6 +121,59 @@ public:
         }
     }
 
+    /**
+     * @brief Advance the smoother a number of sample points at once and write the
+     *        smoothed values to a buffer. Gives the same values as calling next_value()
+     *        repeatedly, but every value is calculated in closed form from the current
+     *        value so there is no dependency between consecutive samples and the loops
+     *        can be vectorised.
+     * @param buffer Array to write the values to, must hold at least samples values
+     * @param samples The number of sample points to advance
+     */
+    void fill_buffer(T* buffer, int samples)
+    {
+        if constexpr (mode == Mode::RAMP)
+        {
+            assert(_spec.steps >= 0);
+            int ramp_samples = std::min(_spec.count, samples);
+            T start = _current_value;
+            T step = _spec.step;
+            for (int i = 0; i < ramp_samples; ++i)
+            {
+                buffer[i] = start + static_cast<T>(i + 1) * step;
+            }
+            std::fill(buffer + ramp_samples, buffer + samples, _target_value);
+            _spec.count -= ramp_samples;
+            _current_value = _spec.count > 0 ? start + static_cast<T>(ramp_samples) * step : _target_value;
+        }
+        else
+        {
+            assert(_spec.coeff != 0);
+            /* value[n] = target + (current - target) * coeff^(n + 1), the powers are
+             * precalculated for a short block and the distance updated once per block */
+            T distance = _current_value - _target_value;
+            int n = 0;
+            for (; n + FILTER_BLOCK_SIZE <= samples; n += FILTER_BLOCK_SIZE)
+            {
+                for (int i = 0; i < FILTER_BLOCK_SIZE; ++i)
+                {
+                    buffer[n + i] = _target_value + distance * _spec.powers[i];
+                }
+                distance *= _spec.powers[FILTER_BLOCK_SIZE - 1];
+            }
+            int remaining = samples - n;
+            for (int i = 0; i < remaining; ++i)
+            {
+                buffer[n + i] = _target_value + distance * _spec.powers[i];
+            }
+            if (remaining > 0)
+            {
+                distance *= _spec.powers[remaining - 1];
+            }
+            _current_value = _target_value + distance;
+        }
+    }
+
     /**
      * @brief Test whether the smoother has reached the target value.
      * @return true if the value has reached the target value, false otherwise
@@ -152,9 +207,13 @@ private:
         int count{0};
         int steps{-1};
     };
+    static constexpr int FILTER_BLOCK_SIZE = 8;
+
     struct FilterSpecific
     {
         T   coeff{0};
+        /* coeff^1 to coeff^FILTER_BLOCK_SIZE, for fill_buffer() */
+        std::array<T, FILTER_BLOCK_SIZE> powers{};
     };
 
     static constexpr T TIMECONSTANTS_RISE_TIME = 2.19;
@@ -166,6 +225,12 @@ private:
         if constexpr (mode == Mode::FILTER)
         {
             _spec.coeff = std::exp(-1.0 * TIMECONSTANTS_RISE_TIME / (lag_time.count() * sample_rate));
+            T power = 1;
+            for (auto& p : _spec.powers)
+            {
+                power *= _spec.coeff;
+                p = power;
+            }
         }
         else
         {
@@ -21,6 +21,7 @@
 #include <fstream>
 #include <iomanip>
 #include <functional>
+#include <iterator>
 
 #include "twine/src/twine_internal.h"
 
@@ -37,6 +38,7 @@
 #include "plugins/step_sequencer_plugin.h"
 #include "plugins/cv_to_control_plugin.h"
 #include "plugins/control_to_cv_plugin.h"
+#include "plugins/convolution_reverb_plugin.h"
 #include "library/vst2x_wrapper.h"
 #include "library/vst3x_wrapper.h"
 #include "library/lv2/lv2_wrapper.h"
@@ -84,18 +86,23 @@ void ClipDetector::detect_clipped_samples(const ChunkSampleBuffer& buffer, RtSaf
     }
 }
 
-AudioEngine::AudioEngine(float sample_rate, int rt_cpu_cores) : BaseEngine::BaseEngine(sample_rate),
-                                                                _multicore_processing(rt_cpu_cores > 1),
-                                                                _rt_cores(rt_cpu_cores),
-                                                                _transport(sample_rate),
-                                                                _clip_detector(sample_rate)
+AudioEngine::AudioEngine(float sample_rate,
+                         int rt_cpu_cores,
+                         int event_queue_size) : BaseEngine::BaseEngine(sample_rate),
+                                                 _multicore_processing(rt_cpu_cores > 1),
+                                                 _rt_cores(rt_cpu_cores),
+                                                 _audio_graph(rt_cpu_cores, MAX_TRACKS),
+                                                 _internal_control_queue(event_queue_size),
+                                                 _main_in_queue(event_queue_size),
+                                                 _processor_out_queue(event_queue_size),
+                                                 _main_out_queue(event_queue_size),
+                                                 _control_queue_out(event_queue_size),
+                                                 _transport(sample_rate),
+                                                 _clip_detector(sample_rate)
 {
     this->set_sample_rate(sample_rate);
     _event_dispatcher.run();
-    if (_multicore_processing)
-    {
-        _worker_pool = twine::WorkerPool::create_worker_pool(_rt_cores);
-    }
+    SUSHI_LOG_INFO("Using {} audio buffer kernels", simd::to_string(simd::kernels().instruction_set));
 }
 
 AudioEngine::~AudioEngine()
@@ -118,6 +125,7 @@ void AudioEngine::set_sample_rate(float sample_rate)
     _transport.set_sample_rate(sample_rate);
     _process_timer.set_timing_period(sample_rate, AUDIO_CHUNK_SIZE);
     _clip_detector.set_sample_rate(sample_rate);
+    _update_transport_latency();
 }
 
 void AudioEngine::set_audio_input_channels(int channels)
@@ -162,8 +170,8 @@ EngineReturnStatus AudioEngine::connect_audio_input_channel(int input_channel, i
     {
         return EngineReturnStatus::INVALID_CHANNEL;
     }
-    AudioConnection con = {input_channel, track_channel, track->id()};
-    _in_audio_connections.push_back(con);
+    AudioConnection con = {input_channel, track_channel, track->id(), nullptr};
+    _in_audio_connections.push_back(std::move(con));
     SUSHI_LOG_INFO("Connected inputs {} to channel {} of track \"{}\"", input_channel, track_channel, track_name);
     return EngineReturnStatus::OK;
 }
@@ -185,8 +193,10 @@ EngineReturnStatus AudioEngine::connect_audio_output_channel(int output_channel,
         }
         track->set_output_channels(track_channel + 1);
     }
-    AudioConnection con = {output_channel, track_channel, track->id()};
-    _out_audio_connections.push_back(con);
+    AudioConnection con = {output_channel, track_channel, track->id(),
+                           std::make_unique<dsp::DelayLine>(MAX_LATENCY_COMPENSATION)};
+    _out_audio_connections.push_back(std::move(con));
+    _update_latency_compensation();
     SUSHI_LOG_INFO("Connected channel {} of track \"{}\" to output {}", track_channel, track_name, output_channel);
     return EngineReturnStatus::OK;
 }
@@ -211,6 +221,120 @@ EngineReturnStatus AudioEngine::connect_audio_output_bus(int output_bus, int tra
     return connect_audio_output_channel(output_bus * 2 + 1, track_bus * 2 + 1, track_name);
 }
 
+EngineReturnStatus AudioEngine::connect_track_channel_to_track(int source_channel,
+                                                               const std::string& source_track_name,
+                                                               int dest_channel,
+                                                               const std::string& dest_track_name)
+{
+    auto status = _connect_track_channel(source_channel, source_track_name, dest_channel, dest_track_name, 1.0f);
+    if (status == EngineReturnStatus::OK)
+    {
+        SUSHI_LOG_INFO("Connected channel {} of track \"{}\" to channel {} of track \"{}\"", source_channel,
+                       source_track_name, dest_channel, dest_track_name);
+    }
+    return status;
+}
+
+EngineReturnStatus AudioEngine::connect_track_bus_to_track(int source_bus,
+                                                           const std::string& source_track_name,
+                                                           int dest_bus,
+                                                           const std::string& dest_track_name)
+{
+    auto status = connect_track_channel_to_track(source_bus * 2, source_track_name, dest_bus * 2, dest_track_name);
+    if (status != EngineReturnStatus::OK)
+    {
+        return status;
+    }
+    return connect_track_channel_to_track(source_bus * 2 + 1, source_track_name, dest_bus * 2 + 1, dest_track_name);
+}
+
+EngineReturnStatus AudioEngine::add_send_to_track(int source_bus,
+                                                  const std::string& source_track_name,
+                                                  int return_bus,
+                                                  const std::string& return_track_name,
+                                                  float gain)
+{
+    auto status = _connect_track_channel(source_bus * 2, source_track_name,
+                                         return_bus * 2, return_track_name, gain);
+    if (status != EngineReturnStatus::OK)
+    {
+        return status;
+    }
+    status = _connect_track_channel(source_bus * 2 + 1, source_track_name,
+                                    return_bus * 2 + 1, return_track_name, gain);
+    if (status != EngineReturnStatus::OK)
+    {
+        /* Don't leave half a send behind. The tracks were found by the first call */
+        auto source = static_cast<Track*>(_processors.at(source_track_name).get());
+        auto return_track = static_cast<Track*>(_processors.at(return_track_name).get());
+        _audio_graph.disconnect(source, source_bus * 2, return_track, return_bus * 2);
+        _update_latency_compensation();
+        return status;
+    }
+    SUSHI_LOG_INFO("Added send from bus {} of track \"{}\" to bus {} of track \"{}\" with gain {}", source_bus,
+                   source_track_name, return_bus, return_track_name, gain);
+    return EngineReturnStatus::OK;
+}
+
+EngineReturnStatus AudioEngine::set_send_gain(const std::string& source_track_name,
+                                              const std::string& return_track_name,
+                                              float gain)
+{
+    auto source_node = _processors.find(source_track_name);
+    auto return_node = _processors.find(return_track_name);
+    if (source_node == _processors.end() || return_node == _processors.end())
+    {
+        return EngineReturnStatus::INVALID_TRACK;
+    }
+    auto source = static_cast<Track*>(source_node->second.get());
+    auto return_track = static_cast<Track*>(return_node->second.get());
+    if (_audio_graph.set_gain(source, return_track, gain) == false)
+    {
+        return EngineReturnStatus::ERROR;
+    }
+    return EngineReturnStatus::OK;
+}
+
+EngineReturnStatus AudioEngine::set_track_pipeline_stages(const std::string& track_name, int stages)
+{
+    auto track_node = _processors.find(track_name);
+    if (track_node == _processors.end())
+    {
+        return EngineReturnStatus::INVALID_TRACK;
+    }
+    if (realtime())
+    {
+        SUSHI_LOG_ERROR("Can't change the pipeline stages of track \"{}\" while the engine is running", track_name);
+        return EngineReturnStatus::ERROR;
+    }
+    auto track = static_cast<Track*>(track_node->second.get());
+    if (track->set_pipeline_stages(stages) == false)
+    {
+        return EngineReturnStatus::ERROR;
+    }
+    _update_latency_compensation();
+    SUSHI_LOG_INFO("Set track \"{}\" to {} pipeline stages", track_name, stages);
+    return EngineReturnStatus::OK;
+}
+
+EngineReturnStatus AudioEngine::set_track_double_precision(const std::string& track_name, bool enabled)
+{
+    auto track_node = _processors.find(track_name);
+    if (track_node == _processors.end())
+    {
+        return EngineReturnStatus::INVALID_TRACK;
+    }
+    if (realtime())
+    {
+        SUSHI_LOG_ERROR("Can't change the precision of track \"{}\" while the engine is running", track_name);
+        return EngineReturnStatus::ERROR;
+    }
+    auto track = static_cast<Track*>(track_node->second.get());
+    track->set_double_precision(enabled);
+    SUSHI_LOG_INFO("Set track \"{}\" to {} precision", track_name, enabled ? "double" : "single");
+    return EngineReturnStatus::OK;
+}
+
 EngineReturnStatus AudioEngine::connect_cv_to_parameter(const std::string& processor_name,
                                                         const std::string& parameter_name,
                                                         int cv_input_id)
@@ -350,9 +474,10 @@ void AudioEngine::enable_realtime(bool enabled)
 
 int AudioEngine::n_channels_in_track(int track)
 {
-    if (track <= static_cast<int>(_audio_graph.size()))
+    const auto& tracks = _audio_graph.tracks();
+    if (track < static_cast<int>(tracks.size()))
     {
-        return _audio_graph[track]->input_channels();
+        return tracks[track]->input_channels();
     }
     return 0;
 }
@@ -404,6 +529,10 @@ Processor* AudioEngine::_make_internal_plugin(const std::string& uid)
     {
         instance = new control_to_cv_plugin::ControlToCvPlugin(_host_control);
     }
+    else if (uid == "sushi.testing.convolution_reverb")
+    {
+        instance = new convolution_reverb_plugin::ConvolutionReverbPlugin(_host_control);
+    }
     return instance;
 }
 
@@ -420,6 +549,8 @@ EngineReturnStatus AudioEngine::_register_processor(Processor* processor, const
         return EngineReturnStatus::INVALID_PROCESSOR;
     }
     processor->set_name(name);
+    /* Any memory needed to insert the processor in the realtime part is allocated here */
+    _realtime_processors.reserve(processor->id());
     _processors[name] = std::move(std::unique_ptr<Processor>(processor));
     SUSHI_LOG_DEBUG("Succesfully registered processor {}.", name);
     return EngineReturnStatus::OK;
@@ -432,6 +563,17 @@ EngineReturnStatus AudioEngine::_deregister_processor(const std::string &name)
     {
         return EngineReturnStatus::INVALID_PLUGIN_NAME;
     }
+    if (realtime() || transaction_active())
+    {
+        /* The audio thread keeps using the processor until the transaction removing it
+         * is committed and picked up, it is freed in commit_transaction() after that */
+        std::lock_guard<std::mutex> lock(_transaction_lock);
+        _transaction_garbage.push_back(std::move(processor_node->second));
+    }
+    else
+    {
+        _realtime_processors.release(processor_node->second->id());
+    }
     _processors.erase(processor_node);
     return EngineReturnStatus::OK;
 }
@@ -448,7 +590,7 @@ bool AudioEngine::_processor_exists(const std::string& processor_name)
 
 bool AudioEngine::_processor_exists(const ObjectId uid)
 {
-    if(uid >= _realtime_processors.size() || _realtime_processors[uid] == nullptr)
+    if(_realtime_processors.get(uid) == nullptr)
     {
         return false;
     }
@@ -457,30 +599,13 @@ bool AudioEngine::_processor_exists(const ObjectId uid)
 
 bool AudioEngine::_insert_processor_in_realtime_part(Processor* processor)
 {
-    if (processor->id() > _realtime_processors.size())
-    {
-        /* TODO - When non-rt callbacks for events are ready we can have the
-         * rt processor list re-allocated outside the rt domain
-         * In the meantime, put a limit on the number of processors */
-        SUSHI_LOG_ERROR("Realtime processor list full");
-        assert(false);
-    }
-    if(_realtime_processors[processor->id()] != nullptr)
-    {
-        return false;
-    }
-    _realtime_processors[processor->id()] = processor;
-    return true;
+    /* The id was reserved when the processor was registered, so this never allocates */
+    return _realtime_processors.insert(processor);
 }
 
 bool AudioEngine::_remove_processor_from_realtime_part(ObjectId processor)
 {
-    if(_realtime_processors[processor] == nullptr)
-    {
-        return false;
-    }
-    _realtime_processors[processor] = nullptr;
-    return true;
+    return _realtime_processors.remove(processor);
 }
 
 void AudioEngine::process_chunk(SampleBuffer<AUDIO_CHUNK_SIZE>* in_buffer,
@@ -496,6 +621,7 @@ void AudioEngine::process_chunk(SampleBuffer<AUDIO_CHUNK_SIZE>* in_buffer,
     auto engine_timestamp = _process_timer.start_timer();
 
     _transport.set_time(timestamp, samplecount);
+    auto events_sent = _main_out_queue.pushed();
 
     RtEvent in_event;
     while (_internal_control_queue.pop(in_event))
@@ -515,39 +641,46 @@ void AudioEngine::process_chunk(SampleBuffer<AUDIO_CHUNK_SIZE>* in_buffer,
     _event_dispatcher.set_time(_transport.current_process_time());
     auto state = _state.load();
 
+    /* Any changes to the audio graph are picked up here, and only here, together with
+     * the events committed with them so that they take effect in the same chunk */
+    if (_audio_graph.acquire_render_plan())
+    {
+        _update_output_delays();
+    }
+    while (_audio_graph.pop_committed_event(in_event))
+    {
+        send_rt_event(in_event);
+    }
+
     if (_input_clip_detection_enabled)
     {
         _clip_detector.detect_clipped_samples(*in_buffer, _main_out_queue, true);
     }
     _copy_audio_to_tracks(in_buffer);
 
+    _audio_graph.render();
+
     if (_multicore_processing)
     {
-        _worker_pool->wakeup_workers();
         _retrieve_events_from_tracks(*out_controls);
     }
     else
     {
-        for (auto& track : _audio_graph)
-        {
-            track->render();
-        }
         _process_outgoing_events(*out_controls, _processor_out_queue);
     }
 
-    if (_multicore_processing)
-    {
-        _worker_pool->wait_for_workers_idle();
-    }
-
     _main_out_queue.push(RtEvent::make_synchronisation_event(_transport.current_process_time()));
     _copy_audio_from_tracks(out_buffer);
+    _audio_graph.release_render_plan();
     _state.store(update_state(state));
 
     if (_output_clip_detection_enabled)
     {
         _clip_detector.detect_clipped_samples(*out_buffer, _main_out_queue, false);
     }
+    /* Every chunk sends one synchronisation event, which alone doesn't need to be
+     * handled right away */
+    _event_dispatcher.notify_from_rt(_main_out_queue.pushed() - events_sent > 1);
     _process_timer.stop_timer(engine_timestamp, ENGINE_TIMING_ID);
 }
 
@@ -601,24 +734,30 @@ EngineReturnStatus AudioEngine::send_rt_event(RtEvent& event)
     {
         return EngineReturnStatus::OK;
     }
-    if (event.processor_id() > _realtime_processors.size())
-    {
-        SUSHI_LOG_WARNING("Invalid processor id {}.", event.processor_id());
-        return EngineReturnStatus::INVALID_PROCESSOR;
-    }
-    auto processor_node = _realtime_processors[event.processor_id()];
+    auto processor_node = _realtime_processors.get(event.processor_id());
     if (processor_node == nullptr)
     {
         SUSHI_LOG_WARNING("Invalid processor id {}.", event.processor_id());
         return EngineReturnStatus::INVALID_PROCESSOR;
     }
     processor_node->process_event(event);
+    /* Any event, i.e. also parameter changes, wakes up a sleeping processor */
+    processor_node->wake_up();
     return EngineReturnStatus::OK;
 }
 
 EngineReturnStatus AudioEngine::send_async_event(RtEvent& event)
 {
-    std::lock_guard<std::mutex> lock(_in_queue_lock);
+    if (_transaction_active.load(std::memory_order_acquire))
+    {
+        std::lock_guard<std::mutex> lock(_transaction_lock);
+        /* Check again, as the transaction could have been committed in between */
+        if (_transaction_active)
+        {
+            _transaction_events.push_back(event);
+            return EngineReturnStatus::OK;
+        }
+    }
     if (_internal_control_queue.push(event))
     {
         return EngineReturnStatus::OK;
@@ -626,6 +765,83 @@ EngineReturnStatus AudioEngine::send_async_event(RtEvent& event)
     return EngineReturnStatus::QUEUE_FULL;
 }
 
+EngineReturnStatus AudioEngine::begin_transaction()
+{
+    if (_try_begin_transaction() == false)
+    {
+        SUSHI_LOG_ERROR("A transaction is already active");
+        return EngineReturnStatus::ERROR;
+    }
+    return EngineReturnStatus::OK;
+}
+
+EngineReturnStatus AudioEngine::commit_transaction()
+{
+    std::vector<RtEvent> events;
+    std::vector<EventId> returnable_ids;
+    std::vector<std::unique_ptr<Processor>> garbage;
+    {
+        std::lock_guard<std::mutex> lock(_transaction_lock);
+        if (_transaction_active == false)
+        {
+            SUSHI_LOG_ERROR("No transaction to commit");
+            return EngineReturnStatus::ERROR;
+        }
+        _transaction_active = false;
+        events.swap(_transaction_events);
+        returnable_ids.swap(_transaction_returnable_ids);
+        garbage.swap(_transaction_garbage);
+    }
+    _audio_graph.commit_transaction(events);
+
+    auto status = EngineReturnStatus::OK;
+    if (realtime())
+    {
+        /* All events are handled in the same chunk, so this is the only round trip */
+        for (auto id : returnable_ids)
+        {
+            if (_event_receiver.wait_for_response(id, RT_EVENT_TIMEOUT) == false)
+            {
+                SUSHI_LOG_ERROR("Failed to apply event {} in transaction", id);
+                status = EngineReturnStatus::ERROR;
+            }
+        }
+    }
+    /* Removed processors can only be freed once the audio thread has handled the events
+     * removing them and is done with the previous render plan */
+    if (realtime() && _audio_graph.wait_for_render_plan(RT_EVENT_TIMEOUT) == false)
+    {
+        SUSHI_LOG_ERROR("Transaction not picked up by the audio thread, keeping {} removed processors", garbage.size());
+        std::lock_guard<std::mutex> lock(_transaction_lock);
+        std::move(garbage.begin(), garbage.end(), std::back_inserter(_transaction_garbage));
+        status = EngineReturnStatus::ERROR;
+    }
+    else
+    {
+        for (const auto& processor : garbage)
+        {
+            _realtime_processors.release(processor->id());
+        }
+        garbage.clear();
+    }
+    _update_latency_compensation();
+    SUSHI_LOG_INFO("Committed transaction with {} events", events.size());
+    return status;
+}
+
+bool AudioEngine::transaction_active()
+{
+    return _transaction_active.load(std::memory_order_acquire);
+}
+
+std::vector<ext::EventQueueInfo> AudioEngine::event_queue_info() const
+{
+    return {{"control_in", _internal_control_queue.capacity(), _internal_control_queue.dropped()},
+            {"events_in", _main_in_queue.capacity(), _main_in_queue.dropped()},
+            {"processor_events_out", _processor_out_queue.capacity(), _processor_out_queue.dropped()},
+            {"events_out", _main_out_queue.capacity(), _main_out_queue.dropped()},
+            {"control_out", _control_queue_out.capacity(), _control_queue_out.dropped()}};
+}
 
 std::pair<EngineReturnStatus, ObjectId> AudioEngine::processor_id_from_name(const std::string& name)
 {
@@ -659,7 +875,7 @@ std::pair<EngineReturnStatus, const std::string> AudioEngine::processor_name_fro
     {
         return std::make_pair(EngineReturnStatus::INVALID_PROCESSOR, std::string(""));
     }
-    return std::make_pair(EngineReturnStatus::OK, _realtime_processors[uid]->name());
+    return std::make_pair(EngineReturnStatus::OK, _realtime_processors.get(uid)->name());
 }
 
 std::pair<EngineReturnStatus, const std::string> AudioEngine::parameter_name_from_id(const std::string &processor_name,
@@ -711,34 +927,31 @@ EngineReturnStatus AudioEngine::delete_track(const std::string &track_name)
         return EngineReturnStatus::INVALID_TRACK;
     }
     auto track = track_node->second.get();
+    bool own_transaction = _begin_edit();
+    if (_audio_graph.remove(static_cast<Track*>(track)) == false)
+    {
+        SUSHI_LOG_WARNING("Plugin track {} was not in the audio graph", track_name);
+        _commit_edit(own_transaction);
+        return EngineReturnStatus::INVALID_TRACK;
+    }
     if (realtime())
     {
-        auto remove_track_event = RtEvent::make_remove_track_event(track->id());
+        /* Staged and published together with the plan without the track */
         auto delete_event = RtEvent::make_remove_processor_event(track->id());
-        send_async_event(remove_track_event);
-        send_async_event(delete_event);
-        bool removed = _event_receiver.wait_for_response(remove_track_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        bool deleted = _event_receiver.wait_for_response(delete_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        if (!removed || !deleted)
-        {
-            SUSHI_LOG_ERROR("Failed to remove processor {} from processing part", track_name);
-        }
-        return _deregister_processor(track_name);
+        _send_control_events({delete_event});
     }
     else
     {
-        for (auto track_in_graph = _audio_graph.begin(); track_in_graph != _audio_graph.end(); ++track)
-        {
-            if (*track_in_graph == track)
-            {
-                _audio_graph.erase(track_in_graph);
-                _remove_processor_from_realtime_part(track->id());
-                return _deregister_processor(track_name);
-            }
-            SUSHI_LOG_WARNING("Plugin track {} was not in the audio graph", track_name);
-        }
-        return EngineReturnStatus::INVALID_TRACK;
+        _remove_processor_from_realtime_part(track->id());
+    }
+    auto status = _deregister_processor(track_name);
+    if (_commit_edit(own_transaction) == false)
+    {
+        SUSHI_LOG_ERROR("Failed to remove processor {} from processing part", track_name);
+        return EngineReturnStatus::ERROR;
     }
+    _update_latency_compensation();
+    return status;
 }
 
 EngineReturnStatus AudioEngine::add_plugin_to_track(const std::string &track_name,
@@ -793,16 +1006,19 @@ EngineReturnStatus AudioEngine::add_plugin_to_track(const std::string &track_nam
         return status;
     }
     plugin->set_enabled(true);
+    /* Switching precision can reconfigure the plugin, which is not rt safe */
+    if (track->double_precision() && plugin->supports_double_precision())
+    {
+        plugin->set_double_precision(true);
+    }
     if (realtime())
     {
         // In realtime mode we need to handle this in the audio thread
         auto insert_event = RtEvent::make_insert_processor_event(plugin);
         auto add_event = RtEvent::make_add_processor_to_track_event(plugin->id(), track->id());
-        send_async_event(insert_event);
-        send_async_event(add_event);
-        bool inserted = _event_receiver.wait_for_response(insert_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        bool added = _event_receiver.wait_for_response(add_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        if (!inserted || !added)
+        bool own_transaction = _begin_edit();
+        _send_control_events({insert_event, add_event});
+        if (_commit_edit(own_transaction) == false)
         {
             SUSHI_LOG_ERROR("Failed to insert/add processor {} to processing part", plugin_name);
             return EngineReturnStatus::INVALID_PROCESSOR;
@@ -817,6 +1033,7 @@ EngineReturnStatus AudioEngine::add_plugin_to_track(const std::string &track_nam
             return EngineReturnStatus::ERROR;
         }
     }
+    _update_latency_compensation();
     return EngineReturnStatus::OK;
 }
 
@@ -837,19 +1054,13 @@ EngineReturnStatus AudioEngine::remove_plugin_from_track(const std::string &trac
     }
     auto processor = processor_node->second.get();
     Track* track = static_cast<Track*>(track_node->second.get());
+    bool own_transaction = _begin_edit();
     if (realtime())
     {
         // Send events to handle this in the rt domain
         auto remove_event = RtEvent::make_remove_processor_from_track_event(processor->id(), track->id());
         auto delete_event = RtEvent::make_remove_processor_event(processor->id());
-        send_async_event(remove_event);
-        send_async_event(delete_event);
-        bool remove_ok = _event_receiver.wait_for_response(remove_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        bool delete_ok = _event_receiver.wait_for_response(delete_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        if (!remove_ok || !delete_ok)
-        {
-            SUSHI_LOG_ERROR("Failed to remove/delete processor {} from processing part", plugin_name);
-        }
+        _send_control_events({remove_event, delete_event});
     }
     else
     {
@@ -859,7 +1070,13 @@ EngineReturnStatus AudioEngine::remove_plugin_from_track(const std::string &trac
         }
         _remove_processor_from_realtime_part(processor->id());
     }
-    return _deregister_processor(processor->name());
+    auto status = _deregister_processor(processor->name());
+    if (_commit_edit(own_transaction) == false)
+    {
+        SUSHI_LOG_ERROR("Failed to remove/delete processor {} from processing part", plugin_name);
+    }
+    _update_latency_compensation();
+    return status;
 }
 
 const Processor* AudioEngine::processor(ObjectId processor_id) const
@@ -869,11 +1086,111 @@ const Processor* AudioEngine::processor(ObjectId processor_id) const
 
 Processor* AudioEngine::mutable_processor(ObjectId processor_id)
 {
-    if (processor_id >= _realtime_processors.size())
+    return _realtime_processors.get(processor_id);
+}
+
+int AudioEngine::get_latency()
+{
+    return _audio_graph.latency();
+}
+
+void AudioEngine::_update_latency_compensation()
+{
+    /* Rebuilding the render plan picks up latency changes in the tracks and recalculates
+     * the delays between tracks. Outputs from tracks with less latency than the graph
+     * are then delayed so that all outputs are aligned in time */
+    _audio_graph.update();
+    int latency = _audio_graph.latency();
+    for (auto& c : _out_audio_connections)
+    {
+        auto track = static_cast<const Track*>(_realtime_processors.get(c.track));
+        if (track != nullptr && latency - _audio_graph.latency(track) > c.delay_line->max_delay())
+        {
+            SUSHI_LOG_WARNING("Latency of {} samples between track {} and output {} is too long to compensate for",
+                              latency - _audio_graph.latency(track), track->name(), c.engine_channel);
+        }
+    }
+    _update_transport_latency();
+}
+
+void AudioEngine::_update_transport_latency()
+{
+    auto sample_time = std::chrono::duration<double>(1.0 / _sample_rate);
+    _transport.set_latency(_output_latency + std::chrono::duration_cast<Time>(sample_time * _audio_graph.latency()));
+}
+
+EngineReturnStatus AudioEngine::_connect_track_channel(int source_channel,
+                                                       const std::string& source_track_name,
+                                                       int dest_channel,
+                                                       const std::string& dest_track_name,
+                                                       float gain)
+{
+    auto source_node = _processors.find(source_track_name);
+    auto dest_node = _processors.find(dest_track_name);
+    if (source_node == _processors.end() || dest_node == _processors.end())
+    {
+        return EngineReturnStatus::INVALID_TRACK;
+    }
+    auto source = static_cast<Track*>(source_node->second.get());
+    auto dest = static_cast<Track*>(dest_node->second.get());
+    if (source_channel >= source->max_output_channels() || dest_channel >= dest->max_input_channels())
+    {
+        return EngineReturnStatus::INVALID_CHANNEL;
+    }
+    if (source_channel >= source->output_channels())
     {
-        return nullptr;
+        source->set_output_channels(source_channel + 1);
     }
-    return _realtime_processors[processor_id];
+    if (_audio_graph.connect(source, source_channel, dest, dest_channel, gain) == false)
+    {
+        return EngineReturnStatus::ERROR;
+    }
+    _update_latency_compensation();
+    return EngineReturnStatus::OK;
+}
+
+bool AudioEngine::_try_begin_transaction()
+{
+    std::lock_guard<std::mutex> lock(_transaction_lock);
+    if (_transaction_active)
+    {
+        return false;
+    }
+    _transaction_active = true;
+    _audio_graph.begin_transaction();
+    return true;
+}
+
+bool AudioEngine::_begin_edit()
+{
+    return realtime() && _try_begin_transaction();
+}
+
+bool AudioEngine::_commit_edit(bool own_transaction)
+{
+    return own_transaction == false || commit_transaction() == EngineReturnStatus::OK;
+}
+
+bool AudioEngine::_send_control_events(std::initializer_list<RtEvent> events)
+{
+    bool own_transaction = false;
+    {
+        std::lock_guard<std::mutex> lock(_transaction_lock);
+        if (_transaction_active == false)
+        {
+            /* Never sent directly, so that the events are applied atomically together
+             * with the render plan even if the audio thread is late */
+            _transaction_active = true;
+            _audio_graph.begin_transaction();
+            own_transaction = true;
+        }
+        for (const auto& event : events)
+        {
+            _transaction_events.push_back(event);
+            _transaction_returnable_ids.push_back(event.returnable_event()->event_id());
+        }
+    }
+    return own_transaction == false || commit_transaction() == EngineReturnStatus::OK;
 }
 
 EngineReturnStatus AudioEngine::_register_new_track(const std::string& name, Track* track)
@@ -894,27 +1211,38 @@ EngineReturnStatus AudioEngine::_register_new_track(const std::string& name, Tra
     {
         track->set_event_output(&_processor_out_queue);
     }
+    /* The track is inserted in the realtime part and picked up by the audio thread
+     * together with the new render plan */
+    bool own_transaction = _begin_edit();
     if (realtime())
     {
         auto insert_event = RtEvent::make_insert_processor_event(track);
-        auto add_event = RtEvent::make_add_track_event(track->id());
-        send_async_event(insert_event);
-        send_async_event(add_event);
-        bool inserted = _event_receiver.wait_for_response(insert_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        bool added = _event_receiver.wait_for_response(add_event.returnable_event()->event_id(), RT_EVENT_TIMEOUT);
-        if (!inserted || !added)
-        {
-            SUSHI_LOG_ERROR("Failed to insert/add track {} to processing part", name);
-            return EngineReturnStatus::INVALID_PROCESSOR;
-        }
-    } else
+        _send_control_events({insert_event});
+    }
+    else
     {
         _insert_processor_in_realtime_part(track);
-        _audio_graph.push_back(track);
     }
-    if (_multicore_processing)
+    if (_audio_graph.add(track) == false)
+    {
+        SUSHI_LOG_ERROR("Failed to add track {} to the audio graph", name);
+        if (realtime())
+        {
+            auto delete_event = RtEvent::make_remove_processor_event(track->id());
+            _send_control_events({delete_event});
+        }
+        else
+        {
+            _remove_processor_from_realtime_part(track->id());
+        }
+        _deregister_processor(name);
+        _commit_edit(own_transaction);
+        return EngineReturnStatus::ERROR;
+    }
+    if (_commit_edit(own_transaction) == false)
     {
-        _worker_pool->add_worker(Track::ext_render_function, track);
+        SUSHI_LOG_ERROR("Failed to insert track {} in processing part", name);
+        return EngineReturnStatus::INVALID_PROCESSOR;
     }
     SUSHI_LOG_INFO("Track {} successfully added to engine", name);
     return EngineReturnStatus::OK;
@@ -948,8 +1276,8 @@ bool AudioEngine::_handle_internal_events(RtEvent& event)
         case RtEventType::ADD_PROCESSOR_TO_TRACK:
         {
             auto typed_event = event.processor_reorder_event();
-            Track* track = static_cast<Track*>(_realtime_processors[typed_event->track()]);
-            Processor* processor = static_cast<Processor*>(_realtime_processors[typed_event->processor()]);
+            Track* track = static_cast<Track*>(_realtime_processors.get(typed_event->track()));
+            Processor* processor = _realtime_processors.get(typed_event->processor());
             if (track && processor)
             {
                 auto ok = track->add(processor);
@@ -964,7 +1292,7 @@ bool AudioEngine::_handle_internal_events(RtEvent& event)
         case RtEventType::REMOVE_PROCESSOR_FROM_TRACK:
         {
             auto typed_event = event.processor_reorder_event();
-            Track* track = static_cast<Track*>(_realtime_processors[typed_event->track()]);
+            Track* track = static_cast<Track*>(_realtime_processors.get(typed_event->track()));
             if (track)
             {
                 bool ok = track->remove(typed_event->processor());
@@ -974,39 +1302,6 @@ bool AudioEngine::_handle_internal_events(RtEvent& event)
                 typed_event->set_handled(true);
             break;
         }
-        case RtEventType::ADD_TRACK:
-        {
-            auto typed_event = event.processor_reorder_event();
-            Track* track = static_cast<Track*>(_realtime_processors[typed_event->track()]);
-            if (track)
-            {
-                _audio_graph.push_back(track);
-                typed_event->set_handled(true);
-            }
-            else
-                typed_event->set_handled(false);
-            break;
-        }
-        case RtEventType::REMOVE_TRACK:
-        {
-            auto typed_event = event.processor_reorder_event();
-            Track* track = static_cast<Track*>(_realtime_processors[typed_event->track()]);
-            if (track)
-            {
-                for (auto i = _audio_graph.begin(); i != _audio_graph.end(); ++i)
-                {
-                    if ((*i)->id() == typed_event->track())
-                    {
-                        _audio_graph.erase(i);
-                        typed_event->set_handled(true);
-                        break;
-                    }
-                }
-            }
-            else
-                typed_event->set_handled(false);
-            break;
-        }
         case RtEventType::TEMPO:
         case RtEventType::TIME_SIGNATURE:
         case RtEventType::PLAYING_MODE:
@@ -1025,7 +1320,7 @@ bool AudioEngine::_handle_internal_events(RtEvent& event)
 
 void AudioEngine::_retrieve_events_from_tracks(ControlBuffer& buffer)
 {
-    for (auto& track : _audio_graph)
+    for (auto& track : _audio_graph.active_tracks())
     {
         auto& event_buffer = track->output_event_buffer();
         _process_outgoing_events(buffer, event_buffer);
@@ -1034,22 +1329,32 @@ void AudioEngine::_retrieve_events_from_tracks(ControlBuffer& buffer)
 
 void AudioEngine::_copy_audio_to_tracks(ChunkSampleBuffer* input)
 {
+    _audio_graph.clear_connected_inputs();
     for (const auto& c : _in_audio_connections)
     {
         auto engine_in = ChunkSampleBuffer::create_non_owning_buffer(*input, c.engine_channel, 1);
-        auto track_in = static_cast<Track*>(_realtime_processors[c.track])->input_channel(c.track_channel);
+        auto track_in = static_cast<Track*>(_realtime_processors.get(c.track))->input_channel(c.track_channel);
         track_in = engine_in;
     }
 }
 
+void AudioEngine::_update_output_delays()
+{
+    for (const auto& c : _out_audio_connections)
+    {
+        auto track = static_cast<const Track*>(_realtime_processors.get(c.track));
+        c.delay_line->set_delay(_audio_graph.output_delay(track));
+    }
+}
+
 void AudioEngine::_copy_audio_from_tracks(ChunkSampleBuffer* output)
 {
     output->clear();
     for (const auto& c : _out_audio_connections)
     {
-        auto track_out = static_cast<Track*>(_realtime_processors[c.track])->output_channel(c.track_channel);
+        auto track_out = static_cast<Track*>(_realtime_processors.get(c.track))->output_channel(c.track_channel);
         auto engine_out = ChunkSampleBuffer::create_non_owning_buffer(*output, c.engine_channel, 1);
-        engine_out.add(track_out);
+        engine_out.add(c.delay_line->process(track_out));
     }
 }
 
@@ -1102,7 +1407,7 @@ void AudioEngine::print_timings_to_file(const std::string& filename)
          << "us)\n\n" << std::setw(24) << "" << std::setw(16) << "average(%)" << std::setw(16) << "minimum(%)"
          << std::setw(16) << "maximum(%)" << std::endl;
 
-    for (const auto& track : _audio_graph)
+    for (const auto& track : _audio_graph.tracks())
     {
         file << std::setw(0) << "Track: " << track->name() << "\n";
         auto processors = track->process_chain();
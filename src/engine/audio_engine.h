@@ -27,10 +27,11 @@
 #include <utility>
 #include <mutex>
 
-#include "twine/twine.h"
-
 #include "engine/event_dispatcher.h"
 #include "engine/base_engine.h"
+#include "engine/audio_graph.h"
+#include "dsp_library/delay_line.h"
+#include "engine/processor_table.h"
 #include "track.h"
 #include "engine/receiver.h"
 #include "engine/transport.h"
@@ -77,7 +78,7 @@ private:
 };
 
 
-constexpr int MAX_RT_PROCESSOR_ID = 1000;
+constexpr int MAX_TRACKS = 100;
 
 class AudioEngine : public BaseEngine
 {
@@ -91,8 +92,10 @@ public:
      *                     is 1 and means that audio processing is done only in the rt callback
      *                     of the audio frontend.
      *                     With values >1 tracks will be processed in parallel threads.
+     * @param event_queue_size The number of events each of the queues between the rt
+     *                         part and the non-rt part of the engine can hold.
      */
-    explicit AudioEngine(float sample_rate, int rt_cpu_cores = 1);
+    explicit AudioEngine(float sample_rate, int rt_cpu_cores = 1, int event_queue_size = DEFAULT_EVENT_QUEUE_SIZE);
 
      ~AudioEngine();
 
@@ -182,6 +185,90 @@ public:
                                                 int track_bus,
                                                 const std::string& track_name) override;
 
+    /**
+     * @brief Connect an output channel of a track to an input channel of another track.
+     *        The destination track will be rendered after the source track, with the
+     *        source channel summed into its input. Not safe to call while the engine
+     *        is running.
+     * @param source_channel Index of the output channel of the source track.
+     * @param source_track_name The unique name of the track to connect from.
+     * @param dest_channel Index of the input channel of the destination track.
+     * @param dest_track_name The unique name of the track to connect to.
+     * @return EngineReturnStatus::OK if successful, error status otherwise
+     */
+    EngineReturnStatus connect_track_channel_to_track(int source_channel,
+                                                      const std::string& source_track_name,
+                                                      int dest_channel,
+                                                      const std::string& dest_track_name) override;
+
+    /**
+     * @brief Connect an output bus of a track to an input bus of another track.
+     *        Not safe to call while the engine is running.
+     * @param source_bus The output bus of the source track.
+     * @param source_track_name The unique name of the track to connect from.
+     * @param dest_bus The input bus of the destination track.
+     * @param dest_track_name The unique name of the track to connect to.
+     * @return EngineReturnStatus::OK if successful, error status otherwise
+     */
+    EngineReturnStatus connect_track_bus_to_track(int source_bus,
+                                                  const std::string& source_track_name,
+                                                  int dest_bus,
+                                                  const std::string& dest_track_name) override;
+
+    /**
+     * @brief Send a gain scaled copy of an output bus of a track to an input bus of a
+     *        return track, i.e. a track used as an aux bus. The return track is rendered
+     *        once all tracks sending to it are done. Not safe to call while the engine
+     *        is running.
+     * @param source_bus The output bus of the sending track.
+     * @param source_track_name The unique name of the sending track.
+     * @param return_bus The input bus of the return track.
+     * @param return_track_name The unique name of the return track.
+     * @param gain The linear send gain.
+     * @return EngineReturnStatus::OK if successful, error status otherwise
+     */
+    EngineReturnStatus add_send_to_track(int source_bus,
+                                         const std::string& source_track_name,
+                                         int return_bus,
+                                         const std::string& return_track_name,
+                                         float gain) override;
+
+    /**
+     * @brief Change the gain of all sends from one track to a return track.
+     *        Safe to call while the engine is running.
+     * @param source_track_name The unique name of the sending track.
+     * @param return_track_name The unique name of the return track.
+     * @param gain The new linear send gain.
+     * @return EngineReturnStatus::OK if successful, error status otherwise
+     */
+    EngineReturnStatus set_send_gain(const std::string& source_track_name,
+                                     const std::string& return_track_name,
+                                     float gain) override;
+
+    /**
+     * @brief Split the processors of a track into pipeline stages that are rendered in
+     *        parallel when processing on multiple cores. Each stage after the first adds
+     *        one chunk of latency, which is included in the latency reported to the
+     *        transport. Can only be called while the engine is stopped.
+     * @param track_name The unique name of the track.
+     * @param stages The number of stages, 1 disables pipelining.
+     * @return EngineReturnStatus::OK if successful, EngineReturnStatus::ERROR if the
+     *         engine is running, error status otherwise
+     */
+    EngineReturnStatus set_track_pipeline_stages(const std::string& track_name, int stages) override;
+
+    /**
+     * @brief Process the audio of a track in double precision, converting to and from
+     *        single precision at the input and output of the track. Processors on the
+     *        track that support double precision process natively. Plugins added to
+     *        the track later are set to double precision before they are added.
+     * @param track_name The unique name of the track.
+     * @param enabled True to enable double precision processing.
+     * @return EngineReturnStatus::OK if successful, EngineReturnStatus::ERROR if the
+     *         engine is running, error status otherwise
+     */
+    EngineReturnStatus set_track_double_precision(const std::string& track_name, bool enabled) override;
+
     /**
      * @brief Connect a control voltage input to control a parameter on a processor
      * @param processor_name The unique name of the processor.
@@ -297,7 +384,8 @@ public:
      */
     void set_output_latency(Time latency) override
     {
-        _transport.set_latency(latency);
+        _output_latency = latency;
+        _update_transport_latency();
     }
 
     /**
@@ -336,11 +424,53 @@ public:
     EngineReturnStatus send_rt_event(RtEvent& event) override;
 
     /**
-     * @brief Called from a non-realtime thread to process an event in the realtime
+     * @brief Called from a non-realtime thread to process an event in the realtime.
+     *        While a transaction is active, the event is held back until the
+     *        transaction is committed.
      * @param event The event to process
      * @return EngineReturnStatus::OK if the event was properly processed, error code otherwise
      */
     EngineReturnStatus send_async_event(RtEvent& event) override;
+
+    /**
+     * @brief Start a transaction. Tracks, plugins, connections and events sent with
+     *        send_async_event() until commit_transaction() is called are staged and not
+     *        seen by the audio thread until the transaction is committed. Edits in a
+     *        transaction don't wait for the audio thread, so the only round trip is the
+     *        one made when committing. Processors created in the transaction can be
+     *        looked up by name immediately. Edits are assumed to be made from a single
+     *        thread. The transaction is not tied to that thread though, edits made from
+     *        other threads, e.g. by other control clients, while the transaction is active
+     *        are staged as part of it and applied when it is committed.
+     * @return EngineReturnStatus::OK if successful, EngineReturnStatus::ERROR if a
+     *         transaction is already active
+     */
+    EngineReturnStatus begin_transaction() override;
+
+    /**
+     * @brief Apply all edits staged since begin_transaction(). The audio thread applies
+     *        all of them at the start of the same chunk, so no partial state of the
+     *        edits is ever rendered. Blocks until the processor and track edits have
+     *        been applied, other staged events are not waited for. Processors removed
+     *        in the transaction are deleted once the audio thread is done with them, or
+     *        when a later transaction is committed if the audio thread doesn't respond.
+     * @return EngineReturnStatus::OK if successful, error code otherwise
+     */
+    EngineReturnStatus commit_transaction() override;
+
+    /**
+     * @brief Query whether a transaction is active
+     * @return true if begin_transaction() has been called and the transaction not yet committed
+     */
+    bool transaction_active() override;
+
+    /**
+     * @brief Get the processing latency of the engine, i.e. the latency of the track
+     *        with the longest latency, which all outputs are aligned to.
+     * @return The latency in samples
+     */
+    int get_latency() override;
+
     /**
      * @brief Get the unique id of a processor given its name
      * @param unique_name The unique name of a processor
@@ -452,7 +582,7 @@ public:
      */
     const std::vector<Track*>& all_tracks() override
     {
-        return _audio_graph;
+        return _audio_graph.tracks();
     }
 
     /**
@@ -493,6 +623,8 @@ public:
         return &_process_timer;
     }
 
+    std::vector<ext::EventQueueInfo> event_queue_info() const override;
+
     /**
      * @brief Print the current processor timings (in enabled) in the log
      */
@@ -514,7 +646,8 @@ private:
     EngineReturnStatus _register_processor(Processor* processor, const std::string& name);
 
     /**
-     * @breif Remove a processor from the engine and delete it.
+     * @breif Remove a processor from the engine and delete it. In a transaction the
+     *        processor is not deleted until the transaction is committed.
      * @param name The unique name of the processor to delete
      * @return True if the processor existed and it was correctly deleted
      */
@@ -535,6 +668,37 @@ private:
      */
     bool _remove_processor_from_realtime_part(ObjectId processor);
 
+    /**
+     * @brief Start a transaction unless one is already active
+     * @return true if a transaction was started, false if one was already active
+     */
+    bool _try_begin_transaction();
+
+    /**
+     * @brief Start a transaction for a single edit if the engine is running and no
+     *        transaction is active, so that all parts of the edit are published to the
+     *        audio thread together and applied in the same chunk.
+     * @return true if a transaction was started and must be committed with _commit_edit()
+     */
+    bool _begin_edit();
+
+    /**
+     * @brief Commit the transaction started by _begin_edit(), if any
+     * @param own_transaction The value returned from _begin_edit()
+     * @return true if successful or if there was nothing to commit, false otherwise
+     */
+    bool _commit_edit(bool own_transaction);
+
+    /**
+     * @brief Send events to the realtime part. The events are always staged in a
+     *        transaction and passed to the audio thread together with a render plan.
+     *        If no transaction is active, one is started and committed for the events,
+     *        which waits for them to be handled.
+     * @param events Returnable events
+     * @return true if all events were handled successfully or staged, false otherwise
+     */
+    bool _send_control_events(std::initializer_list<RtEvent> events);
+
     /**
      * @brief Register a newly created track
      * @param track Pointer to the track
@@ -542,6 +706,32 @@ private:
      */
     EngineReturnStatus _register_new_track(const std::string& name, Track* track);
 
+    /**
+     * @brief Connect an output channel of a track to an input channel of another track
+     *        in the audio graph.
+     * @return OK if succesfull, error code otherwise
+     */
+    EngineReturnStatus _connect_track_channel(int source_channel,
+                                              const std::string& source_track_name,
+                                              int dest_channel,
+                                              const std::string& dest_track_name,
+                                              float gain);
+
+    /**
+     * @brief Recalculate the latency compensation of the audio graph and the outputs,
+     *        should be called whenever tracks, plugins or connections are changed.
+     */
+    void _update_latency_compensation();
+
+    void _update_transport_latency();
+
+    /**
+     * @brief Delay the outputs of tracks with less latency than the render plan that
+     *        was just picked up, so that all outputs are aligned in time. Called from
+     *        the audio thread when the render plan changes.
+     */
+    void _update_output_delays();
+
     /**
      * @brief Checks whether a processor exists in the engine.
      * @param processor_name The unique name of the processor.
@@ -579,22 +769,22 @@ private:
     const bool _multicore_processing;
     const int  _rt_cores;
 
-    std::unique_ptr<twine::WorkerPool> _worker_pool;
-
-    std::vector<Track*> _audio_graph;
+    AudioGraph _audio_graph;
 
     // All registered processors indexed by their unique name
     std::map<std::string, std::unique_ptr<Processor>> _processors;
 
     // Processors in the realtime part indexed by their unique 32 bit id
-    // Only to be accessed from the process callback in rt mode.
-    std::vector<Processor*> _realtime_processors{MAX_RT_PROCESSOR_ID, nullptr};
+    // Only to be modified from the process callback in rt mode.
+    ProcessorTable _realtime_processors;
 
     struct AudioConnection
     {
         int engine_channel;
         int track_channel;
         ObjectId track;
+        /* Latency compensation, only used for outputs */
+        std::unique_ptr<dsp::DelayLine> delay_line;
     };
     std::vector<AudioConnection> _in_audio_connections;
     std::vector<AudioConnection> _out_audio_connections;
@@ -621,14 +811,27 @@ private:
 
     std::atomic<RealtimeState> _state{RealtimeState::STOPPED};
 
-    RtSafeRtEventFifo _internal_control_queue;
+    /* Any non-rt thread can send events, so this is the only multi producer queue */
+    RtSafeMultiProducerRtEventFifo _internal_control_queue;
     RtSafeRtEventFifo _main_in_queue;
     RtSafeRtEventFifo _processor_out_queue;
     RtSafeRtEventFifo _main_out_queue;
     RtSafeRtEventFifo _control_queue_out;
-    std::mutex _in_queue_lock;
+
+    /* Transaction state. The flag is read without the lock by senders of events, which
+     * only take the lock if a transaction is active */
+    std::mutex _transaction_lock;
+    std::atomic<bool> _transaction_active{false};
+    std::vector<RtEvent> _transaction_events;
+    /* Ids of the staged events that the audio thread returns, waited for when committing */
+    std::vector<EventId> _transaction_returnable_ids;
+    /* Processors removed while the engine is running or in a transaction, deleted when
+     * the audio thread has picked up the transaction removing them */
+    std::vector<std::unique_ptr<Processor>> _transaction_garbage;
+
     receiver::AsynchronousEventReceiver _event_receiver{&_control_queue_out};
     Transport _transport;
+    Time _output_latency{0};
 
     dispatcher::EventDispatcher _event_dispatcher{this, &_main_out_queue, &_main_in_queue};
     Controller _controller{this};
@@ -0,0 +1,719 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Graph of tracks with audio dependencies, rendered in dependency order,
+ *        optionally on several cpu cores with cost-aware work stealing.
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include "audio_graph.h"
+#include "logging.h"
+
+namespace sushi {
+namespace engine {
+
+SUSHI_GET_LOGGER_WITH_MODULE_NAME("audio graph");
+
+constexpr int EMPTY_SLOT = -1;
+/* Weight of the latest measurement in the moving average of track render times */
+constexpr float COST_SMOOTHING = 0.1f;
+/* Number of pauses an idle worker waits before checking the ready queues again */
+constexpr int IDLE_SPIN_COUNT = 32;
+constexpr auto SYNCHRONIZE_POLL_INTERVAL = std::chrono::microseconds(200);
+
+AudioGraph::AudioGraph(int cpu_cores, int max_no_tracks) : _max_no_tracks(max_no_tracks),
+                                                           _cpu_cores(cpu_cores)
+{
+    int max_no_nodes = max_no_tracks * TRACK_MAX_PIPELINE_STAGES;
+    _tracks.reserve(max_no_tracks);
+    _cost_slots.reserve(max_no_tracks);
+    _free_cost_slots.reserve(max_no_tracks);
+    for (int slot = max_no_tracks - 1; slot >= 0; --slot)
+    {
+        _free_cost_slots.push_back(slot);
+    }
+    _track_costs = std::make_unique<std::array<std::atomic<float>, TRACK_MAX_PIPELINE_STAGES>[]>(max_no_tracks);
+    _initial_nodes.reserve(max_no_nodes);
+    _pending_inputs = std::make_unique<std::atomic<int>[]>(max_no_nodes);
+
+    if (cpu_cores > 1)
+    {
+        _worker_pool = twine::WorkerPool::create_worker_pool(cpu_cores);
+        _worker_contexts = std::make_unique<WorkerContext[]>(cpu_cores);
+        _worker_queues = std::make_unique<WorkerQueue[]>(cpu_cores);
+        for (int i = 0; i < cpu_cores; ++i)
+        {
+            _worker_queues[i].nodes = std::make_unique<int[]>(max_no_nodes);
+            _worker_contexts[i] = {this, i};
+            _worker_pool->add_worker(_worker_callback, &_worker_contexts[i]);
+        }
+    }
+    _plan.store(_build_plan().release());
+    _rt_plan = _plan.load();
+}
+
+AudioGraph::~AudioGraph()
+{
+    delete _plan.load();
+}
+
+bool AudioGraph::add(Track* track)
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    if (static_cast<int>(_tracks.size()) >= _max_no_tracks || _track_index(track) >= 0)
+    {
+        return false;
+    }
+    int slot = _free_cost_slots.back();
+    _free_cost_slots.pop_back();
+    for (auto& cost : _track_costs[slot])
+    {
+        cost.store(0.0f, std::memory_order_relaxed);
+    }
+    _tracks.push_back(track);
+    _cost_slots.push_back(slot);
+    if (_transaction_active == false)
+    {
+        _publish(_build_plan());
+    }
+    return true;
+}
+
+bool AudioGraph::remove(Track* track)
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    int index = _track_index(track);
+    if (index < 0)
+    {
+        return false;
+    }
+    _free_cost_slots.push_back(_cost_slots[index]);
+    _cost_slots.erase(_cost_slots.begin() + index);
+    _tracks.erase(_tracks.begin() + index);
+    _routes.erase(std::remove_if(_routes.begin(), _routes.end(), [&](const auto& route)
+    {
+        return route.source == track || route.dest == track;
+    }), _routes.end());
+    if (_transaction_active == false)
+    {
+        _publish(_build_plan());
+    }
+    return true;
+}
+
+bool AudioGraph::connect(Track* source, int source_channel, Track* dest, int dest_channel, float gain)
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    if (_track_index(source) < 0 || _track_index(dest) < 0)
+    {
+        return false;
+    }
+    _routes.emplace_back(source, source_channel, dest, dest_channel, gain);
+    auto plan = _build_plan();
+    if (plan == nullptr)
+    {
+        SUSHI_LOG_ERROR("Connecting track {} to track {} would create a cycle", source->name(), dest->name());
+        _routes.pop_back();
+        return false;
+    }
+    if (_transaction_active == false)
+    {
+        _publish(std::move(plan));
+    }
+    return true;
+}
+
+bool AudioGraph::disconnect(const Track* source, int source_channel, const Track* dest, int dest_channel)
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    auto route = std::find_if(_routes.rbegin(), _routes.rend(), [&](const auto& r)
+    {
+        return r.source == source && r.source_channel == source_channel &&
+               r.dest == dest && r.dest_channel == dest_channel;
+    });
+    if (route == _routes.rend())
+    {
+        return false;
+    }
+    _routes.erase(std::next(route).base());
+    if (_transaction_active == false)
+    {
+        _publish(_build_plan());
+    }
+    return true;
+}
+
+bool AudioGraph::set_gain(const Track* source, const Track* dest, float gain)
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    bool found = false;
+    for (auto& route : _routes)
+    {
+        if (route.source == source && route.dest == dest)
+        {
+            route.gain.store(gain, std::memory_order_relaxed);
+            found = true;
+        }
+    }
+    /* Plans are only replaced while holding the lock, so the current one can't be freed under us */
+    for (auto& route : _plan.load()->routes)
+    {
+        if (route.source == source && route.dest == dest)
+        {
+            route.gain.store(gain, std::memory_order_relaxed);
+        }
+    }
+    return found;
+}
+
+bool AudioGraph::update()
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    if (_transaction_active)
+    {
+        return true;
+    }
+    auto plan = _build_plan();
+    if (plan == nullptr)
+    {
+        return false;
+    }
+    _publish(std::move(plan));
+    return true;
+}
+
+void AudioGraph::begin_transaction()
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    _transaction_active = true;
+}
+
+bool AudioGraph::commit_transaction(std::vector<RtEvent> events)
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    if (_transaction_active == false)
+    {
+        return false;
+    }
+    _transaction_active = false;
+    /* Connections are checked for cycles when made, so this can't fail */
+    _publish(_build_plan(), std::move(events));
+    return true;
+}
+
+void AudioGraph::synchronize()
+{
+    /* Plans already retired were replaced during or before the chunk the audio thread
+     * is in now, so they can all be freed once it has moved on. This is waited for
+     * without holding the lock so that other threads can keep editing the graph */
+    uint64_t epoch = _rt_epoch.load();
+    while (epoch % 2 != 0 && _rt_epoch.load() == epoch)
+    {
+        std::this_thread::sleep_for(SYNCHRONIZE_POLL_INTERVAL);
+    }
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    _reclaim_plans();
+}
+
+bool AudioGraph::wait_for_render_plan(std::chrono::milliseconds timeout)
+{
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(_edit_lock);
+        generation = _plan.load()->generation;
+    }
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (_released_generation.load(std::memory_order_acquire) < generation)
+    {
+        if (std::chrono::steady_clock::now() >= deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(SYNCHRONIZE_POLL_INTERVAL);
+    }
+    /* The audio thread has moved on from all plans replaced before this one */
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    _reclaim_plans();
+    return true;
+}
+
+bool AudioGraph::acquire_render_plan()
+{
+    _rt_epoch.fetch_add(1);
+    _rt_plan = _plan.load();
+    if (_rt_plan->generation == _rt_generation)
+    {
+        return false;
+    }
+    _rt_generation = _rt_plan->generation;
+    for (size_t i = 0; i < _rt_plan->routes.size(); ++i)
+    {
+        const auto& route = _rt_plan->routes[i];
+        if (route.delay_line)
+        {
+            route.delay_line->set_delay(_rt_plan->route_delays[i]);
+        }
+    }
+    return true;
+}
+
+bool AudioGraph::pop_committed_event(RtEvent& event)
+{
+    const auto& plan = *_rt_plan;
+    /* Plans never start after the first event not yet returned, see _publish() */
+    auto index = _rt_popped_events - plan.first_event;
+    if (index >= plan.events.size())
+    {
+        return false;
+    }
+    event = plan.events[index];
+    _rt_popped_events++;
+    _popped_events.store(_rt_popped_events, std::memory_order_release);
+    return true;
+}
+
+void AudioGraph::release_render_plan()
+{
+    _released_generation.store(_rt_generation, std::memory_order_release);
+    _rt_epoch.fetch_add(1);
+}
+
+void AudioGraph::clear_connected_inputs()
+{
+    for (const auto& route : _rt_plan->routes)
+    {
+        route.dest->input_channel(route.dest_channel).clear();
+    }
+}
+
+void AudioGraph::render()
+{
+    int node_count = static_cast<int>(_rt_plan->nodes.size());
+    if (_worker_pool == nullptr)
+    {
+        for (int node = 0; node < node_count; ++node)
+        {
+            _render_node(node);
+        }
+        _advance_pipelines();
+        return;
+    }
+
+    /* Reset the scheduling state and queue all tracks without upstream dependencies,
+     * the rest will be queued by the workers as their dependencies are completed */
+    for (int node = 0; node < node_count; ++node)
+    {
+        _pending_inputs[node].store(_rt_plan->dependency_count[node], std::memory_order_relaxed);
+    }
+    _remaining_nodes.store(node_count, std::memory_order_relaxed);
+    _distribute_ready_nodes();
+    _worker_pool->wakeup_workers();
+    _worker_pool->wait_for_workers_idle();
+    _advance_pipelines();
+}
+
+float AudioGraph::expected_cost(const Track* track) const
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    int index = _track_index(track);
+    if (index < 0)
+    {
+        return 0.0f;
+    }
+    float cost = 0.0f;
+    for (const auto& stage_cost : _track_costs[_cost_slots[index]])
+    {
+        cost += stage_cost.load(std::memory_order_relaxed);
+    }
+    return cost;
+}
+
+int AudioGraph::latency() const
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    return _plan.load()->latency;
+}
+
+int AudioGraph::latency(const Track* track) const
+{
+    std::lock_guard<std::mutex> lock(_edit_lock);
+    const auto& plan = *_plan.load();
+    for (size_t i = 0; i < plan.tracks.size(); ++i)
+    {
+        if (plan.tracks[i] == track)
+        {
+            return plan.latencies[i];
+        }
+    }
+    return 0;
+}
+
+int AudioGraph::output_delay(const Track* track) const
+{
+    const auto& plan = *_rt_plan;
+    for (size_t i = 0; i < plan.tracks.size(); ++i)
+    {
+        if (plan.tracks[i] == track)
+        {
+            return plan.latency - plan.latencies[i];
+        }
+    }
+    return 0;
+}
+
+std::unique_ptr<AudioGraph::RenderPlan> AudioGraph::_build_plan()
+{
+    auto plan = std::make_unique<RenderPlan>();
+    int track_count = static_cast<int>(_tracks.size());
+    std::vector<int> in_degree(track_count, 0);
+    std::vector<int> sort_position(track_count, 0);
+    std::vector<int> sort_queue;
+    sort_queue.reserve(track_count);
+
+    for (const auto& route : _routes)
+    {
+        in_degree[_track_index(route.dest)]++;
+    }
+    for (int i = 0; i < track_count; ++i)
+    {
+        if (in_degree[i] == 0)
+        {
+            sort_queue.push_back(i);
+        }
+    }
+    /* Kahn's algorithm, sort_queue doubles as the output list */
+    for (int i = 0; i < static_cast<int>(sort_queue.size()); ++i)
+    {
+        const Track* track = _tracks[sort_queue[i]];
+        for (const auto& route : _routes)
+        {
+            if (route.source == track)
+            {
+                int dest = _track_index(route.dest);
+                if (--in_degree[dest] == 0)
+                {
+                    sort_queue.push_back(dest);
+                }
+            }
+        }
+    }
+    if (static_cast<int>(sort_queue.size()) < track_count)
+    {
+        return nullptr;
+    }
+
+    /* Signals from all inputs of a track must arrive with the same latency, so routes
+     * from tracks with less latency than the other inputs of the destination are delayed */
+    std::vector<int> input_latencies(track_count, 0);
+    plan->latencies.assign(track_count, 0);
+    for (int track_index : sort_queue)
+    {
+        plan->latencies[track_index] = input_latencies[track_index] + _tracks[track_index]->latency();
+        plan->latency = std::max(plan->latency, plan->latencies[track_index]);
+        for (const auto& route : _routes)
+        {
+            if (route.source == _tracks[track_index])
+            {
+                int& input_latency = input_latencies[_track_index(route.dest)];
+                input_latency = std::max(input_latency, plan->latencies[track_index]);
+            }
+        }
+    }
+    for (auto& route : _routes)
+    {
+        int delay = input_latencies[_track_index(route.dest)] - plan->latencies[_track_index(route.source)];
+        if (delay > MAX_LATENCY_COMPENSATION)
+        {
+            SUSHI_LOG_WARNING("Latency of {} samples between tracks {} and {} is too long to compensate for",
+                              delay, route.source->name(), route.dest->name());
+        }
+        if (delay > 0 && route.delay_line == nullptr)
+        {
+            route.delay_line = std::make_shared<dsp::DelayLine>(MAX_LATENCY_COMPENSATION);
+        }
+        plan->route_delays.push_back(std::min(delay, MAX_LATENCY_COMPENSATION));
+    }
+
+    plan->tracks = _tracks;
+    plan->routes = _routes;
+
+    /* Every pipeline stage of a track is a separate node. Only the first stage depends
+     * on upstream tracks and only the last stage has downstream tracks, the stages in
+     * between work on data from the previous chunk and can be rendered at any time */
+    for (int track_index : sort_queue)
+    {
+        Track* track = _tracks[track_index];
+        plan->render_order.push_back(track);
+        sort_position[track_index] = static_cast<int>(plan->nodes.size());
+        for (int stage = 0; stage < track->pipeline_stages(); ++stage)
+        {
+            plan->nodes.push_back({track, _cost_slots[track_index], stage});
+        }
+        if (track->pipeline_stages() > 1)
+        {
+            plan->pipelined_tracks.push_back(track);
+        }
+    }
+
+    const auto& routes = plan->routes;
+    for (int node = 0; node < static_cast<int>(plan->nodes.size()); ++node)
+    {
+        const auto& render_node = plan->nodes[node];
+        plan->downstream_offsets.push_back(static_cast<int>(plan->downstream_nodes.size()));
+        plan->input_route_offsets.push_back(static_cast<int>(plan->input_routes.size()));
+        bool first_stage = render_node.stage == 0;
+        bool last_stage = render_node.stage == render_node.track->pipeline_stages() - 1;
+        for (int r = 0; r < static_cast<int>(routes.size()); ++r)
+        {
+            if (last_stage && routes[r].source == render_node.track)
+            {
+                plan->downstream_nodes.push_back(sort_position[_track_index(routes[r].dest)]);
+            }
+            if (first_stage && routes[r].dest == render_node.track)
+            {
+                plan->input_routes.push_back(r);
+            }
+        }
+        int dependencies = static_cast<int>(plan->input_routes.size()) - plan->input_route_offsets.back();
+        plan->dependency_count.push_back(dependencies);
+        if (dependencies == 0)
+        {
+            plan->initial_nodes.push_back(node);
+        }
+    }
+    plan->downstream_offsets.push_back(static_cast<int>(plan->downstream_nodes.size()));
+    plan->input_route_offsets.push_back(static_cast<int>(plan->input_routes.size()));
+    return plan;
+}
+
+void AudioGraph::_publish(std::unique_ptr<RenderPlan> plan, std::vector<RtEvent> events)
+{
+    /* The audio thread could pick up the previous plan at any time, so any of its events
+     * that are not known to be popped are copied, they are skipped if popped already */
+    const RenderPlan* current = _plan.load();
+    uint64_t popped = _popped_events.load(std::memory_order_acquire);
+    auto carried = std::max(current->first_event, popped) - current->first_event;
+    plan->first_event = current->first_event + carried;
+    plan->events.assign(current->events.begin() + carried, current->events.end());
+    plan->events.insert(plan->events.end(), events.begin(), events.end());
+    plan->generation = current->generation + 1;
+
+    RenderPlan* previous = _plan.exchange(plan.release());
+    /* Must be read after the exchange. If the audio thread is not inside a chunk now,
+     * it will see the new plan when it acquires the next one */
+    _retired_plans.push_back({std::unique_ptr<RenderPlan>(previous), _rt_epoch.load()});
+    _reclaim_plans();
+}
+
+void AudioGraph::_reclaim_plans()
+{
+    uint64_t epoch = _rt_epoch.load();
+    _retired_plans.erase(std::remove_if(_retired_plans.begin(), _retired_plans.end(), [&](const auto& retired)
+    {
+        return retired.epoch % 2 == 0 || retired.epoch != epoch;
+    }), _retired_plans.end());
+}
+
+int AudioGraph::_track_index(const Track* track) const
+{
+    for (int i = 0; i < static_cast<int>(_tracks.size()); ++i)
+    {
+        if (_tracks[i] == track)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void AudioGraph::_render_node(int node)
+{
+    auto& plan = *_rt_plan;
+    for (int i = plan.input_route_offsets[node]; i < plan.input_route_offsets[node + 1]; ++i)
+    {
+        auto& route = plan.routes[plan.input_routes[i]];
+        auto dest = route.dest->input_channel(route.dest_channel);
+        auto output = route.source->output_channel(route.source_channel);
+        const auto& source = route.delay_line ? route.delay_line->process(output) : output;
+        float gain = route.gain.load(std::memory_order_relaxed);
+        float& current_gain = *route.current_gain;
+        if (gain != current_gain)
+        {
+            dest.add_with_ramp(source, current_gain, gain);
+            current_gain = gain;
+        }
+        else if (gain == 1.0f)
+        {
+            dest.add(source);
+        }
+        else
+        {
+            dest.add_with_gain(source, gain);
+        }
+    }
+    const auto& render_node = plan.nodes[node];
+    if (render_node.track->pipeline_stages() > 1)
+    {
+        render_node.track->render_stage(render_node.stage);
+    }
+    else
+    {
+        render_node.track->render();
+    }
+}
+
+void AudioGraph::_advance_pipelines()
+{
+    for (auto track : _rt_plan->pipelined_tracks)
+    {
+        track->advance_pipeline();
+    }
+}
+
+void AudioGraph::_distribute_ready_nodes()
+{
+    /* The capacity of _initial_nodes covers the largest possible plan, so this does not allocate */
+    _initial_nodes.assign(_rt_plan->initial_nodes.begin(), _rt_plan->initial_nodes.end());
+    std::sort(_initial_nodes.begin(), _initial_nodes.end(), [&](int lhs, int rhs)
+    {
+        return _node_cost(lhs) > _node_cost(rhs);
+    });
+
+    /* Longest processing time first scheduling, ties are broken by the number of
+     * queued nodes so that work is spread evenly before any costs are known */
+    for (int node : _initial_nodes)
+    {
+        int target = 0;
+        for (int worker = 1; worker < _cpu_cores; ++worker)
+        {
+            float cost = _worker_queues[worker].queued_cost.load(std::memory_order_relaxed);
+            float target_cost = _worker_queues[target].queued_cost.load(std::memory_order_relaxed);
+            if (cost < target_cost || (cost == target_cost && _worker_queues[worker].count < _worker_queues[target].count))
+            {
+                target = worker;
+            }
+        }
+        _push_ready(target, node);
+    }
+}
+
+void AudioGraph::_push_ready(int worker, int node)
+{
+    auto& queue = _worker_queues[worker];
+    float cost = _node_cost(node);
+    std::lock_guard<SpinLock> lock(queue.lock);
+    int i = queue.count;
+    while (i > 0 && _node_cost(queue.nodes[i - 1]) > cost)
+    {
+        queue.nodes[i] = queue.nodes[i - 1];
+        --i;
+    }
+    queue.nodes[i] = node;
+    queue.count++;
+    queue.queued_cost.store(queue.queued_cost.load(std::memory_order_relaxed) + cost, std::memory_order_relaxed);
+}
+
+int AudioGraph::_pop_ready(int worker)
+{
+    auto& queue = _worker_queues[worker];
+    std::lock_guard<SpinLock> lock(queue.lock);
+    if (queue.count == 0)
+    {
+        return EMPTY_SLOT;
+    }
+    int node = queue.nodes[--queue.count];
+    float cost = queue.count > 0 ? queue.queued_cost.load(std::memory_order_relaxed) - _node_cost(node) : 0.0f;
+    queue.queued_cost.store(cost, std::memory_order_relaxed);
+    return node;
+}
+
+int AudioGraph::_steal_ready(int worker)
+{
+    /* Steal the most expensive node from the worker with the most queued work */
+    int victim = EMPTY_SLOT;
+    float max_cost = -1.0f;
+    for (int i = 0; i < _cpu_cores; ++i)
+    {
+        float cost = _worker_queues[i].queued_cost.load(std::memory_order_relaxed);
+        if (i != worker && cost > max_cost)
+        {
+            victim = i;
+            max_cost = cost;
+        }
+    }
+    int node = victim != EMPTY_SLOT ? _pop_ready(victim) : EMPTY_SLOT;
+    for (int i = 0; node == EMPTY_SLOT && i < _cpu_cores; ++i)
+    {
+        /* Queued costs are only a hint, the queue could be empty when we
+         * get to it, or the costs could all be unknown */
+        if (i != worker && i != victim)
+        {
+            node = _pop_ready(i);
+        }
+    }
+    return node;
+}
+
+void AudioGraph::_worker(int worker)
+{
+    while (_remaining_nodes.load(std::memory_order_acquire) > 0)
+    {
+        int node = _pop_ready(worker);
+        if (node == EMPTY_SLOT)
+        {
+            node = _steal_ready(worker);
+        }
+        if (node == EMPTY_SLOT)
+        {
+            /* All remaining tracks are waiting for their inputs, which are currently
+             * being rendered by other workers. Back off for a while before looking at
+             * the queues again, to keep their locks free for the workers pushing to them.
+             * Never sleep here, on Xenomai any system call would force a mode switch
+             * in the middle of the chunk. Workers are parked by the pool between chunks */
+            for (int i = 0; i < IDLE_SPIN_COUNT && _remaining_nodes.load(std::memory_order_relaxed) > 0; ++i)
+            {
+                cpu_pause();
+            }
+            continue;
+        }
+        auto start_time = twine::current_rt_time();
+        _render_node(node);
+        float render_time = static_cast<float>((twine::current_rt_time() - start_time).count());
+        const auto& render_node = _rt_plan->nodes[node];
+        auto& cost = _track_costs[render_node.cost_slot][render_node.stage];
+        float previous_cost = cost.load(std::memory_order_relaxed);
+        float new_cost = previous_cost > 0.0f ? previous_cost + COST_SMOOTHING * (render_time - previous_cost) : render_time;
+        cost.store(new_cost, std::memory_order_relaxed);
+
+        /* Newly ready downstream tracks are queued on this worker as their
+         * input data is most likely still in this core's cache */
+        for (int i = _rt_plan->downstream_offsets[node]; i < _rt_plan->downstream_offsets[node + 1]; ++i)
+        {
+            int downstream = _rt_plan->downstream_nodes[i];
+            if (_pending_inputs[downstream].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                _push_ready(worker, downstream);
+            }
+        }
+        _remaining_nodes.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+} // namespace engine
+} // namespace sushi
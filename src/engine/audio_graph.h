@@ -0,0 +1,463 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Graph of tracks with audio dependencies, rendered in dependency order,
+ *        optionally on several cpu cores with cost-aware work stealing.
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_AUDIO_GRAPH_H
+#define SUSHI_AUDIO_GRAPH_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "twine/twine.h"
+
+#include "library/constants.h"
+#include "library/rt_event.h"
+#include "library/spinlock.h"
+#include "engine/track.h"
+#include "dsp_library/delay_line.h"
+
+namespace sushi {
+namespace engine {
+
+/* The longest delay that can be inserted to compensate for processing latency */
+constexpr int MAX_LATENCY_COMPENSATION = 16384;
+
+class AudioGraph
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(AudioGraph);
+
+    /**
+     * @brief Create an empty audio graph.
+     * @param cpu_cores The number of cpu cores to render tracks on. With values > 1, a
+     *                  pool of worker threads is created and tracks are rendered in
+     *                  parallel as soon as all their upstream tracks have been rendered.
+     *                  Each worker renders the most expensive track in its own queue
+     *                  first and steals from the most loaded worker when it runs out.
+     * @param max_no_tracks The maximum number of tracks in the graph. All storage used
+     *                      when rendering is allocated up front.
+     */
+    AudioGraph(int cpu_cores, int max_no_tracks);
+
+    ~AudioGraph();
+
+    /* Edits to the graph are never done on the data used for rendering. Instead every edit
+     * builds a new, immutable render plan which is published with a single atomic pointer
+     * swap and picked up by the audio thread at the start of the next chunk. Replaced plans
+     * are freed once the audio thread can no longer be using them. Hence the functions below
+     * are safe to call while the engine is running, but not from the realtime thread.
+     * Several edits can be grouped in a transaction, in which case they are published
+     * together in one plan when the transaction is committed. */
+
+    /**
+     * @brief Add a track to the graph.
+     * @param track The track to add
+     * @return true if the track was added, false if the graph is full or the track
+     *         is already in the graph.
+     */
+    bool add(Track* track);
+
+    /**
+     * @brief Remove a track and all audio connections to and from it. The track may
+     *        still be rendered until synchronize() has been called.
+     * @param track The track to remove
+     * @return true if the track was found and removed, false otherwise.
+     */
+    bool remove(Track* track);
+
+    /**
+     * @brief Connect an output channel of one track to an input channel of another
+     *        track. The destination track will always be rendered after the source
+     *        track and the source channel will be summed into the destination channel.
+     *        Summing is done by the worker rendering the destination track, so tracks
+     *        sending to the same destination can be rendered in parallel without locking.
+     *        If the source track has less latency than other tracks connected to the same
+     *        destination track, the connection is delayed to compensate for the difference.
+     * @param source The track to connect from
+     * @param source_channel The output channel of the source track
+     * @param dest The track to connect to
+     * @param dest_channel The input channel of the destination track
+     * @param gain Linear gain applied to the source channel before summing
+     * @return true if the connection was made, false if any of the tracks are not in the
+     *         graph or if the connection would create a cycle in the graph.
+     */
+    bool connect(Track* source, int source_channel, Track* dest, int dest_channel, float gain = 1.0f);
+
+    /**
+     * @brief Remove a connection made with connect(). If the same channels are
+     *        connected more than once, the most recent connection is removed.
+     * @param source The track connected from
+     * @param source_channel The output channel of the source track
+     * @param dest The track connected to
+     * @param dest_channel The input channel of the destination track
+     * @return true if the connection was found and removed, false otherwise
+     */
+    bool disconnect(const Track* source, int source_channel, const Track* dest, int dest_channel);
+
+    /**
+     * @brief Set the gain of all connections from one track to another. Gain changes
+     *        are ramped over one chunk. Does not publish a new render plan.
+     * @param source The track connected from
+     * @param dest The track connected to
+     * @param gain The new linear gain
+     * @return true if any connection was found, false otherwise
+     */
+    bool set_gain(const Track* source, const Track* dest, float gain);
+
+    /**
+     * @brief Rebuild the render plan. Should be called when the number of pipeline
+     *        stages of a track in the graph has changed.
+     * @return true if successful, false otherwise
+     */
+    bool update();
+
+    /**
+     * @brief Start a transaction. Edits made until commit_transaction() is called are
+     *        not published, the audio thread keeps rendering the current plan until then.
+     */
+    void begin_transaction();
+
+    /**
+     * @brief Publish all edits made since begin_transaction() in one render plan.
+     * @param events Events to pass to the audio thread together with the new plan. They
+     *        are returned from pop_committed_event() in the same chunk as the plan is
+     *        first rendered, before rendering starts.
+     * @return true if successful, false if no transaction was started
+     */
+    bool commit_transaction(std::vector<RtEvent> events = {});
+
+    /**
+     * @brief Wait until the audio thread is done with all replaced render plans and free
+     *        them. After this returns, removed tracks are guaranteed not to be rendered
+     *        again and can be deleted. Blocks for at most the duration of one chunk,
+     *        other threads can keep editing the graph in the meantime.
+     */
+    void synchronize();
+
+    /**
+     * @brief Wait until the audio thread has rendered a whole chunk with the latest
+     *        published render plan, so that all events committed with it have been
+     *        handled, and free all replaced plans.
+     * @param timeout The longest time to wait
+     * @return true if successful, false if the audio thread did not finish a chunk with
+     *         the plan in time
+     */
+    bool wait_for_render_plan(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Pick up the latest published render plan and apply its latency compensation
+     *        delays. Must be called from the audio thread at the start of every chunk,
+     *        before any of the functions below.
+     * @return true if the plan was changed since the previous chunk
+     */
+    bool acquire_render_plan();
+
+    /**
+     * @brief Get the next event committed together with the current render plan or any
+     *        plan published before it. Events are returned once, in the order they were
+     *        committed. Must be called from the audio thread after acquire_render_plan().
+     * @param event The event to fill in
+     * @return true if an event was returned, false if there are no more events
+     */
+    bool pop_committed_event(RtEvent& event);
+
+    /**
+     * @brief Signal that the audio thread is done with the current render plan. Must be
+     *        called from the audio thread at the end of every chunk.
+     */
+    void release_render_plan();
+
+    /**
+     * @brief Clear all track input channels that are fed from other tracks. Should be
+     *        called before engine input audio is copied to the tracks.
+     */
+    void clear_connected_inputs();
+
+    /**
+     * @brief Render all tracks in the graph in dependency order. Returns when all
+     *        tracks have been rendered. The pipeline stages of pipelined tracks are
+     *        rendered as independent nodes.
+     */
+    void render();
+
+    /**
+     * @brief Return all tracks in the render plan currently used by the audio thread.
+     *        Only valid to call from the audio thread.
+     * @return An std::vector of all tracks being rendered
+     */
+    const std::vector<Track*>& active_tracks() const
+    {
+        return _rt_plan->tracks;
+    }
+
+    /**
+     * @brief Get the delay needed to align the output of a track with the output of the
+     *        track with the longest latency, according to the render plan currently used
+     *        by the audio thread. Only valid to call from the audio thread.
+     * @param track The track to query
+     * @return The delay in samples, 0 if the track is not in the graph
+     */
+    int output_delay(const Track* track) const;
+
+    /**
+     * @brief Get the total processing latency of the graph, i.e. the latency of the
+     *        track with the longest latency, including the latency of upstream tracks.
+     * @return The latency in samples
+     */
+    int latency() const;
+
+    /**
+     * @brief Get the latency of the output of a track, including the latency of all
+     *        upstream tracks and latency compensation.
+     * @param track The track to query
+     * @return The latency in samples, 0 if the track is not in the graph
+     */
+    int latency(const Track* track) const;
+
+    /**
+     * @brief Get the expected render time of a track, measured as a moving average over
+     *        previous chunks when rendering on several cores.
+     * @param track The track to query
+     * @return The expected render time of all pipeline stages of the track in nanoseconds,
+     *         0 if unknown
+     */
+    float expected_cost(const Track* track) const;
+
+    /**
+     * @brief Return all tracks in the order they were added.
+     * @return An std::vector of all tracks
+     */
+    const std::vector<Track*>& tracks() const
+    {
+        return _tracks;
+    }
+
+    /**
+     * @brief Return all tracks sorted so that every track comes after all tracks it
+     *        depends on, according to the latest published render plan.
+     * @return An std::vector of all tracks in rendering order
+     */
+    std::vector<Track*> render_order() const
+    {
+        /* The plan could be replaced and freed as soon as the lock is released */
+        std::lock_guard<std::mutex> lock(_edit_lock);
+        return _plan.load()->render_order;
+    }
+
+private:
+    struct AudioRoute
+    {
+        AudioRoute(Track* source, int source_channel, Track* dest, int dest_channel, float gain) :
+                source(source), source_channel(source_channel), dest(dest), dest_channel(dest_channel),
+                gain(gain), current_gain(std::make_shared<float>(gain)) {}
+
+        AudioRoute(const AudioRoute& other) : source(other.source), source_channel(other.source_channel),
+                                              dest(other.dest), dest_channel(other.dest_channel),
+                                              gain(other.gain.load()), current_gain(other.current_gain),
+                                              delay_line(other.delay_line) {}
+
+        AudioRoute& operator=(const AudioRoute& other)
+        {
+            source = other.source;
+            source_channel = other.source_channel;
+            dest = other.dest;
+            dest_channel = other.dest_channel;
+            gain = other.gain.load();
+            current_gain = other.current_gain;
+            delay_line = other.delay_line;
+            return *this;
+        }
+
+        Track* source;
+        int source_channel;
+        Track* dest;
+        int dest_channel;
+        /* Target gain, set from any thread */
+        std::atomic<float> gain;
+        /* Gain applied in the last chunk, only touched when rendering dest. Shared between
+         * all plans like delay_line, so that a gain ramp continues across graph edits */
+        std::shared_ptr<float> current_gain;
+        /* Latency compensation, only allocated once the route needs to be delayed and
+         * shared between all plans so that it keeps its state when the graph is edited */
+        std::shared_ptr<dsp::DelayLine> delay_line;
+    };
+
+    struct RenderNode
+    {
+        Track* track;
+        /* Index into _track_costs, stays the same for as long as the track is in the graph */
+        int cost_slot;
+        int stage;
+    };
+
+    /* Everything needed to render the graph, never modified after being published
+     * except for the route gains. All node data is sorted in render order */
+    struct RenderPlan
+    {
+        std::vector<Track*> tracks;
+        std::vector<Track*> render_order;
+        std::vector<Track*> pipelined_tracks;
+        std::vector<AudioRoute> routes;
+
+        std::vector<RenderNode> nodes;
+        std::vector<int> dependency_count;
+        std::vector<int> downstream_offsets;
+        std::vector<int> downstream_nodes;
+        std::vector<int> input_route_offsets;
+        std::vector<int> input_routes;
+        std::vector<int> initial_nodes;
+
+        /* Output latency of each track, in the same order as tracks */
+        std::vector<int> latencies;
+        int latency{0};
+
+        /* Latency compensation of each route, in the same order as routes. Set on the
+         * delay lines by the audio thread when it picks up the plan, as the delay lines
+         * are shared with the plan it is currently rendering */
+        std::vector<int> route_delays;
+
+        /* Incremented for every published plan */
+        uint64_t generation{0};
+
+        /* Committed events not known to have been passed to the audio thread, the
+         * first one being event number first_event in the sequence of all events */
+        std::vector<RtEvent> events;
+        uint64_t first_event{0};
+    };
+
+    struct RetiredPlan
+    {
+        std::unique_ptr<RenderPlan> plan;
+        /* Value of _rt_epoch when the plan was replaced */
+        uint64_t epoch;
+    };
+
+    /**
+     * @brief Sort the tracks topologically and build a render plan from them. Also
+     *        calculates the latency compensation delays of the routes.
+     * @return A new render plan, or nullptr if the graph contains a cycle
+     */
+    std::unique_ptr<RenderPlan> _build_plan();
+
+    /**
+     * @brief Make a render plan the current one and retire the previous plan. Events
+     *        from the previous plan that the audio thread might not have seen yet are
+     *        carried over to the new plan.
+     */
+    void _publish(std::unique_ptr<RenderPlan> plan, std::vector<RtEvent> events = {});
+
+    /**
+     * @brief Free retired plans that the audio thread can no longer be using
+     */
+    void _reclaim_plans();
+
+    int _track_index(const Track* track) const;
+
+    void _render_node(int node);
+
+    void _advance_pipelines();
+
+    /**
+     * @brief Queue all tracks without upstream dependencies, longest expected render
+     *        time first, each to the worker with the least queued work.
+     */
+    void _distribute_ready_nodes();
+
+    void _push_ready(int worker, int node);
+
+    int _pop_ready(int worker);
+
+    int _steal_ready(int worker);
+
+    float _node_cost(int node) const
+    {
+        const auto& render_node = _rt_plan->nodes[node];
+        return _track_costs[render_node.cost_slot][render_node.stage].load(std::memory_order_relaxed);
+    }
+
+    struct WorkerContext
+    {
+        AudioGraph* instance;
+        int worker;
+    };
+
+    /* Nodes ready to render, sorted by increasing cost so that the most expensive
+     * node is always taken from the back of the queue. Guarded by lock */
+    struct alignas(ASSUMED_CACHE_LINE_SIZE) WorkerQueue
+    {
+        SpinLock lock;
+        std::unique_ptr<int[]> nodes;
+        int count{0};
+        std::atomic<float> queued_cost{0.0f};
+    };
+
+    static void _worker_callback(void* arg)
+    {
+        auto context = reinterpret_cast<WorkerContext*>(arg);
+        context->instance->_worker(context->worker);
+    }
+
+    void _worker(int worker);
+
+    int _max_no_tracks;
+
+    /* The graph as edited from the non realtime side, guarded by _edit_lock */
+    mutable std::mutex _edit_lock;
+    std::vector<Track*> _tracks;
+    std::vector<int> _cost_slots;
+    std::vector<int> _free_cost_slots;
+    std::vector<AudioRoute> _routes;
+    std::vector<RetiredPlan> _retired_plans;
+    bool _transaction_active{false};
+
+    /* The latest published plan and the plan used by the audio thread in the current chunk */
+    std::atomic<RenderPlan*> _plan{nullptr};
+    RenderPlan* _rt_plan{nullptr};
+    uint64_t _rt_generation{0};
+    /* Incremented by the audio thread when acquiring and releasing a plan, so odd
+     * values mean that a plan is in use */
+    std::atomic<uint64_t> _rt_epoch{0};
+    /* Generation of the plan used in the last chunk the audio thread finished */
+    std::atomic<uint64_t> _released_generation{0};
+    /* The number of committed events returned to the audio thread so far */
+    uint64_t _rt_popped_events{0};
+    std::atomic<uint64_t> _popped_events{0};
+
+    /* Expected render time of each stage, indexed by cost slot */
+    std::unique_ptr<std::array<std::atomic<float>, TRACK_MAX_PIPELINE_STAGES>[]> _track_costs;
+
+    /* Scheduling state for multicore rendering */
+    int _cpu_cores;
+    std::unique_ptr<twine::WorkerPool> _worker_pool;
+    std::unique_ptr<WorkerContext[]> _worker_contexts;
+    std::unique_ptr<WorkerQueue[]> _worker_queues;
+    std::unique_ptr<std::atomic<int>[]> _pending_inputs;
+    std::vector<int> _initial_nodes;
+    alignas(ASSUMED_CACHE_LINE_SIZE) std::atomic<int> _remaining_nodes{0};
+};
+
+} // namespace engine
+} // namespace sushi
+
+#endif //SUSHI_AUDIO_GRAPH_H
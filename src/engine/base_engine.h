@@ -154,6 +154,50 @@ public:
         return EngineReturnStatus::OK;
     }
 
+    virtual EngineReturnStatus connect_track_channel_to_track(int /*source_channel*/,
+                                                              const std::string& /*source_track_name*/,
+                                                              int /*dest_channel*/,
+                                                              const std::string& /*dest_track_name*/)
+    {
+        return EngineReturnStatus::OK;
+    }
+
+    virtual EngineReturnStatus connect_track_bus_to_track(int /*source_bus*/,
+                                                          const std::string& /*source_track_name*/,
+                                                          int /*dest_bus*/,
+                                                          const std::string& /*dest_track_name*/)
+    {
+        return EngineReturnStatus::OK;
+    }
+
+    virtual EngineReturnStatus add_send_to_track(int /*source_bus*/,
+                                                 const std::string& /*source_track_name*/,
+                                                 int /*return_bus*/,
+                                                 const std::string& /*return_track_name*/,
+                                                 float /*gain*/)
+    {
+        return EngineReturnStatus::OK;
+    }
+
+    virtual EngineReturnStatus set_send_gain(const std::string& /*source_track_name*/,
+                                             const std::string& /*return_track_name*/,
+                                             float /*gain*/)
+    {
+        return EngineReturnStatus::OK;
+    }
+
+    virtual EngineReturnStatus set_track_pipeline_stages(const std::string& /*track_name*/,
+                                                         int /*stages*/)
+    {
+        return EngineReturnStatus::OK;
+    }
+
+    virtual EngineReturnStatus set_track_double_precision(const std::string& /*track_name*/,
+                                                          bool /*enabled*/)
+    {
+        return EngineReturnStatus::OK;
+    }
+
     virtual EngineReturnStatus connect_cv_to_parameter(const std::string& /*processor_name*/,
                                                        const std::string& /*parameter_name*/,
                                                        int /*cv_input_id*/)
@@ -230,6 +274,26 @@ public:
 
     virtual EngineReturnStatus send_async_event(RtEvent& event) = 0;
 
+    virtual EngineReturnStatus begin_transaction()
+    {
+        return EngineReturnStatus::OK;
+    }
+
+    virtual EngineReturnStatus commit_transaction()
+    {
+        return EngineReturnStatus::OK;
+    }
+
+    virtual bool transaction_active()
+    {
+        return false;
+    }
+
+    virtual int get_latency()
+    {
+        return 0;
+    }
+
     virtual std::pair<EngineReturnStatus, ObjectId> processor_id_from_name(const std::string& /*name*/)
     {
         return std::make_pair(EngineReturnStatus::OK, 0);
@@ -318,6 +382,15 @@ public:
         return nullptr;
     }
 
+    /**
+     * @brief Get the capacity and the number of dropped events of every event queue
+     *        between the engine and the non-rt part
+     */
+    virtual std::vector<ext::EventQueueInfo> event_queue_info() const
+    {
+        return {};
+    }
+
     virtual void enable_input_clip_detection(bool /*enabled*/) {}
 
     virtual void enable_output_clip_detection(bool /*enabled*/) {}
@@ -20,6 +20,7 @@
 
 #include "engine/controller.h"
 #include "engine/base_engine.h"
+#include "library/event_pool.h"
 
 #include "logging.h"
 
@@ -119,6 +120,12 @@ float Controller::get_samplerate() const
     return _engine->sample_rate();
 }
 
+int Controller::get_latency() const
+{
+    SUSHI_LOG_DEBUG("get_latency called");
+    return _engine->get_latency();
+}
+
 ext::PlayingMode Controller::get_playing_mode() const
 {
     SUSHI_LOG_DEBUG("get_playing_mode called");
@@ -207,6 +214,26 @@ std::vector<ext::TrackInfo> Controller::get_tracks() const
     return returns;
 }
 
+std::vector<ext::EventQueueInfo> Controller::get_event_queues() const
+{
+    SUSHI_LOG_DEBUG("get_event_queues called");
+    return _engine->event_queue_info();
+}
+
+std::vector<ext::EventPoolInfo> Controller::get_event_pools() const
+{
+    SUSHI_LOG_DEBUG("get_event_pools called");
+    std::vector<ext::EventPoolInfo> pools;
+    for (const auto& usage : EventPool::instance().usage())
+    {
+        pools.push_back({static_cast<int>(usage.block_size),
+                         usage.blocks,
+                         usage.blocks_in_use,
+                         usage.peak_blocks_in_use});
+    }
+    return pools;
+}
+
 ext::ControlStatus Controller::send_note_on(int track_id, int channel, int note, float velocity)
 {
     SUSHI_LOG_DEBUG("send_note_on called with track {}, note {}, velocity {}", track_id, note, velocity);
@@ -635,6 +662,14 @@ ext::ControlStatus Controller::set_parameter_value(int processor_id, int paramet
 {
     float clamped_value = std::clamp<float>(value, 0.0f, 1.0f);
     SUSHI_LOG_DEBUG("set_parameter_value called with processor {}, parameter {} and value {}", processor_id, parameter_id, clamped_value);
+    if (_engine->transaction_active())
+    {
+        /* Bypass the dispatcher so the change is staged together with the rest of the transaction */
+        auto rt_event = RtEvent::make_parameter_change_event(static_cast<ObjectId>(processor_id), 0,
+                                                             static_cast<ObjectId>(parameter_id), clamped_value);
+        _engine->send_async_event(rt_event);
+        return ext::ControlStatus::OK;
+    }
     auto event = new ParameterChangeEvent(ParameterChangeEvent::Subtype::FLOAT_PARAMETER_CHANGE,
                                           static_cast<ObjectId>(processor_id),
                                           static_cast<ObjectId>(parameter_id),
@@ -651,6 +686,18 @@ ext::ControlStatus Controller::set_string_property_value(int /*processor_id*/, i
     return ext::ControlStatus::UNSUPPORTED_OPERATION;
 }
 
+ext::ControlStatus Controller::begin_transaction()
+{
+    SUSHI_LOG_DEBUG("begin_transaction called");
+    return _engine->begin_transaction() == engine::EngineReturnStatus::OK ? ext::ControlStatus::OK : ext::ControlStatus::ERROR;
+}
+
+ext::ControlStatus Controller::commit_transaction()
+{
+    SUSHI_LOG_DEBUG("commit_transaction called");
+    return _engine->commit_transaction() == engine::EngineReturnStatus::OK ? ext::ControlStatus::OK : ext::ControlStatus::ERROR;
+}
+
 std::pair<ext::ControlStatus, ext::CpuTimings> Controller::_get_timings(int node) const
 {
     if (_performance_timer->enabled())
@@ -38,6 +38,7 @@ public:
     ~Controller();
 
     float                                               get_samplerate() const override;
+    int                                                 get_latency() const override;
     ext::PlayingMode                                    get_playing_mode() const override;
     void                                                set_playing_mode(ext::PlayingMode playing_mode) override;
     ext::SyncMode                                       get_sync_mode() const override;
@@ -49,6 +50,8 @@ public:
     bool                                                get_timing_statistics_enabled() const override;
     void                                                set_timing_statistics_enabled(bool enabled) override;
     std::vector<ext::TrackInfo>                         get_tracks() const override;
+    std::vector<ext::EventQueueInfo>                    get_event_queues() const override;
+    std::vector<ext::EventPoolInfo>                     get_event_pools() const override;
 
     ext::ControlStatus                                  send_note_on(int track_id, int channel, int note, float velocity) override;
     ext::ControlStatus                                  send_note_off(int track_id, int channel, int note, float velocity) override;
@@ -89,6 +92,9 @@ public:
     ext::ControlStatus                                  set_parameter_value(int processor_id, int parameter_id, float value) override;
     ext::ControlStatus                                  set_string_property_value(int processor_id, int parameter_id, const std::string& value) override;
 
+    ext::ControlStatus                                  begin_transaction() override;
+    ext::ControlStatus                                  commit_transaction() override;
+
 protected:
     std::pair<ext::ControlStatus, ext::CpuTimings> _get_timings(int node) const;
 
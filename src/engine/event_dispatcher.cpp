@@ -18,6 +18,8 @@
  * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
  */
 
+#include <algorithm>
+
 #include "event_dispatcher.h"
 #include "engine/base_engine.h"
 #include "logging.h"
@@ -46,6 +48,15 @@ EventDispatcher::EventDispatcher(engine::BaseEngine* engine,
 void EventDispatcher::post_event(Event* event)
 {
     _in_queue.push(event);
+    _wakeup.notify();
+}
+
+void EventDispatcher::notify_from_rt(bool new_events)
+{
+    if (new_events)
+    {
+        _rt_events_pending.store(true, std::memory_order_relaxed);
+    }
 }
 
 EventDispatcherStatus EventDispatcher::register_poster(EventPoster* poster)
@@ -68,6 +79,7 @@ void EventDispatcher::run()
 void EventDispatcher::stop()
 {
     _running = false;
+    _wakeup.notify();
     _worker.stop();
     if (_event_thread.joinable())
     {
@@ -137,8 +149,6 @@ void EventDispatcher::_event_loop()
 {
     do
     {
-        auto start_time = std::chrono::system_clock::now();
-
         /* Handle incoming Events */
         while (Event* event = _next_event())
         {
@@ -167,11 +177,34 @@ void EventDispatcher::_event_loop()
             _in_rt_queue->pop(rt_event);
             _process_rt_event(rt_event);
         }
-        std::this_thread::sleep_until(start_time + THREAD_PERIODICITY);
+        if (_running)
+        {
+            _wait_for_events();
+        }
     }
     while (_running);
 }
 
+void EventDispatcher::_wait_for_events()
+{
+    /* Synchronisation events pile up in the rt queue between polls, so even when idle
+     * the queue is polled often enough to keep it from filling up */
+    Time timeout = std::min<Time>(RT_EVENT_IDLE_POLL_PERIOD,
+                                  _event_timer.chunk_time() * std::max(1, _in_rt_queue->capacity() / 4));
+    if (_rt_events_pending.exchange(false, std::memory_order_relaxed))
+    {
+        timeout = RT_EVENT_POLL_PERIOD;
+    }
+    /* Events waiting for their time to come are sent when they fall within the next
+     * chunk, events waiting for space in the rt queue are retried at the next poll */
+    for (auto event : _waiting_list)
+    {
+        auto time_left = _event_timer.time_until_next_chunk(event->time());
+        timeout = std::min(timeout, time_left > Time(0) ? time_left : Time(RT_EVENT_POLL_PERIOD));
+    }
+    _wakeup.wait_until(std::chrono::steady_clock::now() + timeout);
+}
+
 int EventDispatcher::_process_rt_event(RtEvent &rt_event)
 {
     Time timestamp = _event_timer.real_time_from_sample_offset(rt_event.sample_offset());
@@ -308,6 +341,7 @@ void Worker::run()
 void Worker::stop()
 {
     _running = false;
+    _wakeup.notify();
     if (_worker_thread.joinable())
     {
         _worker_thread.join();
@@ -317,6 +351,7 @@ void Worker::stop()
 int Worker::process(Event*event)
 {
     _queue.push(event);
+    _wakeup.notify();
     return EventStatus::QUEUED_HANDLING;
 }
 
@@ -358,7 +393,10 @@ void Worker::_worker()
             _engine->print_timings_to_log();
         }
 
-        std::this_thread::sleep_until(start_time + WORKER_THREAD_PERIODICITY);
+        if (_running)
+        {
+            _wakeup.wait_until(std::chrono::steady_clock::now() + PRINT_TIMING_INTERVAL);
+        }
     }
     while (_running);
 }
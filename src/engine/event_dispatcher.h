@@ -31,6 +31,7 @@
 #include "library/synchronised_fifo.h"
 #include "library/rt_event_fifo.h"
 #include "library/event_interface.h"
+#include "library/wakeup_signal.h"
 
 namespace sushi {
 namespace engine {class BaseEngine;}
@@ -39,8 +40,11 @@ namespace dispatcher {
 class BaseEventDispatcher;
 
 constexpr int AUDIO_ENGINE_ID = 0;
-constexpr std::chrono::milliseconds THREAD_PERIODICITY = std::chrono::milliseconds(1);
-constexpr auto WORKER_THREAD_PERIODICITY = std::chrono::milliseconds(1);
+/* The rt thread never wakes up the event thread, as that would take a system call from
+ * the audio callback. Instead the event thread polls the rt queue at the shorter interval
+ * while the rt thread is sending events, and at the longer one when it is not */
+constexpr auto RT_EVENT_POLL_PERIOD = std::chrono::milliseconds(1);
+constexpr auto RT_EVENT_IDLE_POLL_PERIOD = std::chrono::milliseconds(20);
 
 /**
  * @brief Low priority worker for handling possibly time consuming tasks like
@@ -68,6 +72,7 @@ private:
     void                        _worker();
     std::thread                 _worker_thread;
     std::atomic<bool>           _running;
+    WakeupSignal                _wakeup;
 
     SynchronizedQueue<Event*>   _queue;
 };
@@ -84,6 +89,15 @@ public:
 
     void post_event(Event* event) override;
 
+    /**
+     * @brief Called from the rt thread at the end of every chunk to let the event thread
+     *        know that it has rt events to handle. Only sets a flag that the event thread
+     *        checks when it polls the rt queue, so it never makes a system call.
+     * @param new_events true if events other than the synchronisation event were sent
+     *        to the event thread during the chunk
+     */
+    void notify_from_rt(bool new_events);
+
     EventDispatcherStatus register_poster(EventPoster* poster) override;
     EventDispatcherStatus subscribe_to_keyboard_events(EventPoster* receiver) override;
     EventDispatcherStatus subscribe_to_parameter_change_notifications(EventPoster* receiver) override;
@@ -103,6 +117,8 @@ private:
 
     void _event_loop();
 
+    void _wait_for_events();
+
     int _process_rt_event(RtEvent& rt_event);
 
     Event* _next_event();
@@ -113,6 +129,8 @@ private:
 
     std::atomic<bool>           _running;
     std::thread                 _event_thread;
+    WakeupSignal                _wakeup;
+    std::atomic<bool>           _rt_events_pending{false};
 
     engine::BaseEngine*         _engine;
 
@@ -46,6 +46,23 @@ public:
      */
     std::pair<bool, int>  sample_offset_from_realtime(Time timestamp);
 
+    /**
+     * @brief Get how long it is until a timestamp falls within the next chunk
+     * @param timestamp A real time timestamp
+     * @return The time left, zero or negative if sample_offset_from_realtime() would
+     *         already return true for the timestamp
+     */
+    Time time_until_next_chunk(Time timestamp) const
+    {
+        return timestamp - _incoming_chunk_time.load() - _chunk_time + Time(1);
+    }
+
+    /**
+     * @brief Get the duration of one chunk at the current sample rate
+     * @return The chunk duration
+     */
+    Time chunk_time() const {return _chunk_time;}
+
     /**
      * @brief Convert a sample offset to real time.
      * @param offset Offset in samples
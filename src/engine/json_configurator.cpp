@@ -46,6 +46,10 @@ std::pair<JsonConfigReturnStatus, AudioConfig> JsonConfigurator::load_audio_conf
         return {status, audio_config};
     }
 
+    if (host_config.HasMember("driver_buffer_size"))
+    {
+        audio_config.driver_buffer_size = host_config["driver_buffer_size"].GetInt();
+    }
     if (host_config.HasMember("cv_inputs"))
     {
         audio_config.cv_inputs = host_config["cv_inputs"].GetInt();
@@ -161,15 +165,44 @@ JsonConfigReturnStatus JsonConfigurator::load_tracks()
         return status;
     }
 
+    /* All tracks are built in one transaction so that the engine picks them up in a single
+     * chunk without waiting for the audio thread for every track and plugin. There is no
+     * rollback, tracks created before an error are kept, as when not using a transaction */
+    bool transaction = _engine->begin_transaction() == engine::EngineReturnStatus::OK;
+    status = _make_tracks(tracks);
+    if (transaction && _engine->commit_transaction() != engine::EngineReturnStatus::OK)
+    {
+        SUSHI_LOG_ERROR("Failed to apply tracks from JSON config file");
+        return JsonConfigReturnStatus::INVALID_CONFIGURATION;
+    }
+    if (status != JsonConfigReturnStatus::OK)
+    {
+        return status;
+    }
+    SUSHI_LOG_INFO("Successfully configured engine with tracks in JSON config file \"{}\"", _document_path);
+    return JsonConfigReturnStatus::OK;
+}
+
+JsonConfigReturnStatus JsonConfigurator::_make_tracks(const rapidjson::Value& tracks)
+{
     for (auto& track : tracks.GetArray())
     {
-        status = _make_track(track);
+        auto status = _make_track(track);
+        if (status != JsonConfigReturnStatus::OK)
+        {
+            return status;
+        }
+    }
+    /* Connections between tracks are made once all tracks are created so that
+     * tracks can take input from tracks defined later in the file */
+    for (auto& track : tracks.GetArray())
+    {
+        auto status = _connect_track_inputs(track);
         if (status != JsonConfigReturnStatus::OK)
         {
             return status;
         }
     }
-    SUSHI_LOG_INFO("Successfully configured engine with tracks in JSON config file \"{}\"", _document_path);
     return JsonConfigReturnStatus::OK;
 }
 
@@ -534,6 +567,10 @@ JsonConfigReturnStatus JsonConfigurator::_make_track(const rapidjson::Value &tra
 
     for(const auto& con : track_def["inputs"].GetArray())
     {
+        if (con.HasMember("track"))
+        {
+            continue;
+        }
         if (con.HasMember("engine_bus"))
         {
             status = _engine->connect_audio_input_bus(con["engine_bus"].GetInt(), con["track_bus"].GetInt(), name);
@@ -611,10 +648,66 @@ JsonConfigReturnStatus JsonConfigurator::_make_track(const rapidjson::Value &tra
                                " Chain \"{}\"", plugin_name, name);
     }
 
+    if (track_def.HasMember("pipeline_stages"))
+    {
+        status = _engine->set_track_pipeline_stages(name, track_def["pipeline_stages"].GetInt());
+        if (status != EngineReturnStatus::OK)
+        {
+            SUSHI_LOG_ERROR("Error setting pipeline stages of track {}", name);
+            return JsonConfigReturnStatus::INVALID_CONFIGURATION;
+        }
+    }
+
+    if (track_def.HasMember("double_precision"))
+    {
+        status = _engine->set_track_double_precision(name, track_def["double_precision"].GetBool());
+        if (status != EngineReturnStatus::OK)
+        {
+            SUSHI_LOG_ERROR("Error setting double precision of track {}", name);
+            return JsonConfigReturnStatus::INVALID_CONFIGURATION;
+        }
+    }
+
     SUSHI_LOG_DEBUG("Successfully added Track {} to the engine", name);
     return JsonConfigReturnStatus::OK;
 }
 
+JsonConfigReturnStatus JsonConfigurator::_connect_track_inputs(const rapidjson::Value& track_def)
+{
+    auto name = track_def["name"].GetString();
+    for(const auto& con : track_def["inputs"].GetArray())
+    {
+        if (con.HasMember("track") == false)
+        {
+            continue;
+        }
+        auto status = _engine->connect_track_bus_to_track(con["source_bus"].GetInt(), con["track"].GetString(),
+                                                          con["track_bus"].GetInt(), name);
+        if(status != EngineReturnStatus::OK)
+        {
+            SUSHI_LOG_ERROR("Error connecting track \"{}\" to track \"{}\", error {}", con["track"].GetString(),
+                            name, static_cast<int>(status));
+            return JsonConfigReturnStatus::INVALID_CONFIGURATION;
+        }
+    }
+    if (track_def.HasMember("sends"))
+    {
+        for (const auto& send : track_def["sends"].GetArray())
+        {
+            float gain = send.HasMember("gain") ? send["gain"].GetFloat() : 1.0f;
+            auto status = _engine->add_send_to_track(send["source_bus"].GetInt(), name,
+                                                     send["return_bus"].GetInt(), send["track"].GetString(), gain);
+            if (status != EngineReturnStatus::OK)
+            {
+                SUSHI_LOG_ERROR("Error adding send from track \"{}\" to track \"{}\", error {}", name,
+                                send["track"].GetString(), static_cast<int>(status));
+                return JsonConfigReturnStatus::INVALID_CONFIGURATION;
+            }
+        }
+    }
+    return JsonConfigReturnStatus::OK;
+}
+
 int JsonConfigurator::_get_midi_channel(const rapidjson::Value& channels)
 {
     if (channels.IsString())
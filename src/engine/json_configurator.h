@@ -61,6 +61,7 @@ enum class JsonSection
 
 struct AudioConfig
 {
+    std::optional<int> driver_buffer_size;
     std::optional<int> cv_inputs;
     std::optional<int> cv_outputs;
     std::optional<int> midi_inputs;
@@ -137,6 +138,13 @@ private:
      */
     std::pair<JsonConfigReturnStatus, const rapidjson::Value&> _parse_section(JsonSection section);
 
+    /**
+     * @brief Create all tracks in the tracks section and connect them. Used by load_tracks.
+     * @param tracks rapidjson array of track definitions
+     * @return JsonConfigReturnStatus::OK if success, different error code otherwise.
+     */
+    JsonConfigReturnStatus _make_tracks(const rapidjson::Value& tracks);
+
     /**
      * @brief Uses Engine's API to create a single track with the specified number of channels and adds
      *        the respective plugins to the track if they are defined in the file. Used by load_tracks.
@@ -145,6 +153,14 @@ private:
      */
     JsonConfigReturnStatus _make_track(const rapidjson::Value &track_def);
 
+    /**
+     * @brief Connect the inputs of a track that are fed from other tracks and the sends from
+     *        the track to return tracks. Used by load_tracks after all tracks have been created.
+     * @param track_def rapidjson document object representing a single track and its details.
+     * @return JsonConfigReturnStatus::OK if success, different error code otherwise.
+     */
+    JsonConfigReturnStatus _connect_track_inputs(const rapidjson::Value &track_def);
+
     /**
      * @brief Helper function to extract the number of midi channels in the midi definition.
      * @param channels rapidjson document object containing the channel information parsed from the file.
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Growable table for looking up processors by id from the realtime thread
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include "processor_table.h"
+#include "logging.h"
+
+namespace sushi {
+namespace engine {
+
+SUSHI_GET_LOGGER_WITH_MODULE_NAME("processor table");
+
+ProcessorTable::ProcessorTable()
+{
+    _directories.push_back(std::make_unique<Directory>(PROCESSOR_TABLE_INITIAL_PAGES));
+    _directory.store(_directories.back().get());
+}
+
+void ProcessorTable::reserve(ObjectId id)
+{
+    std::lock_guard<std::mutex> lock(_reserve_lock);
+    auto directory = _directory.load(std::memory_order_relaxed);
+    size_t page_index = id / PROCESSOR_TABLE_PAGE_SIZE;
+    if (page_index >= directory->size)
+    {
+        size_t size = directory->size;
+        while (size <= page_index)
+        {
+            size *= 2;
+        }
+        SUSHI_LOG_DEBUG("Growing processor table to {} pages", size);
+        auto new_directory = std::make_unique<Directory>(size);
+        for (size_t i = 0; i < directory->size; ++i)
+        {
+            new_directory->pages[i].store(directory->pages[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        directory = new_directory.get();
+        _directories.push_back(std::move(new_directory));
+        _directory.store(directory, std::memory_order_release);
+    }
+
+    Page* page = directory->pages[page_index].load(std::memory_order_relaxed);
+    if (page == nullptr)
+    {
+        if (_free_pages.empty())
+        {
+            _pages.push_back(std::make_unique<Page>());
+            page = _pages.back().get();
+        }
+        else
+        {
+            page = _free_pages.back();
+            _free_pages.pop_back();
+        }
+        for (auto& slot : page->slots)
+        {
+            slot.store(nullptr, std::memory_order_relaxed);
+        }
+        directory->pages[page_index].store(page, std::memory_order_release);
+    }
+    page->reserved++;
+}
+
+void ProcessorTable::release(ObjectId id)
+{
+    std::lock_guard<std::mutex> lock(_reserve_lock);
+    auto directory = _directory.load(std::memory_order_relaxed);
+    size_t page_index = id / PROCESSOR_TABLE_PAGE_SIZE;
+    Page* page = _page(id);
+    if (page == nullptr || page->reserved == 0)
+    {
+        SUSHI_LOG_WARNING("Releasing processor id {} which was not reserved", id);
+        return;
+    }
+    if (--page->reserved == 0)
+    {
+        directory->pages[page_index].store(nullptr, std::memory_order_release);
+        _free_pages.push_back(page);
+    }
+}
+
+bool ProcessorTable::insert(Processor* processor)
+{
+    Page* page = _page(processor->id());
+    if (page == nullptr)
+    {
+        return false;
+    }
+    auto& slot = page->slots[processor->id() % PROCESSOR_TABLE_PAGE_SIZE];
+    if (slot.load(std::memory_order_relaxed) != nullptr)
+    {
+        return false;
+    }
+    slot.store(processor, std::memory_order_release);
+    return true;
+}
+
+bool ProcessorTable::remove(ObjectId id)
+{
+    Page* page = _page(id);
+    if (page == nullptr)
+    {
+        return false;
+    }
+    auto& slot = page->slots[id % PROCESSOR_TABLE_PAGE_SIZE];
+    Processor* processor = slot.load(std::memory_order_relaxed);
+    if (processor == nullptr || processor->id() != id)
+    {
+        return false;
+    }
+    slot.store(nullptr, std::memory_order_release);
+    return true;
+}
+
+int ProcessorTable::allocated_pages() const
+{
+    std::lock_guard<std::mutex> lock(_reserve_lock);
+    return static_cast<int>(_pages.size());
+}
+
+ProcessorTable::Page* ProcessorTable::_page(ObjectId id) const
+{
+    const auto directory = _directory.load(std::memory_order_acquire);
+    size_t page_index = id / PROCESSOR_TABLE_PAGE_SIZE;
+    if (page_index >= directory->size)
+    {
+        return nullptr;
+    }
+    return directory->pages[page_index].load(std::memory_order_acquire);
+}
+
+} // namespace engine
+} // namespace sushi
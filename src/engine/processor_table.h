@@ -0,0 +1,155 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Growable table for looking up processors by id from the realtime thread
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_PROCESSOR_TABLE_H
+#define SUSHI_PROCESSOR_TABLE_H
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "library/constants.h"
+#include "library/processor.h"
+
+namespace sushi {
+namespace engine {
+
+constexpr int PROCESSOR_TABLE_PAGE_SIZE = 64;
+constexpr int PROCESSOR_TABLE_INITIAL_PAGES = 64;
+
+/**
+ * @brief Maps processor ids to processors. Processor ids are never reused, so instead of
+ *        one slot per id ever created, the slots are split in fixed size pages that are
+ *        only allocated for id ranges with live processors. Pages that no longer hold any
+ *        processors are put on a free list and reused for later id ranges. All allocations
+ *        are done when reserving ids, which is done outside of the realtime thread, so that
+ *        inserting, removing and looking up processors is realtime safe and O(1).
+ */
+class ProcessorTable
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(ProcessorTable);
+
+    ProcessorTable();
+
+    /**
+     * @brief Make room for a processor id. Must be called before the processor can be
+     *        inserted. Not safe to call from the realtime thread.
+     * @param id The processor id to reserve
+     */
+    void reserve(ObjectId id);
+
+    /**
+     * @brief Release a reserved processor id, the processor must have been removed from
+     *        the table before calling. Not safe to call from the realtime thread.
+     * @param id The processor id to release
+     */
+    void release(ObjectId id);
+
+    /**
+     * @brief Insert a processor. Realtime safe.
+     * @param processor The processor to insert, its id must have been reserved
+     * @return true if the processor was inserted, false if its id was not reserved or
+     *         a processor with the same id is already in the table
+     */
+    bool insert(Processor* processor);
+
+    /**
+     * @brief Remove a processor. Realtime safe.
+     * @param id The id of the processor to remove
+     * @return true if the processor was found and removed, false otherwise
+     */
+    bool remove(ObjectId id);
+
+    /**
+     * @brief Look up a processor. Realtime safe.
+     * @param id The id of the processor
+     * @return A pointer to the processor if found, nullptr otherwise
+     */
+    Processor* get(ObjectId id) const
+    {
+        const auto directory = _directory.load(std::memory_order_acquire);
+        auto page_index = id / PROCESSOR_TABLE_PAGE_SIZE;
+        if (page_index >= directory->size)
+        {
+            return nullptr;
+        }
+        const Page* page = directory->pages[page_index].load(std::memory_order_acquire);
+        if (page == nullptr)
+        {
+            return nullptr;
+        }
+        Processor* processor = page->slots[id % PROCESSOR_TABLE_PAGE_SIZE].load(std::memory_order_acquire);
+        /* The page could have been recycled for another id range after the directory was read */
+        if (processor == nullptr || processor->id() != id)
+        {
+            return nullptr;
+        }
+        return processor;
+    }
+
+    /**
+     * @brief Get the number of allocated pages, including pages on the free list.
+     * @return The number of pages
+     */
+    int allocated_pages() const;
+
+private:
+    struct Page
+    {
+        std::array<std::atomic<Processor*>, PROCESSOR_TABLE_PAGE_SIZE> slots;
+        /* Number of reserved ids in the page, only accessed with _reserve_lock held */
+        int reserved{0};
+    };
+
+    struct Directory
+    {
+        explicit Directory(size_t size) : size(size), pages(std::make_unique<std::atomic<Page*>[]>(size))
+        {
+            for (size_t i = 0; i < size; ++i)
+            {
+                pages[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        size_t size;
+        std::unique_ptr<std::atomic<Page*>[]> pages;
+    };
+
+    Page* _page(ObjectId id) const;
+
+    std::atomic<Directory*> _directory{nullptr};
+
+    /* Guards everything below, which is only used outside of the realtime thread */
+    mutable std::mutex _reserve_lock;
+    /* Replaced directories are kept as the realtime thread might still be reading them.
+     * Directories grow by doubling in size, so these never use more memory than the current one */
+    std::vector<std::unique_ptr<Directory>> _directories;
+    /* Pages are never deallocated, only reused, for the same reason */
+    std::vector<std::unique_ptr<Page>> _pages;
+    std::vector<Page*> _free_pages;
+};
+
+} // namespace engine
+} // namespace sushi
+
+#endif //SUSHI_PROCESSOR_TABLE_H
@@ -112,9 +112,20 @@ bool Track::add(Processor* processor)
     _processors.push_back(processor);
     processor->set_event_output(this);
     _update_channel_config();
+    _update_pipeline();
     return true;
 }
 
+int Track::latency() const
+{
+    int latency = pipeline_latency() * AUDIO_CHUNK_SIZE;
+    for (const auto& processor : _processors)
+    {
+        latency += processor->latency();
+    }
+    return latency;
+}
+
 bool Track::remove(ObjectId processor)
 {
     for (auto plugin = _processors.begin(); plugin != _processors.end(); ++plugin)
@@ -124,6 +135,7 @@ bool Track::remove(ObjectId processor)
             (*plugin)->set_event_output(nullptr);
             _processors.erase(plugin);
             _update_channel_config();
+            _update_pipeline();
             return true;
         }
     }
@@ -132,6 +144,26 @@ bool Track::remove(ObjectId processor)
 
 void Track::render()
 {
+    if (_pipeline)
+    {
+        for (int stage = 0; stage < _pipeline_stages; ++stage)
+        {
+            render_stage(stage);
+        }
+        advance_pipeline();
+        return;
+    }
+    if (_idle())
+    {
+        /* All processors are asleep and there is nothing to wake them, so the output is silent */
+        _output_buffer.clear();
+        for (int bus = 0; bus < _output_busses; ++bus)
+        {
+            _skip_pan_and_gain(bus);
+        }
+        _timer->skip_timer_rt_safe(this->id());
+        return;
+    }
     process_audio(_input_buffer, _output_buffer);
     for (int bus = 0; bus < _output_busses; ++bus)
     {
@@ -140,45 +172,116 @@ void Track::render()
     }
 }
 
-void Track::process_audio(const ChunkSampleBuffer& /*in*/, ChunkSampleBuffer& out)
+bool Track::set_pipeline_stages(int stages)
 {
-    auto track_timestamp = _timer->start_timer();
-    /* For Tracks, process function is called from render() and the input audio data
-     * should be copied to _input_buffer prior to this call.
-     * We alias the buffers so we can swap them cheaply, without copying the underlying
-     * data, though we can't alias in since it is const, even though it points to
-     * _input_buffer  */
-    ChunkSampleBuffer aliased_in = ChunkSampleBuffer::create_non_owning_buffer(_input_buffer);
-    ChunkSampleBuffer aliased_out = ChunkSampleBuffer::create_non_owning_buffer(out);
+    if (stages < 1 || stages > TRACK_MAX_PIPELINE_STAGES)
+    {
+        return false;
+    }
+    _pipeline_stages = stages;
+    _update_double_precision_buffers();
+    if (stages == 1)
+    {
+        _pipeline.reset();
+        for (auto& processor : _processors)
+        {
+            processor->set_event_output(this);
+        }
+        return true;
+    }
+    _pipeline = std::make_unique<Pipeline>();
+    for (auto& buffers : _pipeline->buffers)
+    {
+        for (auto& buffer : buffers)
+        {
+            buffer = ChunkSampleBuffer(_input_buffer.channel_count());
+        }
+    }
+    _update_pipeline();
+    return true;
+}
 
-    for (auto &processor : _processors)
+void Track::set_double_precision(bool enabled)
+{
+    _double_precision = enabled;
+    for (auto& processor : _processors)
     {
-        auto processor_timestamp = _timer->start_timer();
-        while (!_kb_event_buffer.empty())
+        if (processor->supports_double_precision())
         {
-            RtEvent event;
-            if (_kb_event_buffer.pop(event))
-            {
-                processor->process_event(event);
-            }
+            processor->set_double_precision(enabled);
         }
-        ChunkSampleBuffer proc_in = ChunkSampleBuffer::create_non_owning_buffer(aliased_in, 0, processor->input_channels());
-        ChunkSampleBuffer proc_out = ChunkSampleBuffer::create_non_owning_buffer(aliased_out, 0, processor->output_channels());
-        processor->process_audio(proc_in, proc_out);
-        std::swap(aliased_in, aliased_out);
-        _timer->stop_timer_rt_safe(processor_timestamp, processor->id());
     }
+    _update_double_precision_buffers();
+}
 
-    int output_channels = _processors.empty() ? _current_output_channels : _processors.back()->output_channels();
+void Track::render_stage(int stage)
+{
+    assert(_pipeline && stage < _pipeline_stages);
+    auto& pipeline_stage = _pipeline->stages[stage];
+    int write_index = _pipeline->write_index;
+    int read_index = 1 - write_index;
+    bool last_stage = stage == _pipeline_stages - 1;
+
+    RtSafeRtEventFifo& kb_input = stage == 0 ? _kb_event_buffer : _pipeline->events[stage - 1][read_index];
+    RtEvent event;
+    while (kb_input.pop(event))
+    {
+        pipeline_stage.kb_events.push(event);
+    }
 
-    if (output_channels > 0)
+    /* The input buffer is used as scratch space during processing, this is fine since
+     * it is not read again until it has been written by the previous stage */
+    ChunkSampleBuffer& in = stage == 0 ? _input_buffer : _pipeline->buffers[stage - 1][read_index];
+    ChunkSampleBuffer& out = last_stage ? _output_buffer : _pipeline->buffers[stage][write_index];
+    _process_processors(pipeline_stage.first_processor, pipeline_stage.last_processor, in, out,
+                        pipeline_stage.kb_events, stage);
+
+    if (last_stage)
     {
-        aliased_out.replace(aliased_in);
+        for (int bus = 0; bus < _output_busses; ++bus)
+        {
+            auto buffer = ChunkSampleBuffer::create_non_owning_buffer(_output_buffer, bus * 2, 2);
+            _apply_pan_and_gain(buffer, bus);
+        }
     }
     else
     {
-        aliased_out.clear();
+        auto& kb_output = _pipeline->events[stage][write_index];
+        while (pipeline_stage.kb_events.pop(event))
+        {
+            kb_output.push(event);
+        }
+    }
+}
+
+void Track::advance_pipeline()
+{
+    assert(_pipeline);
+    RtEvent event;
+    for (int stage = 0; stage < _pipeline_stages; ++stage)
+    {
+        auto& pipeline_stage = _pipeline->stages[stage];
+        while (pipeline_stage.output_events.pop(event))
+        {
+            output_event(event);
+        }
     }
+    /* Keyboard events not consumed by the last stage are passed on from the track */
+    auto& last_stage = _pipeline->stages[_pipeline_stages - 1];
+    while (last_stage.kb_events.pop(event))
+    {
+        _kb_event_buffer.push(event);
+    }
+    _process_output_events();
+    _pipeline->write_index = 1 - _pipeline->write_index;
+}
+
+void Track::process_audio(const ChunkSampleBuffer& /*in*/, ChunkSampleBuffer& out)
+{
+    auto track_timestamp = _timer->start_timer();
+    /* For Tracks, process function is called from render() and the input audio data
+     * should be copied to _input_buffer prior to this call. */
+    _process_processors(0, static_cast<int>(_processors.size()), _input_buffer, out, _kb_event_buffer, 0);
 
     /* If there are keyboard events not consumed, pass them on upwards so the engine can process them */
     _process_output_events();
@@ -306,6 +409,155 @@ void Track::_update_channel_config()
     }
 }
 
+void Track::_update_pipeline()
+{
+    if (_pipeline == nullptr)
+    {
+        return;
+    }
+    /* Spread the processors evenly over the stages */
+    int processors = static_cast<int>(_processors.size());
+    for (int stage = 0; stage < _pipeline_stages; ++stage)
+    {
+        auto& pipeline_stage = _pipeline->stages[stage];
+        pipeline_stage.first_processor = processors * stage / _pipeline_stages;
+        pipeline_stage.last_processor = processors * (stage + 1) / _pipeline_stages;
+        for (int i = pipeline_stage.first_processor; i < pipeline_stage.last_processor; ++i)
+        {
+            _processors[i]->set_event_output(&pipeline_stage);
+        }
+    }
+}
+
+void Track::_process_processors(int first, int last, ChunkSampleBuffer& in, ChunkSampleBuffer& out,
+                                RtSafeRtEventFifo& kb_events, int stage)
+{
+    if (_double_precision == false)
+    {
+        _process_chain(first, last, in, out, kb_events, nullptr);
+        return;
+    }
+    auto& buffers = _double_precision_buffers[stage];
+    auto double_in = DoubleChunkSampleBuffer::create_non_owning_buffer(buffers.in, 0, in.channel_count());
+    auto double_out = DoubleChunkSampleBuffer::create_non_owning_buffer(buffers.out, 0, out.channel_count());
+    double_in.convert_from(in);
+    _process_chain(first, last, double_in, double_out, kb_events, &buffers);
+    out.convert_from(double_out);
+}
+
+template<typename BufferType>
+void Track::_process_chain(int first, int last, BufferType& in, BufferType& out,
+                           RtSafeRtEventFifo& kb_events, DoublePrecisionBuffers* double_buffers)
+{
+    /* We alias the buffers so we can swap them cheaply, without copying the underlying data */
+    BufferType aliased_in = BufferType::create_non_owning_buffer(in);
+    BufferType aliased_out = BufferType::create_non_owning_buffer(out);
+
+    for (int i = first; i < last; ++i)
+    {
+        auto processor = _processors[i];
+        BufferType proc_in = BufferType::create_non_owning_buffer(aliased_in, 0, processor->input_channels());
+        BufferType proc_out = BufferType::create_non_owning_buffer(aliased_out, 0, processor->output_channels());
+        if (processor->sleeping() && (!kb_events.empty() || !proc_in.is_silent()))
+        {
+            processor->wake_up();
+        }
+        if (processor->sleeping())
+        {
+            /* A sleeping processor has silent output by definition */
+            proc_out.clear();
+            std::swap(aliased_in, aliased_out);
+            _timer->skip_timer_rt_safe(processor->id());
+            continue;
+        }
+        auto processor_timestamp = _timer->start_timer();
+        while (!kb_events.empty())
+        {
+            RtEvent event;
+            if (kb_events.pop(event))
+            {
+                processor->process_event(event);
+            }
+        }
+        _process_processor(processor, proc_in, proc_out, double_buffers);
+        processor->update_sleep_state(proc_in, proc_out);
+        std::swap(aliased_in, aliased_out);
+        _timer->stop_timer_rt_safe(processor_timestamp, processor->id());
+    }
+
+    int output_channels = _current_output_channels;
+    if (last > 0)
+    {
+        output_channels = _processors[last - 1]->output_channels();
+    }
+
+    if (output_channels > 0)
+    {
+        aliased_out.replace(aliased_in);
+    }
+    else
+    {
+        aliased_out.clear();
+    }
+}
+
+void Track::_process_processor(Processor* processor, const ChunkSampleBuffer& in, ChunkSampleBuffer& out,
+                               DoublePrecisionBuffers* /*double_buffers*/)
+{
+    processor->process_audio(in, out);
+}
+
+void Track::_process_processor(Processor* processor, const DoubleChunkSampleBuffer& in, DoubleChunkSampleBuffer& out,
+                               DoublePrecisionBuffers* double_buffers)
+{
+    if (processor->supports_double_precision())
+    {
+        processor->process_audio_double(in, out);
+        return;
+    }
+    auto float_in = ChunkSampleBuffer::create_non_owning_buffer(double_buffers->float_in, 0, in.channel_count());
+    auto float_out = ChunkSampleBuffer::create_non_owning_buffer(double_buffers->float_out, 0, out.channel_count());
+    float_in.convert_from(in);
+    processor->process_audio(float_in, float_out);
+    out.convert_from(float_out);
+}
+
+void Track::_update_double_precision_buffers()
+{
+    _double_precision_buffers.clear();
+    if (_double_precision)
+    {
+        for (int stage = 0; stage < _pipeline_stages; ++stage)
+        {
+            _double_precision_buffers.emplace_back(_input_buffer.channel_count());
+        }
+    }
+}
+
+bool Track::_idle()
+{
+    for (const auto& processor : _processors)
+    {
+        if (processor->sleeping() == false)
+        {
+            return false;
+        }
+    }
+    return _kb_event_buffer.empty() && _input_buffer.is_silent();
+}
+
+void Track::PipelineStage::send_event(const RtEvent& event)
+{
+    if (is_keyboard_event(event))
+    {
+        kb_events.push(event);
+    }
+    else
+    {
+        output_events.push(event);
+    }
+}
+
 void Track::_process_output_events()
 {
     while (!_kb_event_buffer.empty())
@@ -388,5 +640,16 @@ void Track::_apply_pan_and_gain(ChunkSampleBuffer& buffer, int bus)
     }
 }
 
+void Track::_skip_pan_and_gain(int bus)
+{
+    float gain = _gain_parameters[bus]->processed_value();
+    float pan = _pan_parameters[bus]->processed_value();
+    auto [left_gain, right_gain] = calc_l_r_gain(gain, pan);
+    _pan_gain_smoothers_left[bus].set(left_gain);
+    _pan_gain_smoothers_right[bus].set(right_gain);
+    _pan_gain_smoothers_left[bus].next_value();
+    _pan_gain_smoothers_right[bus].next_value();
+}
+
 } // namespace engine
 } // namespace sushi
@@ -40,6 +40,8 @@ namespace engine {
 /* No real technical limit, just something arbitrarily high enough */
 constexpr int TRACK_MAX_CHANNELS = 10;
 constexpr int TRACK_MAX_BUSSES = TRACK_MAX_CHANNELS / 2;
+/* Each pipeline stage after the first adds one chunk of latency */
+constexpr int TRACK_MAX_PIPELINE_STAGES = 4;
 
 class Track : public InternalPlugin, public RtEventPipe
 {
@@ -68,7 +70,9 @@ public:
     void configure(float sample_rate) override;
 
     /**
-     * @brief Adds a plugin to the end of the track.
+     * @brief Adds a plugin to the end of the track. Called from the audio thread when
+     *        the engine is running, so the plugin must already be set to the precision
+     *        of the track.
      * @param The plugin to add.
      */
     bool add(Processor* processor);
@@ -172,6 +176,75 @@ public:
      */
     void render();
 
+    /**
+     * @brief Split the processors of the track into stages that can be rendered in parallel,
+     *        on different cores, with each stage processing the output of the previous stage
+     *        from the previous chunk. Every stage after the first adds one chunk of latency.
+     *        Not safe to call while the engine is running.
+     * @param stages The number of stages, 1 disables pipelining.
+     * @return true if successful, false if the number of stages is out of range
+     */
+    bool set_pipeline_stages(int stages);
+
+    /**
+     * @brief Get the number of pipeline stages of the track.
+     * @return The number of pipeline stages, 1 if pipelining is not enabled
+     */
+    int pipeline_stages() const
+    {
+        return _pipeline_stages;
+    }
+
+    /**
+     * @brief Process the audio of the track in double precision. The input is converted
+     *        to double precision before the first processor and back to single precision
+     *        after the last, so that only this track pays for the conversion. Processors
+     *        that support double precision process natively, others are passed converted
+     *        single precision buffers. Not safe to call while the engine is running.
+     * @param enabled True to process in double precision.
+     */
+    void set_double_precision(bool enabled);
+
+    /**
+     * @brief Check if the track processes audio in double precision.
+     */
+    bool double_precision() const
+    {
+        return _double_precision;
+    }
+
+    /**
+     * @brief Get the latency added by pipelining.
+     * @return The latency in number of chunks
+     */
+    int pipeline_latency() const
+    {
+        return _pipeline_stages - 1;
+    }
+
+    /**
+     * @brief Get the total latency of the track, i.e. the sum of the latencies of all
+     *        processors on the track plus the latency added by pipelining.
+     * @return The latency in samples
+     */
+    int latency() const override;
+
+    /**
+     * @brief Render one pipeline stage of the track. Different stages can be rendered
+     *        concurrently from different threads. Should only be called if pipelining is
+     *        enabled, and advance_pipeline() must be called once all stages have been
+     *        rendered.
+     * @param stage The index of the stage to render.
+     */
+    void render_stage(int stage);
+
+    /**
+     * @brief Pass on audio and events between pipeline stages and forward events output
+     *        from the stages. Should be called once every chunk after all pipeline stages
+     *        have been rendered.
+     */
+    void advance_pipeline();
+
     /**
      * @brief Static render function for passing to a thread manager
      * @param arg Void* pointing to an instance of a Track.
@@ -209,10 +282,61 @@ public:
     void send_event(const RtEvent& event) override;
 
 private:
+    /* Processors in a pipeline stage send their events here instead of to the
+     * track, since stages can be rendered concurrently from different threads */
+    class PipelineStage : public RtEventPipe
+    {
+    public:
+        void send_event(const RtEvent& event) override;
+
+        int first_processor{0};
+        int last_processor{0};
+        RtSafeRtEventFifo kb_events;
+        RtSafeRtEventFifo output_events;
+    };
+
+    struct Pipeline
+    {
+        std::array<PipelineStage, TRACK_MAX_PIPELINE_STAGES> stages;
+        /* Audio and keyboard events passed on between stages are double buffered,
+         * stage n writes to one buffer while stage n + 1 reads from the other */
+        std::array<std::array<ChunkSampleBuffer, 2>, TRACK_MAX_PIPELINE_STAGES - 1> buffers;
+        std::array<std::array<RtSafeRtEventFifo, 2>, TRACK_MAX_PIPELINE_STAGES - 1> events;
+        int write_index{0};
+    };
+
+    /* Buffers for double precision processing, one set per pipeline stage since the
+     * stages can be rendered concurrently. Processors that only support single precision
+     * process via the float buffers. */
+    struct DoublePrecisionBuffers
+    {
+        DoublePrecisionBuffers(int channels) : in{channels}, out{channels}, float_in{channels}, float_out{channels} {}
+
+        DoubleChunkSampleBuffer in;
+        DoubleChunkSampleBuffer out;
+        ChunkSampleBuffer float_in;
+        ChunkSampleBuffer float_out;
+    };
+
     void _common_init();
     void _update_channel_config();
+    void _update_pipeline();
+    void _update_double_precision_buffers();
+    /* True if all processors are sleeping and there is no input that would wake them */
+    bool _idle();
+    void _process_processors(int first, int last, ChunkSampleBuffer& in, ChunkSampleBuffer& out,
+                             RtSafeRtEventFifo& kb_events, int stage);
+    template<typename BufferType>
+    void _process_chain(int first, int last, BufferType& in, BufferType& out,
+                        RtSafeRtEventFifo& kb_events, DoublePrecisionBuffers* double_buffers);
+    void _process_processor(Processor* processor, const ChunkSampleBuffer& in, ChunkSampleBuffer& out,
+                            DoublePrecisionBuffers* double_buffers);
+    void _process_processor(Processor* processor, const DoubleChunkSampleBuffer& in, DoubleChunkSampleBuffer& out,
+                            DoublePrecisionBuffers* double_buffers);
     void _process_output_events();
     void _apply_pan_and_gain(ChunkSampleBuffer& buffer, int bus);
+    /* Advance the pan and gain smoothers one chunk when the track is not rendered */
+    void _skip_pan_and_gain(int bus);
 
     std::vector<Processor*> _processors;
     ChunkSampleBuffer _input_buffer;
@@ -227,6 +351,12 @@ private:
     std::array<ValueSmootherFilter<float>, TRACK_MAX_BUSSES> _pan_gain_smoothers_right;
     std::array<ValueSmootherFilter<float>, TRACK_MAX_BUSSES> _pan_gain_smoothers_left;
 
+    int _pipeline_stages{1};
+    std::unique_ptr<Pipeline> _pipeline;
+
+    bool _double_precision{false};
+    std::vector<DoublePrecisionBuffers> _double_precision_buffers;
+
     performance::PerformanceTimer* _timer;
 
     RtSafeRtEventFifo _kb_event_buffer;
@@ -33,6 +33,8 @@ struct ProcessTimings
     float avg_case{1};
     float min_case{1};
     float max_case{0};
+    /* The fraction of process calls that were skipped because the node was sleeping */
+    float skip_rate{0};
 };
 
 class BasePerformanceTimer
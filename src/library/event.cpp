@@ -26,6 +26,9 @@
 
 namespace sushi {
 
+/* The largest event, which should fit in a block of the event pool */
+static_assert(sizeof(AddProcessorEvent) <= EVENT_POOL_BLOCK_SIZES.back());
+
 Event* Event::from_rt_event(RtEvent& rt_event, Time timestamp)
 {
     switch (rt_event.type())
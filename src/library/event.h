@@ -28,6 +28,7 @@
 #include "library/rt_event.h"
 #include "library/time.h"
 #include "library/types.h"
+#include "library/event_pool.h"
 
 namespace sushi {
 namespace dispatcher {class EventDispatcher;};
@@ -61,6 +62,18 @@ public:
 
     virtual ~Event() {}
 
+    /* Events are created and deleted at high rates, so their memory comes from a pool.
+     * As the destructor is virtual, delete is passed the size of the most derived class */
+    static void* operator new(std::size_t size)
+    {
+        return EventPool::instance().allocate(size);
+    }
+
+    static void operator delete(void* ptr, std::size_t size)
+    {
+        EventPool::instance().deallocate(ptr, size);
+    }
+
     /**
      * @brief Creates an Event from its RtEvent counterpart if possible
      * @param rt_event The RtEvent to convert from
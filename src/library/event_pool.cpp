@@ -0,0 +1,119 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Slab allocator for non-rt Events
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <new>
+
+#include "event_pool.h"
+
+namespace sushi {
+
+static_assert(EVENT_POOL_BLOCK_SIZES[0] % alignof(std::max_align_t) == 0);
+static_assert(EVENT_POOL_BLOCK_SIZES[0] >= sizeof(void*));
+
+EventPool& EventPool::instance()
+{
+    /* Never destroyed, as Events still in queues when sushi exits are deleted late */
+    static auto pool = new EventPool();
+    return *pool;
+}
+
+void* EventPool::allocate(size_t size)
+{
+    int index = _size_class(size);
+    if (index < 0)
+    {
+        return ::operator new(size);
+    }
+    auto& size_class = _size_classes[index];
+    std::lock_guard<std::mutex> lock(size_class.lock);
+    if (size_class.free_blocks == nullptr)
+    {
+        _add_slab(size_class, EVENT_POOL_BLOCK_SIZES[index]);
+    }
+    FreeBlock* block = size_class.free_blocks;
+    size_class.free_blocks = block->next;
+    size_class.blocks_in_use++;
+    size_class.peak_blocks_in_use = std::max(size_class.peak_blocks_in_use, size_class.blocks_in_use);
+    return block;
+}
+
+void EventPool::deallocate(void* ptr, size_t size)
+{
+    if (ptr == nullptr)
+    {
+        return;
+    }
+    int index = _size_class(size);
+    if (index < 0)
+    {
+        ::operator delete(ptr);
+        return;
+    }
+    auto& size_class = _size_classes[index];
+    std::lock_guard<std::mutex> lock(size_class.lock);
+    auto block = static_cast<FreeBlock*>(ptr);
+    block->next = size_class.free_blocks;
+    size_class.free_blocks = block;
+    size_class.blocks_in_use--;
+}
+
+std::vector<EventPoolUsage> EventPool::usage() const
+{
+    std::vector<EventPoolUsage> usage;
+    for (size_t i = 0; i < _size_classes.size(); ++i)
+    {
+        const auto& size_class = _size_classes[i];
+        std::lock_guard<std::mutex> lock(size_class.lock);
+        usage.push_back({EVENT_POOL_BLOCK_SIZES[i],
+                         static_cast<int>(size_class.slabs.size()) * EVENT_POOL_BLOCKS_PER_SLAB,
+                         size_class.blocks_in_use,
+                         size_class.peak_blocks_in_use});
+    }
+    return usage;
+}
+
+int EventPool::_size_class(size_t size)
+{
+    for (size_t i = 0; i < EVENT_POOL_BLOCK_SIZES.size(); ++i)
+    {
+        if (size <= EVENT_POOL_BLOCK_SIZES[i])
+        {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void EventPool::_add_slab(SizeClass& size_class, size_t block_size)
+{
+    /* Memory from new[] is aligned for any type, and all block sizes are multiples of
+     * that alignment, so every block is too */
+    auto slab = std::make_unique<std::byte[]>(block_size * EVENT_POOL_BLOCKS_PER_SLAB);
+    for (int i = EVENT_POOL_BLOCKS_PER_SLAB - 1; i >= 0; --i)
+    {
+        auto block = reinterpret_cast<FreeBlock*>(slab.get() + i * block_size);
+        block->next = size_class.free_blocks;
+        size_class.free_blocks = block;
+    }
+    size_class.slabs.push_back(std::move(slab));
+}
+
+} // namespace sushi
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Slab allocator for non-rt Events
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_EVENT_POOL_H
+#define SUSHI_EVENT_POOL_H
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "library/constants.h"
+
+namespace sushi {
+
+/* Every Event subclass fits in the largest block size */
+constexpr std::array<size_t, 3> EVENT_POOL_BLOCK_SIZES = {64, 128, 256};
+constexpr int EVENT_POOL_BLOCKS_PER_SLAB = 256;
+
+struct EventPoolUsage
+{
+    size_t  block_size;
+    int     blocks;
+    int     blocks_in_use;
+    int     peak_blocks_in_use;
+};
+
+/**
+ * @brief Allocates memory for Events from slabs of equally sized blocks, one set of
+ *        slabs for every size in EVENT_POOL_BLOCK_SIZES. Freed blocks are kept in a
+ *        free list and reused, and slabs are never returned to the system, so after
+ *        the first burst of events no more heap allocations are made, and events
+ *        created and deleted at high rates do not fragment the heap. Allocations larger
+ *        than the largest block size fall back to the heap. Safe to call from any
+ *        non-rt thread.
+ */
+class EventPool
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(EventPool);
+
+    EventPool() = default;
+
+    /**
+     * @brief Get the pool used by all Events
+     */
+    static EventPool& instance();
+
+    /**
+     * @brief Allocate memory for an object. Not realtime safe.
+     * @param size The size of the object in bytes
+     * @return A pointer to at least size bytes, aligned for any type
+     */
+    void* allocate(size_t size);
+
+    /**
+     * @brief Return memory to the pool. Not realtime safe.
+     * @param ptr A pointer returned by allocate(), may be nullptr
+     * @param size The same size that was passed to allocate()
+     */
+    void deallocate(void* ptr, size_t size);
+
+    /**
+     * @brief Get the usage of every block size, in the order of EVENT_POOL_BLOCK_SIZES
+     */
+    std::vector<EventPoolUsage> usage() const;
+
+private:
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct SizeClass
+    {
+        mutable std::mutex lock;
+        FreeBlock* free_blocks{nullptr};
+        std::vector<std::unique_ptr<std::byte[]>> slabs;
+        int blocks_in_use{0};
+        int peak_blocks_in_use{0};
+    };
+
+    /* Returns -1 if size is larger than the largest block size */
+    static int _size_class(size_t size);
+
+    void _add_slab(SizeClass& size_class, size_t block_size);
+
+    std::array<SizeClass, EVENT_POOL_BLOCK_SIZES.size()> _size_classes;
+};
+
+} // namespace sushi
+
+#endif //SUSHI_EVENT_POOL_H
@@ -0,0 +1,376 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Conversion between interleaved audio in different sample formats and
+ *        non-interleaved float audio
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SUSHI_INTERLEAVE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SUSHI_INTERLEAVE_NEON
+#endif
+
+#include "interleaving.h"
+
+namespace sushi {
+
+namespace {
+
+/* Frames converted at a time, so that each channel is written one cache line at a time
+ * while the interleaved frames being read stay in the cache */
+constexpr int TILE_FRAMES = 16;
+
+/* Sample format traits, converting to and from floats in [-1, 1) before applying gain */
+struct Int16Format
+{
+    static constexpr int SIZE = 2;
+    static constexpr float SCALE = 32768.0f;
+
+    static float read(const uint8_t* data)
+    {
+        int16_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static void write(uint8_t* data, float value)
+    {
+        auto sample = static_cast<int16_t>(std::lrint(std::clamp(value, -SCALE, SCALE - 1.0f)));
+        std::memcpy(data, &sample, sizeof(sample));
+    }
+};
+
+struct Int24Format
+{
+    static constexpr int SIZE = 3;
+    static constexpr float SCALE = 8388608.0f;
+
+    static float read(const uint8_t* data)
+    {
+        /* Shift up to the top of an int32 and back to sign extend */
+        uint32_t value = uint32_t{data[0]} << 8 | uint32_t{data[1]} << 16 | uint32_t{data[2]} << 24;
+        return static_cast<int32_t>(value) >> 8;
+    }
+
+    static void write(uint8_t* data, float value)
+    {
+        auto sample = static_cast<int32_t>(std::lrint(std::clamp(value, -SCALE, SCALE - 1.0f)));
+        data[0] = sample & 0xff;
+        data[1] = (sample >> 8) & 0xff;
+        data[2] = (sample >> 16) & 0xff;
+    }
+};
+
+struct Int32Format
+{
+    static constexpr int SIZE = 4;
+    static constexpr float SCALE = 2147483648.0f;
+    /* The largest float that fits in an int32 */
+    static constexpr float MAX_VALUE = 2147483520.0f;
+
+    static float read(const uint8_t* data)
+    {
+        int32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return static_cast<float>(value);
+    }
+
+    static void write(uint8_t* data, float value)
+    {
+        auto sample = static_cast<int32_t>(std::lrint(std::clamp(value, -SCALE, MAX_VALUE)));
+        std::memcpy(data, &sample, sizeof(sample));
+    }
+};
+
+struct Float32Format
+{
+    static constexpr int SIZE = 4;
+    static constexpr float SCALE = 1.0f;
+
+    static float read(const uint8_t* data)
+    {
+        float value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    static void write(uint8_t* data, float value)
+    {
+        std::memcpy(data, &value, sizeof(value));
+    }
+};
+
+template <class Format>
+void deinterleave_generic(const uint8_t* source, int channels, int frames, float* dest, int channel_stride, float gain)
+{
+    float scale = gain / Format::SCALE;
+    for (int tile = 0; tile < frames; tile += TILE_FRAMES)
+    {
+        int tile_end = std::min(tile + TILE_FRAMES, frames);
+        for (int c = 0; c < channels; ++c)
+        {
+            float* out = dest + c * channel_stride;
+            for (int n = tile; n < tile_end; ++n)
+            {
+                out[n] = Format::read(source + (n * channels + c) * Format::SIZE) * scale;
+            }
+        }
+    }
+}
+
+template <class Format>
+void interleave_generic(const float* source, int channel_stride, int channels, int frames, uint8_t* dest, float gain)
+{
+    float scale = gain * Format::SCALE;
+    for (int tile = 0; tile < frames; tile += TILE_FRAMES)
+    {
+        int tile_end = std::min(tile + TILE_FRAMES, frames);
+        for (int c = 0; c < channels; ++c)
+        {
+            const float* in = source + c * channel_stride;
+            for (int n = tile; n < tile_end; ++n)
+            {
+                Format::write(dest + (n * channels + c) * Format::SIZE, in[n] * scale);
+            }
+        }
+    }
+}
+
+#if defined(SUSHI_INTERLEAVE_SSE2) || defined(SUSHI_INTERLEAVE_NEON)
+#define SUSHI_INTERLEAVE_VECTORISED
+
+#ifdef SUSHI_INTERLEAVE_SSE2
+using float4 = __m128;
+
+inline float4 load4(const float* data) {return _mm_loadu_ps(data);}
+
+inline void store4(float* data, float4 value) {_mm_storeu_ps(data, value);}
+
+inline float4 mul4(float4 value, float gain) {return _mm_mul_ps(value, _mm_set1_ps(gain));}
+
+inline void transpose4(float4& r0, float4& r1, float4& r2, float4& r3)
+{
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+}
+
+/* l0 r0 l1 r1, l2 r2 l3 r3 -> l0 l1 l2 l3, r0 r1 r2 r3 */
+inline void unzip2(float4 a, float4 b, float4& left, float4& right)
+{
+    left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+    right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+inline void zip2(float4 left, float4 right, float4& a, float4& b)
+{
+    a = _mm_unpacklo_ps(left, right);
+    b = _mm_unpackhi_ps(left, right);
+}
+#else
+using float4 = float32x4_t;
+
+inline float4 load4(const float* data) {return vld1q_f32(data);}
+
+inline void store4(float* data, float4 value) {vst1q_f32(data, value);}
+
+inline float4 mul4(float4 value, float gain) {return vmulq_n_f32(value, gain);}
+
+inline void transpose4(float4& r0, float4& r1, float4& r2, float4& r3)
+{
+    float32x4x2_t t01 = vtrnq_f32(r0, r1);
+    float32x4x2_t t23 = vtrnq_f32(r2, r3);
+    r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+}
+
+inline void unzip2(float4 a, float4 b, float4& left, float4& right)
+{
+    float32x4x2_t unzipped = vuzpq_f32(a, b);
+    left = unzipped.val[0];
+    right = unzipped.val[1];
+}
+
+inline void zip2(float4 left, float4 right, float4& a, float4& b)
+{
+    float32x4x2_t zipped = vzipq_f32(left, right);
+    a = zipped.val[0];
+    b = zipped.val[1];
+}
+#endif
+
+void deinterleave_stereo(const float* source, int frames, float* dest, int channel_stride, float gain)
+{
+    float* left = dest;
+    float* right = dest + channel_stride;
+    for (int n = 0; n < frames; n += 4)
+    {
+        float4 l;
+        float4 r;
+        unzip2(load4(source + 2 * n), load4(source + 2 * n + 4), l, r);
+        store4(left + n, mul4(l, gain));
+        store4(right + n, mul4(r, gain));
+    }
+}
+
+void interleave_stereo(const float* source, int channel_stride, int frames, float* dest, float gain)
+{
+    const float* left = source;
+    const float* right = source + channel_stride;
+    for (int n = 0; n < frames; n += 4)
+    {
+        float4 a;
+        float4 b;
+        zip2(mul4(load4(left + n), gain), mul4(load4(right + n), gain), a, b);
+        store4(dest + 2 * n, a);
+        store4(dest + 2 * n + 4, b);
+    }
+}
+
+/* Transpose blocks of 4 frames by 4 channels */
+void deinterleave_4x4(const float* source, int channels, int frames, float* dest, int channel_stride, float gain)
+{
+    for (int n = 0; n < frames; n += 4)
+    {
+        for (int c = 0; c < channels; c += 4)
+        {
+            const float* in = source + n * channels + c;
+            float4 r0 = load4(in);
+            float4 r1 = load4(in + channels);
+            float4 r2 = load4(in + 2 * channels);
+            float4 r3 = load4(in + 3 * channels);
+            transpose4(r0, r1, r2, r3);
+            float* out = dest + c * channel_stride + n;
+            store4(out, mul4(r0, gain));
+            store4(out + channel_stride, mul4(r1, gain));
+            store4(out + 2 * channel_stride, mul4(r2, gain));
+            store4(out + 3 * channel_stride, mul4(r3, gain));
+        }
+    }
+}
+
+void interleave_4x4(const float* source, int channel_stride, int channels, int frames, float* dest, float gain)
+{
+    for (int n = 0; n < frames; n += 4)
+    {
+        for (int c = 0; c < channels; c += 4)
+        {
+            const float* in = source + c * channel_stride + n;
+            float4 r0 = mul4(load4(in), gain);
+            float4 r1 = mul4(load4(in + channel_stride), gain);
+            float4 r2 = mul4(load4(in + 2 * channel_stride), gain);
+            float4 r3 = mul4(load4(in + 3 * channel_stride), gain);
+            transpose4(r0, r1, r2, r3);
+            float* out = dest + n * channels + c;
+            store4(out, r0);
+            store4(out + channels, r1);
+            store4(out + 2 * channels, r2);
+            store4(out + 3 * channels, r3);
+        }
+    }
+}
+#endif
+
+} // anonymous namespace
+
+void deinterleave(const void* source, SampleFormat format, int channels, int frames,
+                  float* dest, int channel_stride, float gain)
+{
+    auto data = static_cast<const uint8_t*>(source);
+    switch (format)
+    {
+        case SampleFormat::INT16:
+            deinterleave_generic<Int16Format>(data, channels, frames, dest, channel_stride, gain);
+            break;
+
+        case SampleFormat::INT24:
+            deinterleave_generic<Int24Format>(data, channels, frames, dest, channel_stride, gain);
+            break;
+
+        case SampleFormat::INT32:
+            deinterleave_generic<Int32Format>(data, channels, frames, dest, channel_stride, gain);
+            break;
+
+        case SampleFormat::FLOAT32:
+        {
+#ifdef SUSHI_INTERLEAVE_VECTORISED
+            auto float_data = static_cast<const float*>(source);
+            if (frames % 4 == 0 && channels == 2)
+            {
+                deinterleave_stereo(float_data, frames, dest, channel_stride, gain);
+                break;
+            }
+            if (frames % 4 == 0 && channels % 4 == 0)
+            {
+                deinterleave_4x4(float_data, channels, frames, dest, channel_stride, gain);
+                break;
+            }
+#endif
+            deinterleave_generic<Float32Format>(data, channels, frames, dest, channel_stride, gain);
+            break;
+        }
+    }
+}
+
+void interleave(const float* source, int channel_stride, int channels, int frames,
+                void* dest, SampleFormat format, float gain)
+{
+    auto data = static_cast<uint8_t*>(dest);
+    switch (format)
+    {
+        case SampleFormat::INT16:
+            interleave_generic<Int16Format>(source, channel_stride, channels, frames, data, gain);
+            break;
+
+        case SampleFormat::INT24:
+            interleave_generic<Int24Format>(source, channel_stride, channels, frames, data, gain);
+            break;
+
+        case SampleFormat::INT32:
+            interleave_generic<Int32Format>(source, channel_stride, channels, frames, data, gain);
+            break;
+
+        case SampleFormat::FLOAT32:
+        {
+#ifdef SUSHI_INTERLEAVE_VECTORISED
+            auto float_data = static_cast<float*>(dest);
+            if (frames % 4 == 0 && channels == 2)
+            {
+                interleave_stereo(source, channel_stride, frames, float_data, gain);
+                break;
+            }
+            if (frames % 4 == 0 && channels % 4 == 0)
+            {
+                interleave_4x4(source, channel_stride, channels, frames, float_data, gain);
+                break;
+            }
+#endif
+            interleave_generic<Float32Format>(source, channel_stride, channels, frames, data, gain);
+            break;
+        }
+    }
+}
+
+} // namespace sushi
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Conversion between interleaved audio in different sample formats and
+ *        non-interleaved float audio
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_INTERLEAVING_H
+#define SUSHI_INTERLEAVING_H
+
+namespace sushi {
+
+/**
+ * @brief Sample formats of interleaved audio. Integers are signed and in native byte
+ *        order, except INT24 which is packed in 3 bytes, little endian.
+ */
+enum class SampleFormat
+{
+    INT16,
+    INT24,
+    INT32,
+    FLOAT32
+};
+
+/**
+ * @brief Get the size of one sample in bytes
+ */
+constexpr int sample_format_size(SampleFormat format)
+{
+    switch (format)
+    {
+        case SampleFormat::INT16:   return 2;
+        case SampleFormat::INT24:   return 3;
+        case SampleFormat::INT32:   return 4;
+        case SampleFormat::FLOAT32: return 4;
+    }
+    return 0;
+}
+
+/**
+ * @brief Convert interleaved audio to non-interleaved float audio, in one pass.
+ * @param source Interleaved audio with frames * channels samples
+ * @param format The sample format of source
+ * @param channels The number of channels in source
+ * @param frames The number of frames to convert
+ * @param dest Non-interleaved destination, channel c starts at dest + c * channel_stride
+ * @param channel_stride The distance in samples between the channels in dest
+ * @param gain Gain applied to all samples
+ */
+void deinterleave(const void* source, SampleFormat format, int channels, int frames,
+                  float* dest, int channel_stride, float gain = 1.0f);
+
+/**
+ * @brief Convert non-interleaved float audio to interleaved audio, in one pass.
+ *        Integer samples are clipped to the range of the format.
+ * @param source Non-interleaved audio, channel c starts at source + c * channel_stride
+ * @param channel_stride The distance in samples between the channels in source
+ * @param channels The number of channels to convert
+ * @param frames The number of frames to convert
+ * @param dest Interleaved destination with room for frames * channels samples
+ * @param format The sample format of dest
+ * @param gain Gain applied to all samples
+ */
+void interleave(const float* source, int channel_stride, int channels, int frames,
+                void* dest, SampleFormat format, float gain = 1.0f);
+
+} // namespace sushi
+
+#endif //SUSHI_INTERLEAVING_H
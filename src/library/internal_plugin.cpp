@@ -24,6 +24,45 @@ namespace sushi {
 
 constexpr int DEFAULT_CHANNELS = 2;
 
+SmoothedFloatParameter::SmoothedFloatParameter(FloatParameterValue* parameter,
+                                               std::chrono::microseconds lag_time) : _parameter(parameter),
+                                                                                     _lag_time(lag_time)
+{
+    set_sample_rate(0.0f);
+}
+
+void SmoothedFloatParameter::set_sample_rate(float sample_rate)
+{
+    _smoother.set_lag_time(_lag_time, sample_rate);
+    _target = _parameter->processed_value();
+    _smoother.set_direct(_target);
+    _buffer.fill(_target);
+    _stationary = true;
+}
+
+const float* SmoothedFloatParameter::render()
+{
+    float target = _parameter->processed_value();
+    if (target != _target)
+    {
+        _target = target;
+        _smoother.set(target);
+    }
+    if (_smoother.stationary() == false)
+    {
+        _smoother.fill_buffer(_buffer.data(), AUDIO_CHUNK_SIZE);
+        _stationary = false;
+    }
+    else if (_stationary == false || _buffer.back() != _target)
+    {
+        /* Either the last chunk finished the ramp or the change was too quick to smooth */
+        _smoother.set_direct(_target);
+        _buffer.fill(_target);
+        _stationary = true;
+    }
+    return _buffer.data();
+}
+
 InternalPlugin::InternalPlugin(HostControl host_control) : Processor(host_control)
 {
     _max_input_channels = DEFAULT_CHANNELS;
@@ -109,6 +148,14 @@ BoolParameterValue* InternalPlugin::register_bool_parameter(const std::string& i
 }
 
 
+SmoothedFloatParameter* InternalPlugin::register_parameter_smoother(FloatParameterValue* parameter,
+                                                                   std::chrono::microseconds lag_time)
+{
+    assert(parameter);
+    _parameter_smoothers.emplace_back(parameter, lag_time);
+    return &_parameter_smoothers.back();
+}
+
 bool InternalPlugin::register_string_property(const std::string &id,
                                               const std::string &label,
                                               const std::string& unit)
@@ -217,6 +264,14 @@ void InternalPlugin::set_parameter_and_notify(BoolParameterValue* storage, bool
     output_event(e);
 }
 
+void InternalPlugin::configure_parameter_smoothers(float sample_rate)
+{
+    for (auto& smoother : _parameter_smoothers)
+    {
+        smoother.set_sample_rate(sample_rate);
+    }
+}
+
 std::pair<ProcessorReturnCode, float> InternalPlugin::parameter_value(ObjectId parameter_id) const
 {
     if (parameter_id >= _parameter_values.size())
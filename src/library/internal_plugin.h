@@ -21,13 +21,62 @@
 #ifndef SUSHI_INTERNAL_PLUGIN_H
 #define SUSHI_INTERNAL_PLUGIN_H
 
+#include <array>
+#include <chrono>
 #include <deque>
 
 #include "library/processor.h"
 #include "library/plugin_parameters.h"
+#include "dsp_library/value_smoother.h"
 
 namespace sushi {
 
+constexpr auto DEFAULT_PARAMETER_SMOOTHING_TIME = std::chrono::milliseconds(20);
+
+/**
+ * @brief A float parameter with a smoother attached that renders the parameter's
+ *        processed value as one value per sample for every audio chunk. The values
+ *        can be applied directly with SampleBuffer::apply_envelope() or
+ *        SampleBuffer::add_with_envelope(). Created through
+ *        InternalPlugin::register_parameter_smoother().
+ */
+class SmoothedFloatParameter
+{
+public:
+    SmoothedFloatParameter(FloatParameterValue* parameter, std::chrono::microseconds lag_time);
+
+    /**
+     * @brief Set the sample rate and jump to the current value of the parameter.
+     *        Until this is called, value changes are not smoothed.
+     */
+    void set_sample_rate(float sample_rate);
+
+    /**
+     * @brief Advance the smoother one audio chunk towards the current parameter
+     *        value. Should be called once per call to process_audio().
+     * @return An array of AUDIO_CHUNK_SIZE smoothed values
+     */
+    const float* render();
+
+    /**
+     * @brief Whether all values of the last rendered chunk are equal to value(), in
+     *        which case a fixed gain can be used instead
+     */
+    bool stationary() const {return _stationary;}
+
+    float value() const {return _smoother.value();}
+
+    const float* data() const {return _buffer.data();}
+
+private:
+    FloatParameterValue* _parameter;
+    std::chrono::microseconds _lag_time;
+    float _target;
+    bool _stationary{true};
+    ValueSmootherRamp<float> _smoother;
+    std::array<float, AUDIO_CHUNK_SIZE> _buffer;
+};
+
 /**
  * @brief internal base class for processors that keeps track of all host-related
  * configuration and provides basic parameter and event handling.
@@ -106,6 +155,23 @@ public:
                                                 const std::string& unit,
                                                 bool default_value);
 
+    /**
+     * @brief Attach a smoother to a parameter previously registered with
+     *        register_float_parameter(). Not safe to call during processing.
+     * @param parameter The parameter to smooth
+     * @param lag_time The time it takes to reach a new value
+     * @return Pointer to a SmoothedFloatParameter object
+     */
+    SmoothedFloatParameter* register_parameter_smoother(FloatParameterValue* parameter,
+                                                       std::chrono::microseconds lag_time = DEFAULT_PARAMETER_SMOOTHING_TIME);
+
+    /**
+     * @brief Set the sample rate of all parameter smoothers, should be called from
+     *        init() and configure() by plugins using register_parameter_smoother()
+     * @param sample_rate The sample rate to use
+     */
+    void configure_parameter_smoothers(float sample_rate);
+
     /**
      * @brief Register a string property that can be updated through events
      * @param name Unique name of the property
@@ -158,6 +224,7 @@ private:
      * that iterators are never invalidated by adding to the containers.
      * For arrays or std::vectors we need to know the maximum capacity for that to work. */
     std::deque<ParameterStorage> _parameter_values;
+    std::deque<SmoothedFloatParameter> _parameter_smoothers;
 };
 
 } // end namespace sushi
@@ -0,0 +1,241 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Bounded lock free fifo queues with their capacity set when constructed
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_LOCK_FREE_FIFO_H
+#define SUSHI_LOCK_FREE_FIFO_H
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+
+#include "library/constants.h"
+#include "library/spinlock.h"
+
+namespace sushi {
+
+/**
+ * @brief Wait free fifo for one producer thread and one consumer thread. All memory is
+ *        allocated when constructed.
+ * @tparam T The type of the items, must be default constructible and copyable
+ */
+template <typename T>
+class SpscFifo
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(SpscFifo);
+
+    /**
+     * @brief Create a fifo
+     * @param capacity The maximum number of items in the fifo
+     */
+    explicit SpscFifo(int capacity) : _size(capacity + 1),
+                                      _data(std::make_unique<T[]>(_size))
+    {
+        assert(capacity > 0);
+    }
+
+    /**
+     * @brief Add an item, called from the producer thread
+     * @return false if the fifo was full, in which case the item is not added
+     */
+    bool push(const T& item)
+    {
+        int tail = _tail.load(std::memory_order_relaxed);
+        int next = _increment(tail);
+        if (next == _head.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        _data[tail] = item;
+        _tail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get the oldest item, called from the consumer thread
+     * @return false if the fifo was empty, in which case item is not changed
+     */
+    bool pop(T& item)
+    {
+        int head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = _data[head];
+        _head.store(_increment(head), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Whether the fifo was empty, which may have changed when the call returns
+     *        unless called from the producer thread
+     */
+    bool was_empty() const
+    {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    int capacity() const {return _size - 1;}
+
+private:
+    int _increment(int index) const {return index + 1 == _size ? 0 : index + 1;}
+
+    /* One slot is always left empty to tell a full fifo from an empty one */
+    int _size;
+    std::unique_ptr<T[]> _data;
+    alignas(ASSUMED_CACHE_LINE_SIZE) std::atomic<int> _tail{0};
+    alignas(ASSUMED_CACHE_LINE_SIZE) std::atomic<int> _head{0};
+};
+
+/**
+ * @brief Lock free fifo for any number of producer and consumer threads. Every slot has
+ *        a sequence number that tells producers and consumers whether it is free or
+ *        holds an item, so that they only need to agree on a position with one compare
+ *        and swap. Neither push nor pop ever waits for another thread. A producer that
+ *        is preempted half way through a push can make the items pushed after it appear
+ *        a little later, but never makes a consumer block.
+ * @tparam T The type of the items, must be default constructible and copyable
+ */
+template <typename T>
+class MpmcFifo
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(MpmcFifo);
+
+    /**
+     * @brief Create a fifo
+     * @param capacity The maximum number of items in the fifo, rounded up to a power of 2
+     */
+    explicit MpmcFifo(int capacity)
+    {
+        assert(capacity > 0);
+        size_t size = 2;
+        while (size < static_cast<size_t>(capacity))
+        {
+            size *= 2;
+        }
+        _mask = size - 1;
+        _slots = std::make_unique<Slot[]>(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            _slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Add an item, safe to call from any thread
+     * @return false if the fifo was full, in which case the item is not added
+     */
+    bool push(const T& item)
+    {
+        size_t position = _push_position.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true)
+        {
+            slot = &_slots[position & _mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence - position);
+            if (difference == 0)
+            {
+                /* The slot is free, claim it if no other producer got there first */
+                if (_push_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                /* The slot still holds the item from one lap before */
+                return false;
+            }
+            else
+            {
+                position = _push_position.load(std::memory_order_relaxed);
+            }
+        }
+        slot->item = item;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Get the oldest item, safe to call from any thread
+     * @return false if the fifo was empty, in which case item is not changed
+     */
+    bool pop(T& item)
+    {
+        size_t position = _pop_position.load(std::memory_order_relaxed);
+        Slot* slot;
+        while (true)
+        {
+            slot = &_slots[position & _mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            auto difference = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+            if (difference == 0)
+            {
+                if (_pop_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                return false;
+            }
+            else
+            {
+                position = _pop_position.load(std::memory_order_relaxed);
+            }
+        }
+        item = slot->item;
+        /* Free the slot for the producer one lap ahead */
+        slot->sequence.store(position + _mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Whether the fifo was empty, which may have changed when the call returns
+     */
+    bool was_empty() const
+    {
+        size_t position = _pop_position.load(std::memory_order_relaxed);
+        return _slots[position & _mask].sequence.load(std::memory_order_acquire) != position + 1;
+    }
+
+    int capacity() const {return static_cast<int>(_mask + 1);}
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    size_t _mask;
+    std::unique_ptr<Slot[]> _slots;
+    alignas(ASSUMED_CACHE_LINE_SIZE) std::atomic<size_t> _push_position{0};
+    alignas(ASSUMED_CACHE_LINE_SIZE) std::atomic<size_t> _pop_position{0};
+};
+
+} // end namespace sushi
+
+#endif //SUSHI_LOCK_FREE_FIFO_H
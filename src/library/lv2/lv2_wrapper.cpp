@@ -200,6 +200,11 @@ int LV2_Wrapper::program_count() const
     return _model->state()->number_of_programs();
 }
 
+int LV2_Wrapper::latency() const
+{
+    return _model->plugin_latency();
+}
+
 int LV2_Wrapper::current_program() const
 {
     if (this->supports_programs())
@@ -576,8 +581,8 @@ void LV2_Wrapper::_deliver_outputs_from_plugin(bool /*send_ui_updates*/)
                     {
                         if (_model->plugin_latency() != current_port->control_value())
                         {
+                            /* Picked up by the engine the next time latency compensation is updated */
                             _model->set_plugin_latency(current_port->control_value());
-                            // TODO: Introduce latency compensation reporting to Sushi
                         }
                     }
                     break;
@@ -101,6 +101,8 @@ public:
 
     int current_program() const override;
 
+    int latency() const override;
+
     std::string current_program_name() const override;
 
     std::pair<ProcessorReturnCode, std::string> program_name(int program) const override;
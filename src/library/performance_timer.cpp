@@ -118,14 +118,24 @@ ProcessTimings PerformanceTimer::_calculate_timings(const std::vector<TimingLogP
     float min_value{100};
     float max_value{0};
     float sum{0.0f};
+    int skipped{0};
     for (const auto& entry : entries)
     {
+        /* Skipped entries are counted separately so they don't skew the timings */
+        if (entry.skipped)
+        {
+            skipped++;
+            continue;
+        }
         float process_time = static_cast<float>(entry.delta_time.count()) / _period;
         sum += process_time;
         min_value = std::min(min_value, process_time);
         max_value = std::max(max_value, process_time);
     }
-    return {sum / entries.size(), min_value, max_value};
+    int processed = static_cast<int>(entries.size()) - skipped;
+    ProcessTimings timings{processed > 0 ? sum / processed : 0.0f, min_value, max_value};
+    timings.skip_rate = static_cast<float>(skipped) / entries.size();
+    return timings;
 }
 
 ProcessTimings PerformanceTimer::_merge_timings(ProcessTimings prev_timings, ProcessTimings new_timings)
@@ -134,10 +144,12 @@ ProcessTimings PerformanceTimer::_merge_timings(ProcessTimings prev_timings, Pro
     {
         prev_timings.avg_case = new_timings.avg_case;
     }
-    else
+    /* If every call was skipped there are no new timings to average in */
+    else if (new_timings.skip_rate < 1.0f)
     {
         prev_timings.avg_case = (1.0f - AVERAGEING_FACTOR) * prev_timings.avg_case + AVERAGEING_FACTOR * new_timings.avg_case;
     }
+    prev_timings.skip_rate = (1.0f - AVERAGEING_FACTOR) * prev_timings.skip_rate + AVERAGEING_FACTOR * new_timings.skip_rate;
     prev_timings.min_case = std::min(prev_timings.min_case, new_timings.min_case);
     prev_timings.max_case = std::max(prev_timings.max_case, new_timings.max_case);
     return prev_timings;
@@ -109,6 +109,23 @@ public:
         }
     }
 
+    /**
+     * @brief Record that a timing section was skipped, i.e. that the node was not
+     *        processed at all. Safe to call concurrently from several threads.
+     * @param node_id An integer id to identify timings from this node
+     */
+    void skip_timer_rt_safe(int node_id)
+    {
+        if(_enabled)
+        {
+            TimingLogPoint tp{node_id, std::chrono::nanoseconds(0), true};
+            _queue_lock.lock();
+            _entry_queue.push(tp);
+            _queue_lock.unlock();
+            // if queue is full, drop entries silently.
+        }
+    }
+
     /**
      * @brief Enable or disable timings
      * @param enabled Enable timings if true, disable if false
@@ -146,6 +163,7 @@ protected:
     {
         int id;
         TimePoint delta_time;
+        bool skipped{false};
     };
 
     struct TimingNode
@@ -93,7 +93,8 @@ bool Processor::maybe_output_gate_event(int channel, int note, bool note_on)
     return true;
 }
 
-void Processor::bypass_process(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer)
+template<typename BufferType>
+void Processor::bypass_process(const BufferType &in_buffer, BufferType &out_buffer)
 {
     if (_current_input_channels == 0)
     {
@@ -112,6 +113,9 @@ void Processor::bypass_process(const ChunkSampleBuffer &in_buffer, ChunkSampleBu
     }
 }
 
+template void Processor::bypass_process(const ChunkSampleBuffer&, ChunkSampleBuffer&);
+template void Processor::bypass_process(const DoubleChunkSampleBuffer&, DoubleChunkSampleBuffer&);
+
 void Processor::output_midi_event_as_internal(MidiDataByte midi_data, int sample_offset)
 {
     auto msg_type = midi::decode_message_type(midi_data);
@@ -185,7 +189,8 @@ std::string Processor::_make_unique_parameter_name(std::string name) const
     return unique_name;
 }
 
-void BypassManager::crossfade_output(const ChunkSampleBuffer& input_buffer, ChunkSampleBuffer& output_buffer,
+template<typename BufferType>
+void BypassManager::crossfade_output(const BufferType& input_buffer, BufferType& output_buffer,
                                      int input_channels, int output_channels)
 {
     auto [start, end] = get_ramp();
@@ -200,6 +205,9 @@ void BypassManager::crossfade_output(const ChunkSampleBuffer& input_buffer, Chun
     }
 }
 
+template void BypassManager::crossfade_output(const ChunkSampleBuffer&, ChunkSampleBuffer&, int, int);
+template void BypassManager::crossfade_output(const DoubleChunkSampleBuffer&, DoubleChunkSampleBuffer&, int, int);
+
 std::pair<float, float> BypassManager::get_ramp()
 {
     int prev_count = 0;
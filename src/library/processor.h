@@ -49,6 +49,9 @@ enum class ProcessorReturnCode
     PLUGIN_INIT_ERROR,
 };
 
+/* Tail length of processors that should never be put to sleep */
+constexpr int INFINITE_TAIL_LENGTH = -1;
+
 class Processor
 {
 public:
@@ -217,6 +220,92 @@ public:
      */
     virtual void set_bypassed(bool bypassed) {_bypassed = bypassed;}
 
+    /**
+     * @brief Get the length of the processor's audio tail, i.e. for how long it can keep
+     *        outputting audio after its input has become silent. Processors with a finite
+     *        tail are put to sleep when idle and are not processed until they receive audio
+     *        or events again. Processors that generate audio or events on their own should
+     *        keep the default. Called after every process_audio(), so the tail length can
+     *        change while processing.
+     * @return The tail length in samples, or INFINITE_TAIL_LENGTH if the processor can
+     *         never be put to sleep.
+     */
+    virtual int tail_length() const {return INFINITE_TAIL_LENGTH;}
+
+    /**
+     * @brief Get the processing latency of the processor, i.e. how much the audio output
+     *        is delayed relative to the input, e.g. by lookahead. Used by the engine to
+     *        compensate for the latency by delaying audio on shorter paths.
+     * @return The latency in samples
+     */
+    virtual int latency() const {return 0;}
+
+    /**
+     * @brief Check if the processor can process audio in double precision natively.
+     *        Processors that return true must implement process_audio_double().
+     */
+    virtual bool supports_double_precision() const {return false;}
+
+    /**
+     * @brief Switch between single and double precision processing. Only called on
+     *        processors that support double precision, and never while the engine is
+     *        running. When enabled, process_audio_double() is called instead of
+     *        process_audio().
+     * @param enabled True to process in double precision
+     */
+    virtual void set_double_precision(bool /*enabled*/) {}
+
+    /**
+     * @brief Process a chunk of audio in double precision.
+     * @param in_buffer Input SampleBuffer
+     * @param out_buffer Output SampleBuffer
+     */
+    virtual void process_audio_double(const DoubleChunkSampleBuffer& /*in_buffer*/,
+                                      DoubleChunkSampleBuffer& /*out_buffer*/) {}
+
+    /**
+     * @brief Query if the processor has been put to sleep because it is idle
+     * @return true if the processor is sleeping, false otherwise
+     */
+    bool sleeping() const {return _sleeping;}
+
+    /**
+     * @brief Wake up a sleeping processor so that it is processed again. Should be
+     *        called from the audio thread when the processor receives an event.
+     */
+    void wake_up()
+    {
+        _sleeping = false;
+        _silent_samples = 0;
+    }
+
+    /**
+     * @brief Update the sleep state after a call to process_audio(). The processor is put
+     *        to sleep once its input has been silent for longer than its tail and its output
+     *        is silent too. Should be called from the audio thread.
+     * @param in_buffer The input buffer passed to process_audio()
+     * @param out_buffer The output buffer passed to process_audio()
+     */
+    template<typename BufferType>
+    void update_sleep_state(const BufferType& in_buffer, const BufferType& out_buffer)
+    {
+        int tail = tail_length();
+        if (tail == INFINITE_TAIL_LENGTH)
+        {
+            return;
+        }
+        if (in_buffer.is_silent() == false)
+        {
+            _silent_samples = 0;
+            return;
+        }
+        if (_silent_samples <= tail)
+        {
+            _silent_samples += AUDIO_CHUNK_SIZE;
+        }
+        _sleeping = _silent_samples > tail && out_buffer.is_silent();
+    }
+
     /**
      * @brief Get the value of the parameter with parameter_id, safe to call from
      *        a non rt-thread
@@ -379,7 +468,8 @@ protected:
     * @param in_buffer Input SampleBuffer
     * @param out_buffer Output SampleBuffer
     */
-    void bypass_process(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer);
+    template<typename BufferType>
+    void bypass_process(const BufferType &in_buffer, BufferType &out_buffer);
 
     /**
      * @brief Takes a parameter name and makes sure that it is unique and is not empty. An
@@ -399,6 +489,9 @@ protected:
     bool _enabled{false};
     bool _bypassed{false};
 
+    bool _sleeping{false};
+    int  _silent_samples{0};
+
     HostControl _host_control;
 
 private:
@@ -512,7 +605,8 @@ public:
      * @param input_channels The current number of input channels of the processor
      * @param output_channels The current number of output channels of the processor
      */
-    void crossfade_output(const ChunkSampleBuffer& input_buffer, ChunkSampleBuffer& output_buffer,
+    template<typename BufferType>
+    void crossfade_output(const BufferType& input_buffer, BufferType& output_buffer,
                           int input_channels, int output_channels);
 
 private:
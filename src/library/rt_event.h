@@ -70,8 +70,6 @@ enum class RtEventType
     REMOVE_PROCESSOR,
     ADD_PROCESSOR_TO_TRACK,
     REMOVE_PROCESSOR_FROM_TRACK,
-    ADD_TRACK,
-    REMOVE_TRACK,
     ASYNC_WORK,
     ASYNC_WORK_NOTIFICATION,
     /* Delete object event */
@@ -634,9 +632,7 @@ public:
     {
         assert(_processor_reorder_event.type() == RtEventType::REMOVE_PROCESSOR ||
                _processor_reorder_event.type() == RtEventType::ADD_PROCESSOR_TO_TRACK ||
-               _processor_reorder_event.type() == RtEventType::REMOVE_PROCESSOR_FROM_TRACK ||
-               _processor_reorder_event.type() == RtEventType::ADD_TRACK ||
-               _processor_reorder_event.type() == RtEventType::REMOVE_TRACK);
+               _processor_reorder_event.type() == RtEventType::REMOVE_PROCESSOR_FROM_TRACK);
         ;
         return &_processor_reorder_event;
     }
@@ -645,9 +641,7 @@ public:
     {
         assert(_processor_reorder_event.type() == RtEventType::REMOVE_PROCESSOR ||
                _processor_reorder_event.type() == RtEventType::ADD_PROCESSOR_TO_TRACK ||
-               _processor_reorder_event.type() == RtEventType::REMOVE_PROCESSOR_FROM_TRACK ||
-               _processor_reorder_event.type() == RtEventType::ADD_TRACK ||
-               _processor_reorder_event.type() == RtEventType::REMOVE_TRACK);
+               _processor_reorder_event.type() == RtEventType::REMOVE_PROCESSOR_FROM_TRACK);
         ;
         return &_processor_reorder_event;
     }
@@ -831,18 +825,6 @@ public:
         return RtEvent(typed_event);
     }
 
-    static RtEvent make_add_track_event(ObjectId track)
-    {
-        ProcessorReorderRtEvent typed_event(RtEventType::ADD_TRACK, 0, track);
-        return RtEvent(typed_event);
-    }
-
-    static RtEvent make_remove_track_event(ObjectId track)
-    {
-        ProcessorReorderRtEvent typed_event(RtEventType::REMOVE_TRACK, 0, track);
-        return RtEvent(typed_event);
-    }
-
     static RtEvent make_async_work_event(AsyncWorkCallback callback, ObjectId processor, void* data)
     {
         AsyncWorkRtEvent typed_event(callback, processor, data);
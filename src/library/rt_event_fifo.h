@@ -21,35 +21,110 @@
 #ifndef SUSHI_REALTIME_FIFO_H
 #define SUSHI_REALTIME_FIFO_H
 
-#include "fifo/circularfifo_memory_relaxed_aquire_release.h"
+#include <atomic>
+#include <cstdint>
+
+#include "library/lock_free_fifo.h"
 #include "library/simple_fifo.h"
 #include "library/rt_event.h"
 #include "library/rt_event_pipe.h"
 
 namespace sushi {
 
-constexpr int MAX_EVENTS_IN_QUEUE = 100;
+constexpr int DEFAULT_EVENT_QUEUE_SIZE = 100;
 
 /**
- * @brief Wait free fifo queue for communication between rt and non-rt code
+ * @brief Wait free fifo queue for communication between rt and non-rt code, with one
+ *        producer thread and one consumer thread. Events pushed when the queue is full
+ *        are dropped and counted.
  */
 class RtSafeRtEventFifo : public RtEventPipe
 {
 public:
+    explicit RtSafeRtEventFifo(int capacity = DEFAULT_EVENT_QUEUE_SIZE) : _fifo(capacity) {}
 
-    inline bool push(const RtEvent& event) {return _fifo.push(event);}
+    inline bool push(const RtEvent& event)
+    {
+        if (_fifo.push(event))
+        {
+            _pushed++;
+            return true;
+        }
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
 
     inline bool pop(RtEvent& event)
     {
         return _fifo.pop(event);
     }
 
-    inline bool empty() {return _fifo.wasEmpty();}
+    inline bool empty() {return _fifo.was_empty();}
+
+    int capacity() const {return _fifo.capacity();}
+
+    /**
+     * @brief Get the number of events dropped because the queue was full
+     */
+    uint64_t dropped() const {return _dropped.load(std::memory_order_relaxed);}
+
+    /**
+     * @brief Get the number of events pushed to the queue, only valid when called from
+     *        the producer thread
+     */
+    uint64_t pushed() const {return _pushed;}
+
+    void send_event(const RtEvent &event) override {push(event);}
+
+private:
+    SpscFifo<RtEvent> _fifo;
+    std::atomic<uint64_t> _dropped{0};
+    uint64_t _pushed{0};
+};
+
+/**
+ * @brief Lock free fifo queue for rt events that any number of threads can push to and
+ *        pop from concurrently. Events pushed when the queue is full are dropped and
+ *        counted.
+ */
+class RtSafeMultiProducerRtEventFifo : public RtEventPipe
+{
+public:
+    /**
+     * @brief Create a queue
+     * @param capacity The number of events the queue can hold, rounded up to a power of 2
+     */
+    explicit RtSafeMultiProducerRtEventFifo(int capacity = DEFAULT_EVENT_QUEUE_SIZE) : _fifo(capacity) {}
+
+    inline bool push(const RtEvent& event)
+    {
+        if (_fifo.push(event))
+        {
+            return true;
+        }
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    inline bool pop(RtEvent& event)
+    {
+        return _fifo.pop(event);
+    }
+
+    inline bool empty() {return _fifo.was_empty();}
+
+    int capacity() const {return _fifo.capacity();}
+
+    /**
+     * @brief Get the number of events dropped because the queue was full
+     */
+    uint64_t dropped() const {return _dropped.load(std::memory_order_relaxed);}
 
     void send_event(const RtEvent &event) override {push(event);}
 
 private:
-    memory_relaxed_aquire_release::CircularFifo<RtEvent, MAX_EVENTS_IN_QUEUE> _fifo;
+    MpmcFifo<RtEvent> _fifo;
+    std::atomic<uint64_t> _dropped{0};
 };
 
 /**
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Contiguous, aligned memory arena for audio sample storage
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+
+#include "sample_arena.h"
+#include "logging.h"
+
+namespace sushi {
+
+SUSHI_GET_LOGGER_WITH_MODULE_NAME("sample arena");
+
+constexpr size_t HUGEPAGE_SIZE = 2 * 1024 * 1024;
+
+SampleArena::~SampleArena()
+{
+    if (_memory != nullptr)
+    {
+        if (_locked)
+        {
+            munlock(_memory, _size);
+        }
+        munmap(_memory, _size);
+    }
+}
+
+SampleArena& SampleArena::instance()
+{
+    /* Never destroyed, as SampleBuffers with static storage could outlive it */
+    static auto arena = new SampleArena();
+    return *arena;
+}
+
+bool SampleArena::init(size_t size, bool use_hugepages, bool lock_memory)
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    if (_memory != nullptr)
+    {
+        SUSHI_LOG_ERROR("Sample arena already initialised");
+        return false;
+    }
+    void* memory = MAP_FAILED;
+    if (use_hugepages)
+    {
+        size = (size + HUGEPAGE_SIZE - 1) / HUGEPAGE_SIZE * HUGEPAGE_SIZE;
+#ifdef MAP_HUGETLB
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (memory == MAP_FAILED)
+        {
+            SUSHI_LOG_WARNING("Failed to allocate {} bytes of hugepages, using regular pages", size);
+        }
+    }
+    _hugepages = memory != MAP_FAILED;
+    if (memory == MAP_FAILED)
+    {
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            SUSHI_LOG_ERROR("Failed to allocate sample arena of {} bytes: {}", size, strerror(errno));
+            return false;
+        }
+#ifdef MADV_HUGEPAGE
+        if (use_hugepages)
+        {
+            /* Transparent hugepages are the next best thing */
+            madvise(memory, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+    if (lock_memory)
+    {
+        _locked = mlock(memory, size) == 0;
+        if (_locked == false)
+        {
+            SUSHI_LOG_WARNING("Failed to lock sample arena in memory: {}", strerror(errno));
+        }
+    }
+    /* Touch every page now instead of on first use from the audio thread */
+    std::memset(memory, 0, size);
+
+    _memory = static_cast<std::byte*>(memory);
+    _size = size;
+    _used = 0;
+    SUSHI_LOG_INFO("Allocated sample arena of {} bytes{}{}", size, _hugepages? ", using hugepages" : "",
+                   _locked? ", locked in memory" : "");
+    return true;
+}
+
+float* SampleArena::allocate(int samples)
+{
+    size_t block_size = _block_size(samples);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        auto free_list = _free_blocks.find(block_size);
+        if (free_list != _free_blocks.end() && free_list->second != nullptr)
+        {
+            FreeBlock* block = free_list->second;
+            free_list->second = block->next;
+            return reinterpret_cast<float*>(block);
+        }
+        if (_used + block_size <= _size)
+        {
+            auto data = reinterpret_cast<float*>(_memory + _used);
+            _used += block_size;
+            return data;
+        }
+        if (_memory != nullptr)
+        {
+            SUSHI_LOG_WARNING("Sample arena full, allocating {} bytes from the heap", block_size);
+        }
+    }
+    return static_cast<float*>(::operator new(block_size, std::align_val_t(SAMPLE_BUFFER_ALIGNMENT)));
+}
+
+void SampleArena::deallocate(float* data, int samples)
+{
+    if (data == nullptr)
+    {
+        return;
+    }
+    size_t block_size = _block_size(samples);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        if (_owns(data))
+        {
+            /* Memory in the arena is never given back, only reused for blocks of the same size */
+            auto block = reinterpret_cast<FreeBlock*>(data);
+            auto& head = _free_blocks[block_size];
+            block->next = head;
+            head = block;
+            return;
+        }
+    }
+    ::operator delete(data, std::align_val_t(SAMPLE_BUFFER_ALIGNMENT));
+}
+
+size_t SampleArena::size() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _size;
+}
+
+size_t SampleArena::used() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _used;
+}
+
+bool SampleArena::uses_hugepages() const
+{
+    std::lock_guard<std::mutex> lock(_lock);
+    return _hugepages;
+}
+
+size_t SampleArena::_block_size(int samples)
+{
+    size_t bytes = std::max(samples, 1) * sizeof(float);
+    return (bytes + SAMPLE_BUFFER_ALIGNMENT - 1) / SAMPLE_BUFFER_ALIGNMENT * SAMPLE_BUFFER_ALIGNMENT;
+}
+
+} // namespace sushi
@@ -0,0 +1,121 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Contiguous, aligned memory arena for audio sample storage
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_SAMPLE_ARENA_H
+#define SUSHI_SAMPLE_ARENA_H
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+
+#include "constants.h"
+
+namespace sushi {
+
+/* All sample storage is aligned to at least one cache line, which is also enough for
+ * aligned loads with the widest SIMD instructions in use */
+constexpr size_t SAMPLE_BUFFER_ALIGNMENT = 64;
+constexpr size_t DEFAULT_SAMPLE_ARENA_SIZE = 32 * 1024 * 1024;
+
+/**
+ * @brief Allocates sample storage from one contiguous block of memory that can be
+ *        prefaulted, locked in memory and optionally backed by hugepages, so that audio
+ *        buffers are close together in memory and never cause page faults when touched
+ *        from the audio thread. Freed blocks are kept in free lists by size and reused.
+ *        Before the arena is initialised, or if it runs out of memory, allocations fall
+ *        back to aligned allocations from the heap.
+ */
+class SampleArena
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(SampleArena);
+
+    SampleArena() = default;
+
+    ~SampleArena();
+
+    /**
+     * @brief Get the arena used for all SampleBuffers
+     */
+    static SampleArena& instance();
+
+    /**
+     * @brief Allocate and prefault the memory of the arena. Can only be done once.
+     * @param size The size of the arena in bytes
+     * @param use_hugepages If true, try to back the arena with hugepages
+     * @param lock_memory If true, lock the arena in memory so it is never paged out
+     * @return true if the arena was set up, false if it was already initialised or
+     *         the memory could not be allocated
+     */
+    bool init(size_t size, bool use_hugepages, bool lock_memory);
+
+    /**
+     * @brief Allocate storage for a number of samples. Not realtime safe.
+     * @param samples The number of samples
+     * @return A pointer to memory aligned to SAMPLE_BUFFER_ALIGNMENT
+     */
+    float* allocate(int samples);
+
+    /**
+     * @brief Return storage to the arena. Not realtime safe.
+     * @param data A pointer returned by allocate(), may be nullptr
+     * @param samples The same number of samples that was passed to allocate()
+     */
+    void deallocate(float* data, int samples);
+
+    /**
+     * @brief Get the size of the arena, 0 if not initialised.
+     */
+    size_t size() const;
+
+    /**
+     * @brief Get the number of bytes handed out from the arena, including freed
+     *        blocks that are kept for reuse.
+     */
+    size_t used() const;
+
+    bool uses_hugepages() const;
+
+private:
+    static size_t _block_size(int samples);
+
+    bool _owns(const void* data) const
+    {
+        return data >= _memory && data < _memory + _size;
+    }
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    mutable std::mutex _lock;
+    std::byte* _memory{nullptr};
+    size_t _size{0};
+    size_t _used{0};
+    bool _hugepages{false};
+    bool _locked{false};
+    /* Free lists indexed by block size */
+    std::map<size_t, FreeBlock*> _free_blocks;
+};
+
+} // namespace sushi
+
+#endif //SUSHI_SAMPLE_ARENA_H
@@ -23,24 +23,38 @@
 
 #include <algorithm>
 #include <cassert>
+#include <type_traits>
 
 #include "constants.h"
+#include "interleaving.h"
+#include "sample_arena.h"
+#include "simd_kernels.h"
 
 namespace sushi {
 
 constexpr int LEFT_CHANNEL_INDEX = 0;
 constexpr int RIGHT_CHANNEL_INDEX = 1;
+/* Samples below this level (-120 dB) are considered silent */
+constexpr float SILENCE_THRESHOLD = 1.0e-6f;
 
-template<int size>
+/**
+ * @brief Multichannel audio buffer with the channels stored after each other. Storage
+ *        is allocated from the SampleArena and aligned to SAMPLE_BUFFER_ALIGNMENT, so if
+ *        size is a multiple of 16, every channel is aligned as well.
+ *        Samples are either float or, for double precision processing, double.
+ */
+template<int size, typename T = float>
 class SampleBuffer
 {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>);
+
 public:
     /**
      * @brief Construct a zeroed buffer with specified number of channels
      */
     explicit SampleBuffer(int channel_count) : _channel_count(channel_count),
                                                _own_buffer(true),
-                                               _buffer(new float[size * channel_count])
+                                               _buffer(_allocate(channel_count))
     {
         clear();
     }
@@ -62,7 +76,7 @@ public:
     {
         if (o._own_buffer)
         {
-            _buffer = new float[size * o._channel_count];
+            _buffer = _allocate(o._channel_count);
             std::copy(o._buffer, o._buffer + (size * o._channel_count), _buffer);
         } else
         {
@@ -89,7 +103,7 @@ public:
     {
         if (_own_buffer)
         {
-            delete[] _buffer;
+            _deallocate(_buffer, _channel_count);
         }
     }
 
@@ -105,8 +119,8 @@ public:
             {
                 if (_channel_count != o._channel_count)
                 {
-                    delete[] _buffer;
-                    _buffer = (o._channel_count > 0)? (new float[size * o._channel_count]) : nullptr;
+                    _deallocate(_buffer, _channel_count);
+                    _buffer = (o._channel_count > 0)? _allocate(o._channel_count) : nullptr;
                     _channel_count = o._channel_count;
                 }
             }
@@ -140,7 +154,7 @@ public:
         {
             if (_own_buffer)
             {
-                delete[] _buffer;
+                _deallocate(_buffer, _channel_count);
             }
             _channel_count = o._channel_count;
             _own_buffer = o._own_buffer;
@@ -192,7 +206,7 @@ public:
      *                           minus start_channel.
      * @return The created, non-owning SampleBuffer.
      */
-    static SampleBuffer create_from_raw_pointer(float* data,
+    static SampleBuffer create_from_raw_pointer(T* data,
                                                 int start_channel,
                                                 int number_of_channels)
     {
@@ -209,13 +223,13 @@ public:
      */
     void clear()
     {
-        std::fill(_buffer, _buffer + (size * _channel_count), 0.0f);
+        std::fill(_buffer, _buffer + (size * _channel_count), T(0));
     }
 
     /**
     * @brief Returns a writeable pointer to a specific channel in the buffer. No bounds checking.
     */
-    float* channel(int channel)
+    T* channel(int channel)
     {
         return _buffer + channel * size;
     }
@@ -223,7 +237,7 @@ public:
     /**
     * @brief Returns a read-only pointer to a specific channel in the buffer. No bounds checking.
     */
-    const float* channel(int channel) const
+    const T* channel(int channel) const
     {
         return _buffer + channel * size;
     }
@@ -241,71 +255,33 @@ public:
      */
     void from_interleaved(const float* interleaved_buf)
     {
-        switch (_channel_count)
-        {
-            case 2:  // Most common case, others are mostly included for future compatibility
-            {
-                float* l_in = _buffer;
-                float* r_in = _buffer + size;
-                for (int n = 0; n < size; ++n)
-                {
-                    *l_in++ = *interleaved_buf++;
-                    *r_in++ = *interleaved_buf++;
-                }
-                break;
-            }
-            case 1:
-            {
-                std::copy(interleaved_buf, interleaved_buf + size, _buffer);
-                break;
-            }
-            default:
-            {
-                for (int n = 0; n < size; ++n)
-                {
-                    for (int c = 0; c < _channel_count; ++c)
-                    {
-                        _buffer[n + c * _channel_count] = *interleaved_buf++;
-                    }
-                }
-            }
-        }
+        deinterleave(interleaved_buf, SampleFormat::FLOAT32, _channel_count, size, _buffer, size);
+    }
+
+    /**
+     * @brief Convert interleaved audio data in any sample format to this buffer,
+     *        applying a gain in the same pass.
+     */
+    void from_interleaved(const void* interleaved_buf, SampleFormat format, float gain = 1.0f)
+    {
+        deinterleave(interleaved_buf, format, _channel_count, size, _buffer, size, gain);
     }
 
     /**
      * @brief Copy buffer data in interleaved format to interleaved_buf
      */
-    void to_interleaved(float* interleaved_buf)
+    void to_interleaved(float* interleaved_buf) const
     {
-        switch (_channel_count)
-        {
-            case 2:  // Most common case, others are mostly included for future compatibility
-            {
-                float* l_out = _buffer;
-                float* r_out = _buffer + size;
-                for (int n = 0; n < size; ++n)
-                {
-                    *interleaved_buf++ = *l_out++;
-                    *interleaved_buf++ = *r_out++;
-                }
-                break;
-            }
-            case 1:
-            {
-                std::copy(_buffer, _buffer + size, interleaved_buf);
-                break;
-            }
-            default:
-            {
-                for (int n = 0; n < size; ++n)
-                {
-                    for (int c = 0; c < _channel_count; ++c)
-                    {
-                        *interleaved_buf++ = _buffer[n + c * size];
-                    }
-                }
-            }
-        }
+        interleave(_buffer, size, _channel_count, size, interleaved_buf, SampleFormat::FLOAT32);
+    }
+
+    /**
+     * @brief Convert buffer data to interleaved_buf in any sample format, applying a
+     *        gain in the same pass. Integer samples are clipped.
+     */
+    void to_interleaved(void* interleaved_buf, SampleFormat format, float gain = 1.0f) const
+    {
+        interleave(_buffer, size, _channel_count, size, interleaved_buf, format, gain);
     }
 
     /**
@@ -313,10 +289,7 @@ public:
      */
     void apply_gain(float gain)
     {
-        for (int i = 0; i < size * _channel_count; ++i)
-        {
-            _buffer[i] *= gain;
-        }
+        _kernels().apply_gain(_buffer, gain, size * _channel_count);
     }
 
     /**
@@ -324,11 +297,7 @@ public:
     */
     void apply_gain(float gain, int channel)
     {
-        float* data = _buffer + size * channel;
-        for (int i = 0; i < size; ++i)
-        {
-            data[i] *= gain;
-        }
+        _kernels().apply_gain(_buffer + size * channel, gain, size);
     }
 
     /**
@@ -340,16 +309,17 @@ public:
     {
         assert(source.channel_count() == 1 || source.channel_count() == this->channel_count());
 
+        const auto& kernels = _kernels();
         if (source.channel_count() == 1) // mono input, copy to all dest channels
         {
             for (int channel = 0; channel < _channel_count; ++channel)
             {
-                std::copy(source._buffer, source._buffer + size, _buffer + channel * size);
+                kernels.copy(_buffer + channel * size, source._buffer, size);
             }
         }
         else
         {
-            std::copy(source._buffer, source._buffer + _channel_count * size, _buffer);
+            kernels.copy(_buffer, source._buffer, _channel_count * size);
         }
     }
 
@@ -359,9 +329,7 @@ public:
     void replace(int dest_channel, int source_channel, const SampleBuffer &source)
     {
         assert(source_channel < source.channel_count() && dest_channel < this->channel_count());
-        std::copy(source.channel(source_channel),
-                  source.channel(source_channel) + size,
-                  _buffer + (dest_channel * size));
+        _kernels().copy(_buffer + (dest_channel * size), source.channel(source_channel), size);
     }
 
     /**
@@ -373,22 +341,16 @@ public:
     {
         assert(source.channel_count() == 1 || source.channel_count() == this->channel_count());
 
+        const auto& kernels = _kernels();
         if (source.channel_count() == 1) // mono input, add to all dest channels
         {
             for (int channel = 0; channel < _channel_count; ++channel)
             {
-                float* dest = _buffer + size * channel;
-                for (int i = 0; i < size; ++i)
-                {
-                    dest[i] += source._buffer[i];
-                }
+                kernels.add(_buffer + size * channel, source._buffer, size);
             }
         } else if (source.channel_count() == _channel_count)
         {
-            for (int i = 0; i < size * _channel_count; ++i)
-            {
-                _buffer[i] += source._buffer[i];
-            }
+            kernels.add(_buffer, source._buffer, size * _channel_count);
         }
     }
 
@@ -397,12 +359,7 @@ public:
      */
     void add(int dest_channel, int source_channel, const SampleBuffer& source)
     {
-        float* source_data = source._buffer + size * source_channel;
-        float* dest_data = _buffer + size * dest_channel;
-        for (int i = 0; i < size; ++i)
-        {
-            dest_data[i] += source_data[i];
-        }
+        _kernels().add(_buffer + size * dest_channel, source._buffer + size * source_channel, size);
     }
 
     /**
@@ -415,22 +372,16 @@ public:
     {
         assert(source.channel_count() == 1 || source.channel_count() == this->channel_count());
 
+        const auto& kernels = _kernels();
         if (source.channel_count() == 1)
         {
             for (int channel = 0; channel < _channel_count; ++channel)
             {
-                float* dest = _buffer + size * channel;
-                for (int i = 0; i < size; ++i)
-                {
-                    dest[i] += source._buffer[i] * gain;
-                }
+                kernels.add_with_gain(_buffer + size * channel, source._buffer, gain, size);
             }
         } else if (source.channel_count() == _channel_count)
         {
-            for (int i = 0; i < size * _channel_count; ++i)
-            {
-                _buffer[i] += source._buffer[i] * gain;
-            }
+            kernels.add_with_gain(_buffer, source._buffer, gain, size * _channel_count);
         }
     }
 
@@ -439,12 +390,7 @@ public:
      */
     void add_with_gain(int dest_channel, int source_channel, const SampleBuffer& source, float gain)
     {
-        float* source_data = source._buffer + size * source_channel;
-        float* dest_data = _buffer + size * dest_channel;
-        for (int i = 0; i < size; ++i)
-        {
-            dest_data[i] += source_data[i] * gain;
-        }
+        _kernels().add_with_gain(_buffer + size * dest_channel, source._buffer + size * source_channel, gain, size);
     }
 
     /**
@@ -460,28 +406,13 @@ public:
     {
         assert(source.channel_count() == 1 || source.channel_count() == _channel_count);
 
-        float inc = (end - start) / (size - 1);
-        if (source.channel_count() == 1)
-        {
-            for (int channel = 0; channel < _channel_count; ++channel)
-            {
-                float* dest = _buffer + size * channel;
-                for (int i = 0; i < size; ++i)
-                {
-                    dest[i] += source._buffer[i] * (start + i * inc);
-                }
-            }
-        } else if (source.channel_count() == _channel_count)
+        const auto& kernels = _kernels();
+        T inc = (end - start) / static_cast<T>(size - 1);
+        for (int channel = 0; channel < _channel_count; ++channel)
         {
-            for (int channel = 0; channel < _channel_count; ++channel)
-            {
-                float* source_data = _buffer + size * channel;
-                float* dest_data = _buffer + size * channel;
-                for (int i = 0; i < size; ++i)
-                {
-                    dest_data[i] += source_data[i] * (start + i * inc);
-                }
-            }
+            /* Mono sources are added to all channels */
+            const T* source_data = source.channel_count() == 1 ? source._buffer : source._buffer + size * channel;
+            kernels.add_with_ramp(_buffer + size * channel, source_data, start, inc, size);
         }
     }
 
@@ -491,13 +422,9 @@ public:
     */
     void add_with_ramp(int dest_channel, int source_channel, const SampleBuffer& source, float start, float end)
     {
-        float inc = (end - start) / (size - 1);
-        float* source_data = source._buffer + size * source_channel;
-        float* dest_data = _buffer + size * dest_channel;
-        for (int i = 0; i < size; ++i)
-        {
-            dest_data[i] += source_data[i] * (start + i * inc);
-        }
+        T inc = (end - start) / static_cast<T>(size - 1);
+        _kernels().add_with_ramp(_buffer + size * dest_channel, source._buffer + size * source_channel,
+                                      start, inc, size);
     }
 
     /**
@@ -507,14 +434,45 @@ public:
      */
     void ramp(float start, float end)
     {
-        float inc = (end - start) / (size - 1);
+        const auto& kernels = _kernels();
+        T inc = (end - start) / static_cast<T>(size - 1);
         for (int channel = 0; channel < _channel_count; ++channel)
         {
-            float* data = _buffer + size * channel;
-            for (int i = 0; i < size; ++i)
-            {
-                data[i] *= start + i * inc;
-            }
+            kernels.ramp(_buffer + size * channel, start, inc, size);
+        }
+    }
+
+    /**
+     * @brief Apply a per sample gain to all channels
+     * @param envelope An array of size gain values, one for every sample in a channel
+     */
+    void apply_envelope(const T* envelope)
+    {
+        const auto& kernels = _kernels();
+        for (int channel = 0; channel < _channel_count; ++channel)
+        {
+            kernels.apply_envelope(_buffer + size * channel, envelope, size);
+        }
+    }
+
+    /**
+     * @brief Sums the content of SampleBuffer source into this buffer after applying
+     *        a per sample gain.
+     *
+     * @param source The buffer to copy from. Has to be either a 1 channel buffer or have
+     *        the same number of channels as this buffer
+     * @param envelope An array of size gain values, one for every sample in a channel
+     */
+    void add_with_envelope(const SampleBuffer &source, const T* envelope)
+    {
+        assert(source.channel_count() == 1 || source.channel_count() == _channel_count);
+
+        const auto& kernels = _kernels();
+        for (int channel = 0; channel < _channel_count; ++channel)
+        {
+            /* Mono sources are added to all channels */
+            const T* source_data = source.channel_count() == 1 ? source._buffer : source._buffer + size * channel;
+            kernels.add_with_envelope(_buffer + size * channel, source_data, envelope, size);
         }
     }
 
@@ -544,15 +502,7 @@ public:
     int count_clipped_samples(int start_channel, int number_of_channels) const
     {
         assert(number_of_channels + start_channel <= _channel_count);
-        int clipcount = 0;
-        const float* data = _buffer + size * start_channel;
-        for (int i = 0 ; i < size * number_of_channels; ++i)
-        {
-            /* std::abs() is more efficient than testing for upper and lower bound separately
-               And GCC can compile this to vectorised, branchless code */
-            clipcount += std::abs(data[i]) >= 1.0f;
-        }
-        return clipcount;
+        return _kernels().count_clipped(_buffer + size * start_channel, size * number_of_channels);
     }
 
     /**
@@ -564,13 +514,76 @@ public:
         return count_clipped_samples(0, _channel_count);
     }
 
+    /**
+     * @brief Check if all samples in the buffer are below SILENCE_THRESHOLD
+     * @return true if the buffer is silent, false otherwise
+     */
+    bool is_silent() const
+    {
+        T peak = 0;
+        /* Find the peak without early exit so that the loop can be vectorised */
+        for (int i = 0 ; i < size * _channel_count; ++i)
+        {
+            peak = std::max(peak, std::abs(_buffer[i]));
+        }
+        return peak < SILENCE_THRESHOLD;
+    }
+
+    /**
+     * @brief Convert the contents of a buffer with another sample type to this buffer
+     * @param source SampleBuffer with the same number of channels as this buffer
+     */
+    template<typename SourceType>
+    void convert_from(const SampleBuffer<size, SourceType>& source)
+    {
+        assert(source.channel_count() == _channel_count);
+        if constexpr (std::is_same_v<T, SourceType>)
+        {
+            replace(source);
+        }
+        else if constexpr (std::is_same_v<T, double>)
+        {
+            simd::kernels().to_double(_buffer, source.channel(0), size * _channel_count);
+        }
+        else
+        {
+            simd::kernels().to_float(_buffer, source.channel(0), size * _channel_count);
+        }
+    }
+
 private:
+    /* Storage is allocated in units of floats */
+    static constexpr int FLOATS_PER_SAMPLE = sizeof(T) / sizeof(float);
+
+    static const auto& _kernels()
+    {
+        if constexpr (std::is_same_v<T, double>)
+        {
+            return simd::double_kernels();
+        }
+        else
+        {
+            return simd::kernels();
+        }
+    }
+
+    static T* _allocate(int channel_count)
+    {
+        return reinterpret_cast<T*>(SampleArena::instance().allocate(size * channel_count * FLOATS_PER_SAMPLE));
+    }
+
+    static void _deallocate(T* buffer, int channel_count)
+    {
+        SampleArena::instance().deallocate(reinterpret_cast<float*>(buffer), size * channel_count * FLOATS_PER_SAMPLE);
+    }
+
     int _channel_count;
     bool _own_buffer;
-    float* _buffer;
+    T* _buffer;
 };
 
 typedef SampleBuffer<AUDIO_CHUNK_SIZE> ChunkSampleBuffer;
+typedef SampleBuffer<AUDIO_CHUNK_SIZE, double> DoubleChunkSampleBuffer;
 } // namespace sushi
 
 
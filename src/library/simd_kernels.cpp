@@ -0,0 +1,845 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Vectorised audio buffer kernels, selected at runtime from the instruction sets
+ *        supported by the cpu.
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#if defined(__SSE2__)
+#define SUSHI_SIMD_SSE2
+#endif
+/* AVX kernels are compiled with function specific target attributes so that the
+ * rest of the binary does not require these instruction sets */
+#if defined(__GNUC__)
+#define SUSHI_SIMD_AVX2
+#define SUSHI_SIMD_AVX512
+#define SUSHI_TARGET(isa) __attribute__((target(isa)))
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define SUSHI_SIMD_NEON
+#endif
+
+#include "simd_kernels.h"
+
+namespace sushi {
+namespace simd {
+
+namespace {
+
+/* Scalar versions, also used for the samples left after the vectorised loops, and
+ * for double precision samples, where they are left to the compiler to vectorise */
+
+template <typename T>
+void scalar_apply_gain(T* data, T gain, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        data[i] *= gain;
+    }
+}
+
+template <typename T>
+void scalar_ramp(T* data, T start, T increment, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        data[i] *= start + i * increment;
+    }
+}
+
+template <typename T>
+void scalar_copy(T* dest, const T* source, int count)
+{
+    std::copy(source, source + count, dest);
+}
+
+template <typename T>
+void scalar_add(T* dest, const T* source, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        dest[i] += source[i];
+    }
+}
+
+template <typename T>
+void scalar_add_with_gain(T* dest, const T* source, T gain, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        dest[i] += source[i] * gain;
+    }
+}
+
+template <typename T>
+void scalar_add_with_ramp(T* dest, const T* source, T start, T increment, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        dest[i] += source[i] * (start + i * increment);
+    }
+}
+
+template <typename T>
+void scalar_apply_envelope(T* data, const T* envelope, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        data[i] *= envelope[i];
+    }
+}
+
+template <typename T>
+void scalar_add_with_envelope(T* dest, const T* source, const T* envelope, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        dest[i] += source[i] * envelope[i];
+    }
+}
+
+template <typename T>
+int scalar_count_clipped(const T* data, int count)
+{
+    int clipcount = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        clipcount += std::abs(data[i]) >= 1;
+    }
+    return clipcount;
+}
+
+void scalar_to_double(double* dest, const float* source, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        dest[i] = source[i];
+    }
+}
+
+void scalar_to_float(float* dest, const double* source, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        dest[i] = static_cast<float>(source[i]);
+    }
+}
+
+constexpr Kernels SCALAR_KERNELS = {InstructionSet::SCALAR,
+                                    scalar_apply_gain<float>,
+                                    scalar_ramp<float>,
+                                    scalar_copy<float>,
+                                    scalar_add<float>,
+                                    scalar_add_with_gain<float>,
+                                    scalar_add_with_ramp<float>,
+                                    scalar_apply_envelope<float>,
+                                    scalar_add_with_envelope<float>,
+                                    scalar_count_clipped<float>,
+                                    scalar_to_double,
+                                    scalar_to_float};
+
+constexpr DoubleKernels DOUBLE_KERNELS = {scalar_apply_gain<double>,
+                                          scalar_ramp<double>,
+                                          scalar_copy<double>,
+                                          scalar_add<double>,
+                                          scalar_add_with_gain<double>,
+                                          scalar_add_with_ramp<double>,
+                                          scalar_apply_envelope<double>,
+                                          scalar_add_with_envelope<double>,
+                                          scalar_count_clipped<double>};
+
+#ifdef SUSHI_SIMD_SSE2
+constexpr int SSE2_WIDTH = 4;
+
+void sse2_apply_gain(float* data, float gain, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    __m128 gain_v = _mm_set1_ps(gain);
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain_v));
+    }
+    scalar_apply_gain(data + vector_count, gain, count - vector_count);
+}
+
+void sse2_ramp(float* data, float start, float increment, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    __m128 index_v = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    __m128 index_step_v = _mm_set1_ps(SSE2_WIDTH);
+    __m128 start_v = _mm_set1_ps(start);
+    __m128 increment_v = _mm_set1_ps(increment);
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        __m128 gain_v = _mm_add_ps(start_v, _mm_mul_ps(index_v, increment_v));
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), gain_v));
+        index_v = _mm_add_ps(index_v, index_step_v);
+    }
+    scalar_ramp(data + vector_count, start + vector_count * increment, increment, count - vector_count);
+}
+
+void sse2_copy(float* dest, const float* source, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        _mm_storeu_ps(dest + i, _mm_loadu_ps(source + i));
+    }
+    scalar_copy(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+void sse2_add(float* dest, const float* source, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), _mm_loadu_ps(source + i)));
+    }
+    scalar_add(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+void sse2_add_with_gain(float* dest, const float* source, float gain, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    __m128 gain_v = _mm_set1_ps(gain);
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        __m128 source_v = _mm_mul_ps(_mm_loadu_ps(source + i), gain_v);
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), source_v));
+    }
+    scalar_add_with_gain(dest + vector_count, source + vector_count, gain, count - vector_count);
+}
+
+void sse2_add_with_ramp(float* dest, const float* source, float start, float increment, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    __m128 index_v = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    __m128 index_step_v = _mm_set1_ps(SSE2_WIDTH);
+    __m128 start_v = _mm_set1_ps(start);
+    __m128 increment_v = _mm_set1_ps(increment);
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        __m128 gain_v = _mm_add_ps(start_v, _mm_mul_ps(index_v, increment_v));
+        __m128 source_v = _mm_mul_ps(_mm_loadu_ps(source + i), gain_v);
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), source_v));
+        index_v = _mm_add_ps(index_v, index_step_v);
+    }
+    scalar_add_with_ramp(dest + vector_count, source + vector_count, start + vector_count * increment,
+                         increment, count - vector_count);
+}
+
+void sse2_apply_envelope(float* data, const float* envelope, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm_loadu_ps(envelope + i)));
+    }
+    scalar_apply_envelope(data + vector_count, envelope + vector_count, count - vector_count);
+}
+
+void sse2_add_with_envelope(float* dest, const float* source, const float* envelope, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        __m128 source_v = _mm_mul_ps(_mm_loadu_ps(source + i), _mm_loadu_ps(envelope + i));
+        _mm_storeu_ps(dest + i, _mm_add_ps(_mm_loadu_ps(dest + i), source_v));
+    }
+    scalar_add_with_envelope(dest + vector_count, source + vector_count, envelope + vector_count,
+                             count - vector_count);
+}
+
+int sse2_count_clipped(const float* data, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    __m128 abs_mask_v = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 one_v = _mm_set1_ps(1.0f);
+    int clipcount = 0;
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        __m128 abs_v = _mm_and_ps(_mm_loadu_ps(data + i), abs_mask_v);
+        clipcount += __builtin_popcount(_mm_movemask_ps(_mm_cmpge_ps(abs_v, one_v)));
+    }
+    return clipcount + scalar_count_clipped(data + vector_count, count - vector_count);
+}
+
+void sse2_to_double(double* dest, const float* source, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        __m128 source_v = _mm_loadu_ps(source + i);
+        _mm_storeu_pd(dest + i, _mm_cvtps_pd(source_v));
+        _mm_storeu_pd(dest + i + 2, _mm_cvtps_pd(_mm_movehl_ps(source_v, source_v)));
+    }
+    scalar_to_double(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+void sse2_to_float(float* dest, const double* source, int count)
+{
+    int vector_count = count - count % SSE2_WIDTH;
+    for (int i = 0; i < vector_count; i += SSE2_WIDTH)
+    {
+        __m128 low_v = _mm_cvtpd_ps(_mm_loadu_pd(source + i));
+        __m128 high_v = _mm_cvtpd_ps(_mm_loadu_pd(source + i + 2));
+        _mm_storeu_ps(dest + i, _mm_movelh_ps(low_v, high_v));
+    }
+    scalar_to_float(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+constexpr Kernels SSE2_KERNELS = {InstructionSet::SSE2,
+                                  sse2_apply_gain,
+                                  sse2_ramp,
+                                  sse2_copy,
+                                  sse2_add,
+                                  sse2_add_with_gain,
+                                  sse2_add_with_ramp,
+                                  sse2_apply_envelope,
+                                  sse2_add_with_envelope,
+                                  sse2_count_clipped,
+                                  sse2_to_double,
+                                  sse2_to_float};
+#endif
+
+#ifdef SUSHI_SIMD_AVX2
+constexpr int AVX2_WIDTH = 8;
+
+SUSHI_TARGET("avx2") void avx2_apply_gain(float* data, float gain, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    __m256 gain_v = _mm256_set1_ps(gain);
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), gain_v));
+    }
+    scalar_apply_gain(data + vector_count, gain, count - vector_count);
+}
+
+SUSHI_TARGET("avx2") void avx2_ramp(float* data, float start, float increment, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    __m256 index_v = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    __m256 index_step_v = _mm256_set1_ps(AVX2_WIDTH);
+    __m256 start_v = _mm256_set1_ps(start);
+    __m256 increment_v = _mm256_set1_ps(increment);
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        __m256 gain_v = _mm256_add_ps(start_v, _mm256_mul_ps(index_v, increment_v));
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), gain_v));
+        index_v = _mm256_add_ps(index_v, index_step_v);
+    }
+    scalar_ramp(data + vector_count, start + vector_count * increment, increment, count - vector_count);
+}
+
+SUSHI_TARGET("avx2") void avx2_copy(float* dest, const float* source, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        _mm256_storeu_ps(dest + i, _mm256_loadu_ps(source + i));
+    }
+    scalar_copy(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+SUSHI_TARGET("avx2") void avx2_add(float* dest, const float* source, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), _mm256_loadu_ps(source + i)));
+    }
+    scalar_add(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+SUSHI_TARGET("avx2") void avx2_add_with_gain(float* dest, const float* source, float gain, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    __m256 gain_v = _mm256_set1_ps(gain);
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        __m256 source_v = _mm256_mul_ps(_mm256_loadu_ps(source + i), gain_v);
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), source_v));
+    }
+    scalar_add_with_gain(dest + vector_count, source + vector_count, gain, count - vector_count);
+}
+
+SUSHI_TARGET("avx2") void avx2_add_with_ramp(float* dest, const float* source, float start, float increment, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    __m256 index_v = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    __m256 index_step_v = _mm256_set1_ps(AVX2_WIDTH);
+    __m256 start_v = _mm256_set1_ps(start);
+    __m256 increment_v = _mm256_set1_ps(increment);
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        __m256 gain_v = _mm256_add_ps(start_v, _mm256_mul_ps(index_v, increment_v));
+        __m256 source_v = _mm256_mul_ps(_mm256_loadu_ps(source + i), gain_v);
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), source_v));
+        index_v = _mm256_add_ps(index_v, index_step_v);
+    }
+    scalar_add_with_ramp(dest + vector_count, source + vector_count, start + vector_count * increment,
+                         increment, count - vector_count);
+}
+
+SUSHI_TARGET("avx2") void avx2_apply_envelope(float* data, const float* envelope, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), _mm256_loadu_ps(envelope + i)));
+    }
+    scalar_apply_envelope(data + vector_count, envelope + vector_count, count - vector_count);
+}
+
+SUSHI_TARGET("avx2") void avx2_add_with_envelope(float* dest, const float* source, const float* envelope, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        __m256 source_v = _mm256_mul_ps(_mm256_loadu_ps(source + i), _mm256_loadu_ps(envelope + i));
+        _mm256_storeu_ps(dest + i, _mm256_add_ps(_mm256_loadu_ps(dest + i), source_v));
+    }
+    scalar_add_with_envelope(dest + vector_count, source + vector_count, envelope + vector_count,
+                             count - vector_count);
+}
+
+SUSHI_TARGET("avx2") int avx2_count_clipped(const float* data, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    __m256 abs_mask_v = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 one_v = _mm256_set1_ps(1.0f);
+    int clipcount = 0;
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        __m256 abs_v = _mm256_and_ps(_mm256_loadu_ps(data + i), abs_mask_v);
+        clipcount += __builtin_popcount(_mm256_movemask_ps(_mm256_cmp_ps(abs_v, one_v, _CMP_GE_OQ)));
+    }
+    return clipcount + scalar_count_clipped(data + vector_count, count - vector_count);
+}
+
+SUSHI_TARGET("avx2") void avx2_to_double(double* dest, const float* source, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        _mm256_storeu_pd(dest + i, _mm256_cvtps_pd(_mm_loadu_ps(source + i)));
+        _mm256_storeu_pd(dest + i + 4, _mm256_cvtps_pd(_mm_loadu_ps(source + i + 4)));
+    }
+    scalar_to_double(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+SUSHI_TARGET("avx2") void avx2_to_float(float* dest, const double* source, int count)
+{
+    int vector_count = count - count % AVX2_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX2_WIDTH)
+    {
+        _mm_storeu_ps(dest + i, _mm256_cvtpd_ps(_mm256_loadu_pd(source + i)));
+        _mm_storeu_ps(dest + i + 4, _mm256_cvtpd_ps(_mm256_loadu_pd(source + i + 4)));
+    }
+    scalar_to_float(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+constexpr Kernels AVX2_KERNELS = {InstructionSet::AVX2,
+                                  avx2_apply_gain,
+                                  avx2_ramp,
+                                  avx2_copy,
+                                  avx2_add,
+                                  avx2_add_with_gain,
+                                  avx2_add_with_ramp,
+                                  avx2_apply_envelope,
+                                  avx2_add_with_envelope,
+                                  avx2_count_clipped,
+                                  avx2_to_double,
+                                  avx2_to_float};
+#endif
+
+#ifdef SUSHI_SIMD_AVX512
+constexpr int AVX512_WIDTH = 16;
+
+SUSHI_TARGET("avx512f") void avx512_apply_gain(float* data, float gain, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    __m512 gain_v = _mm512_set1_ps(gain);
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        _mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), gain_v));
+    }
+    scalar_apply_gain(data + vector_count, gain, count - vector_count);
+}
+
+SUSHI_TARGET("avx512f") void avx512_ramp(float* data, float start, float increment, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    __m512 index_v = _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                    8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    __m512 index_step_v = _mm512_set1_ps(AVX512_WIDTH);
+    __m512 start_v = _mm512_set1_ps(start);
+    __m512 increment_v = _mm512_set1_ps(increment);
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        __m512 gain_v = _mm512_add_ps(start_v, _mm512_mul_ps(index_v, increment_v));
+        _mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), gain_v));
+        index_v = _mm512_add_ps(index_v, index_step_v);
+    }
+    scalar_ramp(data + vector_count, start + vector_count * increment, increment, count - vector_count);
+}
+
+SUSHI_TARGET("avx512f") void avx512_copy(float* dest, const float* source, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        _mm512_storeu_ps(dest + i, _mm512_loadu_ps(source + i));
+    }
+    scalar_copy(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+SUSHI_TARGET("avx512f") void avx512_add(float* dest, const float* source, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        _mm512_storeu_ps(dest + i, _mm512_add_ps(_mm512_loadu_ps(dest + i), _mm512_loadu_ps(source + i)));
+    }
+    scalar_add(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+SUSHI_TARGET("avx512f") void avx512_add_with_gain(float* dest, const float* source, float gain, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    __m512 gain_v = _mm512_set1_ps(gain);
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        __m512 source_v = _mm512_mul_ps(_mm512_loadu_ps(source + i), gain_v);
+        _mm512_storeu_ps(dest + i, _mm512_add_ps(_mm512_loadu_ps(dest + i), source_v));
+    }
+    scalar_add_with_gain(dest + vector_count, source + vector_count, gain, count - vector_count);
+}
+
+SUSHI_TARGET("avx512f") void avx512_add_with_ramp(float* dest, const float* source, float start, float increment, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    __m512 index_v = _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                    8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    __m512 index_step_v = _mm512_set1_ps(AVX512_WIDTH);
+    __m512 start_v = _mm512_set1_ps(start);
+    __m512 increment_v = _mm512_set1_ps(increment);
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        __m512 gain_v = _mm512_add_ps(start_v, _mm512_mul_ps(index_v, increment_v));
+        __m512 source_v = _mm512_mul_ps(_mm512_loadu_ps(source + i), gain_v);
+        _mm512_storeu_ps(dest + i, _mm512_add_ps(_mm512_loadu_ps(dest + i), source_v));
+        index_v = _mm512_add_ps(index_v, index_step_v);
+    }
+    scalar_add_with_ramp(dest + vector_count, source + vector_count, start + vector_count * increment,
+                         increment, count - vector_count);
+}
+
+SUSHI_TARGET("avx512f") void avx512_apply_envelope(float* data, const float* envelope, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        _mm512_storeu_ps(data + i, _mm512_mul_ps(_mm512_loadu_ps(data + i), _mm512_loadu_ps(envelope + i)));
+    }
+    scalar_apply_envelope(data + vector_count, envelope + vector_count, count - vector_count);
+}
+
+SUSHI_TARGET("avx512f") void avx512_add_with_envelope(float* dest, const float* source, const float* envelope, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        __m512 source_v = _mm512_mul_ps(_mm512_loadu_ps(source + i), _mm512_loadu_ps(envelope + i));
+        _mm512_storeu_ps(dest + i, _mm512_add_ps(_mm512_loadu_ps(dest + i), source_v));
+    }
+    scalar_add_with_envelope(dest + vector_count, source + vector_count, envelope + vector_count,
+                             count - vector_count);
+}
+
+SUSHI_TARGET("avx512f") int avx512_count_clipped(const float* data, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    __m512 one_v = _mm512_set1_ps(1.0f);
+    int clipcount = 0;
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        __m512 abs_v = _mm512_abs_ps(_mm512_loadu_ps(data + i));
+        clipcount += __builtin_popcount(_mm512_cmp_ps_mask(abs_v, one_v, _CMP_GE_OQ));
+    }
+    return clipcount + scalar_count_clipped(data + vector_count, count - vector_count);
+}
+
+/* The unmasked conversions in GCC's headers start from an undefined register, which
+ * trips -Wmaybe-uninitialized. The zero masked versions with all lanes enabled give the
+ * same result from a zeroed register. */
+constexpr __mmask8 AVX512_ALL_DOUBLE_LANES = 0xff;
+
+SUSHI_TARGET("avx512f") void avx512_to_double(double* dest, const float* source, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        _mm512_storeu_pd(dest + i, _mm512_maskz_cvtps_pd(AVX512_ALL_DOUBLE_LANES, _mm256_loadu_ps(source + i)));
+        _mm512_storeu_pd(dest + i + 8, _mm512_maskz_cvtps_pd(AVX512_ALL_DOUBLE_LANES, _mm256_loadu_ps(source + i + 8)));
+    }
+    scalar_to_double(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+SUSHI_TARGET("avx512f") void avx512_to_float(float* dest, const double* source, int count)
+{
+    int vector_count = count - count % AVX512_WIDTH;
+    for (int i = 0; i < vector_count; i += AVX512_WIDTH)
+    {
+        _mm256_storeu_ps(dest + i, _mm512_maskz_cvtpd_ps(AVX512_ALL_DOUBLE_LANES, _mm512_loadu_pd(source + i)));
+        _mm256_storeu_ps(dest + i + 8, _mm512_maskz_cvtpd_ps(AVX512_ALL_DOUBLE_LANES, _mm512_loadu_pd(source + i + 8)));
+    }
+    scalar_to_float(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+constexpr Kernels AVX512_KERNELS = {InstructionSet::AVX512,
+                                    avx512_apply_gain,
+                                    avx512_ramp,
+                                    avx512_copy,
+                                    avx512_add,
+                                    avx512_add_with_gain,
+                                    avx512_add_with_ramp,
+                                    avx512_apply_envelope,
+                                    avx512_add_with_envelope,
+                                    avx512_count_clipped,
+                                    avx512_to_double,
+                                    avx512_to_float};
+#endif
+
+#ifdef SUSHI_SIMD_NEON
+constexpr int NEON_WIDTH = 4;
+
+void neon_apply_gain(float* data, float gain, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        vst1q_f32(data + i, vmulq_n_f32(vld1q_f32(data + i), gain));
+    }
+    scalar_apply_gain(data + vector_count, gain, count - vector_count);
+}
+
+void neon_ramp(float* data, float start, float increment, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    const float index[NEON_WIDTH] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t index_v = vld1q_f32(index);
+    float32x4_t index_step_v = vdupq_n_f32(NEON_WIDTH);
+    float32x4_t start_v = vdupq_n_f32(start);
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        float32x4_t gain_v = vaddq_f32(start_v, vmulq_n_f32(index_v, increment));
+        vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), gain_v));
+        index_v = vaddq_f32(index_v, index_step_v);
+    }
+    scalar_ramp(data + vector_count, start + vector_count * increment, increment, count - vector_count);
+}
+
+void neon_copy(float* dest, const float* source, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        vst1q_f32(dest + i, vld1q_f32(source + i));
+    }
+    scalar_copy(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+void neon_add(float* dest, const float* source, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        vst1q_f32(dest + i, vaddq_f32(vld1q_f32(dest + i), vld1q_f32(source + i)));
+    }
+    scalar_add(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+void neon_add_with_gain(float* dest, const float* source, float gain, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        vst1q_f32(dest + i, vmlaq_n_f32(vld1q_f32(dest + i), vld1q_f32(source + i), gain));
+    }
+    scalar_add_with_gain(dest + vector_count, source + vector_count, gain, count - vector_count);
+}
+
+void neon_add_with_ramp(float* dest, const float* source, float start, float increment, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    const float index[NEON_WIDTH] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t index_v = vld1q_f32(index);
+    float32x4_t index_step_v = vdupq_n_f32(NEON_WIDTH);
+    float32x4_t start_v = vdupq_n_f32(start);
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        float32x4_t gain_v = vaddq_f32(start_v, vmulq_n_f32(index_v, increment));
+        vst1q_f32(dest + i, vmlaq_f32(vld1q_f32(dest + i), vld1q_f32(source + i), gain_v));
+        index_v = vaddq_f32(index_v, index_step_v);
+    }
+    scalar_add_with_ramp(dest + vector_count, source + vector_count, start + vector_count * increment,
+                         increment, count - vector_count);
+}
+
+void neon_apply_envelope(float* data, const float* envelope, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), vld1q_f32(envelope + i)));
+    }
+    scalar_apply_envelope(data + vector_count, envelope + vector_count, count - vector_count);
+}
+
+void neon_add_with_envelope(float* dest, const float* source, const float* envelope, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        vst1q_f32(dest + i, vmlaq_f32(vld1q_f32(dest + i), vld1q_f32(source + i), vld1q_f32(envelope + i)));
+    }
+    scalar_add_with_envelope(dest + vector_count, source + vector_count, envelope + vector_count,
+                             count - vector_count);
+}
+
+int neon_count_clipped(const float* data, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    float32x4_t one_v = vdupq_n_f32(1.0f);
+    uint32x4_t ones_v = vdupq_n_u32(1);
+    uint32x4_t clipcount_v = vdupq_n_u32(0);
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        uint32x4_t clipped_v = vcgeq_f32(vabsq_f32(vld1q_f32(data + i)), one_v);
+        clipcount_v = vaddq_u32(clipcount_v, vandq_u32(clipped_v, ones_v));
+    }
+    int clipcount = vgetq_lane_u32(clipcount_v, 0) + vgetq_lane_u32(clipcount_v, 1) +
+                    vgetq_lane_u32(clipcount_v, 2) + vgetq_lane_u32(clipcount_v, 3);
+    return clipcount + scalar_count_clipped(data + vector_count, count - vector_count);
+}
+
+#ifdef __aarch64__
+void neon_to_double(double* dest, const float* source, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        float32x4_t source_v = vld1q_f32(source + i);
+        vst1q_f64(dest + i, vcvt_f64_f32(vget_low_f32(source_v)));
+        vst1q_f64(dest + i + 2, vcvt_high_f64_f32(source_v));
+    }
+    scalar_to_double(dest + vector_count, source + vector_count, count - vector_count);
+}
+
+void neon_to_float(float* dest, const double* source, int count)
+{
+    int vector_count = count - count % NEON_WIDTH;
+    for (int i = 0; i < vector_count; i += NEON_WIDTH)
+    {
+        float32x2_t low_v = vcvt_f32_f64(vld1q_f64(source + i));
+        vst1q_f32(dest + i, vcvt_high_f32_f64(low_v, vld1q_f64(source + i + 2)));
+    }
+    scalar_to_float(dest + vector_count, source + vector_count, count - vector_count);
+}
+#else
+/* 32 bit arm has no double precision vector instructions */
+constexpr auto neon_to_double = scalar_to_double;
+constexpr auto neon_to_float = scalar_to_float;
+#endif
+
+constexpr Kernels NEON_KERNELS = {InstructionSet::NEON,
+                                  neon_apply_gain,
+                                  neon_ramp,
+                                  neon_copy,
+                                  neon_add,
+                                  neon_add_with_gain,
+                                  neon_add_with_ramp,
+                                  neon_apply_envelope,
+                                  neon_add_with_envelope,
+                                  neon_count_clipped,
+                                  neon_to_double,
+                                  neon_to_float};
+#endif
+
+} // anonymous namespace
+
+std::vector<const Kernels*> available_kernels()
+{
+    std::vector<const Kernels*> kernel_sets = {&SCALAR_KERNELS};
+#if defined(SUSHI_SIMD_AVX2) || defined(SUSHI_SIMD_AVX512)
+    /* Needed in case this is called during static initialisation */
+    __builtin_cpu_init();
+#endif
+#ifdef SUSHI_SIMD_SSE2
+    kernel_sets.push_back(&SSE2_KERNELS);
+#endif
+#ifdef SUSHI_SIMD_AVX2
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernel_sets.push_back(&AVX2_KERNELS);
+    }
+#endif
+#ifdef SUSHI_SIMD_AVX512
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        kernel_sets.push_back(&AVX512_KERNELS);
+    }
+#endif
+#ifdef SUSHI_SIMD_NEON
+    kernel_sets.push_back(&NEON_KERNELS);
+#endif
+    return kernel_sets;
+}
+
+const Kernels& select_kernels()
+{
+    return *available_kernels().back();
+}
+
+const DoubleKernels& double_kernels()
+{
+    return DOUBLE_KERNELS;
+}
+
+const char* to_string(InstructionSet instruction_set)
+{
+    switch (instruction_set)
+    {
+        case InstructionSet::SCALAR:    return "scalar";
+        case InstructionSet::SSE2:      return "SSE2";
+        case InstructionSet::AVX2:      return "AVX2";
+        case InstructionSet::AVX512:    return "AVX-512";
+        case InstructionSet::NEON:      return "NEON";
+    }
+    return "unknown";
+}
+
+} // namespace simd
+} // namespace sushi
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Vectorised audio buffer kernels, selected at runtime from the instruction sets
+ *        supported by the cpu.
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_SIMD_KERNELS_H
+#define SUSHI_SIMD_KERNELS_H
+
+#include <vector>
+
+namespace sushi {
+namespace simd {
+
+enum class InstructionSet
+{
+    SCALAR,
+    SSE2,
+    AVX2,
+    AVX512,
+    NEON
+};
+
+/**
+ * @brief A set of kernels implemented with the same instruction set. All kernels work
+ *        on count samples and source and destination may not overlap unless they are
+ *        the same pointer. Ramps are applied as start + i * increment for sample i and
+ *        envelopes are per sample gains, as rendered by ValueSmoother::fill_buffer().
+ */
+struct Kernels
+{
+    InstructionSet instruction_set;
+    void (*apply_gain)(float* data, float gain, int count);
+    void (*ramp)(float* data, float start, float increment, int count);
+    void (*copy)(float* dest, const float* source, int count);
+    void (*add)(float* dest, const float* source, int count);
+    void (*add_with_gain)(float* dest, const float* source, float gain, int count);
+    void (*add_with_ramp)(float* dest, const float* source, float start, float increment, int count);
+    void (*apply_envelope)(float* data, const float* envelope, int count);
+    void (*add_with_envelope)(float* dest, const float* source, const float* envelope, int count);
+    int  (*count_clipped)(const float* data, int count);
+    void (*to_double)(double* dest, const float* source, int count);
+    void (*to_float)(float* dest, const double* source, int count);
+};
+
+/**
+ * @brief The same kernels for double precision samples, used by tracks processing in
+ *        double precision. These are compiled for the base instruction set only.
+ */
+struct DoubleKernels
+{
+    void (*apply_gain)(double* data, double gain, int count);
+    void (*ramp)(double* data, double start, double increment, int count);
+    void (*copy)(double* dest, const double* source, int count);
+    void (*add)(double* dest, const double* source, int count);
+    void (*add_with_gain)(double* dest, const double* source, double gain, int count);
+    void (*add_with_ramp)(double* dest, const double* source, double start, double increment, int count);
+    void (*apply_envelope)(double* data, const double* envelope, int count);
+    void (*add_with_envelope)(double* dest, const double* source, const double* envelope, int count);
+    int  (*count_clipped)(const double* data, int count);
+};
+
+/**
+ * @brief Select the kernels with the fastest instruction set supported by the cpu
+ * @return A reference to the kernels
+ */
+const Kernels& select_kernels();
+
+/**
+ * @brief Get the kernels to use for audio processing. The fastest instruction set
+ *        supported by the cpu is selected the first time this is called.
+ * @return A reference to the selected kernels
+ */
+inline const Kernels& kernels()
+{
+    static const Kernels& selected = select_kernels();
+    return selected;
+}
+
+/**
+ * @brief Get the kernels for double precision samples
+ */
+const DoubleKernels& double_kernels();
+
+/**
+ * @brief Get the kernels for all instruction sets that are both compiled in and
+ *        supported by the cpu, in order of increasing speed. Scalar kernels are
+ *        always available.
+ * @return A list of kernels
+ */
+std::vector<const Kernels*> available_kernels();
+
+/**
+ * @brief Get a printable name of an instruction set
+ */
+const char* to_string(InstructionSet instruction_set);
+
+} // namespace simd
+} // namespace sushi
+
+#endif //SUSHI_SIMD_KERNELS_H
@@ -27,6 +27,19 @@
 constexpr int ASSUMED_CACHE_LINE_SIZE = 64;
 
 namespace sushi {
+/**
+ * @brief Tell the cpu that the calling thread is busy waiting. Makes no system
+ *        calls, so it is safe to use from any realtime thread.
+ */
+inline void cpu_pause()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
 /**
  * @brief Simple rt-safe test-and-set spinlock
  */
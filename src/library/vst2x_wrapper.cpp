@@ -20,6 +20,8 @@
 
 #ifdef SUSHI_BUILD_WITH_VST2
 
+#include <algorithm>
+
 #include "twine/twine.h"
 
 #include "library/vst2x_wrapper.h"
@@ -147,6 +149,10 @@ void Vst2xWrapper::set_enabled(bool enabled)
     {
         _vst_dispatcher(effMainsChanged, 0, 1, NULL, 0.0f);
         _vst_dispatcher(effStartProcess, 0, 0, NULL, 0.0f);
+        /* 0 means the plugin doesn't report a tail size and 1 that it has no tail */
+        int tail = _vst_dispatcher(effGetTailSize, 0, 0, NULL, 0.0f);
+        _tail_length = tail == 0 ? INFINITE_TAIL_LENGTH : (tail == 1 ? 0 : tail);
+        _latency = std::max(0, static_cast<int>(_plugin_handle->initialDelay));
     }
     else
     {
@@ -87,6 +87,10 @@ public:
 
     bool bypassed() const override {return _bypass_manager.bypassed();}
 
+    int tail_length() const override {return _tail_length;}
+
+    int latency() const override {return _latency;}
+
     std::pair<ProcessorReturnCode, float> parameter_value(ObjectId parameter_id) const override;
 
     std::pair<ProcessorReturnCode, float> parameter_value_in_domain(ObjectId parameter_id) const override;
@@ -183,6 +187,8 @@ private:
     bool _can_do_soft_bypass;
     bool _double_mono_input;
     int _number_of_programs{0};
+    int _tail_length{INFINITE_TAIL_LENGTH};
+    int _latency{0};
 
     BypassManager _bypass_manager{_bypassed};
 
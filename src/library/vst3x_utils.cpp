@@ -36,6 +36,30 @@ void SushiProcessData::assign_buffers(const ChunkSampleBuffer& input, ChunkSampl
     {
         _process_outputs[i] = output.channel(i);
     }
+    /* The 32 and 64 bit buffer pointers are a union */
+    _input_buffers.channelBuffers32 = _process_inputs;
+    _output_buffers.channelBuffers32 = _process_outputs;
+    symbolicSampleSize = Steinberg::Vst::SymbolicSampleSizes::kSample32;
+    inputs->numChannels = in_channels;
+    outputs->numChannels = out_channels;
+}
+
+void SushiProcessData::assign_buffers(const DoubleChunkSampleBuffer& input, DoubleChunkSampleBuffer& output,
+                                      int in_channels, int out_channels)
+{
+    assert(input.channel_count() <= VST_WRAPPER_MAX_N_CHANNELS &&
+           output.channel_count() <= VST_WRAPPER_MAX_N_CHANNELS);
+    for (int i = 0; i < input.channel_count(); ++i)
+    {
+        _process_inputs_64[i] = const_cast<double*>(input.channel(i));
+    }
+    for (int i = 0; i < output.channel_count(); ++i)
+    {
+        _process_outputs_64[i] = output.channel(i);
+    }
+    _input_buffers.channelBuffers64 = _process_inputs_64;
+    _output_buffers.channelBuffers64 = _process_outputs_64;
+    symbolicSampleSize = Steinberg::Vst::SymbolicSampleSizes::kSample64;
     inputs->numChannels = in_channels;
     outputs->numChannels = out_channels;
 }
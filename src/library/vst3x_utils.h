@@ -77,6 +77,15 @@ public:
      */
     void assign_buffers(const ChunkSampleBuffer& input, ChunkSampleBuffer& output, int in_channels, int out_channels);
 
+    /**
+     * @brief Re-map the internal buffers to point to the given double precision
+     *        samplebuffers. Only valid if processing was set up with kSample64.
+     * @param input Input buffers
+     * @param output Output buffers
+     */
+    void assign_buffers(const DoubleChunkSampleBuffer& input, DoubleChunkSampleBuffer& output,
+                        int in_channels, int out_channels);
+
     /**
      * @brief Clear all event and parameter changes to prepare for a new round
      *        of processing. Call when process(data) has returned
@@ -92,6 +101,8 @@ public:
 private:
     float* _process_inputs[VST_WRAPPER_MAX_N_CHANNELS];
     float* _process_outputs[VST_WRAPPER_MAX_N_CHANNELS];
+    double* _process_inputs_64[VST_WRAPPER_MAX_N_CHANNELS];
+    double* _process_outputs_64[VST_WRAPPER_MAX_N_CHANNELS];
     Steinberg::Vst::AudioBusBuffers _input_buffers;
     Steinberg::Vst::AudioBusBuffers _output_buffers;
     Steinberg::Vst::ProcessContext  _context;
@@ -187,6 +187,8 @@ ProcessorReturnCode Vst3xWrapper::init(float sample_rate)
     {
         return ProcessorReturnCode::PLUGIN_INIT_ERROR;
     }
+    _supports_double_precision = _instance.processor()->canProcessSampleSize(
+            Steinberg::Vst::SymbolicSampleSizes::kSample64) == Steinberg::kResultTrue;
     if (!_setup_processing())
     {
         return ProcessorReturnCode::PLUGIN_INIT_ERROR;
@@ -291,6 +293,40 @@ void Vst3xWrapper::process_event(const RtEvent& event)
 }
 
 void Vst3xWrapper::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer)
+{
+    _process_audio(in_buffer, out_buffer);
+}
+
+void Vst3xWrapper::process_audio_double(const DoubleChunkSampleBuffer& in_buffer, DoubleChunkSampleBuffer& out_buffer)
+{
+    _process_audio(in_buffer, out_buffer);
+}
+
+void Vst3xWrapper::set_double_precision(bool enabled)
+{
+    if (enabled == _double_precision || (enabled && _supports_double_precision == false))
+    {
+        return;
+    }
+    /* The sample size can only be changed while the plugin is inactive */
+    bool reset_enabled = this->enabled();
+    if (reset_enabled)
+    {
+        set_enabled(false);
+    }
+    _double_precision = enabled;
+    if (!_setup_processing())
+    {
+        SUSHI_LOG_ERROR("Error setting up {} precision processing", enabled ? "double" : "single");
+    }
+    if (reset_enabled)
+    {
+        set_enabled(true);
+    }
+}
+
+template<typename BufferType>
+void Vst3xWrapper::_process_audio(const BufferType& in_buffer, BufferType& out_buffer)
 {
     if (_process_data.inputParameterChanges->getParameterCount() > 0)
     {
@@ -336,6 +372,20 @@ void Vst3xWrapper::set_enabled(bool enabled)
     {
         _enabled = enabled;
     }
+    if (enabled)
+    {
+        auto tail = _instance.processor()->getTailSamples();
+        if (tail == Steinberg::Vst::kInfiniteTail || tail > static_cast<Steinberg::uint32>(INT_MAX))
+        {
+            _tail_length = INFINITE_TAIL_LENGTH;
+        }
+        else
+        {
+            _tail_length = static_cast<int>(tail);
+        }
+        _latency = static_cast<int>(std::min(_instance.processor()->getLatencySamples(),
+                                             static_cast<Steinberg::uint32>(INT_MAX)));
+    }
 }
 
 void Vst3xWrapper::set_bypassed(bool bypassed)
@@ -718,7 +768,8 @@ bool Vst3xWrapper::_setup_processing()
     setup.maxSamplesPerBlock = AUDIO_CHUNK_SIZE;
     setup.processMode = Steinberg::Vst::ProcessModes::kRealtime;
     setup.sampleRate = _sample_rate;
-    setup.symbolicSampleSize = Steinberg::Vst::SymbolicSampleSizes::kSample32;
+    setup.symbolicSampleSize = _double_precision ? Steinberg::Vst::SymbolicSampleSizes::kSample64 :
+                                                   Steinberg::Vst::SymbolicSampleSizes::kSample32;
     auto res = _instance.processor()->setupProcessing(setup);
     if (res != Steinberg::kResultOk)
     {
@@ -92,6 +92,16 @@ public:
 
     bool bypassed() const override;
 
+    int tail_length() const override {return _tail_length;}
+
+    int latency() const override {return _latency;}
+
+    bool supports_double_precision() const override {return _supports_double_precision;}
+
+    void set_double_precision(bool enabled) override;
+
+    void process_audio_double(const DoubleChunkSampleBuffer& in_buffer, DoubleChunkSampleBuffer& out_buffer) override;
+
     const ParameterDescriptor* parameter_from_id(ObjectId id) const override;
 
     std::pair<ProcessorReturnCode, float> parameter_value(ObjectId parameter_id) const override;
@@ -161,6 +171,9 @@ private:
 
     void _fill_processing_context();
 
+    template<typename BufferType>
+    void _process_audio(const BufferType& in_buffer, BufferType& out_buffer);
+
     inline void _add_parameter_change(Steinberg::Vst::ParamID id, float value, int sample_offset);
 
     bool _sync_controller_to_processor();
@@ -190,6 +203,10 @@ private:
     int _main_program_list_id;
     int _program_count{0};
     int _current_program{0};
+    int _tail_length{INFINITE_TAIL_LENGTH};
+    int _latency{0};
+    bool _supports_double_precision{false};
+    bool _double_precision{false};
 
     BypassManager _bypass_manager{_bypassed};
 
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Signal for waking up a sleeping thread
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "wakeup_signal.h"
+
+namespace sushi {
+
+#ifdef __linux__
+static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t));
+
+inline int32_t* futex_word(std::atomic<int32_t>& value)
+{
+    return reinterpret_cast<int32_t*>(&value);
+}
+#endif
+
+void WakeupSignal::wait()
+{
+    _wait(nullptr);
+}
+
+bool WakeupSignal::wait_until(std::chrono::steady_clock::time_point deadline)
+{
+    return _wait(&deadline);
+}
+
+bool WakeupSignal::_wait(const std::chrono::steady_clock::time_point* deadline)
+{
+    if (_signalled.exchange(0) == 1)
+    {
+        return true;
+    }
+    _waiting.store(true);
+    while (_signalled.load() == 0)
+    {
+        if (deadline && std::chrono::steady_clock::now() >= *deadline)
+        {
+            break;
+        }
+#ifdef __linux__
+        /* Sleeps only if the signal is still 0 when the kernel checks it, so a notify
+         * between the check above and here is not missed. The timeout is absolute on
+         * CLOCK_MONOTONIC, which is the clock std::chrono::steady_clock uses on Linux */
+        timespec timeout;
+        if (deadline)
+        {
+            auto time = deadline->time_since_epoch();
+            auto seconds = std::chrono::duration_cast<std::chrono::seconds>(time);
+            timeout.tv_sec = seconds.count();
+            timeout.tv_nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(time - seconds).count();
+        }
+        syscall(SYS_futex, futex_word(_signalled), FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, 0,
+                deadline ? &timeout : nullptr, nullptr, FUTEX_BITSET_MATCH_ANY);
+#else
+        auto wakeup = std::chrono::steady_clock::now() + WAKEUP_SIGNAL_POLL_PERIODICITY;
+        std::this_thread::sleep_until(deadline ? std::min(wakeup, *deadline) : wakeup);
+#endif
+    }
+    _waiting.store(false);
+    return _signalled.exchange(0) == 1;
+}
+
+void WakeupSignal::_wake()
+{
+#ifdef __linux__
+    syscall(SYS_futex, futex_word(_signalled), FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1, nullptr, nullptr, 0);
+#endif
+}
+
+} // namespace sushi
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Signal for waking up a sleeping thread
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_WAKEUP_SIGNAL_H
+#define SUSHI_WAKEUP_SIGNAL_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "library/constants.h"
+
+namespace sushi {
+
+/* Only used where futexes are not available, in which case waiting polls the signal */
+constexpr auto WAKEUP_SIGNAL_POLL_PERIODICITY = std::chrono::milliseconds(1);
+
+/**
+ * @brief Lets one thread sleep until another thread has work for it. Notifications are
+ *        not counted, any number of notifications before a wait make the wait return
+ *        once. On Linux the waiting thread sleeps on a futex, and notify() only makes a
+ *        system call when the other thread is actually sleeping.
+ */
+class WakeupSignal
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(WakeupSignal);
+
+    WakeupSignal() = default;
+
+    /**
+     * @brief Wake up the waiting thread, or make its next wait return immediately if it
+     *        is not waiting. Never blocks and can be called from any number of threads.
+     *        Not safe to call from the rt thread, as it makes a system call when the other
+     *        thread is sleeping, which forces a mode switch on Xenomai.
+     */
+    void notify()
+    {
+        if (_signalled.exchange(1) == 0 && _waiting.load())
+        {
+            _wake();
+        }
+    }
+
+    /**
+     * @brief Wait until notified. Only one thread at a time may wait.
+     */
+    void wait();
+
+    /**
+     * @brief Wait until notified or until a deadline has passed. Only one thread at a
+     *        time may wait.
+     * @param deadline The latest time to wake up
+     * @return true if notified, false if the deadline passed first
+     */
+    bool wait_until(std::chrono::steady_clock::time_point deadline);
+
+private:
+    bool _wait(const std::chrono::steady_clock::time_point* deadline);
+
+    void _wake();
+
+    /* 1 if notified since the last wait, used as the futex word */
+    std::atomic<int32_t> _signalled{0};
+    std::atomic<bool> _waiting{false};
+};
+
+} // namespace sushi
+
+#endif //SUSHI_WAKEUP_SIGNAL_H
@@ -18,12 +18,14 @@
  * @copyright 2017-2020 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
  */
 
+#include <algorithm>
 #include <vector>
 #include <fstream>
 #include <iostream>
 #include <sstream>
 #include <csignal>
 #include <memory>
+#include <optional>
 #include <condition_variable>
 
 #include "twine/src/twine_internal.h"
@@ -39,6 +41,7 @@
 #include "control_frontends/osc_frontend.h"
 #include "control_frontends/alsa_midi_frontend.h"
 #include "library/parameter_dump.h"
+#include "library/sample_arena.h"
 
 #ifdef SUSHI_BUILD_WITH_RPC_INTERFACE
 #include "sushi_rpc/grpc_server.h"
@@ -116,7 +119,7 @@ void print_version_and_build_info()
     }
     std::cout << std::endl;
 
-    std::cout << "Audio buffer size in frames: " << AUDIO_CHUNK_SIZE << std::endl;
+    std::cout << "Engine chunk size in frames: " << AUDIO_CHUNK_SIZE << std::endl;
     std::cout << "Git commit: " << SUSHI_GIT_COMMIT_HASH << std::endl;
     std::cout << "Built on: " << SUSHI_BUILD_TIMESTAMP << std::endl;
 }
@@ -175,7 +178,10 @@ int main(int argc, char* argv[])
     bool connect_ports = false;
     bool debug_mode_switches = false;
     int  rt_cpu_cores = 1;
+    int  event_queue_size = sushi::DEFAULT_EVENT_QUEUE_SIZE;
+    std::optional<int> driver_buffer_size;
     bool enable_timings = false;
+    bool use_hugepages = false;
     bool enable_flush_interval = false;
     bool enable_parameter_dump = false;
     std::chrono::seconds log_flush_interval = std::chrono::seconds(0);
@@ -259,6 +265,10 @@ int main(int argc, char* argv[])
             debug_mode_switches = true;
             break;
 
+        case OPT_IDX_DRIVER_BUFFER_SIZE:
+            driver_buffer_size = atoi(opt.arg);
+            break;
+
         case OPT_IDX_MULTICORE_PROCESSING:
             rt_cpu_cores = atoi(opt.arg);
             break;
@@ -279,6 +289,14 @@ int main(int argc, char* argv[])
             grpc_listening_address = opt.arg;
             break;
 
+        case OPT_IDX_HUGEPAGES:
+            use_hugepages = true;
+            break;
+
+        case OPT_IDX_EVENT_QUEUE_SIZE:
+            event_queue_size = std::max(1, atoi(opt.arg));
+            break;
+
         default:
             SushiArg::print_error("Unhandled option '", opt, "' \n");
             break;
@@ -318,7 +336,12 @@ int main(int argc, char* argv[])
     {
         twine::init_xenomai(); // must be called before setting up any worker pools
     }
-    auto engine = std::make_unique<sushi::engine::AudioEngine>(SUSHI_SAMPLE_RATE_DEFAULT, rt_cpu_cores);
+    /* Set up the sample arena before any audio buffers are created */
+    sushi::SampleArena::instance().init(sushi::DEFAULT_SAMPLE_ARENA_SIZE, use_hugepages, true);
+
+    auto engine = std::make_unique<sushi::engine::AudioEngine>(SUSHI_SAMPLE_RATE_DEFAULT,
+                                                               rt_cpu_cores,
+                                                               event_queue_size);
     auto midi_dispatcher = std::make_unique<sushi::midi_dispatcher::MidiDispatcher>(engine.get());
     auto configurator = std::make_unique<sushi::jsonconfig::JsonConfigurator>(engine.get(),
                                                                               midi_dispatcher.get(),
@@ -342,6 +365,9 @@ int main(int argc, char* argv[])
         }
         error_exit("Error reading host config, check logs for details.");
     }
+    /* A driver buffer size given on the command line takes precedence over the config file.
+     * The engine always processes AUDIO_CHUNK_SIZE frames at a time, set at build time */
+    int audio_buffer_size = driver_buffer_size.value_or(audio_config.driver_buffer_size.value_or(AUDIO_CHUNK_SIZE));
     int cv_inputs = audio_config.cv_inputs.value_or(0);
     int cv_outputs = audio_config.cv_outputs.value_or(0);
     int midi_inputs = audio_config.midi_inputs.value_or(1);
@@ -350,6 +376,13 @@ int main(int argc, char* argv[])
     midi_dispatcher->set_midi_inputs(midi_inputs);
     midi_dispatcher->set_midi_outputs(midi_outputs);
 
+    /* Only the Raspa frontend can run the driver at another buffer size than the engine chunk */
+    if (frontend_type != FrontendType::XENOMAI_RASPA && audio_buffer_size != AUDIO_CHUNK_SIZE)
+    {
+        error_exit("Driver buffer size " + std::to_string(audio_buffer_size) + " is not supported by the selected "
+                   "audio frontend, only Xenomai RASPA supports setting a driver buffer size.");
+    }
+
     ////////////////////////////////////////////////////////////////////////////////
     // Set up Audio Frontend //
     ////////////////////////////////////////////////////////////////////////////////
@@ -372,6 +405,7 @@ int main(int argc, char* argv[])
         {
             SUSHI_LOG_INFO("Setting up Xenomai RASPA frontend");
             frontend_config = std::make_unique<sushi::audio_frontend::XenomaiRaspaFrontendConfiguration>(debug_mode_switches,
+                                                                                                         audio_buffer_size,
                                                                                                          cv_inputs,
                                                                                                          cv_outputs);
             audio_frontend = std::make_unique<sushi::audio_frontend::XenomaiRaspaFrontend>(engine.get());
@@ -117,11 +117,14 @@ enum OptionIndex
     OPT_IDX_JACK_SERVER,
     OPT_IDX_USE_XENOMAI_RASPA,
     OPT_IDX_XENOMAI_DEBUG_MODE_SW,
+    OPT_IDX_DRIVER_BUFFER_SIZE,
     OPT_IDX_MULTICORE_PROCESSING,
     OPT_IDX_TIMINGS_STATISTICS,
     OPT_IDX_OSC_RECEIVE_PORT,
     OPT_IDX_OSC_SEND_PORT,
-    OPT_IDX_GRPC_LISTEN_ADDRESS
+    OPT_IDX_GRPC_LISTEN_ADDRESS,
+    OPT_IDX_HUGEPAGES,
+    OPT_IDX_EVENT_QUEUE_SIZE
 };
 
 // Option types (UNUSED is generally used for options that take a value as argument)
@@ -279,6 +282,14 @@ const optionparser::Descriptor usage[] =
         SushiArg::Optional,
         "\t\t--debug-mode-sw \tBreak to debugger if a mode switch is detected (Xenomai only)."
     },
+    {
+        OPT_IDX_DRIVER_BUFFER_SIZE,
+        OPT_TYPE_UNUSED,
+        "b",
+        "driver-buffer-size",
+        SushiArg::Numeric,
+        "\t\t-b <n>, --driver-buffer-size=<n> \tAudio driver buffer size in frames (Xenomai only). Must be a multiple of the engine chunk size, which is set at build time."
+    },
     {
         OPT_IDX_MULTICORE_PROCESSING,
         OPT_TYPE_UNUSED,
@@ -319,6 +330,22 @@ const optionparser::Descriptor usage[] =
         SushiArg::NonEmpty,
         "\t\t--grpc-address=<port> \tgRPC listening address in the format: address:port. By default accepts incoming connections from all ip:s [default port=" SUSHI_GRPC_LISTENING_PORT "]."
     },
+    {
+        OPT_IDX_HUGEPAGES,
+        OPT_TYPE_DISABLED,
+        "",
+        "hugepages",
+        SushiArg::Optional,
+        "\t\t--hugepages \tAllocate audio buffers from hugepages if available."
+    },
+    {
+        OPT_IDX_EVENT_QUEUE_SIZE,
+        OPT_TYPE_UNUSED,
+        "",
+        "event-queue-size",
+        SushiArg::Numeric,
+        "\t\t--event-queue-size=<n> \tNumber of events the queues to and from the audio thread can hold [default n=100]."
+    },
     // Don't touch this one (set default values for optionparse library)
     { 0, 0, 0, 0, 0, 0}
 };
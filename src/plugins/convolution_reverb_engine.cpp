@@ -0,0 +1,160 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Non uniformly partitioned convolution for the convolution reverb
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <cassert>
+
+#include "convolution_reverb_engine.h"
+
+namespace sushi {
+namespace convolution_reverb_plugin {
+
+ConvolutionEngine::ConvolutionEngine(const std::vector<std::vector<float>>& impulse_responses, int channels)
+{
+    assert(impulse_responses.empty() == false && channels > 0);
+    for (int c = 0; c < channels; ++c)
+    {
+        const auto& response = impulse_responses[std::min<size_t>(c, impulse_responses.size() - 1)];
+        int length = static_cast<int>(response.size());
+        _length = std::max(_length, length);
+        _heads.push_back(std::make_unique<dsp::PartitionedConvolver>(AUDIO_CHUNK_SIZE, response.data(),
+                                                                     std::min(length, HEAD_LENGTH)));
+        _tails.push_back(std::make_unique<dsp::PartitionedConvolver>(TAIL_BLOCK_SIZE, response.data() + std::min(length, HEAD_LENGTH),
+                                                                     std::max(0, length - HEAD_LENGTH)));
+    }
+    for (const auto& tail : _tails)
+    {
+        _tail_partitions = std::max(_tail_partitions, tail->partitions());
+    }
+    _has_tail = _length > HEAD_LENGTH;
+    if (_has_tail)
+    {
+        _tail_input.resize(channels * TAIL_BLOCK_SIZE, 0.0f);
+        _tail_output.resize(channels * TAIL_BLOCK_SIZE, 0.0f);
+        _job_input.resize(channels * TAIL_BLOCK_SIZE, 0.0f);
+        _job_output.resize(channels * TAIL_BLOCK_SIZE, 0.0f);
+        _running = true;
+        _thread = std::thread(&ConvolutionEngine::_worker, this);
+    }
+}
+
+ConvolutionEngine::~ConvolutionEngine()
+{
+    if (_running)
+    {
+        _running = false;
+        _thread.join();
+    }
+}
+
+void ConvolutionEngine::process(const ChunkSampleBuffer& in_buffer, ChunkSampleBuffer& out_buffer)
+{
+    int channels = std::min(out_buffer.channel_count(), this->channels());
+    int last_input = in_buffer.channel_count() - 1;
+    for (int c = 0; c < channels; ++c)
+    {
+        const float* input = in_buffer.channel(std::min(c, last_input));
+        float* output = out_buffer.channel(c);
+        if (_has_tail)
+        {
+            /* Copied before processing, as input and output may be the same buffer */
+            std::copy(input, input + AUDIO_CHUNK_SIZE, _tail_input.data() + c * TAIL_BLOCK_SIZE + _tail_position);
+        }
+        _heads[c]->process(input, output);
+        if (_has_tail)
+        {
+            const float* tail = _tail_output.data() + c * TAIL_BLOCK_SIZE + _tail_position;
+            for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+            {
+                output[i] += tail[i];
+            }
+        }
+    }
+    if (_has_tail)
+    {
+        _tail_position += AUDIO_CHUNK_SIZE;
+        if (_tail_position == TAIL_BLOCK_SIZE)
+        {
+            _exchange_tail_block();
+            _tail_position = 0;
+        }
+    }
+}
+
+void ConvolutionEngine::_exchange_tail_block()
+{
+    int64_t block = _tail_blocks++;
+    if (_completed.load(std::memory_order_acquire) != _submitted.load(std::memory_order_relaxed))
+    {
+        /* The background thread is still busy with the previous block. This block is
+         * dropped, which the background thread treats as a block of silence */
+        std::fill(_tail_output.begin(), _tail_output.end(), 0.0f);
+        _underruns.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    /* The result is only played if it is the one for the block before this one,
+     * otherwise it is late and would be played out of time */
+    if (_job_block == block - 1)
+    {
+        std::copy(_job_output.begin(), _job_output.end(), _tail_output.begin());
+    }
+    else
+    {
+        std::fill(_tail_output.begin(), _tail_output.end(), 0.0f);
+    }
+    std::copy(_tail_input.begin(), _tail_input.end(), _job_input.begin());
+    _job_block = block;
+    _submitted.fetch_add(1, std::memory_order_release);
+}
+
+void ConvolutionEngine::_worker()
+{
+    std::vector<float> silence(TAIL_BLOCK_SIZE, 0.0f);
+    std::vector<float> discarded(TAIL_BLOCK_SIZE);
+    int64_t processed = 0;
+    int64_t last_block = -1;
+    while (_running)
+    {
+        if (_submitted.load(std::memory_order_acquire) == processed)
+        {
+            std::this_thread::sleep_for(TAIL_THREAD_PERIODICITY);
+            continue;
+        }
+        /* Dropped blocks are silence. After as many blocks as the tail has partitions,
+         * all history is silent and more blocks make no difference */
+        int64_t dropped = std::min<int64_t>(_job_block - last_block - 1, _tail_partitions);
+        for (int64_t i = 0; i < dropped; ++i)
+        {
+            for (auto& tail : _tails)
+            {
+                tail->process(silence.data(), discarded.data());
+            }
+        }
+        for (size_t c = 0; c < _tails.size(); ++c)
+        {
+            _tails[c]->process(_job_input.data() + c * TAIL_BLOCK_SIZE, _job_output.data() + c * TAIL_BLOCK_SIZE);
+        }
+        last_block = _job_block;
+        _completed.store(++processed, std::memory_order_release);
+    }
+}
+
+} // end namespace convolution_reverb_plugin
+} // end namespace sushi
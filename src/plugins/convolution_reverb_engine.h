@@ -0,0 +1,131 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Non uniformly partitioned convolution for the convolution reverb
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ *
+ * The impulse response is split in a head and a tail. The head, the first HEAD_LENGTH
+ * samples, is convolved on the rt thread in partitions of one audio chunk, so the
+ * reverb adds no latency. The tail is convolved on a background thread in partitions of
+ * TAIL_BLOCK_SIZE samples. Once a block of TAIL_BLOCK_SIZE input samples has been
+ * collected, the rt thread hands it to the background thread and picks up the result of
+ * the block before it. As the tail starts 2 * TAIL_BLOCK_SIZE samples into the impulse
+ * response, that result is not needed until the following block, which leaves the
+ * background thread a full block to compute every block. The rt thread never waits for
+ * the background thread, a result that is not ready in time is dropped and counted as
+ * an underrun.
+ */
+
+#ifndef SUSHI_CONVOLUTION_REVERB_ENGINE_H
+#define SUSHI_CONVOLUTION_REVERB_ENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "library/constants.h"
+#include "library/sample_buffer.h"
+#include "dsp_library/partitioned_convolver.h"
+
+namespace sushi {
+namespace convolution_reverb_plugin {
+
+/* Around 23 ms at 44.1 kHz, which is the time the background thread has for every block */
+constexpr int TAIL_BLOCK_SIZE = 1024;
+constexpr int HEAD_LENGTH = 2 * TAIL_BLOCK_SIZE;
+constexpr auto TAIL_THREAD_PERIODICITY = std::chrono::milliseconds(1);
+
+static_assert(TAIL_BLOCK_SIZE % AUDIO_CHUNK_SIZE == 0);
+
+class ConvolutionEngine
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(ConvolutionEngine);
+
+    /**
+     * @brief Create an engine and start its background thread if the impulse response
+     *        has a tail. Not realtime safe.
+     * @param impulse_responses One impulse response per channel. Channels without an
+     *        impulse response of their own use the last one.
+     * @param channels The number of channels to convolve
+     */
+    ConvolutionEngine(const std::vector<std::vector<float>>& impulse_responses, int channels);
+
+    /**
+     * @brief Stops the background thread, not realtime safe
+     */
+    ~ConvolutionEngine();
+
+    int channels() const {return static_cast<int>(_heads.size());}
+
+    /**
+     * @brief The length of the longest impulse response in samples
+     */
+    int length() const {return _length;}
+
+    /**
+     * @brief Convolve one chunk of audio. Called from the rt thread.
+     * @param in_buffer Input, channels without input of their own use the last input
+     *        channel
+     * @param out_buffer Output, set to the convolved signal. Only as many channels as
+     *        out_buffer has, up to channels(), are processed.
+     */
+    void process(const ChunkSampleBuffer& in_buffer, ChunkSampleBuffer& out_buffer);
+
+    /**
+     * @brief Get the number of tail blocks that were not ready in time
+     */
+    int underruns() const {return _underruns.load(std::memory_order_relaxed);}
+
+private:
+    /* Called from the rt thread once every TAIL_BLOCK_SIZE samples */
+    void _exchange_tail_block();
+
+    void _worker();
+
+    std::vector<std::unique_ptr<dsp::PartitionedConvolver>> _heads;
+    /* Only used by the background thread */
+    std::vector<std::unique_ptr<dsp::PartitionedConvolver>> _tails;
+    int _tail_partitions{0};
+    int _length{0};
+    bool _has_tail{false};
+
+    /* Only used by the rt thread, TAIL_BLOCK_SIZE samples for every channel */
+    std::vector<float> _tail_input;
+    std::vector<float> _tail_output;
+    int _tail_position{0};
+    int64_t _tail_blocks{0};
+
+    /* Handed between the rt thread and the background thread with _submitted and
+     * _completed, only the side that holds the job may touch them */
+    std::vector<float> _job_input;
+    std::vector<float> _job_output;
+    int64_t _job_block{-1};
+    std::atomic<int64_t> _submitted{0};
+    std::atomic<int64_t> _completed{0};
+    std::atomic<int> _underruns{0};
+
+    std::thread _thread;
+    std::atomic<bool> _running{false};
+};
+
+} // end namespace convolution_reverb_plugin
+} // end namespace sushi
+
+#endif //SUSHI_CONVOLUTION_REVERB_ENGINE_H
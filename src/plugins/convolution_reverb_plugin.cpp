@@ -0,0 +1,238 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Convolution reverb plugin with impulse responses loaded from file
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <cassert>
+#include <sndfile.h>
+
+#include "convolution_reverb_plugin.h"
+#include "dsp_library/resampler.h"
+#include "logging.h"
+
+namespace sushi {
+namespace convolution_reverb_plugin {
+
+SUSHI_GET_LOGGER_WITH_MODULE_NAME("convolution_reverb");
+
+std::vector<std::vector<float>> load_impulse_response(const std::string& path, float sample_rate)
+{
+    SNDFILE*    file;
+    SF_INFO     info = {};
+    if (! (file = sf_open(path.c_str(), SFM_READ, &info)) )
+    {
+        SUSHI_LOG_ERROR("Failed to open impulse response file: {}", path);
+        return {};
+    }
+    int file_channels = std::max(info.channels, 1);
+    int frames = static_cast<int>(std::min<sf_count_t>(info.frames, MAX_IMPULSE_RESPONSE_LENGTH));
+    std::vector<float> file_buffer(static_cast<size_t>(frames) * file_channels);
+    int read_frames = static_cast<int>(sf_readf_float(file, file_buffer.data(), frames));
+    sf_close(file);
+    if (read_frames != frames || frames == 0)
+    {
+        SUSHI_LOG_ERROR("Failed to read impulse response file: {}", path);
+        return {};
+    }
+
+    if (info.samplerate != static_cast<int>(sample_rate))
+    {
+        dsp::resampler::Resampler resampler(file_channels, info.samplerate, sample_rate);
+        resampler.push(file_buffer.data(), frames);
+        resampler.flush();
+        frames = resampler.available();
+        file_buffer.resize(static_cast<size_t>(frames) * file_channels);
+        resampler.pull(file_buffer.data(), frames);
+    }
+
+    int channels = std::min(file_channels, MAX_CHANNELS_SUPPORTED);
+    std::vector<std::vector<float>> responses(channels, std::vector<float>(frames));
+    for (int c = 0; c < channels; ++c)
+    {
+        for (int i = 0; i < frames; ++i)
+        {
+            responses[c][i] = file_buffer[i * file_channels + c];
+        }
+    }
+    return responses;
+}
+
+ConvolutionReverbPlugin::ConvolutionReverbPlugin(HostControl host_control) : InternalPlugin(host_control)
+{
+    _max_input_channels = MAX_CHANNELS_SUPPORTED;
+    _max_output_channels = MAX_CHANNELS_SUPPORTED;
+    _current_input_channels = 1;
+    _current_output_channels = 1;
+    Processor::set_name(DEFAULT_NAME);
+    Processor::set_label(DEFAULT_LABEL);
+
+    _dry_parameter = register_float_parameter("dry", "Dry", "dB",
+                                              0.0f, -120.0f, 0.0f,
+                                              new dBToLinPreProcessor(-120.0f, 0.0f));
+    _dry_smoother = register_parameter_smoother(_dry_parameter);
+
+    _wet_parameter = register_float_parameter("wet", "Wet", "dB",
+                                              -12.0f, -120.0f, 12.0f,
+                                              new dBToLinPreProcessor(-120.0f, 12.0f));
+    _wet_smoother = register_parameter_smoother(_wet_parameter);
+
+    /* Output only, set when the background thread did not finish a block of the tail in time */
+    _underrun_parameter = register_bool_parameter("tail_underrun", "Tail Underrun", "", false);
+
+    [[maybe_unused]] bool str_pr_ok = register_string_property("impulse_response", "Impulse Response", "");
+    assert(_dry_parameter && _wet_parameter && _underrun_parameter && str_pr_ok);
+}
+
+ConvolutionReverbPlugin::~ConvolutionReverbPlugin()
+{
+    delete _engine;
+    delete _pending_engine;
+    delete _impulse_response_property;
+}
+
+ProcessorReturnCode ConvolutionReverbPlugin::init(float sample_rate)
+{
+    _sample_rate = sample_rate;
+    configure_parameter_smoothers(sample_rate);
+    return ProcessorReturnCode::OK;
+}
+
+void ConvolutionReverbPlugin::configure(float sample_rate)
+{
+    /* A loaded impulse response keeps the samplerate it was converted to */
+    _sample_rate = sample_rate;
+    configure_parameter_smoothers(sample_rate);
+}
+
+void ConvolutionReverbPlugin::set_input_channels(int channels)
+{
+    Processor::set_input_channels(channels);
+    _current_output_channels = channels;
+    _max_output_channels = channels;
+}
+
+void ConvolutionReverbPlugin::process_event(const RtEvent& event)
+{
+    switch (event.type())
+    {
+        case RtEventType::STRING_PROPERTY_CHANGE:
+        {
+            /* The impulse response is the only string property */
+            auto typed_event = event.string_parameter_change_event();
+            _impulse_response_property = typed_event->value();
+            /* Schedule a non-rt callback to load the file and set up the convolution */
+            auto e = RtEvent::make_async_work_event(&ConvolutionReverbPlugin::non_rt_callback, this->id(), this);
+            _pending_event_id = e.async_work_event()->event_id();
+            output_event(e);
+            break;
+        }
+        case RtEventType::ASYNC_WORK_NOTIFICATION:
+        {
+            auto typed_event = event.async_work_completion_event();
+            if (typed_event->sending_event_id() == _pending_event_id &&
+                typed_event->return_status() == ImpulseResponseChangeStatus::SUCCESS)
+            {
+                ConvolutionEngine* old_engine = _engine;
+                _engine = _pending_engine;
+                _pending_engine = nullptr;
+                _tail_length = _engine->length();
+                _reported_underruns = _engine->underruns();
+                /* Stopping the background thread of the old engine is not rt safe */
+                if (old_engine)
+                {
+                    auto delete_event = RtEvent::make_async_work_event(&ConvolutionReverbPlugin::delete_engine_callback,
+                                                                       this->id(), old_engine);
+                    output_event(delete_event);
+                }
+            }
+            break;
+        }
+
+        default:
+            InternalPlugin::process_event(event);
+            break;
+    }
+}
+
+void ConvolutionReverbPlugin::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer)
+{
+    _dry_smoother->render();
+    _wet_smoother->render();
+    if (_bypassed)
+    {
+        bypass_process(in_buffer, out_buffer);
+        return;
+    }
+
+    out_buffer.clear();
+    if (_dry_smoother->stationary())
+    {
+        out_buffer.add_with_gain(in_buffer, _dry_smoother->value());
+    }
+    else
+    {
+        out_buffer.add_with_envelope(in_buffer, _dry_smoother->data());
+    }
+
+    if (_engine)
+    {
+        auto wet_buffer = ChunkSampleBuffer::create_non_owning_buffer(_wet_buffer, 0, out_buffer.channel_count());
+        _engine->process(in_buffer, wet_buffer);
+        if (_wet_smoother->stationary())
+        {
+            out_buffer.add_with_gain(wet_buffer, _wet_smoother->value());
+        }
+        else
+        {
+            out_buffer.add_with_envelope(wet_buffer, _wet_smoother->data());
+        }
+
+        /* Set for the chunk in which a block of the tail was dropped */
+        int underruns = _engine->underruns();
+        bool underrun = underruns != _reported_underruns;
+        _reported_underruns = underruns;
+        if (underrun != _underrun_parameter->processed_value())
+        {
+            set_parameter_and_notify(_underrun_parameter, underrun);
+        }
+    }
+}
+
+int ConvolutionReverbPlugin::_non_rt_callback(EventId id)
+{
+    if (id != _pending_event_id)
+    {
+        SUSHI_LOG_WARNING("Convolution reverb: EventId of non-rt callback didn't match, {} vs {}", id, _pending_event_id);
+        return ImpulseResponseChangeStatus::FAILURE;
+    }
+    /* As in the sample player, several outstanding requests can leak the path string */
+    auto responses = load_impulse_response(*_impulse_response_property, _sample_rate);
+    delete _impulse_response_property;
+    _impulse_response_property = nullptr;
+    if (responses.empty())
+    {
+        return ImpulseResponseChangeStatus::FAILURE;
+    }
+    delete _pending_engine;
+    _pending_engine = new ConvolutionEngine(responses, MAX_CHANNELS_SUPPORTED);
+    SUSHI_LOG_INFO("Convolution reverb: Loaded impulse response of {} samples", _pending_engine->length());
+    return ImpulseResponseChangeStatus::SUCCESS;
+}
+
+}// namespace convolution_reverb_plugin
+}// namespace sushi
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Convolution reverb plugin with impulse responses loaded from file
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_CONVOLUTION_REVERB_PLUGIN_H
+#define SUSHI_CONVOLUTION_REVERB_PLUGIN_H
+
+#include <string>
+#include <vector>
+
+#include "library/internal_plugin.h"
+#include "plugins/convolution_reverb_engine.h"
+
+namespace sushi {
+namespace convolution_reverb_plugin {
+
+constexpr int MAX_CHANNELS_SUPPORTED = 2;
+/* Impulse responses are cut off after around 10 seconds at 48 kHz */
+constexpr int MAX_IMPULSE_RESPONSE_LENGTH = 480000;
+
+static const std::string DEFAULT_NAME = "sushi.testing.convolution_reverb";
+static const std::string DEFAULT_LABEL = "Convolution Reverb";
+
+namespace ImpulseResponseChangeStatus {
+enum ImpulseResponseChange : int
+{
+    SUCCESS = 0,
+    FAILURE
+};}
+
+/**
+ * @brief Read an impulse response from file, not realtime safe
+ * @param path Path to the file
+ * @param sample_rate The samplerate to convert the impulse response to
+ * @return One impulse response for every channel in the file, up to
+ *         MAX_CHANNELS_SUPPORTED, or an empty vector if the file could not be read
+ */
+std::vector<std::vector<float>> load_impulse_response(const std::string& path, float sample_rate);
+
+class ConvolutionReverbPlugin : public InternalPlugin
+{
+public:
+    ConvolutionReverbPlugin(HostControl host_control);
+
+    ~ConvolutionReverbPlugin();
+
+    ProcessorReturnCode init(float sample_rate) override;
+
+    void configure(float sample_rate) override;
+
+    void set_input_channels(int channels) override;
+
+    void process_event(const RtEvent& event) override;
+
+    void process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer) override;
+
+    int tail_length() const override {return _tail_length;}
+
+    static int non_rt_callback(void* data, EventId id)
+    {
+        return reinterpret_cast<ConvolutionReverbPlugin*>(data)->_non_rt_callback(id);
+    }
+
+    static int delete_engine_callback(void* data, EventId /*id*/)
+    {
+        delete reinterpret_cast<ConvolutionEngine*>(data);
+        return ImpulseResponseChangeStatus::SUCCESS;
+    }
+
+private:
+    int _non_rt_callback(EventId id);
+
+    float _sample_rate{0};
+    ConvolutionEngine* _engine{nullptr};
+    int _tail_length{0};
+    int _reported_underruns{0};
+
+    ChunkSampleBuffer _wet_buffer{MAX_CHANNELS_SUPPORTED};
+
+    FloatParameterValue*    _dry_parameter;
+    SmoothedFloatParameter* _dry_smoother;
+    FloatParameterValue*    _wet_parameter;
+    SmoothedFloatParameter* _wet_smoother;
+    BoolParameterValue*     _underrun_parameter;
+
+    std::string*            _impulse_response_property{nullptr};
+    EventId                 _pending_event_id{0};
+    ConvolutionEngine*      _pending_engine{nullptr};
+};
+
+}// namespace convolution_reverb_plugin
+}// namespace sushi
+
+#endif //SUSHI_CONVOLUTION_REVERB_PLUGIN_H
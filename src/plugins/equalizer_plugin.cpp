@@ -14,10 +14,11 @@
  */
 
 /**
- * @brief 1 band equaliser plugin example
+ * @brief Multiband parametric equaliser plugin
  * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
  */
 
+#include <algorithm>
 #include <cassert>
 
 #include "equalizer_plugin.h"
@@ -34,30 +35,46 @@ EqualizerPlugin::EqualizerPlugin(HostControl host_control) : InternalPlugin(host
     Processor::set_name(DEFAULT_NAME);
     Processor::set_label(DEFAULT_LABEL);
 
-    _frequency = register_float_parameter("frequency", "Frequency", "Hz",
-                                          1000.0f, 20.0f, 20000.0f,
-                                          new FloatParameterPreProcessor(20.0f, 20000.0f));
-
-    _gain = register_float_parameter("gain", "Gain", "dB",
-                                     0.0f, -24.0f, 24.0f,
-                                     new dBToLinPreProcessor(-24.0f, 24.0f));
-
-    _q = register_float_parameter("q", "Q", "",
-                                  1.0f, 0.0f, 10.0f,
-                                  new FloatParameterPreProcessor(0.0f, 10.0f));
-    assert(_frequency);
-    assert(_gain);
-    assert(_q);
+    constexpr std::array<float, EQ_BANDS> DEFAULT_FREQUENCIES = {1000.0f, 200.0f, 5000.0f};
+    for (int i = 0; i < EQ_BANDS; ++i)
+    {
+        std::string suffix = i == 0 ? "" : "_" + std::to_string(i + 1);
+        std::string label_suffix = i == 0 ? "" : " " + std::to_string(i + 1);
+        auto& band = _bands[i];
+        band.frequency = register_float_parameter("frequency" + suffix, "Frequency" + label_suffix, "Hz",
+                                                  DEFAULT_FREQUENCIES[i], 20.0f, 20000.0f,
+                                                  new FloatParameterPreProcessor(20.0f, 20000.0f));
+
+        band.gain = register_float_parameter("gain" + suffix, "Gain" + label_suffix, "dB",
+                                             0.0f, -24.0f, 24.0f,
+                                             new dBToLinPreProcessor(-24.0f, 24.0f));
+
+        band.q = register_float_parameter("q" + suffix, "Q" + label_suffix, "",
+                                          1.0f, 0.0f, 10.0f,
+                                          new FloatParameterPreProcessor(0.0f, 10.0f));
+        assert(band.frequency);
+        assert(band.gain);
+        assert(band.q);
+    }
+    _frequency = _bands[0].frequency;
+    _gain = _bands[0].gain;
+    _q = _bands[0].q;
 }
 
 ProcessorReturnCode EqualizerPlugin::init(float sample_rate)
 {
     _sample_rate = sample_rate;
 
-    for (auto& f : _filters)
+    for (auto& bank : _filter_banks)
     {
-        f.set_smoothing(AUDIO_CHUNK_SIZE);
-        f.reset();
+        bank.set_sections(EQ_BANDS);
+        bank.set_smoothing(AUDIO_CHUNK_SIZE);
+    }
+    /* Start from the current parameter values instead of ramping up from zero */
+    _update_coefficients(true);
+    for (auto& bank : _filter_banks)
+    {
+        bank.reset();
     }
 
     return ProcessorReturnCode::OK;
@@ -66,6 +83,7 @@ ProcessorReturnCode EqualizerPlugin::init(float sample_rate)
 void EqualizerPlugin::configure(float sample_rate)
 {
     _sample_rate = sample_rate;
+    _update_coefficients(true);
     return;
 }
 
@@ -80,21 +98,24 @@ void EqualizerPlugin::set_input_channels(int channels)
 
 void EqualizerPlugin::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer)
 {
-    /* Update parameter values */
-    float frequency = _frequency->processed_value();
-    float gain = _gain->processed_value();
-    float q = _q->processed_value();
-
     if (!_bypassed)
     {
-        /* Recalculate the coefficients once per audio chunk, this makes for
-         * predictable cpu load for every chunk */
-        dsp::biquad::Coefficients coefficients;
-        dsp::biquad::calc_biquad_peak(coefficients, _sample_rate, frequency, q, gain);
-        for (int i = 0; i < _current_input_channels; ++i)
+        /* Recalculate the coefficients at most once per audio chunk, this makes
+         * for predictable cpu load for every chunk */
+        _update_coefficients(false);
+
+        for (int bank = 0; bank * dsp::biquad::FILTER_BANK_LANES < _current_input_channels; ++bank)
         {
-            _filters[i].set_coefficients(coefficients);
-            _filters[i].process(in_buffer.channel(i), out_buffer.channel(i), AUDIO_CHUNK_SIZE);
+            int first_channel = bank * dsp::biquad::FILTER_BANK_LANES;
+            int lanes = std::min(dsp::biquad::FILTER_BANK_LANES, _current_input_channels - first_channel);
+            const float* input[dsp::biquad::FILTER_BANK_LANES];
+            float* output[dsp::biquad::FILTER_BANK_LANES];
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                input[lane] = in_buffer.channel(first_channel + lane);
+                output[lane] = out_buffer.channel(first_channel + lane);
+            }
+            _filter_banks[bank].process(input, output, lanes, AUDIO_CHUNK_SIZE);
         }
     }
     else
@@ -103,5 +124,28 @@ void EqualizerPlugin::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSam
     }
 }
 
+void EqualizerPlugin::_update_coefficients(bool force)
+{
+    for (int i = 0; i < EQ_BANDS; ++i)
+    {
+        auto& band = _bands[i];
+        float frequency = band.frequency->processed_value();
+        float gain = band.gain->processed_value();
+        float q = band.q->processed_value();
+        if (force || frequency != band.current_frequency || gain != band.current_gain || q != band.current_q)
+        {
+            dsp::biquad::Coefficients coefficients;
+            dsp::biquad::calc_biquad_peak(coefficients, _sample_rate, frequency, q, gain);
+            for (auto& bank : _filter_banks)
+            {
+                bank.set_coefficients(i, coefficients);
+            }
+            band.current_frequency = frequency;
+            band.current_gain = gain;
+            band.current_q = q;
+        }
+    }
+}
+
 }// namespace equalizer_plugin
 }// namespace sushi
\ No newline at end of file
@@ -14,20 +14,24 @@
  */
 
 /**
- * @brief 1 band equaliser plugin example
+ * @brief Multiband parametric equaliser plugin
  * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
  */
 
 #ifndef EQUALIZER_PLUGIN_H
 #define EQUALIZER_PLUGIN_H
 
+#include <array>
+
 #include "library/internal_plugin.h"
-#include "dsp_library/biquad_filter.h"
+#include "dsp_library/biquad_filter_bank.h"
 
 namespace sushi {
 namespace equalizer_plugin {
 
-constexpr int MAX_CHANNELS_SUPPORTED = 2;
+constexpr int MAX_CHANNELS_SUPPORTED = 8;
+constexpr int EQ_BANDS = 3;
+constexpr int FILTER_BANKS = (MAX_CHANNELS_SUPPORTED + dsp::biquad::FILTER_BANK_LANES - 1) / dsp::biquad::FILTER_BANK_LANES;
 static const std::string DEFAULT_NAME = "sushi.testing.equalizer";
 static const std::string DEFAULT_LABEL = "Equalizer";
 
@@ -46,10 +50,30 @@ public:
 
     void process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer) override;
 
+    /* The filter ringing is short enough to be covered by the check for silent output */
+    int tail_length() const override {return 0;}
+
 private:
+    struct Band
+    {
+        FloatParameterValue* frequency;
+        FloatParameterValue* gain;
+        FloatParameterValue* q;
+        /* Last values the coefficients were calculated from */
+        float current_frequency;
+        float current_gain;
+        float current_q;
+    };
+
+    void _update_coefficients(bool force);
+
     float _sample_rate;
-    dsp::biquad::BiquadFilter _filters[MAX_CHANNELS_SUPPORTED];
+    /* Every band is a cascaded section, every channel a lane of a filter bank */
+    dsp::biquad::BiquadFilterBank _filter_banks[FILTER_BANKS];
+
+    std::array<Band, EQ_BANDS> _bands;
 
+    /* The first band keeps the parameter names of the single band version */
     FloatParameterValue* _frequency;
     FloatParameterValue* _gain;
     FloatParameterValue* _q;
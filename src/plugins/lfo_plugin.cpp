@@ -37,30 +37,38 @@ LfoPlugin::LfoPlugin(HostControl host_control) : InternalPlugin(host_control)
     _freq_parameter = register_float_parameter("freq", "Frequency", "Hz",
                                                1.0f, 0.001f, 10.0f);
 
+    constexpr int MAX_WAVEFORM = static_cast<int>(dsp::LfoWaveform::WAVEFORM_COUNT) - 1;
+    _waveform_parameter = register_int_parameter("waveform", "Waveform", "",
+                                                 static_cast<int>(dsp::LfoWaveform::SINE), 0, MAX_WAVEFORM,
+                                                 new IntParameterPreProcessor(0, MAX_WAVEFORM));
+
     _out_parameter = register_float_parameter("out", "Lfo Out", "",
                                               0.5f, 0.0f, 1.0f);
 
-    assert(_freq_parameter && _out_parameter);
+    assert(_freq_parameter && _waveform_parameter && _out_parameter);
 }
 
 LfoPlugin::~LfoPlugin() = default;
 
 ProcessorReturnCode LfoPlugin::init(float sample_rate)
 {
-    _buffers_per_second = sample_rate / AUDIO_CHUNK_SIZE;
+    _lfo.set_samplerate(sample_rate);
     return ProcessorReturnCode::OK;
 }
 
 void LfoPlugin::configure(float sample_rate)
 {
-    _buffers_per_second = sample_rate / AUDIO_CHUNK_SIZE;
+    _lfo.set_samplerate(sample_rate);
 }
 
 void LfoPlugin::process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer)
 {
     bypass_process(in_buffer, out_buffer);
-    _phase += _freq_parameter->processed_value() * M_PI / _buffers_per_second;
-    this->set_parameter_and_notify(_out_parameter, (std::sin(_phase) + 1) * 0.5f);
+    _lfo.set_frequency(_freq_parameter->processed_value());
+    _lfo.set_waveform(static_cast<dsp::LfoWaveform>(_waveform_parameter->processed_value()));
+    /* Parameters and cv are only updated once per chunk, so only the last value is needed */
+    float value = _lfo.advance(AUDIO_CHUNK_SIZE);
+    this->set_parameter_and_notify(_out_parameter, (value + 1) * 0.5f);
 }
 
 }// namespace lfo_plugin
@@ -22,6 +22,7 @@
 #define LFO_PLUGIN_H
 
 #include "library/internal_plugin.h"
+#include "dsp_library/lfo.h"
 
 namespace sushi {
 namespace lfo_plugin {
@@ -40,9 +41,9 @@ public:
     void process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer) override;
 
 private:
-    float _phase{0};
-    float _buffers_per_second;
+    dsp::Lfo _lfo;
     FloatParameterValue* _freq_parameter;
+    IntParameterValue*   _waveform_parameter;
     FloatParameterValue* _out_parameter;
 };
 
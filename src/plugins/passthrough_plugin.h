@@ -44,6 +44,8 @@ public:
 
     void process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer) override;
 
+    int tail_length() const override {return 0;}
+
 private:
     RtSafeRtEventFifo _event_queue;
 };
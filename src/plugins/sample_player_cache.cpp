@@ -0,0 +1,180 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Process wide cache of decoded sample files shared between sample players
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+#include <sys/mman.h>
+#include <sndfile.h>
+
+#include "sample_player_cache.h"
+#include "logging.h"
+
+namespace sushi {
+namespace sample_player_plugin {
+
+SUSHI_GET_LOGGER_WITH_MODULE_NAME("sampleplayer");
+
+SampleCache::~SampleCache()
+{
+    for (auto& entry : _entries)
+    {
+        _unmap(*entry.second);
+    }
+}
+
+SampleCache& SampleCache::instance()
+{
+    /* Never destroyed, as plugins with static storage could outlive it */
+    static auto cache = new SampleCache();
+    return *cache;
+}
+
+const CachedSample* SampleCache::acquire(const std::string& path, int max_frames)
+{
+    Key key(path, max_frames);
+    {
+        std::scoped_lock lock(_lock);
+        auto cached = _entries.find(key);
+        if (cached != _entries.end())
+        {
+            cached->second->references++;
+            return &cached->second->sample;
+        }
+    }
+
+    /* Decode without holding the lock so that other sample players can get samples
+     * that are already cached in the meantime */
+    auto entry = _load(path, max_frames);
+    if (entry == nullptr)
+    {
+        return nullptr;
+    }
+
+    std::scoped_lock lock(_lock);
+    auto [cached, inserted] = _entries.try_emplace(key, std::move(entry));
+    if (!inserted)
+    {
+        /* Someone else loaded the same file while we were decoding */
+        _unmap(*entry);
+    }
+    cached->second->references++;
+    return &cached->second->sample;
+}
+
+void SampleCache::release(const CachedSample* sample)
+{
+    if (sample == nullptr)
+    {
+        return;
+    }
+    std::scoped_lock lock(_lock);
+    auto cached = std::find_if(_entries.begin(), _entries.end(),
+                               [&](const auto& e) {return &e.second->sample == sample;});
+    if (cached == _entries.end())
+    {
+        SUSHI_LOG_ERROR("Released a sample that is not in the cache");
+        return;
+    }
+    if (--cached->second->references == 0)
+    {
+        SUSHI_LOG_DEBUG("Evicting sample {} from cache", cached->first.first);
+        _unmap(*cached->second);
+        _entries.erase(cached);
+    }
+}
+
+int SampleCache::size() const
+{
+    std::scoped_lock lock(_lock);
+    return static_cast<int>(_entries.size());
+}
+
+std::unique_ptr<SampleCache::Entry> SampleCache::_load(const std::string& path, int max_frames)
+{
+    SNDFILE*    sample_file;
+    SF_INFO     soundfile_info = {};
+    if (! (sample_file = sf_open(path.c_str(), SFM_READ, &soundfile_info)) )
+    {
+        SUSHI_LOG_ERROR("Failed to open sample file: {}", path);
+        return nullptr;
+    }
+    int frames = static_cast<int>(std::min<sf_count_t>(soundfile_info.frames, max_frames));
+    int channels = std::max(soundfile_info.channels, 1);
+
+    auto entry = std::make_unique<Entry>();
+    entry->mapping_size = std::max<size_t>(frames * sizeof(float), 1);
+    entry->mapping = mmap(nullptr, entry->mapping_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (entry->mapping == MAP_FAILED)
+    {
+        SUSHI_LOG_ERROR("Failed to allocate {} bytes for sample {}: {}", entry->mapping_size, path, strerror(errno));
+        sf_close(sample_file);
+        return nullptr;
+    }
+
+    auto data = static_cast<float*>(entry->mapping);
+    int samples;
+    if (channels == 1)
+    {
+        samples = static_cast<int>(sf_readf_float(sample_file, data, frames));
+    }
+    else
+    {
+        /* Mix down to mono, the same as the streamer does for the rest of the file */
+        std::vector<float> file_buffer(static_cast<size_t>(frames) * channels);
+        samples = static_cast<int>(sf_readf_float(sample_file, file_buffer.data(), frames));
+        for (int i = 0; i < samples; ++i)
+        {
+            float value = 0.0f;
+            for (int c = 0; c < channels; ++c)
+            {
+                value += file_buffer[i * channels + c];
+            }
+            data[i] = value / channels;
+        }
+    }
+    sf_close(sample_file);
+    if (samples != frames)
+    {
+        SUSHI_LOG_ERROR("Failed to read sample file: {}", path);
+        _unmap(*entry);
+        return nullptr;
+    }
+
+    /* Shared between all sample players, so make sure no one can write to it */
+    mprotect(entry->mapping, entry->mapping_size, PROT_READ);
+    entry->sample.data = data;
+    entry->sample.frames = frames;
+    entry->sample.total_frames = static_cast<int>(soundfile_info.frames);
+    return entry;
+}
+
+void SampleCache::_unmap(Entry& entry)
+{
+    if (entry.mapping != nullptr)
+    {
+        munmap(entry.mapping, entry.mapping_size);
+        entry.mapping = nullptr;
+    }
+}
+
+} // end namespace sample_player_plugin
+} // end namespace sushi
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Process wide cache of decoded sample files shared between sample players
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#ifndef SUSHI_SAMPLE_PLAYER_CACHE_H
+#define SUSHI_SAMPLE_PLAYER_CACHE_H
+
+#include <climits>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "library/constants.h"
+
+namespace sushi {
+namespace sample_player_plugin {
+
+/**
+ * @brief A decoded, mono sample file. The data is read only and shared by all users.
+ */
+struct CachedSample
+{
+    const float* data{nullptr};
+    /* The number of frames in data */
+    int frames{0};
+    /* The number of frames in the file, larger than frames if only the head was loaded */
+    int total_frames{0};
+};
+
+/**
+ * @brief Keeps one copy of every loaded sample file in memory, no matter how many sample
+ *        players use it. Samples are decoded once into a read only memory mapping and
+ *        reference counted. A sample is evicted when its last user releases it. None of
+ *        the functions are realtime safe, the rt thread must hand samples that should be
+ *        released over to a non-rt thread.
+ */
+class SampleCache
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(SampleCache);
+
+    SampleCache() = default;
+
+    ~SampleCache();
+
+    /**
+     * @brief Get the cache shared by all sample players
+     */
+    static SampleCache& instance();
+
+    /**
+     * @brief Get a sample, loading it from disk if it is not already in the cache.
+     *        Multichannel files are mixed down to mono.
+     * @param path Path to the sample file
+     * @param max_frames Load at most this many frames from the start of the file
+     * @return A sample that stays valid until passed to release(), or nullptr if the
+     *         file could not be loaded
+     */
+    const CachedSample* acquire(const std::string& path, int max_frames = INT_MAX);
+
+    /**
+     * @brief Release a sample returned from acquire()
+     * @param sample The sample to release, may be nullptr
+     */
+    void release(const CachedSample* sample);
+
+    /**
+     * @brief Get the number of samples currently in the cache
+     */
+    int size() const;
+
+private:
+    struct Entry
+    {
+        CachedSample sample;
+        void* mapping{nullptr};
+        size_t mapping_size{0};
+        int references{0};
+    };
+
+    using Key = std::pair<std::string, int>;
+
+    static std::unique_ptr<Entry> _load(const std::string& path, int max_frames);
+
+    static void _unmap(Entry& entry);
+
+    mutable std::mutex _lock;
+    std::map<Key, std::unique_ptr<Entry>> _entries;
+};
+
+} // end namespace sample_player_plugin
+} // end namespace sushi
+
+#endif //SUSHI_SAMPLE_PLAYER_CACHE_H
@@ -19,7 +19,8 @@
  */
 
 #include <cassert>
-#include <sndfile.h>
+#include <limits>
+#include <tuple>
 
 #include "sample_player_plugin.h"
 #include "logging.h"
@@ -36,6 +37,7 @@ SamplePlayerPlugin::SamplePlayerPlugin(HostControl host_control) : InternalPlugi
     _volume_parameter  = register_float_parameter("volume", "Volume", "dB",
                                                   0.0f, -120.0f, 36.0f,
                                                   new dBToLinPreProcessor(-120.0f, 36.0f));
+    _volume_smoother = register_parameter_smoother(_volume_parameter);
 
     _attack_parameter  = register_float_parameter("attack", "Attack", "s",
                                                   0.0f, 0.0f, 10.0f,
@@ -53,18 +55,42 @@ SamplePlayerPlugin::SamplePlayerPlugin(HostControl host_control) : InternalPlugi
                                                   0.0f, 0.0f, 10.0f,
                                                   new FloatParameterPreProcessor(0.0f, 10.0f));
 
+    _polyphony_parameter = register_int_parameter("polyphony", "Polyphony", "",
+                                                  DEFAULT_POLYPHONY, 1, MAX_POLYPHONY,
+                                                  new IntParameterPreProcessor(1, MAX_POLYPHONY));
+
+    _voice_stealing_parameter = register_int_parameter("voice_stealing", "Voice Stealing", "",
+                                                       VoiceStealingPolicy::OLDEST, 0, VoiceStealingPolicy::POLICY_COUNT - 1,
+                                                       new IntParameterPreProcessor(0, VoiceStealingPolicy::POLICY_COUNT - 1));
+
+    constexpr int MAX_QUALITY = static_cast<int>(dsp::resampler::Quality::QUALITY_COUNT) - 1;
+    _interpolation_parameter = register_int_parameter("interpolation", "Interpolation Quality", "",
+                                                      static_cast<int>(dsp::resampler::Quality::MEDIUM), 0, MAX_QUALITY,
+                                                      new IntParameterPreProcessor(0, MAX_QUALITY));
+    for (int quality = 0; quality <= MAX_QUALITY; ++quality)
+    {
+        _interpolation_tables.emplace_back(static_cast<dsp::resampler::Quality>(quality));
+    }
+
+    /* Output only, set when a voice played silence because the disk streaming fell behind */
+    _underrun_parameter = register_bool_parameter("stream_underrun", "Stream Underrun", "", false);
+
     [[maybe_unused]] bool str_pr_ok = register_string_property("sample_file", "Sample File", "");
-    assert(_volume_parameter && _attack_parameter && _decay_parameter && _sustain_parameter && _release_parameter && str_pr_ok);
+    assert(_volume_parameter && _attack_parameter && _decay_parameter && _sustain_parameter && _release_parameter &&
+           _underrun_parameter && _polyphony_parameter && _voice_stealing_parameter &&
+           _interpolation_parameter && str_pr_ok);
 }
 
 ProcessorReturnCode SamplePlayerPlugin::init(float sample_rate)
 {
     _sample.set_sample(&_dummy_sample, 0);
-    for (auto& voice : _voices)
+    for (size_t i = 0; i < _voices.size(); ++i)
     {
-        voice.set_samplerate(sample_rate);
-        voice.set_sample(&_sample);
+        _voices[i].set_samplerate(sample_rate);
+        _voices[i].set_sample(&_sample);
+        _voices[i].set_stream(&_streamer.stream(i));
     }
+    configure_parameter_smoothers(sample_rate);
 
     return ProcessorReturnCode::OK;
 }
@@ -75,6 +101,7 @@ void SamplePlayerPlugin::configure(float sample_rate)
     {
         voice.set_samplerate(sample_rate);
     }
+    configure_parameter_smoothers(sample_rate);
     return;
 }
 
@@ -93,7 +120,8 @@ void SamplePlayerPlugin::set_bypassed(bool bypassed)
 
 SamplePlayerPlugin::~SamplePlayerPlugin()
 {
-    delete _sample_buffer;
+    SampleCache::instance().release(_cached_sample);
+    SampleCache::instance().release(_pending_sample);
     delete _sample_file_property;
 }
 
@@ -107,31 +135,15 @@ void SamplePlayerPlugin::process_event(const RtEvent& event)
             {
                 break;
             }
-            bool voice_allocated = false;
             auto key_event = event.keyboard_event();
             SUSHI_LOG_DEBUG("Sample Player: note ON, num. {}, vel. {}",
                             key_event->note(), key_event->velocity());
-            for (auto& voice : _voices)
-            {
-                if (!voice.active())
-                {
-                    voice.note_on(key_event->note(), key_event->velocity(), event.sample_offset());
-                    voice_allocated = true;
-                    break;
-                }
-            }
-            // TODO - improve voice stealing algorithm
-            if (!voice_allocated)
-            {
-                for (auto& voice : _voices)
-                {
-                    if (voice.stopping())
-                    {
-                        voice.note_on(key_event->note(), key_event->velocity(), event.sample_offset());
-                        break;
-                    }
-                }
-            }
+            int index = _allocate_voice(key_event->note());
+            auto& voice = _voices[index];
+            voice.set_envelope(_attack_parameter->processed_value(), _decay_parameter->processed_value(),
+                               _sustain_parameter->processed_value(), _release_parameter->processed_value());
+            voice.note_on(key_event->note(), key_event->velocity(), event.sample_offset());
+            _voice_start_order[index] = ++_note_counter;
             break;
         }
         case RtEventType::NOTE_OFF:
@@ -175,13 +187,29 @@ void SamplePlayerPlugin::process_event(const RtEvent& event)
             if (typed_event->sending_event_id() == _pending_event_id &&
                 typed_event->return_status() == SampleChangeStatus::SUCCESS)
             {
-                float* old_sample = _sample_buffer;
-                _sample_buffer = reinterpret_cast<float*>(_pending_sample.data);
-                _sample.set_sample(_sample_buffer, _pending_sample.size / sizeof(float));
-                /* Delete the old sample data outside the rt thread */
-                BlobData data{0, reinterpret_cast<uint8_t*>(old_sample)};
-                auto delete_event = RtEvent::make_delete_blob_event(data);
-                output_event(delete_event);
+                const CachedSample* old_sample = _cached_sample;
+                _cached_sample = _pending_sample;
+                _pending_sample = nullptr;
+                _sample.set_sample(_cached_sample->data, _cached_sample->frames);
+                int streamed_length = _cached_sample->total_frames > _cached_sample->frames ? _cached_sample->total_frames : 0;
+                for (auto& voice : _voices)
+                {
+                    voice.set_streamed_length(streamed_length, _pending_stream_source);
+                }
+                if (streamed_length > 0)
+                {
+                    /* Voices already playing keep streaming from the previous sample */
+                    _streamer.set_current_source(_pending_stream_source);
+                }
+                /* The old sample may be shared with other plugins and is released
+                 * outside the rt thread, the cache evicts it if this was the last user */
+                if (old_sample)
+                {
+                    auto release_event = RtEvent::make_async_work_event(&SamplePlayerPlugin::release_sample_callback,
+                                                                        this->id(),
+                                                                        const_cast<CachedSample*>(old_sample));
+                    output_event(release_event);
+                }
             }
             break;
         }
@@ -195,41 +223,86 @@ void SamplePlayerPlugin::process_event(const RtEvent& event)
 
 void SamplePlayerPlugin::process_audio(const ChunkSampleBuffer& /* in_buffer */, ChunkSampleBuffer &out_buffer)
 {
-    float gain = _volume_parameter->processed_value();
+    _volume_smoother->render();
     float attack = _attack_parameter->processed_value();
     float decay = _decay_parameter->processed_value();
     float sustain = _sustain_parameter->processed_value();
     float release = _release_parameter->processed_value();
 
+    /* Linear interpolation has a faster path in the voices than going through the kernel */
+    int quality = _interpolation_parameter->processed_value();
+    const auto* interpolation = quality == static_cast<int>(dsp::resampler::Quality::LINEAR) ?
+                                nullptr : &_interpolation_tables[quality];
+
     _buffer.clear();
     out_buffer.clear();
+    bool underrun = false;
+    _voices_active = false;
     for (auto& voice : _voices)
     {
-        voice.set_envelope(attack, decay, sustain, release);
-        voice.render(_buffer);
+        if (voice.active())
+        {
+            voice.set_envelope(attack, decay, sustain, release);
+            voice.set_interpolation(interpolation);
+            voice.render(_buffer);
+            underrun |= voice.underrun();
+            _voices_active |= voice.active();
+        }
+    }
+    if (underrun != _underrun_parameter->processed_value())
+    {
+        set_parameter_and_notify(_underrun_parameter, underrun);
     }
     if (!_bypassed)
     {
-        out_buffer.add_with_gain(_buffer, gain);
+        if (_volume_smoother->stationary())
+        {
+            out_buffer.add_with_gain(_buffer, _volume_smoother->value());
+        }
+        else
+        {
+            out_buffer.add_with_envelope(_buffer, _volume_smoother->data());
+        }
     }
 }
 
-BlobData SamplePlayerPlugin::load_sample_file(const std::string &file_name)
+int SamplePlayerPlugin::_allocate_voice(int note)
 {
-    SNDFILE*    sample_file;
-    SF_INFO     soundfile_info = {};
-    if (! (sample_file = sf_open(file_name.c_str(), SFM_READ, &soundfile_info)) )
+    int polyphony = _polyphony_parameter->processed_value();
+    auto policy = _voice_stealing_parameter->processed_value();
+    if (policy == VoiceStealingPolicy::SAME_NOTE)
     {
-        SUSHI_LOG_ERROR("Failed to open sample file: {}", file_name);
-        return {0, nullptr};
+        for (int i = 0; i < polyphony; ++i)
+        {
+            if (_voices[i].active() && _voices[i].current_note() == note)
+            {
+                return i;
+            }
+        }
     }
-    assert(soundfile_info.channels == 1);
-    float* sample_buffer = new float[soundfile_info.frames];
-    int samples = sf_readf_float(sample_file, sample_buffer, soundfile_info.frames);
-    assert(samples == soundfile_info.frames);
-    sf_close(sample_file);
 
-    return BlobData{static_cast<int>(samples * sizeof(float)), reinterpret_cast<uint8_t*>(sample_buffer)};
+    /* Free voices are used first, then voices in their release phase are preferred
+     * over held ones, and the policy decides between those */
+    int best = 0;
+    bool best_held = true;
+    double best_score = std::numeric_limits<double>::max();
+    for (int i = 0; i < polyphony; ++i)
+    {
+        const auto& voice = _voices[i];
+        if (!voice.active())
+        {
+            return i;
+        }
+        bool held = !voice.stopping();
+        double score = policy == VoiceStealingPolicy::QUIETEST ? voice.level() : _voice_start_order[i];
+        if (std::tie(held, score) < std::tie(best_held, best_score))
+        {
+            best = i;
+            best_held = held;
+            best_score = score;
+        }
+    }
+    return best;
 }
 
 int SamplePlayerPlugin::_non_rt_callback(EventId id)
@@ -238,12 +311,17 @@ int SamplePlayerPlugin::_non_rt_callback(EventId id)
     {
         /* Note that this doesn't handle multiple requests at once, several outstanding work
          * requests can leak the address string */
-        auto sample_data = load_sample_file(*_sample_file_property);
+        /* Only the head of long samples is loaded, the rest is streamed from disk */
+        auto sample = SampleCache::instance().acquire(*_sample_file_property, STREAM_HEAD_FRAMES);
+        if (sample && sample->total_frames > sample->frames)
+        {
+            _pending_stream_source = _streamer.add_source(*_sample_file_property);
+        }
         delete _sample_file_property;
         _sample_file_property = nullptr;
-        if (sample_data.size > 0)
+        if (sample)
         {
-            _pending_sample = sample_data;
+            _pending_sample = sample;
             SUSHI_LOG_INFO("SamplePlayer: Successfully loaded sample data");
             return SampleChangeStatus::SUCCESS;
         }
@@ -22,14 +22,18 @@
 #define SUSHI_SAMPLER_PLUGIN_H
 
 #include <array>
+#include <vector>
 
 #include "library/internal_plugin.h"
 #include "plugins/sample_player_voice.h"
+#include "plugins/sample_player_streamer.h"
+#include "plugins/sample_player_cache.h"
 
 namespace sushi {
 namespace sample_player_plugin {
 
-constexpr size_t TOTAL_POLYPHONY = 8;
+constexpr int MAX_POLYPHONY = 128;
+constexpr int DEFAULT_POLYPHONY = 32;
 
 static const std::string DEFAULT_NAME = "sushi.testing.sampleplayer";
 static const std::string DEFAULT_LABEL = "Sample player";
@@ -41,6 +45,18 @@ enum SampleChange : int
     FAILURE
 };}
 
+/**
+ * @brief Which voice to reuse for a new note when all voices are playing. Voices in
+ *        their release phase are always stolen before voices that are held.
+ */
+enum VoiceStealingPolicy : int
+{
+    OLDEST = 0,
+    QUIETEST,
+    SAME_NOTE,
+    POLICY_COUNT
+};
+
 class SamplePlayerPlugin : public InternalPlugin
 {
 public:
@@ -58,31 +74,63 @@ public:
 
     void process_audio(const ChunkSampleBuffer &in_buffer, ChunkSampleBuffer &out_buffer) override;
 
+    /* Voices are only started by note events, which also wake the plugin up. A playing
+     * voice can be silent for a while, so the plugin must not sleep until all are done */
+    int tail_length() const override {return _voices_active ? INFINITE_TAIL_LENGTH : 0;}
+
     static int non_rt_callback(void* data, EventId id)
     {
         return reinterpret_cast<SamplePlayerPlugin*>(data)->_non_rt_callback(id);
     }
 
+    static int release_sample_callback(void* data, EventId /*id*/)
+    {
+        SampleCache::instance().release(reinterpret_cast<const CachedSample*>(data));
+        return SampleChangeStatus::SUCCESS;
+    }
+
 private:
-    BlobData load_sample_file(const std::string &file_name);
     int _non_rt_callback(EventId id);
 
-    float*  _sample_buffer{nullptr};
+    /**
+     * @brief Find a voice for a new note, stealing one if all are busy
+     * @param note The note to play
+     * @return The index of the voice to use
+     */
+    int _allocate_voice(int note);
+
+    const CachedSample* _cached_sample{nullptr};
     float   _dummy_sample{0.0f};
     dsp::Sample _sample;
 
     SampleBuffer<AUDIO_CHUNK_SIZE> _buffer{1};
     FloatParameterValue* _volume_parameter;
+    SmoothedFloatParameter* _volume_smoother;
     FloatParameterValue* _attack_parameter;
     FloatParameterValue* _decay_parameter;
     FloatParameterValue* _sustain_parameter;
     FloatParameterValue* _release_parameter;
+    BoolParameterValue*  _underrun_parameter;
+    IntParameterValue*   _polyphony_parameter;
+    IntParameterValue*   _voice_stealing_parameter;
+    IntParameterValue*   _interpolation_parameter;
 
     std::string*         _sample_file_property{nullptr};
     EventId              _pending_event_id{0};
-    BlobData             _pending_sample{0, 0};
+    const CachedSample*  _pending_sample{nullptr};
+
+    SampleStreamer       _streamer{MAX_POLYPHONY};
+    /* Streamer source of the sample being loaded */
+    int                  _pending_stream_source{-1};
+
+    /* One interpolation kernel for every quality tier, indexed by dsp::resampler::Quality */
+    std::vector<dsp::resampler::PolyphaseTable> _interpolation_tables;
 
-    std::array<sample_player_voice::Voice, TOTAL_POLYPHONY> _voices;
+    std::array<sample_player_voice::Voice, MAX_POLYPHONY> _voices;
+    /* When each voice was last started, to find the oldest one */
+    std::array<uint64_t, MAX_POLYPHONY> _voice_start_order{};
+    uint64_t _note_counter{0};
+    bool _voices_active{false};
 };
 
 
@@ -0,0 +1,272 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Disk streaming of samples too large to keep in memory for the sample player
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <sndfile.h>
+
+#include "sample_player_streamer.h"
+#include "logging.h"
+
+namespace sushi {
+namespace sample_player_plugin {
+
+SUSHI_GET_LOGGER_WITH_MODULE_NAME("sampleplayer");
+
+void VoiceStream::start(int64_t start_frame, int source)
+{
+    _rt_start_frame = start_frame;
+    _start_frame.store(start_frame, std::memory_order_relaxed);
+    _requested_source.store(source, std::memory_order_relaxed);
+    _read_frame.store(start_frame, std::memory_order_relaxed);
+    _requested_generation.store(_requested_generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void VoiceStream::stop()
+{
+    _start_frame.store(-1, std::memory_order_relaxed);
+    _requested_generation.store(_requested_generation.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+int64_t VoiceStream::available_end() const
+{
+    /* Until the streamer has picked up the latest request, the buffer may contain
+     * frames from a previous request */
+    if (_served_generation.load(std::memory_order_acquire) != _requested_generation.load(std::memory_order_relaxed))
+    {
+        return 0;
+    }
+    return _write_frame.load(std::memory_order_acquire);
+}
+
+void VoiceStream::release(int64_t frame)
+{
+    _read_frame.store(std::max(frame, _rt_start_frame), std::memory_order_release);
+}
+
+SampleStreamer::SampleStreamer(int streams, int buffer_frames, int read_frames) : _streams(new VoiceStream[streams]),
+                                                                                  _stream_count(streams),
+                                                                                  _read_frames(read_frames)
+{
+    _buffer_frames = 1;
+    while (_buffer_frames < buffer_frames)
+    {
+        _buffer_frames *= 2;
+    }
+    assert(_read_frames <= _buffer_frames);
+}
+
+SampleStreamer::~SampleStreamer()
+{
+    if (_running)
+    {
+        _running = false;
+        _thread.join();
+    }
+    for (auto& source : _sources)
+    {
+        if (source.file)
+        {
+            sf_close(source.file);
+        }
+    }
+}
+
+int SampleStreamer::add_source(const std::string& path)
+{
+    std::scoped_lock lock(_source_lock);
+    Source source;
+    source.id = _next_source_id++;
+    source.path = path;
+    _sources.push_back(source);
+
+    if (_running == false)
+    {
+        /* Buffers are allocated on first use so that sample players with only
+         * small samples don't pay for them */
+        for (int i = 0; i < _stream_count; ++i)
+        {
+            _streams[i]._buffer = std::make_unique<float[]>(_buffer_frames);
+            _streams[i]._mask = _buffer_frames - 1;
+        }
+        _read_buffer.resize(_read_frames);
+        _running = true;
+        _thread = std::thread(&SampleStreamer::_worker, this);
+    }
+    return source.id;
+}
+
+void SampleStreamer::_worker()
+{
+    while (_running)
+    {
+        if (_service() == false)
+        {
+            std::this_thread::sleep_for(STREAMER_THREAD_PERIODICITY);
+        }
+    }
+}
+
+bool SampleStreamer::_service()
+{
+    std::scoped_lock lock(_source_lock);
+    /* Read before the stream requests, so that any stream started from an older source
+     * before the rt thread switched sources is seen in the loop below */
+    int current = _current_source.load(std::memory_order_acquire);
+    bool busy = false;
+    for (int i = 0; i < _stream_count; ++i)
+    {
+        busy |= _service_stream(_streams[i]);
+    }
+    _remove_unused_sources(current);
+    return busy;
+}
+
+bool SampleStreamer::_service_stream(VoiceStream& stream)
+{
+    uint32_t generation = stream._requested_generation.load(std::memory_order_acquire);
+    if (generation != stream._generation)
+    {
+        /* New request from the rt thread */
+        stream._generation = generation;
+        stream._position = stream._start_frame.load(std::memory_order_relaxed);
+        stream._source = stream._requested_source.load(std::memory_order_relaxed);
+        stream._write_frame.store(std::max<int64_t>(stream._position, 0), std::memory_order_relaxed);
+        stream._served_generation.store(generation, std::memory_order_release);
+    }
+
+    if (stream._position < 0)
+    {
+        return false;
+    }
+    Source* source = _find_source(stream._source);
+    if (source == nullptr || (source->file == nullptr && _open_source(*source) == false))
+    {
+        return false;
+    }
+
+    int64_t free_frames = stream._read_frame.load(std::memory_order_acquire) + _buffer_frames - stream._position;
+    int64_t frames = std::min({free_frames, static_cast<int64_t>(_read_frames), source->frames - stream._position});
+    if (frames <= 0)
+    {
+        return false;
+    }
+
+    /* Streams from the same source share the file, so it is only sought when another
+     * stream read from it since this stream did */
+    if (source->position != stream._position)
+    {
+        sf_seek(source->file, stream._position, SEEK_SET);
+        source->position = stream._position;
+    }
+    /* The read buffer is sized for mono files, read multichannel files in several passes */
+    int frames_per_read = static_cast<int>(_read_buffer.size()) / source->channels;
+    int64_t frame = stream._position;
+    int64_t end = stream._position + frames;
+    while (frame < end)
+    {
+        int read_frames = static_cast<int>(std::min<int64_t>(frames_per_read, end - frame));
+        int read = static_cast<int>(sf_readf_float(source->file, _read_buffer.data(), read_frames));
+        if (read <= 0)
+        {
+            SUSHI_LOG_WARNING("Failed to read from sample file at frame {}", frame);
+            source->frames = frame;
+            break;
+        }
+        /* Multichannel files are mixed down to mono */
+        float gain = 1.0f / source->channels;
+        for (int i = 0; i < read; ++i)
+        {
+            float value = 0.0f;
+            for (int c = 0; c < source->channels; ++c)
+            {
+                value += _read_buffer[i * source->channels + c];
+            }
+            stream._buffer[(frame + i) & stream._mask] = value * gain;
+        }
+        frame += read;
+    }
+    source->position = frame;
+    stream._position = frame;
+    stream._write_frame.store(frame, std::memory_order_release);
+    return true;
+}
+
+SampleStreamer::Source* SampleStreamer::_find_source(int id)
+{
+    for (auto& source : _sources)
+    {
+        if (source.id == id)
+        {
+            return &source;
+        }
+    }
+    return nullptr;
+}
+
+bool SampleStreamer::_open_source(Source& source)
+{
+    if (source.failed)
+    {
+        return false;
+    }
+    SF_INFO info = {};
+    source.file = sf_open(source.path.c_str(), SFM_READ, &info);
+    if (source.file == nullptr)
+    {
+        SUSHI_LOG_ERROR("Failed to open sample file for streaming: {}", source.path);
+        source.failed = true;
+        return false;
+    }
+    source.channels = std::max(info.channels, 1);
+    source.frames = info.frames;
+    source.position = 0;
+    if (static_cast<int>(_read_buffer.size()) < source.channels)
+    {
+        _read_buffer.resize(source.channels);
+    }
+    return true;
+}
+
+void SampleStreamer::_remove_unused_sources(int current)
+{
+    _sources.erase(std::remove_if(_sources.begin(), _sources.end(), [&](Source& source)
+    {
+        if (source.id >= current)
+        {
+            return false;
+        }
+        for (int i = 0; i < _stream_count; ++i)
+        {
+            if (_streams[i]._position >= 0 && _streams[i]._source == source.id)
+            {
+                return false;
+            }
+        }
+        if (source.file)
+        {
+            sf_close(source.file);
+        }
+        return true;
+    }), _sources.end());
+}
+
+} // end namespace sample_player_plugin
+} // end namespace sushi
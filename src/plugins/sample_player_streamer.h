@@ -0,0 +1,220 @@
+/*
+ * Copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk
+ *
+ * SUSHI is free software: you can redistribute it and/or modify it under the terms of
+ * the GNU Affero General Public License as published by the Free Software Foundation,
+ * either version 3 of the License, or (at your option) any later version.
+ *
+ * SUSHI is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY;
+ * without even the implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR
+ * PURPOSE.  See the GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License along with
+ * SUSHI.  If not, see http://www.gnu.org/licenses/
+ */
+
+/**
+ * @brief Disk streaming of samples too large to keep in memory for the sample player
+ * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
+ *
+ * Only the first STREAM_HEAD_FRAMES frames of a large sample are kept in memory. When a
+ * voice starts, its VoiceStream requests the frames following the head and a background
+ * thread reads them from disk into the stream's ring buffer ahead of the playback
+ * position, while the voice plays the head. The rt thread never waits for the disk,
+ * frames that have not arrived in time are played as silence and reported as underruns.
+ */
+
+#ifndef SUSHI_SAMPLE_PLAYER_STREAMER_H
+#define SUSHI_SAMPLE_PLAYER_STREAMER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "library/constants.h"
+
+struct SNDFILE_tag;
+
+namespace sushi {
+namespace sample_player_plugin {
+
+/* Around 1.5 seconds at 44.1 kHz, resident in memory for every streamed sample */
+constexpr int STREAM_HEAD_FRAMES = 65536;
+/* Read ahead buffer for every voice, around 0.4 seconds at 44.1 kHz */
+constexpr int STREAM_BUFFER_FRAMES = 16384;
+/* Number of frames read from disk at a time */
+constexpr int STREAM_READ_FRAMES = 4096;
+constexpr auto STREAMER_THREAD_PERIODICITY = std::chrono::milliseconds(2);
+
+/**
+ * @brief Read ahead buffer of one voice. Written by the streamer thread and read by the
+ *        rt thread. Frames are indexed with their absolute position in the sample file.
+ */
+class VoiceStream
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(VoiceStream);
+
+    VoiceStream() = default;
+
+    /**
+     * @brief Request frames from start_frame and onwards, discarding any previous
+     *        frames. Called from the rt thread.
+     * @param start_frame The first frame to stream
+     * @param source The id of the sample file to stream from, as returned by
+     *        SampleStreamer::add_source()
+     */
+    void start(int64_t start_frame, int source);
+
+    /**
+     * @brief Stop streaming. Called from the rt thread.
+     */
+    void stop();
+
+    /**
+     * @brief Get the end of the frames that are ready to be read. All frames from the
+     *        start frame, or the last frame released, up to but not including the
+     *        returned frame can be read with frame(). Called from the rt thread.
+     * @return The frame after the last available frame
+     */
+    int64_t available_end() const;
+
+    /**
+     * @brief Read a frame, which must be available according to available_end()
+     */
+    float frame(int64_t frame) const {return _buffer[frame & _mask];}
+
+    /**
+     * @brief Tell the streamer that frames before frame will not be read again, so
+     *        their space can be reused. Called from the rt thread.
+     */
+    void release(int64_t frame);
+
+private:
+    friend class SampleStreamer;
+
+    std::unique_ptr<float[]> _buffer;
+    int64_t _mask{0};
+
+    /* Written by the rt thread */
+    std::atomic<uint32_t> _requested_generation{0};
+    std::atomic<int64_t>  _start_frame{-1};
+    std::atomic<int>      _requested_source{-1};
+    std::atomic<int64_t>  _read_frame{0};
+    int64_t               _rt_start_frame{0};
+
+    /* Written by the streamer thread */
+    std::atomic<uint32_t> _served_generation{0};
+    std::atomic<int64_t>  _write_frame{0};
+
+    /* Only accessed from the streamer thread */
+    uint32_t              _generation{0};
+    int                   _source{-1};
+    int64_t               _position{-1};
+};
+
+/**
+ * @brief Owns a set of VoiceStreams and the thread that fills them from disk. Every
+ *        sample file is a source with its own id, and every stream reads from the
+ *        source it was started with, so that voices still playing a previous sample
+ *        are not affected when a new one is loaded. All streams from the same source
+ *        share one file reader.
+ */
+class SampleStreamer
+{
+public:
+    SUSHI_DECLARE_NON_COPYABLE(SampleStreamer);
+
+    /**
+     * @brief Create a streamer
+     * @param streams The number of VoiceStreams, typically one per voice
+     * @param buffer_frames Size of every stream buffer, rounded up to a power of 2
+     * @param read_frames The number of frames to read from disk at a time
+     */
+    explicit SampleStreamer(int streams,
+                            int buffer_frames = STREAM_BUFFER_FRAMES,
+                            int read_frames = STREAM_READ_FRAMES);
+
+    ~SampleStreamer();
+
+    /**
+     * @brief Add a file to stream from and start the streamer thread if not already
+     *        running. The file is opened when a stream first reads from it. Not safe
+     *        to call from the rt thread.
+     * @param path Path to the sample file
+     * @return The id of the source, to pass to VoiceStream::start()
+     */
+    int add_source(const std::string& path);
+
+    /**
+     * @brief Tell the streamer which source new streams are started from. Older
+     *        sources are closed once no stream reads from them anymore. Called from
+     *        the rt thread.
+     * @param source The id of the source
+     */
+    void set_current_source(int source)
+    {
+        _current_source.store(source, std::memory_order_release);
+    }
+
+    VoiceStream& stream(int index) {return _streams[index];}
+
+    int streams() const {return _stream_count;}
+
+private:
+    void _worker();
+
+    /**
+     * @brief Service all streams once
+     * @return true if any frames were read from disk
+     */
+    bool _service();
+
+    struct Source
+    {
+        int id;
+        std::string path;
+        SNDFILE_tag* file{nullptr};
+        bool failed{false};
+        int channels{1};
+        int64_t frames{0};
+        /* Current read position of the file, to avoid seeking when reading sequentially */
+        int64_t position{0};
+    };
+
+    bool _service_stream(VoiceStream& stream);
+
+    Source* _find_source(int id);
+
+    bool _open_source(Source& source);
+
+    /**
+     * @brief Close and forget sources older than current that no stream is reading from
+     */
+    void _remove_unused_sources(int current);
+
+    std::unique_ptr<VoiceStream[]> _streams;
+    int _stream_count;
+    int _buffer_frames;
+    int _read_frames;
+    std::vector<float> _read_buffer;
+
+    /* Held by the streamer thread while servicing streams */
+    std::mutex _source_lock;
+    std::vector<Source> _sources;
+    int _next_source_id{0};
+    std::atomic<int> _current_source{-1};
+
+    std::thread _thread;
+    std::atomic<bool> _running{false};
+};
+
+} // end namespace sample_player_plugin
+} // end namespace sushi
+
+#endif //SUSHI_SAMPLE_PLAYER_STREAMER_H
@@ -18,10 +18,12 @@
  * @copyright 2017-2019 Modern Ancient Instruments Networked AB, dba Elk, Stockholm
  */
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 
 #include "plugins/sample_player_voice.h"
+#include "library/simd_kernels.h"
 
 namespace sample_player_voice {
 
@@ -37,8 +39,23 @@ namespace sample_player_voice {
 void Voice::note_on(int note, float velocity, int offset)
 {
     offset = std::min(offset, AUDIO_CHUNK_SIZE - 1);
+    if (_state == SamplePlayMode::PLAYING || _state == SamplePlayMode::STOPPING ||
+        _state == SamplePlayMode::RETRIGGERING)
+    {
+        /* Cutting off a sounding note would click, so it is faded out first */
+        _state = SamplePlayMode::RETRIGGERING;
+        _pending_note = note;
+        _pending_velocity = velocity;
+        _pending_offset = offset;
+        _pending_note_off = false;
+        return;
+    }
+    /* A note that has not been rendered yet is replaced right away */
+    _start_note(note, velocity, offset);
+}
 
-    /* Completely ignore any currently playing note, it will be cut off abruptly */
+void Voice::_start_note(int note, float velocity, int offset)
+{
     _state = SamplePlayMode::STARTING;
     /* Quadratic velocity curve */
     _velocity_gain = velocity * velocity;
@@ -49,13 +66,22 @@ void Voice::note_on(int note, float velocity, int offset)
     /* The root note of the sample is assumed to be C4 in 44100 Hz*/
     _playback_speed = powf(2, (note - 60)/12.0f) * _samplerate / SAMPLE_FILE_RATE;
     _envelope.gate(true);
+    if (_streamed_length > 0)
+    {
+        /* Playback starts from the head, the stream takes over where it ends */
+        _stream->start(_sample->length(), _stream_source);
+    }
 }
 
 /* Release velocity is ignored atm. Has any synth ever supported it? */
 void Voice::note_off(float /*velocity*/, int offset)
 {
     assert(offset < AUDIO_CHUNK_SIZE);
-    if (_state == SamplePlayMode::PLAYING || _state == SamplePlayMode::STARTING)
+    if (_state == SamplePlayMode::RETRIGGERING)
+    {
+        _pending_note_off = true;
+    }
+    else if (_state == SamplePlayMode::PLAYING || _state == SamplePlayMode::STARTING)
     {
         _state = SamplePlayMode::STOPPING;
         _stop_offset = offset;
@@ -66,6 +92,7 @@ void Voice::reset()
 {
     _state = SamplePlayMode::STOPPED;
     _envelope.reset();
+    _stop_stream();
 }
 
 void Voice::render(sushi::SampleBuffer<AUDIO_CHUNK_SIZE>& output_buffer)
@@ -76,24 +103,42 @@ void Voice::render(sushi::SampleBuffer<AUDIO_CHUNK_SIZE>& output_buffer)
     }
     /* Handle only mono samples for now */
     float* out = output_buffer.channel(0);
-
-    for (int i = _start_offset; i < _stop_offset; ++i)
+    _underrun = false;
+    if (_streamed_length > 0)
     {
-        out[i] += _sample->at(_playback_pos) * _velocity_gain * _envelope.tick(1);
-        _playback_pos += _playback_speed;
+        _stream_end = _stream->available_end();
     }
 
-    /* If there is a note off event, set the envelope to off and
-     * render the rest of the chunk */
+    /* The envelope and the sample are rendered separately for the whole chunk and
+     * then mixed into the output in one pass */
+    float gain[AUDIO_CHUNK_SIZE];
+    float samples[AUDIO_CHUNK_SIZE];
+    int start = _start_offset;
     if (_state == SamplePlayMode::STOPPING)
     {
+        /* If there is a note off event, set the envelope to off and
+         * render the rest of the chunk */
+        int stop = std::max(_stop_offset, start);
+        _envelope.render(gain + start, stop - start);
         _envelope.gate(false);
-        for (int i = _stop_offset; i < AUDIO_CHUNK_SIZE; ++i)
+        _envelope.render(gain + stop, AUDIO_CHUNK_SIZE - stop);
+    }
+    else
+    {
+        _envelope.render(gain + start, AUDIO_CHUNK_SIZE - start);
+    }
+    int count = AUDIO_CHUNK_SIZE - start;
+    _render_sample(samples + start, count);
+    const auto& kernels = sushi::simd::kernels();
+    kernels.apply_gain(gain + start, _velocity_gain, count);
+    if (_state == SamplePlayMode::RETRIGGERING)
+    {
+        for (int i = start; i < AUDIO_CHUNK_SIZE; ++i)
         {
-            out[i] += _sample->at(_playback_pos) * _velocity_gain * _envelope.tick(1);
-            _playback_pos += _playback_speed;
+            gain[i] *= static_cast<float>(AUDIO_CHUNK_SIZE - 1 - i) / (AUDIO_CHUNK_SIZE - start);
         }
     }
+    kernels.add_with_envelope(out + start, samples + start, gain + start, count);
 
     /* Handle state changes and reset render limits */
     switch (_state)
@@ -107,6 +152,7 @@ void Voice::render(sushi::SampleBuffer<AUDIO_CHUNK_SIZE>& output_buffer)
             if (_envelope.finished())
             {
                 _state = SamplePlayMode::STOPPED;
+                _stop_stream();
             }
             break;
 
@@ -114,6 +160,127 @@ void Voice::render(sushi::SampleBuffer<AUDIO_CHUNK_SIZE>& output_buffer)
             break;
     }
 
+    if (_streamed_length > 0 && _state != SamplePlayMode::STOPPED)
+    {
+        /* The interpolation reads a few frames before the playback position */
+        int history = _interpolation ? _interpolation->history() : 0;
+        _stream->release(static_cast<int64_t>(_playback_pos) - history);
+    }
+
+    if (_state == SamplePlayMode::RETRIGGERING)
+    {
+        _start_note(_pending_note, _pending_velocity, _pending_offset);
+        if (_pending_note_off)
+        {
+            _state = SamplePlayMode::STOPPING;
+            _stop_offset = _pending_offset;
+        }
+    }
+}
+
+void Voice::_render_sample(float* output, int samples)
+{
+    double last_position = _playback_pos + (samples - 1) * static_cast<double>(_playback_speed);
+    int history = _interpolation ? _interpolation->history() : 0;
+    int ahead = _interpolation ? _interpolation->taps() / 2 : 1;
+    if (_streamed_length > 0 || _playback_pos < history || last_position + ahead >= _sample->length())
+    {
+        /* Near the edges of the sample or reading from a stream */
+        for (int i = 0; i < samples; ++i)
+        {
+            output[i] = _sample_at(_playback_pos);
+            _playback_pos += _playback_speed;
+        }
+        return;
+    }
+
+    /* All positions are inside the sample, so no bounds checks are needed */
+    const float* data = _sample->data();
+    double position = _playback_pos;
+    double speed = _playback_speed;
+    if (_interpolation)
+    {
+        for (int i = 0; i < samples; ++i)
+        {
+            double frame_position = position + i * speed;
+            int frame = static_cast<int>(frame_position);
+            float weight = static_cast<float>(frame_position - frame);
+            output[i] = _interpolation->interpolate(data + frame - history, weight);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < samples; ++i)
+        {
+            double frame_position = position + i * speed;
+            int frame = static_cast<int>(frame_position);
+            float weight = static_cast<float>(frame_position - frame);
+            output[i] = data[frame] + weight * (data[frame + 1] - data[frame]);
+        }
+    }
+    _playback_pos = position + samples * speed;
+}
+
+float Voice::_sample_at(double position)
+{
+    int64_t frame = static_cast<int64_t>(position);
+    float weight = position - frame;
+    if (_interpolation)
+    {
+        float taps[dsp::resampler::MAX_INTERPOLATION_TAPS];
+        int first = frame - _interpolation->history();
+        for (int i = 0; i < _interpolation->taps(); ++i)
+        {
+            taps[i] = _frame_at(first + i);
+        }
+        return _interpolation->interpolate(taps, weight);
+    }
+    if (_streamed_length == 0 || position + 1 < _sample->length())
+    {
+        return _sample->at(position);
+    }
+    return _streamed_frame(frame + 1) * weight + _streamed_frame(frame) * (1.0f - weight);
+}
+
+float Voice::_frame_at(int64_t frame)
+{
+    if (frame < 0)
+    {
+        return 0.0f;
+    }
+    if (_streamed_length > 0)
+    {
+        return _streamed_frame(frame);
+    }
+    return frame < _sample->length() ? _sample->data()[frame] : 0.0f;
+}
+
+float Voice::_streamed_frame(int64_t frame)
+{
+    if (frame < _sample->length())
+    {
+        return _sample->at(static_cast<double>(frame));
+    }
+    if (frame >= _streamed_length)
+    {
+        return 0.0f;
+    }
+    if (frame >= _stream_end)
+    {
+        /* The streamer has not caught up, never wait for it in the rt thread */
+        _underrun = true;
+        return 0.0f;
+    }
+    return _stream->frame(frame);
+}
+
+void Voice::_stop_stream()
+{
+    /* Also if the sample was changed to one that is not streamed while playing */
+    if (_stream)
+    {
+        _stream->stop();
+    }
 }
 
 }// namespace sample_player_voice
\ No newline at end of file
@@ -24,6 +24,8 @@
 #include "library/sample_buffer.h"
 #include "dsp_library/sample_wrapper.h"
 #include "dsp_library/envelopes.h"
+#include "dsp_library/resampler.h"
+#include "plugins/sample_player_streamer.h"
 
 namespace sample_player_voice {
 
@@ -35,7 +37,9 @@ enum class SamplePlayMode
     STOPPED,
     STARTING,
     PLAYING,
-    STOPPING
+    STOPPING,
+    /* The current note fades out during the next chunk, then the pending note starts */
+    RETRIGGERING
 };
 
 
@@ -65,6 +69,38 @@ public:
      */
     void set_sample(dsp::Sample* sample) {_sample = sample;}
 
+    /**
+     * @brief Set the kernel used to interpolate the sample when it is played at a
+     *        different pitch than the original.
+     * @param table The interpolation kernel, or nullptr for linear interpolation
+     */
+    void set_interpolation(const dsp::resampler::PolyphaseTable* table) {_interpolation = table;}
+
+    /**
+     * @brief Set the stream to read from when playing streamed samples
+     * @param stream The stream this voice reads from, not shared with other voices
+     */
+    void set_stream(sushi::sample_player_plugin::VoiceStream* stream) {_stream = stream;}
+
+    /**
+     * @brief Set the full length of the sample when only its head is loaded in
+     *        memory and the rest is streamed from disk.
+     * @param length The length of the sample in frames, or 0 if the sample is not streamed
+     * @param source The streamer source of the sample, not used if length is 0
+     */
+    void set_streamed_length(int64_t length, int source = -1)
+    {
+        _streamed_length = length;
+        _stream_source = source;
+    }
+
+    /**
+     * @brief Whether the stream failed to provide samples in time during the last
+     *        call to render()
+     * @return True if the voice played silence instead of streamed samples
+     */
+    bool underrun() const {return _underrun;}
+
     /**
      * @brief Set the envelope parameters.
      */
@@ -77,22 +113,31 @@ public:
      * @brief Is currently playing sound.
      * @return True if currently playing sound.
      */
-    bool active() {return (_state != SamplePlayMode::STOPPED);}
+    bool active() const {return (_state != SamplePlayMode::STOPPED);}
 
     /**
      * @brief Is currently in the release phase but still playing.
      * @return True if note is currently off but still sounding.
      */
-    bool stopping() {return _state == SamplePlayMode::STOPPING;}
+    bool stopping() const {return _state == SamplePlayMode::STOPPING;}
 
     /**
-     * @brief Return the current note being played, if any.
+     * @brief Get the current output level of the voice, before the sample itself.
+     * @return The envelope level scaled by the note velocity
+     */
+    float level() const {return _envelope.level() * _velocity_gain;}
+
+    /**
+     * @brief Return the current note being played, if any. When retriggering, this is
+     *        the note that is about to start.
      * @return The current note as a midi note number.
      */
-    int current_note() {return _current_note;}
+    int current_note() const {return _state == SamplePlayMode::RETRIGGERING ? _pending_note : _current_note;}
 
     /**
-     * @brief Play a new note within this audio chunk
+     * @brief Play a new note within this audio chunk. If the voice is already sounding,
+     *        the playing note is faded out over one chunk to avoid clicks and the new
+     *        note starts one chunk later.
      * @param note The midi note number to play, with 60 as middle C.
      * @param velocity Velocity of the note to play. 0 to 1.
      * @param time_offset Offset in samples from the start of the chunk.
@@ -118,17 +163,47 @@ public:
     void render(sushi::SampleBuffer<AUDIO_CHUNK_SIZE>& output_buffer);
 
 private:
+    /**
+     * @brief Interpolated sample value at position, reading from the stream
+     *        past the end of the sample head
+     */
+    float _sample_at(double position);
+
+    /**
+     * @brief Interpolate samples samples from the current playback position and advance it
+     */
+    void _render_sample(float* output, int samples);
+
+    float _streamed_frame(int64_t frame);
+
+    float _frame_at(int64_t frame);
+
+    void _stop_stream();
+
+    void _start_note(int note, float velocity, int offset);
 
     float _samplerate{44100};
     dsp::Sample* _sample;
+    const dsp::resampler::PolyphaseTable* _interpolation{nullptr};
     SamplePlayMode _state{SamplePlayMode::STOPPED};
     dsp::AdsrEnvelope _envelope;
     int _current_note;
     float _playback_speed;
-    float _velocity_gain;
+    float _velocity_gain{0.0f};
     double _playback_pos{0.0};
     int _start_offset{0};
     int _stop_offset{0};
+
+    int _pending_note{0};
+    float _pending_velocity{0.0f};
+    int _pending_offset{0};
+    bool _pending_note_off{false};
+
+    sushi::sample_player_plugin::VoiceStream* _stream{nullptr};
+    int64_t _streamed_length{0};
+    int _stream_source{-1};
+    int64_t _stream_end{0};
+    bool _underrun{false};
 };
 
 } // end namespace sample_player_voice
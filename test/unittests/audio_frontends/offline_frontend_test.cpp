@@ -68,6 +68,8 @@ TEST_F(TestOfflineFrontend, TestWavProcessing)
     {
         EXPECT_TRUE(false) << "Error opening output file: " << output_file_name;
     }
+    /* The file is 48 kHz, so it is converted to the engine rate */
+    EXPECT_EQ(static_cast<int>(SAMPLE_RATE), soundfile_info.samplerate);
 
     float file_buffer[_engine.n_channels_in_track(0) * AUDIO_CHUNK_SIZE];
     unsigned int readcount;
@@ -77,7 +79,8 @@ TEST_F(TestOfflineFrontend, TestWavProcessing)
     {
         for (unsigned int n=0; n<(readcount * _engine.n_channels_in_track(0)); n++)
         {
-            ASSERT_FLOAT_EQ(0.5f, file_buffer[n]);
+            /* Allow for rounding in the resampler */
+            ASSERT_NEAR(0.5f, file_buffer[n], 1.0e-5f);
         }
     }
 
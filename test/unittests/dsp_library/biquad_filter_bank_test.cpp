@@ -0,0 +1,151 @@
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "dsp_library/biquad_filter_bank.cpp"
+
+using namespace dsp::biquad;
+
+constexpr float TEST_SAMPLE_RATE = 48000;
+constexpr int TEST_SAMPLES = 150;
+
+/* Plain transposed direct form II cascade without smoothing to compare against */
+void reference_cascade(const std::vector<Coefficients>& sections, const float* input, float* output, int samples)
+{
+    std::vector<DelayRegisters> registers(sections.size(), {0.0f, 0.0f});
+    for (int n = 0; n < samples; ++n)
+    {
+        float x = input[n];
+        for (size_t s = 0; s < sections.size(); ++s)
+        {
+            const auto& c = sections[s];
+            auto& z = registers[s];
+            float y = c.b0 * x + z.z1;
+            z.z1 = c.b1 * x - c.a1 * y + z.z2;
+            z.z2 = c.b2 * x - c.a2 * y;
+            x = y;
+        }
+        output[n] = x;
+    }
+}
+
+std::vector<float> make_test_signal(int seed)
+{
+    std::vector<float> signal(TEST_SAMPLES);
+    for (int n = 0; n < TEST_SAMPLES; ++n)
+    {
+        signal[n] = ((n * 7 + seed * 13) % 23) / 23.0f - 0.5f;
+    }
+    return signal;
+}
+
+TEST(TestBiquadFilterBank, TestUnityByDefault)
+{
+    BiquadFilterBank module_under_test(3);
+    ASSERT_EQ(3, module_under_test.sections());
+    auto signal = make_test_signal(0);
+    std::vector<float> result(TEST_SAMPLES);
+    const float* input[] = {signal.data()};
+    float* output[] = {result.data()};
+    module_under_test.process(input, output, 1, TEST_SAMPLES);
+    for (int n = 0; n < TEST_SAMPLES; ++n)
+    {
+        ASSERT_FLOAT_EQ(signal[n], result[n]);
+    }
+}
+
+TEST(TestBiquadFilterBank, TestMatchesScalarCascade)
+{
+    constexpr int LANES = 3;
+    constexpr int SECTIONS = 2;
+    BiquadFilterBank module_under_test(SECTIONS);
+
+    /* Every lane and section has different coefficients */
+    std::vector<std::vector<Coefficients>> coefficients(LANES, std::vector<Coefficients>(SECTIONS));
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        for (int section = 0; section < SECTIONS; ++section)
+        {
+            calc_biquad_peak(coefficients[lane][section], TEST_SAMPLE_RATE, 200.0f + 1000.0f * lane + 5000.0f * section,
+                             0.7f + 0.5f * section, 0.25f + lane);
+            module_under_test.set_coefficients(section, lane, coefficients[lane][section]);
+        }
+    }
+    module_under_test.reset();
+
+    std::vector<std::vector<float>> signals;
+    std::vector<std::vector<float>> results(LANES, std::vector<float>(TEST_SAMPLES));
+    const float* input[LANES];
+    float* output[LANES];
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        signals.push_back(make_test_signal(lane));
+    }
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        input[lane] = signals[lane].data();
+        output[lane] = results[lane].data();
+    }
+    /* Odd sizes to test the splitting into blocks */
+    module_under_test.process(input, output, LANES, TEST_SAMPLES);
+
+    std::vector<float> expected(TEST_SAMPLES);
+    for (int lane = 0; lane < LANES; ++lane)
+    {
+        reference_cascade(coefficients[lane], signals[lane].data(), expected.data(), TEST_SAMPLES);
+        for (int n = 0; n < TEST_SAMPLES; ++n)
+        {
+            ASSERT_NEAR(expected[n], results[lane][n], 1.0e-5f);
+        }
+    }
+}
+
+TEST(TestBiquadFilterBank, TestInPlace)
+{
+    BiquadFilterBank module_under_test(1);
+    Coefficients coefficients;
+    calc_biquad_peak(coefficients, TEST_SAMPLE_RATE, 1000.0f, 1.0f, 2.0f);
+    module_under_test.set_coefficients(0, coefficients);
+    module_under_test.reset();
+
+    auto signal = make_test_signal(1);
+    std::vector<float> expected(TEST_SAMPLES);
+    reference_cascade({coefficients}, signal.data(), expected.data(), TEST_SAMPLES);
+
+    float* channels[] = {signal.data()};
+    module_under_test.process(channels, channels, 1, TEST_SAMPLES);
+    for (int n = 0; n < TEST_SAMPLES; ++n)
+    {
+        ASSERT_NEAR(expected[n], signal[n], 1.0e-5f);
+    }
+}
+
+TEST(TestBiquadFilterBank, TestSmoothing)
+{
+    BiquadFilterBank module_under_test(2);
+    module_under_test.set_smoothing(64);
+    Coefficients coefficients;
+    calc_biquad_peak(coefficients, TEST_SAMPLE_RATE, 1000.0f, 1.0f, 2.0f);
+    module_under_test.set_coefficients(1, 2, coefficients);
+    EXPECT_TRUE(module_under_test._smoothing);
+
+    std::vector<float> buffer(64, 0.0f);
+    float* channels[] = {buffer.data(), buffer.data(), buffer.data()};
+    module_under_test.process(channels, channels, 3, 1);
+    /* Only the changed lane should move, and not all the way at once */
+    float b0 = module_under_test._sections[1].coefficients[0][2];
+    EXPECT_GT(b0, 1.0f);
+    EXPECT_LT(b0, coefficients.b0);
+    EXPECT_FLOAT_EQ(1.0f, module_under_test._sections[1].coefficients[0][1]);
+    EXPECT_FLOAT_EQ(1.0f, module_under_test._sections[0].coefficients[0][2]);
+
+    for (int i = 0; i < 10; ++i)
+    {
+        module_under_test.process(channels, channels, 3, 64);
+    }
+    EXPECT_FALSE(module_under_test._smoothing);
+    EXPECT_FLOAT_EQ(coefficients.b0, module_under_test._sections[1].coefficients[0][2]);
+    EXPECT_FLOAT_EQ(coefficients.a2, module_under_test._sections[1].coefficients[4][2]);
+}
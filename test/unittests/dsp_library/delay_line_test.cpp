@@ -0,0 +1,54 @@
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "dsp_library/delay_line.h"
+
+#include "test_utils/test_utils.h"
+
+using namespace sushi;
+
+constexpr int TEST_MAX_DELAY = 200;
+
+class TestDelayLine : public ::testing::Test
+{
+protected:
+    TestDelayLine() {}
+
+    dsp::DelayLine _module_under_test{TEST_MAX_DELAY};
+};
+
+TEST_F(TestDelayLine, TestNoDelay)
+{
+    ChunkSampleBuffer buffer(1);
+    test_utils::fill_sample_buffer(buffer, 1.0f);
+    EXPECT_EQ(0, _module_under_test.delay());
+    test_utils::assert_buffer_value(1.0f, _module_under_test.process(buffer), test_utils::DECIBEL_ERROR);
+}
+
+TEST_F(TestDelayLine, TestDelay)
+{
+    _module_under_test.set_delay(AUDIO_CHUNK_SIZE + 10);
+    EXPECT_EQ(AUDIO_CHUNK_SIZE + 10, _module_under_test.delay());
+
+    /* An impulse should come out the set number of samples later, also across chunks */
+    ChunkSampleBuffer buffer(1);
+    buffer.channel(0)[0] = 1.0f;
+    const auto& first = _module_under_test.process(buffer);
+    test_utils::assert_buffer_value(0.0f, first, test_utils::DECIBEL_ERROR);
+
+    buffer.clear();
+    const auto& second = _module_under_test.process(buffer);
+    for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+    {
+        EXPECT_FLOAT_EQ(i == 10 ? 1.0f : 0.0f, second.channel(0)[i]);
+    }
+}
+
+TEST_F(TestDelayLine, TestDelayIsLimited)
+{
+    _module_under_test.set_delay(TEST_MAX_DELAY + 1);
+    EXPECT_EQ(TEST_MAX_DELAY, _module_under_test.delay());
+    _module_under_test.set_delay(-1);
+    EXPECT_EQ(0, _module_under_test.delay());
+}
@@ -66,3 +66,34 @@ TEST_F(TestADSREnvelope, TestParameterLimits)
     EXPECT_FLOAT_EQ(0.0f, level);
     EXPECT_FLOAT_EQ(0.0f, _module_under_test.level());
 }
+
+TEST_F(TestADSREnvelope, TestRender)
+{
+    /* A samplerate where all slopes are exact in binary, so that accumulated and
+     * computed levels are equal */
+    AdsrEnvelope reference;
+    reference.set_samplerate(64);
+    reference.set_parameters(1, 1, 0.5, 1);
+    _module_under_test.set_samplerate(64);
+    _module_under_test.set_parameters(1, 1, 0.5, 1);
+    _module_under_test.gate(true);
+    reference.gate(true);
+
+    /* Odd block sizes so that stage changes happen in the middle of blocks */
+    float levels[37];
+    for (int block = 0; block < 8; ++block)
+    {
+        if (block == 5)
+        {
+            _module_under_test.gate(false);
+            reference.gate(false);
+        }
+        _module_under_test.render(levels, 37);
+        for (float level : levels)
+        {
+            ASSERT_NEAR(reference.tick(1), level, 1.0e-5f);
+        }
+    }
+    EXPECT_TRUE(_module_under_test.finished());
+    EXPECT_FLOAT_EQ(0.0f, _module_under_test.level());
+}
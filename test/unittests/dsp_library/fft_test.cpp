@@ -0,0 +1,79 @@
+#include <cmath>
+#include <complex>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "dsp_library/fft.cpp"
+
+using namespace dsp;
+
+static std::vector<float> make_noise(int size)
+{
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> signal(size);
+    for (auto& sample : signal)
+    {
+        sample = distribution(generator);
+    }
+    return signal;
+}
+
+TEST(TestRealFft, TestForward)
+{
+    for (int size : {4, 16, 256})
+    {
+        RealFft module_under_test(size);
+        ASSERT_EQ(size / 2 + 1, module_under_test.bins());
+        auto signal = make_noise(size);
+        std::vector<std::complex<float>> spectrum(module_under_test.bins());
+        module_under_test.forward(signal.data(), spectrum.data());
+
+        /* Compare with a plain dft */
+        for (int k = 0; k < module_under_test.bins(); ++k)
+        {
+            std::complex<double> expected(0.0, 0.0);
+            for (int i = 0; i < size; ++i)
+            {
+                expected += static_cast<double>(signal[i]) * std::polar(1.0, -2 * M_PI * k * i / size);
+            }
+            ASSERT_NEAR(expected.real(), spectrum[k].real(), 1.0e-4) << "size " << size << ", bin " << k;
+            ASSERT_NEAR(expected.imag(), spectrum[k].imag(), 1.0e-4) << "size " << size << ", bin " << k;
+        }
+    }
+}
+
+TEST(TestRealFft, TestInverse)
+{
+    constexpr int SIZE = 128;
+    RealFft module_under_test(SIZE);
+    auto signal = make_noise(SIZE);
+    std::vector<std::complex<float>> spectrum(module_under_test.bins());
+    std::vector<float> result(SIZE);
+    module_under_test.forward(signal.data(), spectrum.data());
+    module_under_test.inverse(spectrum.data(), result.data());
+    for (int i = 0; i < SIZE; ++i)
+    {
+        ASSERT_NEAR(signal[i], result[i], 1.0e-5f);
+    }
+}
+
+TEST(TestRealFft, TestImpulse)
+{
+    /* The spectrum of an impulse at sample 1 is a unit phase rotation for every bin */
+    constexpr int SIZE = 32;
+    RealFft module_under_test(SIZE);
+    std::vector<float> signal(SIZE, 0.0f);
+    signal[1] = 1.0f;
+    std::vector<std::complex<float>> spectrum(module_under_test.bins());
+    module_under_test.forward(signal.data(), spectrum.data());
+    for (int k = 0; k < module_under_test.bins(); ++k)
+    {
+        EXPECT_NEAR(1.0f, std::abs(spectrum[k]), 1.0e-5f);
+        EXPECT_NEAR(std::cos(2 * M_PI * k / SIZE), spectrum[k].real(), 1.0e-5f);
+    }
+}
@@ -0,0 +1,104 @@
+#include <cmath>
+
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "dsp_library/lfo.h"
+
+using namespace dsp;
+
+constexpr float TEST_SAMPLERATE = 1000;
+constexpr int TEST_BLOCK_SIZE = 37;
+
+TEST(TestFastSine, TestAccuracy)
+{
+    for (int i = -500; i < 500; ++i)
+    {
+        float phase = i / 1000.0f;
+        ASSERT_NEAR(std::sin(2 * M_PI * phase), fast_sine(phase), 1.0e-5f);
+    }
+}
+
+class TestLfo : public ::testing::Test
+{
+protected:
+    TestLfo() {}
+
+    void SetUp()
+    {
+        _module_under_test.set_samplerate(TEST_SAMPLERATE);
+        _module_under_test.set_frequency(10);
+    }
+
+    /* Render in odd sized blocks and compare every value with a reference waveform */
+    template <typename Reference>
+    void check_waveform(Reference reference)
+    {
+        float buffer[TEST_BLOCK_SIZE];
+        int sample = 0;
+        for (int block = 0; block < 10; ++block)
+        {
+            _module_under_test.render(buffer, TEST_BLOCK_SIZE);
+            for (float value : buffer)
+            {
+                float phase = std::fmod(sample * 10 / TEST_SAMPLERATE, 1.0f);
+                ASSERT_NEAR(reference(phase), value, 1.0e-3f) << "at sample " << sample;
+                ++sample;
+            }
+        }
+    }
+
+    Lfo _module_under_test;
+};
+
+TEST_F(TestLfo, TestSine)
+{
+    check_waveform([](float phase) {return std::sin(2 * M_PI * phase);});
+}
+
+TEST_F(TestLfo, TestTriangle)
+{
+    _module_under_test.set_waveform(LfoWaveform::TRIANGLE);
+    check_waveform([](float phase) {return 1.0f - 4.0f * std::abs(phase - 0.5f);});
+}
+
+TEST_F(TestLfo, TestSaw)
+{
+    _module_under_test.set_waveform(LfoWaveform::SAW);
+    _module_under_test.reset(0.905f);
+    float buffer[TEST_BLOCK_SIZE];
+    _module_under_test.render(buffer, 1);
+    EXPECT_NEAR(0.81f, buffer[0], 1.0e-5f);
+    EXPECT_NEAR(0.915f, _module_under_test.phase(), 1.0e-5f);
+    /* The phase wraps around between the 9th and 10th sample */
+    _module_under_test.render(buffer, 15);
+    EXPECT_NEAR(0.99f, buffer[8], 1.0e-4f);
+    EXPECT_NEAR(-0.99f, buffer[9], 1.0e-4f);
+    EXPECT_NEAR(0.065f, _module_under_test.phase(), 1.0e-5f);
+}
+
+TEST_F(TestLfo, TestSquare)
+{
+    _module_under_test.set_waveform(LfoWaveform::SQUARE);
+    float buffer[100];
+    _module_under_test.render(buffer, 100);
+    EXPECT_FLOAT_EQ(1.0f, buffer[0]);
+    EXPECT_FLOAT_EQ(1.0f, buffer[48]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[51]);
+    EXPECT_FLOAT_EQ(-1.0f, buffer[98]);
+}
+
+TEST_F(TestLfo, TestAdvance)
+{
+    Lfo reference;
+    reference.set_samplerate(TEST_SAMPLERATE);
+    reference.set_frequency(10);
+    float buffer[TEST_BLOCK_SIZE];
+    for (int block = 0; block < 10; ++block)
+    {
+        reference.render(buffer, TEST_BLOCK_SIZE);
+        ASSERT_NEAR(buffer[TEST_BLOCK_SIZE - 1], _module_under_test.advance(TEST_BLOCK_SIZE), 1.0e-4f);
+        ASSERT_NEAR(reference.phase(), _module_under_test.phase(), 1.0e-5f);
+    }
+}
@@ -0,0 +1,96 @@
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "dsp_library/partitioned_convolver.cpp"
+
+using namespace dsp;
+
+static std::vector<float> make_random_signal(int size, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> signal(size);
+    for (auto& sample : signal)
+    {
+        sample = distribution(generator);
+    }
+    return signal;
+}
+
+static std::vector<float> convolve(const std::vector<float>& input, const std::vector<float>& impulse_response)
+{
+    std::vector<float> output(input.size(), 0.0f);
+    for (size_t i = 0; i < input.size(); ++i)
+    {
+        double sum = 0.0;
+        for (size_t j = 0; j < impulse_response.size() && j <= i; ++j)
+        {
+            sum += input[i - j] * impulse_response[j];
+        }
+        output[i] = static_cast<float>(sum);
+    }
+    return output;
+}
+
+TEST(TestPartitionedConvolver, TestPartitions)
+{
+    std::vector<float> impulse_response(100, 1.0f);
+    PartitionedConvolver module_under_test(32, impulse_response.data(), 100);
+    EXPECT_EQ(32, module_under_test.block_size());
+    EXPECT_EQ(4, module_under_test.partitions());
+
+    PartitionedConvolver empty(32, impulse_response.data(), 0);
+    EXPECT_EQ(1, empty.partitions());
+}
+
+TEST(TestPartitionedConvolver, TestConvolution)
+{
+    constexpr int BLOCK_SIZE = 16;
+    constexpr int BLOCKS = 20;
+    /* Not a whole number of partitions */
+    auto impulse_response = make_random_signal(71, 1);
+    auto input = make_random_signal(BLOCK_SIZE * BLOCKS, 2);
+    auto expected = convolve(input, impulse_response);
+
+    PartitionedConvolver module_under_test(BLOCK_SIZE, impulse_response.data(), static_cast<int>(impulse_response.size()));
+    std::vector<float> output(input.size());
+    for (int block = 0; block < BLOCKS; ++block)
+    {
+        module_under_test.process(input.data() + block * BLOCK_SIZE, output.data() + block * BLOCK_SIZE);
+    }
+    for (size_t i = 0; i < output.size(); ++i)
+    {
+        ASSERT_NEAR(expected[i], output[i], 1.0e-4f) << "at sample " << i;
+    }
+}
+
+TEST(TestPartitionedConvolver, TestInPlaceAndReset)
+{
+    constexpr int BLOCK_SIZE = 8;
+    std::vector<float> impulse_response = {0.0f, 0.5f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.25f};
+    PartitionedConvolver module_under_test(BLOCK_SIZE, impulse_response.data(), static_cast<int>(impulse_response.size()));
+    std::vector<float> buffer(BLOCK_SIZE, 0.0f);
+    buffer[0] = 1.0f;
+    module_under_test.process(buffer.data(), buffer.data());
+    EXPECT_NEAR(0.0f, buffer[0], 1.0e-6f);
+    EXPECT_NEAR(0.5f, buffer[1], 1.0e-6f);
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    module_under_test.process(buffer.data(), buffer.data());
+    EXPECT_NEAR(0.25f, buffer[1], 1.0e-6f);
+
+    /* The second partition should not ring after a reset */
+    module_under_test.reset();
+    buffer[0] = 1.0f;
+    module_under_test.process(buffer.data(), buffer.data());
+    std::fill(buffer.begin(), buffer.end(), 0.0f);
+    module_under_test.reset();
+    module_under_test.process(buffer.data(), buffer.data());
+    for (auto sample : buffer)
+    {
+        EXPECT_NEAR(0.0f, sample, 1.0e-6f);
+    }
+}
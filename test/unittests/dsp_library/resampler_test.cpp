@@ -0,0 +1,121 @@
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "dsp_library/resampler.cpp"
+
+using namespace dsp::resampler;
+
+constexpr double TEST_FREQUENCY = 1000.0;
+
+std::vector<float> make_sine(int channels, int frames, double rate)
+{
+    std::vector<float> signal(channels * frames);
+    for (int i = 0; i < frames; ++i)
+    {
+        for (int c = 0; c < channels; ++c)
+        {
+            signal[i * channels + c] = static_cast<float>(std::sin(2 * M_PI * TEST_FREQUENCY * i / rate + c));
+        }
+    }
+    return signal;
+}
+
+TEST(TestPolyphaseTable, TestIntegerPositions)
+{
+    /* At whole samples the kernel should return the samples unchanged */
+    for (auto quality : {Quality::LINEAR, Quality::LOW, Quality::MEDIUM, Quality::HIGH})
+    {
+        PolyphaseTable module_under_test(quality);
+        EXPECT_EQ(taps(quality), module_under_test.taps());
+        std::vector<float> data(module_under_test.taps());
+        for (size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<float>(i);
+        }
+        EXPECT_NEAR(module_under_test.history(), module_under_test.interpolate(data.data(), 0.0f), 1.0e-5f);
+        EXPECT_NEAR(module_under_test.history() + 1, module_under_test.interpolate(data.data(), 1.0f), 1.0e-5f);
+    }
+}
+
+TEST(TestPolyphaseTable, TestLinear)
+{
+    PolyphaseTable module_under_test(Quality::LINEAR);
+    float data[] = {1.0f, 3.0f};
+    EXPECT_FLOAT_EQ(1.5f, module_under_test.interpolate(data, 0.25f));
+    EXPECT_FLOAT_EQ(2.0f, module_under_test.interpolate(data, 0.5f));
+}
+
+TEST(TestPolyphaseTable, TestInterpolatesSine)
+{
+    /* A low frequency sine, sampled at 44.1 kHz, interpolated half way between samples */
+    PolyphaseTable module_under_test(Quality::HIGH);
+    std::vector<float> data(module_under_test.taps());
+    for (size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = static_cast<float>(std::sin(2 * M_PI * TEST_FREQUENCY * i / 44100));
+    }
+    float expected = static_cast<float>(std::sin(2 * M_PI * TEST_FREQUENCY * (module_under_test.history() + 0.5) / 44100));
+    EXPECT_NEAR(expected, module_under_test.interpolate(data.data(), 0.5f), 1.0e-4f);
+}
+
+TEST(TestResampler, TestSampleRateConversion)
+{
+    constexpr int CHANNELS = 2;
+    constexpr int INPUT_FRAMES = 10000;
+    constexpr double INPUT_RATE = 48000;
+    constexpr double OUTPUT_RATE = 44100;
+    Resampler module_under_test(CHANNELS, INPUT_RATE, OUTPUT_RATE, Quality::HIGH);
+    auto input = make_sine(CHANNELS, INPUT_FRAMES, INPUT_RATE);
+
+    /* Push and pull in different block sizes to test the buffering */
+    std::vector<float> output;
+    std::vector<float> block(CHANNELS * 64);
+    for (int pushed = 0; pushed < INPUT_FRAMES; pushed += 100)
+    {
+        module_under_test.push(input.data() + pushed * CHANNELS, std::min(100, INPUT_FRAMES - pushed));
+        int frames;
+        while ((frames = module_under_test.pull(block.data(), 64)) > 0)
+        {
+            output.insert(output.end(), block.begin(), block.begin() + frames * CHANNELS);
+        }
+    }
+    EXPECT_EQ(0, module_under_test.available());
+    module_under_test.flush();
+    int frames;
+    while ((frames = module_under_test.pull(block.data(), 64)) > 0)
+    {
+        output.insert(output.end(), block.begin(), block.begin() + frames * CHANNELS);
+    }
+
+    int output_frames = static_cast<int>(output.size()) / CHANNELS;
+    EXPECT_EQ(static_cast<int>(std::ceil(INPUT_FRAMES * OUTPUT_RATE / INPUT_RATE)), output_frames);
+    auto expected = make_sine(CHANNELS, output_frames, OUTPUT_RATE);
+    /* The edges are padded, so the output is only exact away from them */
+    for (int i = 100; i < output_frames - 100; ++i)
+    {
+        for (int c = 0; c < CHANNELS; ++c)
+        {
+            ASSERT_NEAR(expected[i * CHANNELS + c], output[i * CHANNELS + c], 1.0e-3f);
+        }
+    }
+}
+
+TEST(TestResampler, TestConstantSignal)
+{
+    Resampler module_under_test(1, 44100, 96000, Quality::MEDIUM);
+    std::vector<float> input(500, 0.5f);
+    module_under_test.push(input.data(), static_cast<int>(input.size()));
+    module_under_test.flush();
+    std::vector<float> output(2000);
+    int frames = module_under_test.pull(output.data(), static_cast<int>(output.size()));
+    EXPECT_EQ(static_cast<int>(std::ceil(500 * 96000.0 / 44100)), frames);
+    for (int i = 0; i < frames; ++i)
+    {
+        ASSERT_NEAR(0.5f, output[i], 1.0e-6f);
+    }
+    EXPECT_EQ(0, module_under_test.pull(output.data(), 1));
+}
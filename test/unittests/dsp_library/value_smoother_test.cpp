@@ -62,4 +62,35 @@ TEST_F(ValueSmootherTest, TestExpFloat)
     }
     EXPECT_TRUE(_module_under_test_filter.stationary());
     EXPECT_NEAR(TEST_TARGET_VALUE, _module_under_test_filter.value(), 0.001);
-}
\ No newline at end of file
+}
+template <typename T, int mode>
+void test_fill_buffer(ValueSmoother<T, mode>& module_under_test)
+{
+    constexpr int BUFFER_SIZE = 13;
+    module_under_test.set_direct(2.0);
+    module_under_test.set(TEST_TARGET_VALUE);
+    auto reference = module_under_test;
+    T buffer[BUFFER_SIZE];
+    /* Uneven sizes to cover the ends of both the ramp and the blocks of the filter */
+    for (int i = 0; i < 4; ++i)
+    {
+        module_under_test.fill_buffer(buffer, BUFFER_SIZE);
+        for (int n = 0; n < BUFFER_SIZE; ++n)
+        {
+            ASSERT_NEAR(reference.next_value(), buffer[n], 1.0e-5);
+        }
+        ASSERT_NEAR(reference.value(), module_under_test.value(), 1.0e-5);
+    }
+    EXPECT_TRUE(module_under_test.stationary());
+}
+
+TEST_F(ValueSmootherTest, TestLinearFillBuffer)
+{
+    test_fill_buffer(_module_under_test_ramp);
+    EXPECT_FLOAT_EQ(TEST_TARGET_VALUE, _module_under_test_ramp.value());
+}
+
+TEST_F(ValueSmootherTest, TestExpFillBuffer)
+{
+    test_fill_buffer(_module_under_test_filter);
+}
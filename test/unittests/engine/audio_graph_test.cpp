@@ -0,0 +1,500 @@
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "engine/audio_graph.cpp"
+#undef private
+
+#include "test_utils/test_utils.h"
+#include "test_utils/host_control_mockup.h"
+
+using namespace sushi;
+using namespace engine;
+
+constexpr float TEST_SAMPLE_RATE = 48000;
+constexpr int TEST_MAX_TRACKS = 10;
+
+/* Render one chunk the way the engine does it */
+void render_chunk(AudioGraph& graph)
+{
+    graph.acquire_render_plan();
+    graph.clear_connected_inputs();
+    graph.render();
+    graph.release_render_plan();
+}
+
+class TestAudioGraph : public ::testing::Test
+{
+protected:
+    TestAudioGraph() {}
+
+    void SetUp()
+    {
+        for (auto& track : _tracks)
+        {
+            track = std::make_unique<Track>(_host_control.make_host_control_mockup(), 2, &_timer);
+            track->init(TEST_SAMPLE_RATE);
+        }
+    }
+
+    HostControlMockup _host_control;
+    performance::PerformanceTimer _timer;
+    std::array<std::unique_ptr<Track>, 4> _tracks;
+    AudioGraph _module_under_test{1, TEST_MAX_TRACKS};
+};
+
+TEST_F(TestAudioGraph, TestAddAndRemove)
+{
+    ASSERT_TRUE(_module_under_test.add(_tracks[0].get()));
+    ASSERT_TRUE(_module_under_test.add(_tracks[1].get()));
+    /* Adding the same track twice should fail */
+    ASSERT_FALSE(_module_under_test.add(_tracks[1].get()));
+    ASSERT_EQ(2u, _module_under_test.tracks().size());
+    auto order = _module_under_test.render_order();
+    ASSERT_EQ(2u, order.size());
+
+    /* The returned order is a copy and stays valid when the plan it came from is freed */
+    ASSERT_TRUE(_module_under_test.remove(_tracks[0].get()));
+    _module_under_test.synchronize();
+    EXPECT_EQ(2u, order.size());
+    ASSERT_FALSE(_module_under_test.remove(_tracks[0].get()));
+    ASSERT_EQ(1u, _module_under_test.tracks().size());
+    ASSERT_EQ(_tracks[1].get(), _module_under_test.render_order()[0]);
+}
+
+TEST_F(TestAudioGraph, TestRenderOrder)
+{
+    for (auto& track : _tracks)
+    {
+        ASSERT_TRUE(_module_under_test.add(track.get()));
+    }
+    /* Make track 0 depend on 3 and 1 depend on 0 */
+    ASSERT_TRUE(_module_under_test.connect(_tracks[3].get(), 0, _tracks[0].get(), 0));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[0].get(), 0, _tracks[1].get(), 0));
+
+    const auto& order = _module_under_test.render_order();
+    auto position = [&](const Track* track)
+    {
+        return std::find(order.begin(), order.end(), track) - order.begin();
+    };
+    ASSERT_EQ(4u, order.size());
+    EXPECT_LT(position(_tracks[3].get()), position(_tracks[0].get()));
+    EXPECT_LT(position(_tracks[0].get()), position(_tracks[1].get()));
+
+    /* Removing a track should also remove its connections */
+    ASSERT_TRUE(_module_under_test.remove(_tracks[0].get()));
+    EXPECT_TRUE(_module_under_test._routes.empty());
+    EXPECT_EQ(3u, _module_under_test.render_order().size());
+}
+
+TEST_F(TestAudioGraph, TestCycleIsRejected)
+{
+    for (auto& track : _tracks)
+    {
+        ASSERT_TRUE(_module_under_test.add(track.get()));
+    }
+    ASSERT_TRUE(_module_under_test.connect(_tracks[0].get(), 0, _tracks[1].get(), 0));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[1].get(), 0, _tracks[2].get(), 0));
+    ASSERT_FALSE(_module_under_test.connect(_tracks[2].get(), 0, _tracks[0].get(), 0));
+    ASSERT_FALSE(_module_under_test.connect(_tracks[1].get(), 1, _tracks[1].get(), 1));
+    EXPECT_EQ(2u, _module_under_test._routes.size());
+    EXPECT_EQ(4u, _module_under_test.render_order().size());
+}
+
+TEST_F(TestAudioGraph, TestDisconnect)
+{
+    ASSERT_TRUE(_module_under_test.add(_tracks[0].get()));
+    ASSERT_TRUE(_module_under_test.add(_tracks[1].get()));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[0].get(), 0, _tracks[1].get(), 0));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[0].get(), 1, _tracks[1].get(), 1));
+    ASSERT_FALSE(_module_under_test.disconnect(_tracks[0].get(), 1, _tracks[1].get(), 0));
+    ASSERT_TRUE(_module_under_test.disconnect(_tracks[0].get(), 0, _tracks[1].get(), 0));
+    ASSERT_FALSE(_module_under_test.disconnect(_tracks[0].get(), 0, _tracks[1].get(), 0));
+    ASSERT_EQ(1u, _module_under_test._routes.size());
+    EXPECT_EQ(1, _module_under_test._routes[0].source_channel);
+
+    auto input = _tracks[0]->input_bus(0);
+    test_utils::fill_sample_buffer(input, 1.0f);
+    render_chunk(_module_under_test);
+    auto output = _tracks[1]->output_bus(0);
+    EXPECT_FLOAT_EQ(0.0f, output.channel(0)[0]);
+    EXPECT_FLOAT_EQ(1.0f, output.channel(1)[0]);
+}
+
+TEST_F(TestAudioGraph, TestSummingRender)
+{
+    for (auto& track : _tracks)
+    {
+        ASSERT_TRUE(_module_under_test.add(track.get()));
+    }
+    /* Track 0 and 1 are both summed into track 2 */
+    ASSERT_TRUE(_module_under_test.connect(_tracks[0].get(), 0, _tracks[2].get(), 0));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[0].get(), 1, _tracks[2].get(), 1));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[1].get(), 0, _tracks[2].get(), 0));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[1].get(), 1, _tracks[2].get(), 1));
+
+    auto input_0 = _tracks[0]->input_bus(0);
+    auto input_1 = _tracks[1]->input_bus(0);
+    test_utils::fill_sample_buffer(input_0, 1.0f);
+    test_utils::fill_sample_buffer(input_1, 0.5f);
+    render_chunk(_module_under_test);
+
+    test_utils::assert_buffer_value(1.5f, _tracks[2]->output_bus(0), test_utils::DECIBEL_ERROR);
+}
+
+TEST_F(TestAudioGraph, TestConnectionGain)
+{
+    ASSERT_TRUE(_module_under_test.add(_tracks[0].get()));
+    ASSERT_TRUE(_module_under_test.add(_tracks[1].get()));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[0].get(), 0, _tracks[1].get(), 0, 0.5f));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[0].get(), 1, _tracks[1].get(), 1, 0.5f));
+    ASSERT_FALSE(_module_under_test.set_gain(_tracks[1].get(), _tracks[0].get(), 0.25f));
+
+    auto input = _tracks[0]->input_bus(0);
+    test_utils::fill_sample_buffer(input, 1.0f);
+    render_chunk(_module_under_test);
+    test_utils::assert_buffer_value(0.5f, _tracks[1]->output_bus(0), test_utils::DECIBEL_ERROR);
+
+    /* Gain changes should be ramped over one chunk */
+    ASSERT_TRUE(_module_under_test.set_gain(_tracks[0].get(), _tracks[1].get(), 0.25f));
+    test_utils::fill_sample_buffer(input, 1.0f);
+    render_chunk(_module_under_test);
+    auto output = _tracks[1]->output_bus(0);
+    EXPECT_FLOAT_EQ(0.5f, output.channel(0)[0]);
+    EXPECT_FLOAT_EQ(0.25f, output.channel(0)[AUDIO_CHUNK_SIZE - 1]);
+
+    test_utils::fill_sample_buffer(input, 1.0f);
+    render_chunk(_module_under_test);
+    test_utils::assert_buffer_value(0.25f, _tracks[1]->output_bus(0), test_utils::DECIBEL_ERROR);
+
+    /* Editing the graph before the next chunk should not make the ramp jump */
+    ASSERT_TRUE(_module_under_test.set_gain(_tracks[0].get(), _tracks[1].get(), 1.0f));
+    ASSERT_TRUE(_module_under_test.add(_tracks[2].get()));
+    test_utils::fill_sample_buffer(input, 1.0f);
+    render_chunk(_module_under_test);
+    output = _tracks[1]->output_bus(0);
+    EXPECT_FLOAT_EQ(0.25f, output.channel(0)[0]);
+    EXPECT_FLOAT_EQ(1.0f, output.channel(0)[AUDIO_CHUNK_SIZE - 1]);
+}
+
+TEST_F(TestAudioGraph, TestMulticoreRender)
+{
+    AudioGraph module_under_test(3, TEST_MAX_TRACKS);
+    for (auto& track : _tracks)
+    {
+        ASSERT_TRUE(module_under_test.add(track.get()));
+    }
+    /* A chain 0 -> 1 -> 2, with track 3 rendered independently */
+    ASSERT_TRUE(module_under_test.connect(_tracks[0].get(), 0, _tracks[1].get(), 0));
+    ASSERT_TRUE(module_under_test.connect(_tracks[0].get(), 1, _tracks[1].get(), 1));
+    ASSERT_TRUE(module_under_test.connect(_tracks[1].get(), 0, _tracks[2].get(), 0));
+    ASSERT_TRUE(module_under_test.connect(_tracks[1].get(), 1, _tracks[2].get(), 1));
+
+    for (int i = 0; i < 10; ++i)
+    {
+        auto input_0 = _tracks[0]->input_bus(0);
+        auto input_3 = _tracks[3]->input_bus(0);
+        test_utils::fill_sample_buffer(input_0, 1.0f);
+        test_utils::fill_sample_buffer(input_3, 0.5f);
+        render_chunk(module_under_test);
+
+        test_utils::assert_buffer_value(1.0f, _tracks[2]->output_bus(0), test_utils::DECIBEL_ERROR);
+        test_utils::assert_buffer_value(0.5f, _tracks[3]->output_bus(0), test_utils::DECIBEL_ERROR);
+    }
+}
+
+TEST_F(TestAudioGraph, TestLongestFirstDistribution)
+{
+    AudioGraph module_under_test(2, TEST_MAX_TRACKS);
+    for (auto& track : _tracks)
+    {
+        ASSERT_TRUE(module_under_test.add(track.get()));
+    }
+    /* With costs 4, 3, 2 and 1 the most expensive tracks should be on separate workers */
+    std::array<float, 4> costs = {2.0f, 4.0f, 1.0f, 3.0f};
+    for (int i = 0; i < 4; ++i)
+    {
+        module_under_test._track_costs[module_under_test._cost_slots[i]][0] = costs[i];
+    }
+    module_under_test.acquire_render_plan();
+    module_under_test._distribute_ready_nodes();
+    ASSERT_EQ(2, module_under_test._worker_queues[0].count);
+    ASSERT_EQ(2, module_under_test._worker_queues[1].count);
+    EXPECT_FLOAT_EQ(5.0f, module_under_test._worker_queues[0].queued_cost);
+    EXPECT_FLOAT_EQ(5.0f, module_under_test._worker_queues[1].queued_cost);
+
+    /* The most expensive track should be taken first */
+    int node = module_under_test._pop_ready(0);
+    EXPECT_EQ(_tracks[1].get(), module_under_test._rt_plan->nodes[node].track);
+    node = module_under_test._pop_ready(0);
+    EXPECT_EQ(_tracks[2].get(), module_under_test._rt_plan->nodes[node].track);
+    EXPECT_EQ(EMPTY_SLOT, module_under_test._pop_ready(0));
+
+    /* Worker 0 is empty so it should steal from worker 1 */
+    node = module_under_test._steal_ready(0);
+    EXPECT_EQ(_tracks[3].get(), module_under_test._rt_plan->nodes[node].track);
+    node = module_under_test._steal_ready(0);
+    EXPECT_EQ(_tracks[0].get(), module_under_test._rt_plan->nodes[node].track);
+    EXPECT_EQ(EMPTY_SLOT, module_under_test._steal_ready(0));
+}
+
+TEST_F(TestAudioGraph, TestCostMeasurement)
+{
+    AudioGraph module_under_test(2, TEST_MAX_TRACKS);
+    for (auto& track : _tracks)
+    {
+        ASSERT_TRUE(module_under_test.add(track.get()));
+        EXPECT_FLOAT_EQ(0.0f, module_under_test.expected_cost(track.get()));
+    }
+    render_chunk(module_under_test);
+    for (auto& track : _tracks)
+    {
+        EXPECT_GT(module_under_test.expected_cost(track.get()), 0.0f);
+    }
+    /* Costs should follow the tracks when tracks are removed */
+    float cost_2 = module_under_test.expected_cost(_tracks[2].get());
+    float cost_3 = module_under_test.expected_cost(_tracks[3].get());
+    ASSERT_TRUE(module_under_test.remove(_tracks[1].get()));
+    EXPECT_FLOAT_EQ(cost_2, module_under_test.expected_cost(_tracks[2].get()));
+    EXPECT_FLOAT_EQ(cost_3, module_under_test.expected_cost(_tracks[3].get()));
+    EXPECT_FLOAT_EQ(0.0f, module_under_test.expected_cost(_tracks[1].get()));
+}
+
+TEST_F(TestAudioGraph, TestPipelinedTrack)
+{
+    AudioGraph module_under_test(2, TEST_MAX_TRACKS);
+    ASSERT_TRUE(module_under_test.add(_tracks[0].get()));
+    ASSERT_TRUE(module_under_test.add(_tracks[1].get()));
+    ASSERT_TRUE(module_under_test.connect(_tracks[0].get(), 0, _tracks[1].get(), 0));
+    ASSERT_TRUE(module_under_test.connect(_tracks[0].get(), 1, _tracks[1].get(), 1));
+    ASSERT_TRUE(_tracks[0]->set_pipeline_stages(3));
+    ASSERT_TRUE(module_under_test.update());
+
+    /* Only the last stage of track 0 should be connected to track 1 */
+    const auto& plan = *module_under_test._plan.load();
+    ASSERT_EQ(4u, plan.nodes.size());
+    EXPECT_EQ(0, plan.dependency_count[0]);
+    EXPECT_EQ(0, plan.dependency_count[1]);
+    EXPECT_EQ(0, plan.dependency_count[2]);
+    EXPECT_EQ(2, plan.dependency_count[3]);
+    EXPECT_EQ(plan.downstream_offsets[2], plan.downstream_offsets[0]);
+    EXPECT_EQ(2, plan.downstream_offsets[3] - plan.downstream_offsets[2]);
+
+    /* Audio should come out 2 chunks later */
+    for (int i = 0; i < 3; ++i)
+    {
+        auto input = _tracks[0]->input_bus(0);
+        test_utils::fill_sample_buffer(input, 1.0f);
+        render_chunk(module_under_test);
+        float expected = i < 2 ? 0.0f : 1.0f;
+        test_utils::assert_buffer_value(expected, _tracks[1]->output_bus(0), test_utils::DECIBEL_ERROR);
+    }
+}
+
+TEST_F(TestAudioGraph, TestLatencyCompensation)
+{
+    AudioGraph module_under_test(2, TEST_MAX_TRACKS);
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(module_under_test.add(_tracks[i].get()));
+    }
+    /* Track 0 has 2 chunks of latency and track 1 none, both are summed into track 2 */
+    ASSERT_TRUE(module_under_test.connect(_tracks[0].get(), 0, _tracks[2].get(), 0));
+    ASSERT_TRUE(module_under_test.connect(_tracks[1].get(), 0, _tracks[2].get(), 0));
+    ASSERT_TRUE(_tracks[0]->set_pipeline_stages(3));
+    ASSERT_TRUE(module_under_test.update());
+
+    EXPECT_EQ(2 * AUDIO_CHUNK_SIZE, module_under_test.latency());
+    EXPECT_EQ(2 * AUDIO_CHUNK_SIZE, module_under_test.latency(_tracks[0].get()));
+    EXPECT_EQ(0, module_under_test.latency(_tracks[1].get()));
+    EXPECT_EQ(2 * AUDIO_CHUNK_SIZE, module_under_test.latency(_tracks[2].get()));
+    EXPECT_EQ(0, module_under_test.latency(_tracks[3].get()));
+
+    /* Only the route from track 1 should be delayed, but not before the audio thread
+     * has picked up the new plan */
+    for (const auto& route : module_under_test._routes)
+    {
+        if (route.source == _tracks[1].get())
+        {
+            ASSERT_TRUE(route.delay_line);
+            EXPECT_EQ(0, route.delay_line->delay());
+        }
+        else
+        {
+            EXPECT_FALSE(route.delay_line);
+        }
+    }
+
+    /* Audio from both tracks should arrive at the same time */
+    for (int i = 0; i < 3; ++i)
+    {
+        auto input_0 = _tracks[0]->input_bus(0);
+        auto input_1 = _tracks[1]->input_bus(0);
+        test_utils::fill_sample_buffer(input_0, 1.0f);
+        test_utils::fill_sample_buffer(input_1, 0.5f);
+        render_chunk(module_under_test);
+        float expected = i < 2 ? 0.0f : 1.5f;
+        EXPECT_FLOAT_EQ(expected, _tracks[2]->output_channel(0).channel(0)[0]);
+        EXPECT_FLOAT_EQ(expected, _tracks[2]->output_channel(0).channel(0)[AUDIO_CHUNK_SIZE - 1]);
+    }
+    EXPECT_EQ(0, module_under_test.output_delay(_tracks[0].get()));
+    EXPECT_EQ(2 * AUDIO_CHUNK_SIZE, module_under_test.output_delay(_tracks[1].get()));
+    for (const auto& route : module_under_test._routes)
+    {
+        if (route.source == _tracks[1].get())
+        {
+            EXPECT_EQ(2 * AUDIO_CHUNK_SIZE, route.delay_line->delay());
+        }
+    }
+
+    /* Removing the latency should remove the delay but keep the delay line */
+    ASSERT_TRUE(_tracks[0]->set_pipeline_stages(1));
+    ASSERT_TRUE(module_under_test.update());
+    EXPECT_EQ(0, module_under_test.latency());
+    render_chunk(module_under_test);
+    for (const auto& route : module_under_test._routes)
+    {
+        if (route.source == _tracks[1].get())
+        {
+            ASSERT_TRUE(route.delay_line);
+            EXPECT_EQ(0, route.delay_line->delay());
+        }
+    }
+}
+
+TEST_F(TestAudioGraph, TestRenderPlanSwapping)
+{
+    ASSERT_TRUE(_module_under_test.add(_tracks[0].get()));
+    _module_under_test.acquire_render_plan();
+    auto first_plan = _module_under_test._rt_plan;
+    ASSERT_EQ(1u, _module_under_test.active_tracks().size());
+
+    /* Edits while a chunk is being rendered should not be seen until the next chunk,
+     * and the plan in use should not be freed until the chunk is done */
+    ASSERT_TRUE(_module_under_test.add(_tracks[1].get()));
+    EXPECT_EQ(first_plan, _module_under_test._rt_plan);
+    EXPECT_EQ(1u, _module_under_test.active_tracks().size());
+    ASSERT_EQ(1u, _module_under_test._retired_plans.size());
+    EXPECT_EQ(first_plan, _module_under_test._retired_plans[0].plan.get());
+    _module_under_test.render();
+    _module_under_test.release_render_plan();
+
+    _module_under_test.synchronize();
+    EXPECT_TRUE(_module_under_test._retired_plans.empty());
+    _module_under_test.acquire_render_plan();
+    EXPECT_EQ(2u, _module_under_test.active_tracks().size());
+    _module_under_test.release_render_plan();
+
+    /* Outside of a chunk, replaced plans can be freed right away */
+    ASSERT_TRUE(_module_under_test.remove(_tracks[0].get()));
+    EXPECT_TRUE(_module_under_test._retired_plans.empty());
+}
+
+TEST_F(TestAudioGraph, TestSynchronizeDuringEdits)
+{
+    ASSERT_TRUE(_module_under_test.add(_tracks[0].get()));
+    _module_under_test.acquire_render_plan();
+    ASSERT_TRUE(_module_under_test.add(_tracks[1].get()));
+
+    /* The graph should be editable while another thread waits for the audio thread */
+    std::atomic<bool> synchronized{false};
+    std::thread sync_thread([&]()
+    {
+        _module_under_test.synchronize();
+        synchronized = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_TRUE(_module_under_test.add(_tracks[2].get()));
+    EXPECT_FALSE(synchronized);
+
+    _module_under_test.render();
+    _module_under_test.release_render_plan();
+    sync_thread.join();
+    EXPECT_TRUE(synchronized);
+    EXPECT_TRUE(_module_under_test._retired_plans.empty());
+}
+
+TEST_F(TestAudioGraph, TestWaitForRenderPlan)
+{
+    ASSERT_TRUE(_module_under_test.add(_tracks[0].get()));
+    render_chunk(_module_under_test);
+    EXPECT_TRUE(_module_under_test.wait_for_render_plan(std::chrono::milliseconds(0)));
+
+    /* A new plan is only done when a whole chunk has been rendered with it */
+    _module_under_test.acquire_render_plan();
+    ASSERT_TRUE(_module_under_test.add(_tracks[1].get()));
+    EXPECT_FALSE(_module_under_test.wait_for_render_plan(std::chrono::milliseconds(1)));
+    _module_under_test.render();
+    _module_under_test.release_render_plan();
+    EXPECT_FALSE(_module_under_test.wait_for_render_plan(std::chrono::milliseconds(1)));
+    _module_under_test.acquire_render_plan();
+    EXPECT_FALSE(_module_under_test.wait_for_render_plan(std::chrono::milliseconds(1)));
+    _module_under_test.render();
+    _module_under_test.release_render_plan();
+    EXPECT_TRUE(_module_under_test.wait_for_render_plan(std::chrono::milliseconds(0)));
+    EXPECT_TRUE(_module_under_test._retired_plans.empty());
+}
+
+TEST_F(TestAudioGraph, TestTransaction)
+{
+    ASSERT_TRUE(_module_under_test.add(_tracks[0].get()));
+    _module_under_test.begin_transaction();
+    ASSERT_TRUE(_module_under_test.add(_tracks[1].get()));
+    ASSERT_TRUE(_module_under_test.connect(_tracks[0].get(), 0, _tracks[1].get(), 0));
+    /* Cycles are still rejected when made in a transaction */
+    ASSERT_FALSE(_module_under_test.connect(_tracks[1].get(), 0, _tracks[0].get(), 0));
+    ASSERT_EQ(2u, _module_under_test.tracks().size());
+
+    /* Nothing is published until the transaction is committed */
+    render_chunk(_module_under_test);
+    EXPECT_EQ(1u, _module_under_test.active_tracks().size());
+    EXPECT_EQ(1u, _module_under_test.render_order().size());
+
+    std::vector<RtEvent> events{RtEvent::make_bypass_processor_event(1, true),
+                                RtEvent::make_bypass_processor_event(2, true)};
+    ASSERT_TRUE(_module_under_test.commit_transaction(events));
+    ASSERT_FALSE(_module_under_test.commit_transaction());
+
+    /* The edits and the events are picked up in the same chunk, and events only once */
+    RtEvent event;
+    _module_under_test.acquire_render_plan();
+    EXPECT_EQ(2u, _module_under_test.active_tracks().size());
+    ASSERT_TRUE(_module_under_test.pop_committed_event(event));
+    EXPECT_EQ(1u, event.processor_id());
+    ASSERT_TRUE(_module_under_test.pop_committed_event(event));
+    EXPECT_EQ(2u, event.processor_id());
+    EXPECT_FALSE(_module_under_test.pop_committed_event(event));
+    _module_under_test.release_render_plan();
+
+    _module_under_test.acquire_render_plan();
+    EXPECT_FALSE(_module_under_test.pop_committed_event(event));
+    _module_under_test.release_render_plan();
+}
+
+TEST_F(TestAudioGraph, TestCommittedEventsAreNotLost)
+{
+    _module_under_test.begin_transaction();
+    ASSERT_TRUE(_module_under_test.add(_tracks[0].get()));
+    ASSERT_TRUE(_module_under_test.commit_transaction({RtEvent::make_bypass_processor_event(1, true)}));
+
+    /* Replacing the plan before the audio thread picked it up should carry the events over */
+    _module_under_test.begin_transaction();
+    ASSERT_TRUE(_module_under_test.commit_transaction({RtEvent::make_bypass_processor_event(2, true)}));
+    ASSERT_TRUE(_module_under_test.add(_tracks[1].get()));
+
+    RtEvent event;
+    _module_under_test.acquire_render_plan();
+    ASSERT_TRUE(_module_under_test.pop_committed_event(event));
+    EXPECT_EQ(1u, event.processor_id());
+    ASSERT_TRUE(_module_under_test.pop_committed_event(event));
+    EXPECT_EQ(2u, event.processor_id());
+    EXPECT_FALSE(_module_under_test.pop_committed_event(event));
+    _module_under_test.release_render_plan();
+
+    /* Events already popped are not carried over to new plans */
+    ASSERT_TRUE(_module_under_test.remove(_tracks[1].get()));
+    EXPECT_TRUE(_module_under_test._plan.load()->events.empty());
+    _module_under_test.acquire_render_plan();
+    EXPECT_FALSE(_module_under_test.pop_committed_event(event));
+    _module_under_test.release_render_plan();
+}
@@ -190,7 +190,7 @@ TEST_F(ControllerTest, TestProcessorControls)
     auto [param_status, parameters] = _module_under_test->get_processor_parameters(id);
     ASSERT_EQ(ext::ControlStatus::OK, param_status);
 
-    EXPECT_EQ(3u, parameters.size());
+    EXPECT_EQ(9u, parameters.size());
     EXPECT_EQ("frequency", parameters[0].name);
     EXPECT_EQ("Frequency", parameters[0].label);
     EXPECT_EQ("Hz", parameters[0].unit);
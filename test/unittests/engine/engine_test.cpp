@@ -162,6 +162,208 @@ TEST_F(TestEngine, TestOutputMixing)
     test_utils::assert_buffer_value(2.0f, main_bus, test_utils::DECIBEL_ERROR);
 }
 
+TEST_F(TestEngine, TestTrackToTrackRouting)
+{
+    _module_under_test->create_track("1", 2);
+    _module_under_test->create_track("2", 2);
+    _module_under_test->create_track("master", 2);
+    _module_under_test->connect_audio_input_bus(0, 0, "1");
+    _module_under_test->connect_audio_input_bus(1, 0, "2");
+    _module_under_test->connect_audio_output_bus(0, 0, "master");
+
+    auto res = _module_under_test->connect_track_bus_to_track(0, "1", 0, "master");
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+    res = _module_under_test->connect_track_bus_to_track(0, "2", 0, "master");
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+
+    /* Errors and connections that would create a cycle should be rejected */
+    res = _module_under_test->connect_track_bus_to_track(0, "no_track", 0, "master");
+    ASSERT_EQ(EngineReturnStatus::INVALID_TRACK, res);
+    res = _module_under_test->connect_track_channel_to_track(0, "1", 10, "master");
+    ASSERT_EQ(EngineReturnStatus::INVALID_CHANNEL, res);
+    res = _module_under_test->connect_track_bus_to_track(0, "master", 0, "1");
+    ASSERT_EQ(EngineReturnStatus::ERROR, res);
+
+    /* Master must be rendered after all tracks connected to it */
+    ASSERT_EQ("master", _module_under_test->_audio_graph.render_order().back()->name());
+
+    SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(TEST_CHANNEL_COUNT);
+    SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(TEST_CHANNEL_COUNT);
+    ControlBuffer control_buffer;
+
+    test_utils::fill_sample_buffer(in_buffer, 1.0f);
+
+    _module_under_test->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+
+    /* Both tracks are summed in the master track */
+    auto main_bus = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 0, 2);
+    auto second_bus = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 2, 2);
+
+    test_utils::assert_buffer_value(2.0f, main_bus, test_utils::DECIBEL_ERROR);
+    test_utils::assert_buffer_value(0.0f, second_bus, test_utils::DECIBEL_ERROR);
+}
+
+
+TEST_F(TestEngine, TestSendsAndReturns)
+{
+    _module_under_test->create_track("1", 2);
+    _module_under_test->create_track("2", 2);
+    _module_under_test->create_track("return", 2);
+    _module_under_test->connect_audio_input_bus(0, 0, "1");
+    _module_under_test->connect_audio_input_bus(1, 0, "2");
+    _module_under_test->connect_audio_output_bus(0, 0, "1");
+    _module_under_test->connect_audio_output_bus(0, 0, "2");
+    _module_under_test->connect_audio_output_bus(1, 0, "return");
+
+    auto res = _module_under_test->add_send_to_track(0, "1", 0, "return", 0.5f);
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+    res = _module_under_test->add_send_to_track(0, "2", 0, "return", 0.25f);
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+    res = _module_under_test->add_send_to_track(0, "return", 0, "1", 0.25f);
+    ASSERT_EQ(EngineReturnStatus::ERROR, res);
+    res = _module_under_test->set_send_gain("return", "1", 0.25f);
+    ASSERT_EQ(EngineReturnStatus::ERROR, res);
+    res = _module_under_test->set_send_gain("1", "no_track", 0.25f);
+    ASSERT_EQ(EngineReturnStatus::INVALID_TRACK, res);
+
+    /* A stereo send to a mono track fails on the second channel and should not leave
+     * the first channel connected */
+    _module_under_test->create_track("mono", 1);
+    auto route_count = _module_under_test->_audio_graph._routes.size();
+    res = _module_under_test->add_send_to_track(0, "1", 0, "mono", 0.5f);
+    ASSERT_EQ(EngineReturnStatus::INVALID_CHANNEL, res);
+    EXPECT_EQ(route_count, _module_under_test->_audio_graph._routes.size());
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->delete_track("mono"));
+
+    SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(TEST_CHANNEL_COUNT);
+    SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(TEST_CHANNEL_COUNT);
+    ControlBuffer control_buffer;
+    test_utils::fill_sample_buffer(in_buffer, 1.0f);
+
+    _module_under_test->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+
+    /* Both tracks are output directly and sent with different gains to the return track */
+    auto main_bus = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 0, 2);
+    auto return_bus = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 2, 2);
+    test_utils::assert_buffer_value(2.0f, main_bus, test_utils::DECIBEL_ERROR);
+    test_utils::assert_buffer_value(0.75f, return_bus, test_utils::DECIBEL_ERROR);
+
+    res = _module_under_test->set_send_gain("1", "return", 0.0f);
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+    _module_under_test->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+    _module_under_test->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+    return_bus = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 2, 2);
+    test_utils::assert_buffer_value(0.25f, return_bus, test_utils::DECIBEL_ERROR);
+}
+
+TEST_F(TestEngine, TestPipelinedTrack)
+{
+    _module_under_test->create_track("track", 2);
+    _module_under_test->connect_audio_input_bus(0, 0, "track");
+    _module_under_test->connect_audio_output_bus(0, 0, "track");
+    _module_under_test->set_output_latency(std::chrono::microseconds(1000));
+
+    auto res = _module_under_test->set_track_pipeline_stages("no_track", 2);
+    ASSERT_EQ(EngineReturnStatus::INVALID_TRACK, res);
+    res = _module_under_test->set_track_pipeline_stages("track", TRACK_MAX_PIPELINE_STAGES + 1);
+    ASSERT_EQ(EngineReturnStatus::ERROR, res);
+    res = _module_under_test->set_track_pipeline_stages("track", 3);
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+
+    /* The pipeline buffers are reallocated, so this is not rt safe */
+    _module_under_test->enable_realtime(true);
+    res = _module_under_test->set_track_pipeline_stages("track", 1);
+    EXPECT_EQ(EngineReturnStatus::ERROR, res);
+    auto track = static_cast<Track*>(_module_under_test->_processors["track"].get());
+    EXPECT_EQ(3, track->pipeline_stages());
+    _module_under_test->enable_realtime(false);
+
+    /* 2 extra chunks of latency should be reported to the transport */
+    auto chunk_time = std::chrono::duration<double>(AUDIO_CHUNK_SIZE / static_cast<double>(SAMPLE_RATE));
+    auto expected_latency = std::chrono::microseconds(1000) + std::chrono::duration_cast<Time>(chunk_time * 2);
+    _module_under_test->_transport.set_time(Time(0), 0);
+    EXPECT_EQ(expected_latency, _module_under_test->_transport.current_process_time());
+
+    SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(TEST_CHANNEL_COUNT);
+    SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(TEST_CHANNEL_COUNT);
+    ControlBuffer control_buffer;
+    test_utils::fill_sample_buffer(in_buffer, 1.0f);
+    auto main_bus = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 0, 2);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        _module_under_test->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+        test_utils::assert_buffer_value(i < 2 ? 0.0f : 1.0f, main_bus, test_utils::DECIBEL_ERROR);
+    }
+
+    res = _module_under_test->set_track_pipeline_stages("track", 1);
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+    _module_under_test->_transport.set_time(Time(0), 0);
+    EXPECT_EQ(std::chrono::microseconds(1000), _module_under_test->_transport.current_process_time());
+}
+
+TEST_F(TestEngine, TestDoublePrecisionTrack)
+{
+    _module_under_test->create_track("track", 2);
+    _module_under_test->connect_audio_input_bus(0, 0, "track");
+    _module_under_test->connect_audio_output_bus(0, 0, "track");
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->add_plugin_to_track("track", "sushi.testing.gain", "gain",
+                                                                              "", PluginType::INTERNAL));
+
+    auto res = _module_under_test->set_track_double_precision("no_track", true);
+    ASSERT_EQ(EngineReturnStatus::INVALID_TRACK, res);
+    res = _module_under_test->set_track_double_precision("track", true);
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+    auto track = static_cast<Track*>(_module_under_test->_processors["track"].get());
+    EXPECT_TRUE(track->double_precision());
+
+    /* Switching precision is not rt safe */
+    _module_under_test->enable_realtime(true);
+    res = _module_under_test->set_track_double_precision("track", false);
+    EXPECT_EQ(EngineReturnStatus::ERROR, res);
+    EXPECT_TRUE(track->double_precision());
+    _module_under_test->enable_realtime(false);
+
+    SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(TEST_CHANNEL_COUNT);
+    SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(TEST_CHANNEL_COUNT);
+    ControlBuffer control_buffer;
+    test_utils::fill_sample_buffer(in_buffer, 0.5f);
+    _module_under_test->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+    auto main_bus = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 0, 2);
+    test_utils::assert_buffer_value(0.5f, main_bus, test_utils::DECIBEL_ERROR);
+}
+
+TEST_F(TestEngine, TestLatencyCompensation)
+{
+    _module_under_test->create_track("1", 2);
+    _module_under_test->create_track("2", 2);
+    _module_under_test->connect_audio_input_bus(0, 0, "1");
+    _module_under_test->connect_audio_input_bus(0, 0, "2");
+    _module_under_test->connect_audio_output_bus(0, 0, "1");
+    _module_under_test->connect_audio_output_bus(0, 0, "2");
+    EXPECT_EQ(0, _module_under_test->get_latency());
+
+    /* Track 1 gets 2 chunks of latency, so the output of track 2 should be delayed as much */
+    auto res = _module_under_test->set_track_pipeline_stages("1", 3);
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+    EXPECT_EQ(2 * AUDIO_CHUNK_SIZE, _module_under_test->get_latency());
+
+    SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(TEST_CHANNEL_COUNT);
+    SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(TEST_CHANNEL_COUNT);
+    ControlBuffer control_buffer;
+    test_utils::fill_sample_buffer(in_buffer, 1.0f);
+    auto main_bus = SampleBuffer<AUDIO_CHUNK_SIZE>::create_non_owning_buffer(out_buffer, 0, 2);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        _module_under_test->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+        test_utils::assert_buffer_value(i < 2 ? 0.0f : 2.0f, main_bus, test_utils::DECIBEL_ERROR);
+    }
+
+    res = _module_under_test->set_track_pipeline_stages("1", 1);
+    ASSERT_EQ(EngineReturnStatus::OK, res);
+    EXPECT_EQ(0, _module_under_test->get_latency());
+}
 
 TEST_F(TestEngine, TestUidNameMapping)
 {
@@ -210,8 +412,8 @@ TEST_F(TestEngine, TestCreateEmptyTrack)
     auto status = _module_under_test->create_track("left", 2);
     ASSERT_EQ(status, EngineReturnStatus::OK);
     ASSERT_TRUE(_module_under_test->_processor_exists("left"));
-    ASSERT_EQ(_module_under_test->_audio_graph.size(),1u);
-    ASSERT_EQ(_module_under_test->_audio_graph[0]->name(),"left");
+    ASSERT_EQ(_module_under_test->_audio_graph.tracks().size(),1u);
+    ASSERT_EQ(_module_under_test->_audio_graph.tracks()[0]->name(),"left");
 
     /* Test invalid name */
     status = _module_under_test->create_track("left", 1);
@@ -223,7 +425,7 @@ TEST_F(TestEngine, TestCreateEmptyTrack)
     status = _module_under_test->delete_track("left");
     ASSERT_EQ(status, EngineReturnStatus::OK);
     ASSERT_FALSE(_module_under_test->_processor_exists("left"));
-    ASSERT_EQ(_module_under_test->_audio_graph.size(),0u);
+    ASSERT_EQ(_module_under_test->_audio_graph.tracks().size(),0u);
 
     /* Test invalid number of channels */
     status = _module_under_test->create_track("left", 3);
@@ -249,15 +451,15 @@ TEST_F(TestEngine, TestAddAndRemovePlugin)
     ASSERT_EQ(status, EngineReturnStatus::OK);
     ASSERT_TRUE(_module_under_test->_processor_exists("gain"));
     ASSERT_TRUE(_module_under_test->_processor_exists("synth"));
-    ASSERT_EQ(2u, _module_under_test->_audio_graph[0]->_processors.size());
-    ASSERT_EQ("gain", _module_under_test->_audio_graph[0]->_processors[0]->name());
-    ASSERT_EQ("synth", _module_under_test->_audio_graph[0]->_processors[1]->name());
+    ASSERT_EQ(2u, _module_under_test->_audio_graph.tracks()[0]->_processors.size());
+    ASSERT_EQ("gain", _module_under_test->_audio_graph.tracks()[0]->_processors[0]->name());
+    ASSERT_EQ("synth", _module_under_test->_audio_graph.tracks()[0]->_processors[1]->name());
 
     /* Test removal of plugin */
     status = _module_under_test->remove_plugin_from_track("left", "gain");
     ASSERT_EQ(status, EngineReturnStatus::OK);
     ASSERT_FALSE(_module_under_test->_processor_exists("gain"));
-    ASSERT_EQ("synth", _module_under_test->_audio_graph[0]->_processors[0]->name());
+    ASSERT_EQ("synth", _module_under_test->_audio_graph.tracks()[0]->_processors[0]->name());
 
     /* Negative tests */
     status = _module_under_test->add_plugin_to_track("not_found",
@@ -337,8 +539,8 @@ TEST_F(TestEngine, TestRealtimeConfiguration)
                                                      PluginType::INTERNAL);
     rt.join();
     ASSERT_EQ(EngineReturnStatus::OK, status);
-    ASSERT_EQ(1u, _module_under_test->_audio_graph[0]->_processors.size());
-    auto track = _module_under_test->_audio_graph[0];
+    ASSERT_EQ(1u, _module_under_test->_audio_graph.tracks()[0]->_processors.size());
+    auto track = _module_under_test->_audio_graph.tracks()[0];
     ObjectId track_id = track->id();
     ObjectId processor_id = track->_processors[0]->id();
 
@@ -347,19 +549,146 @@ TEST_F(TestEngine, TestRealtimeConfiguration)
     status = _module_under_test->remove_plugin_from_track("main", "gain_0_r");
     rt.join();
     ASSERT_EQ(EngineReturnStatus::OK, status);
-    ASSERT_EQ(0u, _module_under_test->_audio_graph[0]->_processors.size());
+    ASSERT_EQ(0u, _module_under_test->_audio_graph.tracks()[0]->_processors.size());
 
     rt = std::thread(faux_rt_thread, _module_under_test);
     status = _module_under_test->delete_track("main");
     rt.join();
     ASSERT_EQ(EngineReturnStatus::OK, status);
-    ASSERT_EQ(0u, _module_under_test->_audio_graph.size());
+    ASSERT_EQ(0u, _module_under_test->_audio_graph.tracks().size());
 
     // Assert that they were also deleted from the map of processors
     ASSERT_FALSE(_module_under_test->_processor_exists("main"));
     ASSERT_FALSE(_module_under_test->_processor_exists("gain_0_r"));
-    ASSERT_FALSE(_module_under_test->_realtime_processors[track_id]);
-    ASSERT_FALSE(_module_under_test->_realtime_processors[processor_id]);
+    ASSERT_FALSE(_module_under_test->_realtime_processors.get(track_id));
+    ASSERT_FALSE(_module_under_test->_realtime_processors.get(processor_id));
+}
+
+TEST_F(TestEngine, TestTransaction)
+{
+    auto faux_rt_thread = [](AudioEngine* e)
+    {
+        SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(2);
+        SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(2);
+        ControlBuffer control_buffer;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        e->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+    };
+    _module_under_test->enable_realtime(true);
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->begin_transaction());
+    ASSERT_TRUE(_module_under_test->transaction_active());
+    ASSERT_EQ(EngineReturnStatus::ERROR, _module_under_test->begin_transaction());
+
+    /* No audio thread is running, so none of these may wait for it */
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->create_track("main", 2));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->create_track("aux", 2));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->add_plugin_to_track("main",
+                                                                              "sushi.testing.gain",
+                                                                              "gain",
+                                                                              "",
+                                                                              PluginType::INTERNAL));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->connect_track_bus_to_track(0, "main", 0, "aux"));
+    auto [status, gain_id] = _module_under_test->processor_id_from_name("gain");
+    ASSERT_EQ(EngineReturnStatus::OK, status);
+    auto parameter_event = RtEvent::make_parameter_change_event(gain_id, 0, 0, 0.25f);
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->send_async_event(parameter_event));
+    /* Engine events are not returned by the audio thread and should not be waited for */
+    auto tempo_event = RtEvent::make_tempo_event(0, 130);
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->send_async_event(tempo_event));
+
+    /* Nothing should have reached the realtime part yet */
+    auto track_id = _module_under_test->processor_id_from_name("main").second;
+    EXPECT_FALSE(_module_under_test->_realtime_processors.get(track_id));
+    EXPECT_FALSE(_module_under_test->_realtime_processors.get(gain_id));
+    EXPECT_TRUE(_module_under_test->_audio_graph.render_order().empty());
+
+    auto rt = std::thread(faux_rt_thread, _module_under_test);
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->commit_transaction());
+    rt.join();
+    ASSERT_FALSE(_module_under_test->transaction_active());
+    ASSERT_EQ(EngineReturnStatus::ERROR, _module_under_test->commit_transaction());
+
+    EXPECT_TRUE(_module_under_test->_realtime_processors.get(track_id));
+    EXPECT_TRUE(_module_under_test->_realtime_processors.get(gain_id));
+    const auto& render_order = _module_under_test->_audio_graph.render_order();
+    ASSERT_EQ(2u, render_order.size());
+    EXPECT_EQ("main", render_order[0]->name());
+    ASSERT_EQ(1u, render_order[0]->_processors.size());
+    EXPECT_FLOAT_EQ(0.25f, _module_under_test->processor(gain_id)->parameter_value(0).second);
+
+    /* Removed processors are kept alive until the transaction is committed,
+     * but their names can be reused right away */
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->begin_transaction());
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->remove_plugin_from_track("main", "gain"));
+    EXPECT_EQ(1u, _module_under_test->_transaction_garbage.size());
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->add_plugin_to_track("main",
+                                                                              "sushi.testing.passthrough",
+                                                                              "gain",
+                                                                              "",
+                                                                              PluginType::INTERNAL));
+    rt = std::thread(faux_rt_thread, _module_under_test);
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->commit_transaction());
+    rt.join();
+    EXPECT_TRUE(_module_under_test->_transaction_garbage.empty());
+    EXPECT_FALSE(_module_under_test->_realtime_processors.get(gain_id));
+    auto track = _module_under_test->_audio_graph.render_order()[0];
+    ASSERT_EQ(1u, track->_processors.size());
+    EXPECT_EQ("gain", track->_processors[0]->name());
+    EXPECT_NE(gain_id, track->_processors[0]->id());
+}
+
+TEST_F(TestEngine, TestRemoveWhenAudioThreadIsLate)
+{
+    auto faux_rt_thread = [](AudioEngine* e)
+    {
+        SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(2);
+        SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(2);
+        ControlBuffer control_buffer;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        e->process_chunk(&in_buffer, &out_buffer, &control_buffer, &control_buffer, Time(0), 0);
+    };
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->create_track("main", 2));
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->create_track("aux", 2));
+    auto main_id = _module_under_test->processor_id_from_name("main").second;
+    auto aux_id = _module_under_test->processor_id_from_name("aux").second;
+    _module_under_test->enable_realtime(true);
+
+    /* The audio thread never picks up the removal, so the track must not be deleted */
+    ASSERT_EQ(EngineReturnStatus::ERROR, _module_under_test->delete_track("main"));
+    EXPECT_FALSE(_module_under_test->_processor_exists("main"));
+    EXPECT_EQ(1u, _module_under_test->_transaction_garbage.size());
+    EXPECT_TRUE(_module_under_test->_realtime_processors.get(main_id));
+
+    /* Both removals are applied in the next chunk, after which both tracks can be deleted */
+    auto rt = std::thread(faux_rt_thread, _module_under_test);
+    ASSERT_EQ(EngineReturnStatus::OK, _module_under_test->delete_track("aux"));
+    rt.join();
+    EXPECT_TRUE(_module_under_test->_transaction_garbage.empty());
+    EXPECT_FALSE(_module_under_test->_realtime_processors.get(main_id));
+    EXPECT_FALSE(_module_under_test->_realtime_processors.get(aux_id));
+    EXPECT_TRUE(_module_under_test->_audio_graph.render_order().empty());
+}
+
+TEST_F(TestEngine, TestEventQueueSize)
+{
+    AudioEngine engine(SAMPLE_RATE, 1, 6);
+    auto queues = engine.event_queue_info();
+    ASSERT_EQ(5u, queues.size());
+    EXPECT_EQ("control_in", queues[0].name);
+    /* The control queue has several producers and is rounded up to a power of 2 */
+    EXPECT_EQ(8, queues[0].capacity);
+    EXPECT_EQ(6, queues[1].capacity);
+
+    auto event = RtEvent::make_tempo_event(0, 120);
+    for (int i = 0; i < 8; ++i)
+    {
+        ASSERT_EQ(EngineReturnStatus::OK, engine.send_async_event(event));
+    }
+    EXPECT_EQ(EngineReturnStatus::QUEUE_FULL, engine.send_async_event(event));
+    EXPECT_EQ(EngineReturnStatus::QUEUE_FULL, engine.send_async_event(event));
+    queues = engine.event_queue_info();
+    EXPECT_EQ(2u, queues[0].dropped_events);
+    EXPECT_EQ(0u, queues[1].dropped_events);
 }
 
 TEST_F(TestEngine, TestSetCvChannels)
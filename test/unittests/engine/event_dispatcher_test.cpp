@@ -13,6 +13,7 @@ using namespace sushi::dispatcher;
 constexpr int DUMMY_POSTER_ID = 1;
 constexpr int DUMMY_STATUS = 100;
 constexpr auto EVENT_PROCESS_WAIT_TIME = std::chrono::milliseconds(1);
+constexpr auto EVENT_WAKEUP_WAIT_TIME = std::chrono::milliseconds(20);
 
 bool completed = false;
 int completion_status = 0;
@@ -203,6 +204,41 @@ TEST_F(TestEventDispatcher, TestAsyncCallbackFromProcessor)
     EXPECT_EQ(123u, typed_event->processor_id());
 }
 
+TEST_F(TestEventDispatcher, TestPollingFromRt)
+{
+    /* Notifying from the rt thread only sets a flag, and only when there are new events */
+    _module_under_test->notify_from_rt(false);
+    EXPECT_FALSE(_module_under_test->_rt_events_pending);
+    _module_under_test->notify_from_rt(true);
+    EXPECT_TRUE(_module_under_test->_rt_events_pending);
+
+    /* The event thread should pick up rt events when it polls the rt queue */
+    _module_under_test->subscribe_to_keyboard_events(&_poster);
+    _in_rt_queue.push(RtEvent::make_note_on_event(10, 0, 0, 50, 10.f));
+    _module_under_test->run();
+    std::this_thread::sleep_for(EVENT_WAKEUP_WAIT_TIME);
+    EXPECT_TRUE(_poster.event_received());
+    EXPECT_FALSE(_module_under_test->_rt_events_pending);
+
+    _in_rt_queue.push(RtEvent::make_note_on_event(10, 0, 0, 50, 10.f));
+    std::this_thread::sleep_for(RT_EVENT_IDLE_POLL_PERIOD + EVENT_WAKEUP_WAIT_TIME);
+    EXPECT_TRUE(_poster.event_received());
+    _module_under_test->stop();
+}
+
+TEST_F(TestEventDispatcher, TestWakeupFromPostedEvent)
+{
+    _module_under_test->register_poster(&_poster);
+    _module_under_test->run();
+    std::this_thread::sleep_for(EVENT_PROCESS_WAIT_TIME);
+    auto event = new Event(IMMEDIATE_PROCESS);
+    event->set_receiver(DUMMY_POSTER_ID);
+    _module_under_test->post_event(event);
+    std::this_thread::sleep_for(EVENT_WAKEUP_WAIT_TIME);
+    EXPECT_TRUE(_poster.event_received());
+    _module_under_test->stop();
+}
+
 class TestWorker : public ::testing::Test
 {
 public:
@@ -68,6 +68,8 @@ TEST_F(TestJsonConfigurator, TestLoadAudioConfig)
     ASSERT_EQ(1, audio_config.cv_inputs.value());
     ASSERT_TRUE(audio_config.cv_outputs.has_value());
     ASSERT_EQ(2, audio_config.cv_outputs.value());
+    ASSERT_TRUE(audio_config.driver_buffer_size.has_value());
+    ASSERT_EQ(128, audio_config.driver_buffer_size.value());
 }
 
 TEST_F(TestJsonConfigurator, TestLoadHostConfig)
@@ -81,19 +83,19 @@ TEST_F(TestJsonConfigurator, TestLoadTracks)
 {
     auto status = _module_under_test->load_tracks();
     ASSERT_EQ(JsonConfigReturnStatus::OK, status);
-    ASSERT_EQ(2, _engine->_audio_graph[0]->input_channels());
-    ASSERT_EQ(2, _engine->_audio_graph[0]->output_channels());
-    ASSERT_EQ(1, _engine->_audio_graph[1]->input_channels());
-    ASSERT_EQ(1, _engine->_audio_graph[1]->output_channels());
-    ASSERT_EQ(1, _engine->_audio_graph[2]->input_channels());
-    ASSERT_EQ(2, _engine->_audio_graph[2]->output_channels());
-    ASSERT_EQ(4, _engine->_audio_graph[3]->input_channels());
-    ASSERT_EQ(4, _engine->_audio_graph[3]->output_channels());
-    auto track_l = &_engine->_audio_graph[0]->_processors;
-    auto track_r = &_engine->_audio_graph[1]->_processors;
+    ASSERT_EQ(2, _engine->_audio_graph.tracks()[0]->input_channels());
+    ASSERT_EQ(2, _engine->_audio_graph.tracks()[0]->output_channels());
+    ASSERT_EQ(1, _engine->_audio_graph.tracks()[1]->input_channels());
+    ASSERT_EQ(1, _engine->_audio_graph.tracks()[1]->output_channels());
+    ASSERT_EQ(1, _engine->_audio_graph.tracks()[2]->input_channels());
+    ASSERT_EQ(2, _engine->_audio_graph.tracks()[2]->output_channels());
+    ASSERT_EQ(4, _engine->_audio_graph.tracks()[3]->input_channels());
+    ASSERT_EQ(4, _engine->_audio_graph.tracks()[3]->output_channels());
+    auto track_l = &_engine->_audio_graph.tracks()[0]->_processors;
+    auto track_r = &_engine->_audio_graph.tracks()[1]->_processors;
     ASSERT_EQ(3u, track_l->size());
     ASSERT_EQ(3u, track_r->size());
-    ASSERT_EQ(1, _engine->_audio_graph[1]->input_channels());
+    ASSERT_EQ(1, _engine->_audio_graph.tracks()[1]->input_channels());
 
     /* TODO - Is this casting a good idea */
     ASSERT_EQ("passthrough_0_l", static_cast<InternalPlugin*>(track_l->at(0))->name());
@@ -0,0 +1,97 @@
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "engine/processor_table.cpp"
+#include "plugins/passthrough_plugin.h"
+#undef private
+
+#include "test_utils/host_control_mockup.h"
+
+using namespace sushi;
+using namespace engine;
+
+class TestProcessorTable : public ::testing::Test
+{
+protected:
+    TestProcessorTable() {}
+
+    void SetUp()
+    {
+        for (auto& processor : _processors)
+        {
+            processor = std::make_unique<passthrough_plugin::PassthroughPlugin>(_host_control.make_host_control_mockup());
+        }
+    }
+
+    HostControlMockup _host_control;
+    std::array<std::unique_ptr<Processor>, 3> _processors;
+    ProcessorTable _module_under_test;
+};
+
+TEST_F(TestProcessorTable, TestInsertAndRemove)
+{
+    auto processor = _processors[0].get();
+    /* Ids must be reserved before inserting */
+    EXPECT_FALSE(_module_under_test.insert(processor));
+    EXPECT_EQ(nullptr, _module_under_test.get(processor->id()));
+
+    _module_under_test.reserve(processor->id());
+    ASSERT_TRUE(_module_under_test.insert(processor));
+    EXPECT_FALSE(_module_under_test.insert(processor));
+    EXPECT_EQ(processor, _module_under_test.get(processor->id()));
+    EXPECT_EQ(nullptr, _module_under_test.get(processor->id() + 1));
+
+    ASSERT_TRUE(_module_under_test.remove(processor->id()));
+    EXPECT_FALSE(_module_under_test.remove(processor->id()));
+    EXPECT_EQ(nullptr, _module_under_test.get(processor->id()));
+    _module_under_test.release(processor->id());
+}
+
+TEST_F(TestProcessorTable, TestGrowth)
+{
+    /* Ids far beyond the initial size should grow the table without affecting other processors */
+    _processors[0]->_id = 3;
+    _processors[1]->_id = 1'000'000;
+    for (auto& processor : _processors)
+    {
+        _module_under_test.reserve(processor->id());
+        ASSERT_TRUE(_module_under_test.insert(processor.get()));
+    }
+    EXPECT_GT(_module_under_test._directory.load()->size, 1'000'000u / PROCESSOR_TABLE_PAGE_SIZE);
+    for (auto& processor : _processors)
+    {
+        EXPECT_EQ(processor.get(), _module_under_test.get(processor->id()));
+    }
+    EXPECT_EQ(nullptr, _module_under_test.get(2'000'000'000));
+}
+
+TEST_F(TestProcessorTable, TestPageReuse)
+{
+    _processors[0]->_id = 10;
+    _processors[1]->_id = 20;
+    _processors[2]->_id = 10 * PROCESSOR_TABLE_PAGE_SIZE;
+    _module_under_test.reserve(_processors[0]->id());
+    _module_under_test.reserve(_processors[1]->id());
+    ASSERT_TRUE(_module_under_test.insert(_processors[0].get()));
+    ASSERT_TRUE(_module_under_test.insert(_processors[1].get()));
+    EXPECT_EQ(1, _module_under_test.allocated_pages());
+
+    /* The page is kept as long as any id in it is reserved */
+    ASSERT_TRUE(_module_under_test.remove(_processors[0]->id()));
+    _module_under_test.release(_processors[0]->id());
+    EXPECT_EQ(_processors[1].get(), _module_under_test.get(_processors[1]->id()));
+    EXPECT_TRUE(_module_under_test._free_pages.empty());
+
+    ASSERT_TRUE(_module_under_test.remove(_processors[1]->id()));
+    _module_under_test.release(_processors[1]->id());
+    EXPECT_EQ(1u, _module_under_test._free_pages.size());
+
+    /* A new id range should get the freed page */
+    _module_under_test.reserve(_processors[2]->id());
+    ASSERT_TRUE(_module_under_test.insert(_processors[2].get()));
+    EXPECT_EQ(_processors[2].get(), _module_under_test.get(_processors[2]->id()));
+    EXPECT_EQ(nullptr, _module_under_test.get(_processors[1]->id()));
+    EXPECT_EQ(1, _module_under_test.allocated_pages());
+    EXPECT_TRUE(_module_under_test._free_pages.empty());
+}
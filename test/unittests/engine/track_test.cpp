@@ -54,6 +54,50 @@ public:
     }
 };
 
+class DummyTailProcessor : public DummyProcessor
+{
+public:
+    DummyTailProcessor(HostControl host_control) : DummyProcessor(host_control) {}
+
+    int tail_length() const override {return AUDIO_CHUNK_SIZE;}
+
+    void process_audio(const ChunkSampleBuffer& in_buffer, ChunkSampleBuffer& out_buffer) override
+    {
+        process_calls++;
+        DummyProcessor::process_audio(in_buffer, out_buffer);
+    }
+
+    int process_calls{0};
+};
+
+class DummyDoubleProcessor : public DummyProcessor
+{
+public:
+    DummyDoubleProcessor(HostControl host_control) : DummyProcessor(host_control) {}
+
+    bool supports_double_precision() const override {return true;}
+
+    void set_double_precision(bool enabled) override {double_precision = enabled;}
+
+    void process_audio(const ChunkSampleBuffer& in_buffer, ChunkSampleBuffer& out_buffer) override
+    {
+        process_calls++;
+        out_buffer = in_buffer;
+        out_buffer.apply_gain(2.0f);
+    }
+
+    void process_audio_double(const DoubleChunkSampleBuffer& in_buffer, DoubleChunkSampleBuffer& out_buffer) override
+    {
+        double_process_calls++;
+        out_buffer = in_buffer;
+        out_buffer.apply_gain(2.0f);
+    }
+
+    bool double_precision{false};
+    int process_calls{0};
+    int double_process_calls{0};
+};
+
 class TrackTest : public ::testing::Test
 {
 protected:
@@ -242,6 +286,161 @@ TEST_F(TrackTest, TestEventForwarding)
     ASSERT_EQ(_module_under_test.id(), typed_event->processor_id());
 }
 
+TEST_F(TrackTest, TestPipelinedRendering)
+{
+    RtSafeRtEventFifo event_queue;
+    passthrough_plugin::PassthroughPlugin plugin_1(_host_control.make_host_control_mockup());
+    passthrough_plugin::PassthroughPlugin plugin_2(_host_control.make_host_control_mockup());
+    plugin_1.init(44100);
+    plugin_2.init(44100);
+    _module_under_test.set_event_output(&event_queue);
+    _module_under_test.add(&plugin_1);
+    _module_under_test.add(&plugin_2);
+
+    EXPECT_FALSE(_module_under_test.set_pipeline_stages(0));
+    EXPECT_FALSE(_module_under_test.set_pipeline_stages(TRACK_MAX_PIPELINE_STAGES + 1));
+    ASSERT_TRUE(_module_under_test.set_pipeline_stages(2));
+    EXPECT_EQ(2, _module_under_test.pipeline_stages());
+    EXPECT_EQ(1, _module_under_test.pipeline_latency());
+    auto& stages = _module_under_test._pipeline->stages;
+    EXPECT_EQ(0, stages[0].first_processor);
+    EXPECT_EQ(1, stages[0].last_processor);
+    EXPECT_EQ(1, stages[1].first_processor);
+    EXPECT_EQ(2, stages[1].last_processor);
+
+    /* Audio and keyboard events should be delayed by one chunk */
+    auto in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 1.0f);
+    _module_under_test.process_event(RtEvent::make_note_on_event(0, 0, 0, 48, 1.0f));
+    _module_under_test.render();
+    test_utils::assert_buffer_value(0.0f, _module_under_test.output_bus(0), test_utils::DECIBEL_ERROR);
+    EXPECT_TRUE(event_queue.empty());
+
+    in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 0.5f);
+    _module_under_test.render();
+    test_utils::assert_buffer_value(1.0f, _module_under_test.output_bus(0), test_utils::DECIBEL_ERROR);
+    RtEvent event;
+    ASSERT_TRUE(event_queue.pop(event));
+    EXPECT_EQ(RtEventType::NOTE_ON, event.type());
+    EXPECT_EQ(_module_under_test.id(), event.keyboard_event()->processor_id());
+
+    /* Stages can also be rendered separately */
+    in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 0.25f);
+    _module_under_test.render_stage(1);
+    _module_under_test.render_stage(0);
+    _module_under_test.advance_pipeline();
+    test_utils::assert_buffer_value(0.5f, _module_under_test.output_bus(0), test_utils::DECIBEL_ERROR);
+
+    /* Disabling pipelining should give back the processors' event outputs to the track */
+    ASSERT_TRUE(_module_under_test.set_pipeline_stages(1));
+    EXPECT_EQ(nullptr, _module_under_test._pipeline);
+    EXPECT_EQ(static_cast<RtEventPipe*>(&_module_under_test), plugin_1._output_pipe);
+}
+
+TEST_F(TrackTest, TestSleepingProcessors)
+{
+    DummyTailProcessor processor(_host_control.make_host_control_mockup());
+    _module_under_test.add(&processor);
+
+    auto in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 1.0f);
+    _module_under_test.render();
+    EXPECT_FALSE(processor.sleeping());
+
+    /* The processor should keep running until the input has been silent for longer than its tail */
+    in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 0.0f);
+    _module_under_test.render();
+    EXPECT_FALSE(processor.sleeping());
+    _module_under_test.render();
+    EXPECT_TRUE(processor.sleeping());
+    EXPECT_EQ(3, processor.process_calls);
+
+    /* Now the whole track should be skipped */
+    _module_under_test.render();
+    EXPECT_EQ(3, processor.process_calls);
+    test_utils::assert_buffer_value(0.0f, _module_under_test.output_bus(0), test_utils::DECIBEL_ERROR);
+
+    /* Keyboard events should wake up the processor */
+    _module_under_test.process_event(RtEvent::make_note_on_event(0, 0, 0, 48, 1.0f));
+    _module_under_test.render();
+    EXPECT_FALSE(processor.sleeping());
+    EXPECT_EQ(4, processor.process_calls);
+
+    _module_under_test.render();
+    _module_under_test.render();
+    ASSERT_TRUE(processor.sleeping());
+
+    /* And so should audio */
+    in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 1.0f);
+    _module_under_test.render();
+    EXPECT_FALSE(processor.sleeping());
+    test_utils::assert_buffer_value(1.0f, _module_under_test.output_bus(0), test_utils::DECIBEL_ERROR);
+
+    /* Gain changes should still be smoothed while the track is skipped */
+    in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 0.0f);
+    _module_under_test.render();
+    _module_under_test.render();
+    ASSERT_TRUE(processor.sleeping());
+    int process_calls = processor.process_calls;
+    auto gain_param = _module_under_test.parameter_from_name("gain");
+    ASSERT_FALSE(gain_param == nullptr);
+    _module_under_test.process_event(RtEvent::make_parameter_change_event(0, 0, gain_param->id(), 0.875f));
+    float left_gain = _module_under_test._pan_gain_smoothers_left[0].value();
+    _module_under_test.render();
+    EXPECT_EQ(process_calls, processor.process_calls);
+    EXPECT_GT(_module_under_test._pan_gain_smoothers_left[0].value(), left_gain);
+}
+
+TEST_F(TrackTest, TestDoublePrecision)
+{
+    DummyDoubleProcessor double_processor(_host_control.make_host_control_mockup());
+    DummyTailProcessor float_processor(_host_control.make_host_control_mockup());
+    _module_under_test.add(&double_processor);
+    _module_under_test.set_double_precision(true);
+    EXPECT_TRUE(_module_under_test.double_precision());
+    EXPECT_TRUE(double_processor.double_precision);
+    _module_under_test.add(&float_processor);
+
+    auto in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 0.25f);
+    _module_under_test.render();
+    test_utils::assert_buffer_value(0.5f, _module_under_test.output_bus(0), test_utils::DECIBEL_ERROR);
+    EXPECT_EQ(1, double_processor.double_process_calls);
+    EXPECT_EQ(0, double_processor.process_calls);
+    EXPECT_EQ(1, float_processor.process_calls);
+
+    /* Pipeline stages should get their own buffers */
+    ASSERT_TRUE(_module_under_test.set_pipeline_stages(2));
+    EXPECT_EQ(2u, _module_under_test._double_precision_buffers.size());
+    in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 0.25f);
+    _module_under_test.render();
+    _module_under_test.render();
+    test_utils::assert_buffer_value(0.5f, _module_under_test.output_bus(0), test_utils::DECIBEL_ERROR);
+    EXPECT_EQ(3, double_processor.double_process_calls);
+    ASSERT_TRUE(_module_under_test.set_pipeline_stages(1));
+
+    /* Adding and removing processors is done from the audio thread and should not
+     * change their precision, the engine takes care of that before adding them */
+    _module_under_test.remove(double_processor.id());
+    EXPECT_TRUE(double_processor.double_precision);
+    _module_under_test.add(&double_processor);
+    _module_under_test.set_double_precision(false);
+    EXPECT_FALSE(double_processor.double_precision);
+    EXPECT_TRUE(_module_under_test._double_precision_buffers.empty());
+
+    in_bus = _module_under_test.input_bus(0);
+    test_utils::fill_sample_buffer(in_bus, 0.25f);
+    _module_under_test.render();
+    test_utils::assert_buffer_value(0.5f, _module_under_test.output_bus(0), test_utils::DECIBEL_ERROR);
+    EXPECT_EQ(1, double_processor.process_calls);
+}
+
 TEST(TestStandAloneFunctions, TesPanAndGainCalculation)
 {
     auto [left_gain, right_gain] = calc_l_r_gain(5.0f, 0.0f);
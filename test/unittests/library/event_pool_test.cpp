@@ -0,0 +1,152 @@
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "library/event_pool.cpp"
+#undef private
+
+#include "library/event.h"
+
+using namespace sushi;
+
+class TestEventPool : public ::testing::Test
+{
+protected:
+    TestEventPool() {}
+
+    EventPool _module_under_test;
+};
+
+TEST_F(TestEventPool, TestAllocation)
+{
+    auto usage = _module_under_test.usage();
+    ASSERT_EQ(EVENT_POOL_BLOCK_SIZES.size(), usage.size());
+    EXPECT_EQ(0, usage[0].blocks);
+
+    void* small = _module_under_test.allocate(40);
+    void* large = _module_under_test.allocate(200);
+    ASSERT_NE(nullptr, small);
+    ASSERT_NE(nullptr, large);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(small) % alignof(std::max_align_t));
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(large) % alignof(std::max_align_t));
+
+    usage = _module_under_test.usage();
+    EXPECT_EQ(EVENT_POOL_BLOCKS_PER_SLAB, usage[0].blocks);
+    EXPECT_EQ(1, usage[0].blocks_in_use);
+    EXPECT_EQ(0, usage[1].blocks);
+    EXPECT_EQ(1, usage[2].blocks_in_use);
+
+    /* Freed blocks should be reused */
+    _module_under_test.deallocate(small, 40);
+    void* reused = _module_under_test.allocate(64);
+    EXPECT_EQ(small, reused);
+    _module_under_test.deallocate(reused, 64);
+    _module_under_test.deallocate(large, 200);
+
+    usage = _module_under_test.usage();
+    EXPECT_EQ(0, usage[0].blocks_in_use);
+    EXPECT_EQ(1, usage[0].peak_blocks_in_use);
+    EXPECT_EQ(0, usage[2].blocks_in_use);
+}
+
+TEST_F(TestEventPool, TestGrowth)
+{
+    std::vector<void*> blocks;
+    for (int i = 0; i < EVENT_POOL_BLOCKS_PER_SLAB + 1; ++i)
+    {
+        blocks.push_back(_module_under_test.allocate(100));
+    }
+    std::set<void*> unique_blocks(blocks.begin(), blocks.end());
+    EXPECT_EQ(blocks.size(), unique_blocks.size());
+
+    auto usage = _module_under_test.usage();
+    EXPECT_EQ(2 * EVENT_POOL_BLOCKS_PER_SLAB, usage[1].blocks);
+    EXPECT_EQ(EVENT_POOL_BLOCKS_PER_SLAB + 1, usage[1].blocks_in_use);
+
+    for (auto block : blocks)
+    {
+        _module_under_test.deallocate(block, 100);
+    }
+    usage = _module_under_test.usage();
+    EXPECT_EQ(2 * EVENT_POOL_BLOCKS_PER_SLAB, usage[1].blocks);
+    EXPECT_EQ(0, usage[1].blocks_in_use);
+    EXPECT_EQ(EVENT_POOL_BLOCKS_PER_SLAB + 1, usage[1].peak_blocks_in_use);
+}
+
+TEST_F(TestEventPool, TestOversizedAllocation)
+{
+    size_t size = EVENT_POOL_BLOCK_SIZES.back() + 1;
+    void* data = _module_under_test.allocate(size);
+    ASSERT_NE(nullptr, data);
+    for (const auto& usage : _module_under_test.usage())
+    {
+        EXPECT_EQ(0, usage.blocks_in_use);
+    }
+    _module_under_test.deallocate(data, size);
+}
+
+TEST_F(TestEventPool, TestConcurrentAllocation)
+{
+    constexpr int THREADS = 4;
+    constexpr int ITERATIONS = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            std::vector<int*> blocks;
+            for (int i = 0; i < ITERATIONS; ++i)
+            {
+                auto block = static_cast<int*>(_module_under_test.allocate(sizeof(int)));
+                *block = t;
+                blocks.push_back(block);
+                if (blocks.size() > 10)
+                {
+                    for (auto b : blocks)
+                    {
+                        EXPECT_EQ(t, *b);
+                        _module_under_test.deallocate(b, sizeof(int));
+                    }
+                    blocks.clear();
+                }
+            }
+            for (auto b : blocks)
+            {
+                _module_under_test.deallocate(b, sizeof(int));
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_EQ(0, _module_under_test.usage()[0].blocks_in_use);
+}
+
+TEST(TestEventAllocation, TestEventsUsePool)
+{
+    auto& pool = EventPool::instance();
+    auto in_use_before = pool.usage();
+    Event* event = new KeyboardEvent(KeyboardEvent::Subtype::NOTE_ON, 0, 0, 48, 1.0f, IMMEDIATE_PROCESS);
+    Event* engine_event = new AddProcessorEvent("track", "uid", "name", "file",
+                                                AddProcessorEvent::ProcessorType::INTERNAL, IMMEDIATE_PROCESS);
+    auto in_use = pool.usage();
+    int added = 0;
+    for (size_t i = 0; i < in_use.size(); ++i)
+    {
+        added += in_use[i].blocks_in_use - in_use_before[i].blocks_in_use;
+    }
+    EXPECT_EQ(2, added);
+
+    /* Deleting through the base class should return the blocks to the right size */
+    delete event;
+    delete engine_event;
+    auto in_use_after = pool.usage();
+    for (size_t i = 0; i < in_use.size(); ++i)
+    {
+        EXPECT_EQ(in_use_before[i].blocks_in_use, in_use_after[i].blocks_in_use);
+    }
+}
@@ -0,0 +1,143 @@
+#include <cstdint>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "library/interleaving.cpp"
+
+using namespace sushi;
+
+constexpr int TEST_FRAMES = 20;
+
+/* Non-interleaved test signal where every sample is unique, and below 1.0 */
+std::vector<float> make_test_signal(int channels, int stride)
+{
+    std::vector<float> signal(channels * stride, 0.0f);
+    for (int c = 0; c < channels; ++c)
+    {
+        for (int n = 0; n < TEST_FRAMES; ++n)
+        {
+            signal[c * stride + n] = (c * TEST_FRAMES + n) / 1024.0f - 0.25f;
+        }
+    }
+    return signal;
+}
+
+TEST(TestInterleaving, TestSampleFormatSize)
+{
+    EXPECT_EQ(2, sample_format_size(SampleFormat::INT16));
+    EXPECT_EQ(3, sample_format_size(SampleFormat::INT24));
+    EXPECT_EQ(4, sample_format_size(SampleFormat::INT32));
+    EXPECT_EQ(4, sample_format_size(SampleFormat::FLOAT32));
+}
+
+TEST(TestInterleaving, TestFloatRoundTrip)
+{
+    /* Covers the stereo and 4x4 vectorised paths, including frame counts
+     * that do not fit them, as well as the generic path */
+    for (int channels : {1, 2, 3, 4, 8, 10})
+    {
+        for (int frames : {TEST_FRAMES, TEST_FRAMES - 1})
+        {
+            SCOPED_TRACE("channels: " + std::to_string(channels) + ", frames: " + std::to_string(frames));
+            int stride = TEST_FRAMES + 4;
+            auto signal = make_test_signal(channels, stride);
+            std::vector<float> interleaved(channels * TEST_FRAMES, 0.0f);
+            interleave(signal.data(), stride, channels, frames, interleaved.data(), SampleFormat::FLOAT32, 2.0f);
+            for (int n = 0; n < frames; ++n)
+            {
+                for (int c = 0; c < channels; ++c)
+                {
+                    ASSERT_FLOAT_EQ(2.0f * signal[c * stride + n], interleaved[n * channels + c]);
+                }
+            }
+
+            std::vector<float> result(channels * stride, 0.0f);
+            deinterleave(interleaved.data(), SampleFormat::FLOAT32, channels, frames, result.data(), stride, 0.5f);
+            for (int c = 0; c < channels; ++c)
+            {
+                for (int n = 0; n < frames; ++n)
+                {
+                    ASSERT_FLOAT_EQ(signal[c * stride + n], result[c * stride + n]);
+                }
+                /* Nothing outside the frames should be touched */
+                for (int n = frames; n < stride; ++n)
+                {
+                    ASSERT_FLOAT_EQ(0.0f, result[c * stride + n]);
+                }
+            }
+        }
+    }
+}
+
+TEST(TestInterleaving, TestInt16)
+{
+    int16_t interleaved[6] = {0, 16384, -32768, 32767, -16384, 0};
+    float result[6];
+    deinterleave(interleaved, SampleFormat::INT16, 2, 3, result, 3);
+    EXPECT_FLOAT_EQ(0.0f, result[0]);
+    EXPECT_FLOAT_EQ(-1.0f, result[1]);
+    EXPECT_FLOAT_EQ(-0.5f, result[2]);
+    EXPECT_FLOAT_EQ(0.5f, result[3]);
+    EXPECT_NEAR(1.0f, result[4], 1.0e-4f);
+    EXPECT_FLOAT_EQ(0.0f, result[5]);
+
+    /* Out of range samples are clipped */
+    float source[4] = {0.25f, 2.0f, -0.25f, -2.0f};
+    int16_t output[4];
+    interleave(source, 2, 2, 2, output, SampleFormat::INT16, 1.0f);
+    EXPECT_EQ(8192, output[0]);
+    EXPECT_EQ(-8192, output[1]);
+    EXPECT_EQ(32767, output[2]);
+    EXPECT_EQ(-32768, output[3]);
+}
+
+TEST(TestInterleaving, TestInt24)
+{
+    /* 0.5, -0.5, -1.0 packed little endian */
+    uint8_t interleaved[9] = {0x00, 0x00, 0x40, 0x00, 0x00, 0xc0, 0x00, 0x00, 0x80};
+    float result[3];
+    deinterleave(interleaved, SampleFormat::INT24, 3, 1, result, 1);
+    EXPECT_FLOAT_EQ(0.5f, result[0]);
+    EXPECT_FLOAT_EQ(-0.5f, result[1]);
+    EXPECT_FLOAT_EQ(-1.0f, result[2]);
+
+    uint8_t output[9];
+    interleave(result, 1, 3, 1, output, SampleFormat::INT24);
+    for (int i = 0; i < 9; ++i)
+    {
+        EXPECT_EQ(interleaved[i], output[i]);
+    }
+}
+
+TEST(TestInterleaving, TestInt32)
+{
+    int32_t interleaved[2] = {1 << 30, -(1 << 30)};
+    float result[2];
+    deinterleave(interleaved, SampleFormat::INT32, 2, 1, result, 1, 0.5f);
+    EXPECT_FLOAT_EQ(0.25f, result[0]);
+    EXPECT_FLOAT_EQ(-0.25f, result[1]);
+
+    float source[2] = {1.5f, -1.5f};
+    int32_t output[2];
+    interleave(source, 1, 2, 1, output, SampleFormat::INT32);
+    EXPECT_GT(output[0], 2147483000);
+    EXPECT_EQ(INT32_MIN, output[1]);
+}
+
+TEST(TestInterleaving, TestIntegerRoundTrip)
+{
+    constexpr int CHANNELS = 5;
+    auto signal = make_test_signal(CHANNELS, TEST_FRAMES);
+    for (auto format : {SampleFormat::INT16, SampleFormat::INT24, SampleFormat::INT32})
+    {
+        std::vector<uint8_t> interleaved(CHANNELS * TEST_FRAMES * sample_format_size(format));
+        interleave(signal.data(), TEST_FRAMES, CHANNELS, TEST_FRAMES, interleaved.data(), format);
+        std::vector<float> result(CHANNELS * TEST_FRAMES);
+        deinterleave(interleaved.data(), format, CHANNELS, TEST_FRAMES, result.data(), TEST_FRAMES);
+        for (size_t i = 0; i < signal.size(); ++i)
+        {
+            ASSERT_NEAR(signal[i], result[i], 1.0e-4f);
+        }
+    }
+}
@@ -164,4 +164,37 @@ TEST_F(InternalPluginTest, TestFloatParameterHandling)
     EXPECT_EQ(ProcessorReturnCode::PARAMETER_NOT_FOUND, err_status);
 
     DECLARE_UNUSED(unused_value);
-}
\ No newline at end of file
+}
+TEST_F(InternalPluginTest, TestParameterSmoother)
+{
+    constexpr float SAMPLE_RATE = 48000;
+    auto parameter = _module_under_test->register_float_parameter("param_1", "Param 1", "",
+                                                                   1.0f, 0.0f, 4.0f);
+    auto smoother = _module_under_test->register_parameter_smoother(parameter, std::chrono::milliseconds(2));
+    ASSERT_TRUE(smoother);
+    _module_under_test->configure_parameter_smoothers(SAMPLE_RATE);
+
+    const float* values = smoother->render();
+    EXPECT_TRUE(smoother->stationary());
+    EXPECT_FLOAT_EQ(1.0f, values[0]);
+    EXPECT_FLOAT_EQ(1.0f, values[AUDIO_CHUNK_SIZE - 1]);
+
+    /* 2 ms at 48 kHz is 96 samples, so the ramp ends in the second chunk */
+    auto event = RtEvent::make_parameter_change_event(0u, 0, parameter->descriptor()->id(), 0.75f);
+    _module_under_test->process_event(event);
+    values = smoother->render();
+    EXPECT_FALSE(smoother->stationary());
+    EXPECT_GT(values[0], 1.0f);
+    for (int i = 1; i < AUDIO_CHUNK_SIZE; ++i)
+    {
+        ASSERT_GT(values[i], values[i - 1]);
+    }
+    values = smoother->render();
+    EXPECT_FALSE(smoother->stationary());
+    EXPECT_FLOAT_EQ(3.0f, values[AUDIO_CHUNK_SIZE - 1]);
+
+    values = smoother->render();
+    EXPECT_TRUE(smoother->stationary());
+    EXPECT_FLOAT_EQ(3.0f, smoother->value());
+    EXPECT_FLOAT_EQ(3.0f, values[0]);
+}
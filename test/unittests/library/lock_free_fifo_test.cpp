@@ -0,0 +1,203 @@
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "library/lock_free_fifo.h"
+#include "library/rt_event_fifo.h"
+
+using namespace sushi;
+
+constexpr int FIFO_CAPACITY = 5;
+constexpr int PRODUCERS = 4;
+constexpr int ITEMS_PER_PRODUCER = 20000;
+
+TEST(TestSpscFifo, TestOperation)
+{
+    SpscFifo<int> module_under_test(FIFO_CAPACITY);
+    EXPECT_EQ(FIFO_CAPACITY, module_under_test.capacity());
+    EXPECT_TRUE(module_under_test.was_empty());
+
+    for (int i = 0; i < FIFO_CAPACITY; ++i)
+    {
+        EXPECT_TRUE(module_under_test.push(i));
+        EXPECT_FALSE(module_under_test.was_empty());
+    }
+    // Fifo should now be full
+    EXPECT_FALSE(module_under_test.push(10));
+
+    int item = -1;
+    for (int i = 0; i < FIFO_CAPACITY; ++i)
+    {
+        ASSERT_TRUE(module_under_test.pop(item));
+        EXPECT_EQ(i, item);
+    }
+    EXPECT_TRUE(module_under_test.was_empty());
+    EXPECT_FALSE(module_under_test.pop(item));
+    EXPECT_EQ(FIFO_CAPACITY - 1, item);
+
+    // Wrap around a few times
+    for (int i = 0; i < 3 * FIFO_CAPACITY; ++i)
+    {
+        ASSERT_TRUE(module_under_test.push(i));
+        ASSERT_TRUE(module_under_test.pop(item));
+        EXPECT_EQ(i, item);
+    }
+}
+
+TEST(TestSpscFifo, TestConcurrentOperation)
+{
+    SpscFifo<int> module_under_test(FIFO_CAPACITY);
+    std::thread producer([&]()
+    {
+        for (int i = 0; i < ITEMS_PER_PRODUCER; ++i)
+        {
+            while (module_under_test.push(i) == false)
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    int item;
+    while (expected < ITEMS_PER_PRODUCER)
+    {
+        if (module_under_test.pop(item))
+        {
+            ASSERT_EQ(expected, item);
+            expected++;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_TRUE(module_under_test.was_empty());
+}
+
+TEST(TestMpmcFifo, TestOperation)
+{
+    MpmcFifo<int> module_under_test(FIFO_CAPACITY);
+    // Rounded up to the next power of 2
+    ASSERT_EQ(8, module_under_test.capacity());
+    EXPECT_EQ(2, MpmcFifo<int>(1).capacity());
+    EXPECT_TRUE(module_under_test.was_empty());
+
+    for (int i = 0; i < module_under_test.capacity(); ++i)
+    {
+        EXPECT_TRUE(module_under_test.push(i));
+        EXPECT_FALSE(module_under_test.was_empty());
+    }
+    EXPECT_FALSE(module_under_test.push(10));
+
+    int item = -1;
+    for (int i = 0; i < module_under_test.capacity(); ++i)
+    {
+        ASSERT_TRUE(module_under_test.pop(item));
+        EXPECT_EQ(i, item);
+    }
+    EXPECT_TRUE(module_under_test.was_empty());
+    EXPECT_FALSE(module_under_test.pop(item));
+
+    for (int i = 0; i < 3 * module_under_test.capacity(); ++i)
+    {
+        ASSERT_TRUE(module_under_test.push(i));
+        ASSERT_TRUE(module_under_test.pop(item));
+        EXPECT_EQ(i, item);
+    }
+}
+
+TEST(TestMpmcFifo, TestConcurrentOperation)
+{
+    MpmcFifo<int> module_under_test(16);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p)
+    {
+        producers.emplace_back([&, p]()
+        {
+            for (int i = 0; i < ITEMS_PER_PRODUCER; ++i)
+            {
+                while (module_under_test.push(p * ITEMS_PER_PRODUCER + i) == false)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    /* Two consumers, every item should be received exactly once and the items
+     * from any one producer should be received in the order they were pushed */
+    std::vector<int> received(PRODUCERS * ITEMS_PER_PRODUCER, 0);
+    std::atomic<int> count{0};
+    auto consume = [&](std::vector<int>& last)
+    {
+        int item;
+        while (count.load() < PRODUCERS * ITEMS_PER_PRODUCER)
+        {
+            if (module_under_test.pop(item))
+            {
+                received[item]++;
+                int producer = item / ITEMS_PER_PRODUCER;
+                EXPECT_LT(last[producer], item);
+                last[producer] = item;
+                count++;
+            }
+            else
+            {
+                std::this_thread::yield();
+            }
+        }
+    };
+    std::vector<int> last_1(PRODUCERS, -1);
+    std::vector<int> last_2(PRODUCERS, -1);
+    std::thread consumer(consume, std::ref(last_2));
+    consume(last_1);
+    consumer.join();
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    EXPECT_TRUE(module_under_test.was_empty());
+    for (auto r : received)
+    {
+        ASSERT_EQ(1, r);
+    }
+}
+
+TEST(TestRtSafeRtEventFifo, TestDroppedEvents)
+{
+    RtSafeRtEventFifo module_under_test(2);
+    EXPECT_EQ(2, module_under_test.capacity());
+    auto event = RtEvent::make_note_on_event(0, 0, 0, 48, 1.0f);
+    EXPECT_TRUE(module_under_test.push(event));
+    module_under_test.send_event(event);
+    EXPECT_FALSE(module_under_test.push(event));
+    module_under_test.send_event(event);
+    EXPECT_EQ(2u, module_under_test.dropped());
+
+    auto received = RtEvent::make_tempo_event(0, 120);
+    EXPECT_TRUE(module_under_test.pop(received));
+    EXPECT_EQ(RtEventType::NOTE_ON, received.type());
+    EXPECT_TRUE(module_under_test.pop(received));
+    EXPECT_TRUE(module_under_test.empty());
+}
+
+TEST(TestRtSafeMultiProducerRtEventFifo, TestDroppedEvents)
+{
+    RtSafeMultiProducerRtEventFifo module_under_test(2);
+    EXPECT_EQ(2, module_under_test.capacity());
+    auto event = RtEvent::make_note_off_event(0, 0, 0, 48, 1.0f);
+    EXPECT_TRUE(module_under_test.push(event));
+    EXPECT_TRUE(module_under_test.push(event));
+    EXPECT_FALSE(module_under_test.push(event));
+    EXPECT_EQ(1u, module_under_test.dropped());
+
+    auto received = RtEvent::make_tempo_event(0, 120);
+    EXPECT_TRUE(module_under_test.pop(received));
+    EXPECT_EQ(RtEventType::NOTE_OFF, received.type());
+    EXPECT_TRUE(module_under_test.pop(received));
+    EXPECT_TRUE(module_under_test.empty());
+}
@@ -103,3 +103,29 @@ TEST_F(TestPerformanceTimer, TestClearRecords)
     ASSERT_FLOAT_EQ(100.0f, t.min_case);
     ASSERT_FLOAT_EQ(0.0f, t.max_case);
 }
+
+TEST_F(TestPerformanceTimer, TestSkippedRecords)
+{
+    auto start = _module_under_test.start_timer();
+    start = virtual_wait(start, 2);
+    _module_under_test.stop_timer_rt_safe(start, 1);
+    _module_under_test.skip_timer_rt_safe(1);
+    _module_under_test.skip_timer_rt_safe(1);
+    _module_under_test.skip_timer_rt_safe(1);
+    _module_under_test._update_timings();
+
+    auto timings = _module_under_test.timings_for_node(1);
+    ASSERT_TRUE(timings.has_value());
+    auto t = timings.value();
+    /* Skipped calls should not affect the process timings */
+    ASSERT_GT(t.avg_case, 0.0f);
+    ASSERT_FLOAT_EQ(t.avg_case, t.min_case);
+    ASSERT_FLOAT_EQ(0.75f * 0.3f, t.skip_rate);
+
+    /* And a period with only skipped calls should leave the average untouched */
+    float avg = t.avg_case;
+    _module_under_test.skip_timer_rt_safe(1);
+    _module_under_test._update_timings();
+    t = _module_under_test.timings_for_node(1).value();
+    ASSERT_FLOAT_EQ(avg, t.avg_case);
+}
@@ -0,0 +1,76 @@
+#include <cstdint>
+
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "library/sample_arena.cpp"
+#include "library/sample_buffer.h"
+#undef private
+
+using namespace sushi;
+
+constexpr size_t TEST_ARENA_SIZE = 64 * 1024;
+
+bool is_aligned(const void* data)
+{
+    return reinterpret_cast<std::uintptr_t>(data) % SAMPLE_BUFFER_ALIGNMENT == 0;
+}
+
+class TestSampleArena : public ::testing::Test
+{
+protected:
+    TestSampleArena() {}
+
+    SampleArena _module_under_test;
+};
+
+TEST_F(TestSampleArena, TestHeapFallback)
+{
+    /* Uninitialised arenas should still give aligned memory */
+    float* data = _module_under_test.allocate(3);
+    ASSERT_NE(nullptr, data);
+    EXPECT_TRUE(is_aligned(data));
+    EXPECT_FALSE(_module_under_test._owns(data));
+    _module_under_test.deallocate(data, 3);
+    _module_under_test.deallocate(nullptr, 3);
+}
+
+TEST_F(TestSampleArena, TestAllocation)
+{
+    ASSERT_TRUE(_module_under_test.init(TEST_ARENA_SIZE, false, false));
+    ASSERT_FALSE(_module_under_test.init(TEST_ARENA_SIZE, false, false));
+    EXPECT_EQ(TEST_ARENA_SIZE, _module_under_test.size());
+
+    float* first = _module_under_test.allocate(AUDIO_CHUNK_SIZE * 2);
+    float* second = _module_under_test.allocate(5);
+    EXPECT_TRUE(_module_under_test._owns(first));
+    EXPECT_TRUE(_module_under_test._owns(second));
+    EXPECT_TRUE(is_aligned(first));
+    EXPECT_TRUE(is_aligned(second));
+    /* Blocks should be packed after each other */
+    EXPECT_EQ(first + AUDIO_CHUNK_SIZE * 2, second);
+    EXPECT_EQ(AUDIO_CHUNK_SIZE * 2 * sizeof(float) + SAMPLE_BUFFER_ALIGNMENT, _module_under_test.used());
+
+    /* Freed blocks should be reused for the same size */
+    _module_under_test.deallocate(first, AUDIO_CHUNK_SIZE * 2);
+    float* third = _module_under_test.allocate(5);
+    EXPECT_NE(first, third);
+    float* fourth = _module_under_test.allocate(AUDIO_CHUNK_SIZE * 2);
+    EXPECT_EQ(first, fourth);
+
+    /* Allocating more than what is left should fall back to the heap */
+    float* large = _module_under_test.allocate(TEST_ARENA_SIZE / sizeof(float));
+    EXPECT_FALSE(_module_under_test._owns(large));
+    EXPECT_TRUE(is_aligned(large));
+    _module_under_test.deallocate(large, TEST_ARENA_SIZE / sizeof(float));
+}
+
+TEST_F(TestSampleArena, TestSampleBufferAlignment)
+{
+    ChunkSampleBuffer buffer(3);
+    EXPECT_TRUE(is_aligned(buffer.channel(0)));
+    ChunkSampleBuffer copy(buffer);
+    EXPECT_TRUE(is_aligned(copy.channel(0)));
+    EXPECT_NE(buffer.channel(0), copy.channel(0));
+}
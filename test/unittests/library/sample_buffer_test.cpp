@@ -154,6 +154,17 @@ TEST(TestSampleBuffer, TestDeinterleaving)
         ASSERT_FLOAT_EQ(2.0f, buffer_3ch.channel(1)[n]);
         ASSERT_FLOAT_EQ(3.0f, buffer_3ch.channel(2)[n]);
     }
+
+    int16_t interleaved_4ch[8] = {8192, 16384, -8192, -16384, 8192, 16384, -8192, -16384};
+    SampleBuffer<2> buffer_4ch(4);
+    buffer_4ch.from_interleaved(interleaved_4ch, SampleFormat::INT16, 2.0f);
+    for (unsigned int n = 0; n < 2; ++n)
+    {
+        ASSERT_FLOAT_EQ(0.5f, buffer_4ch.channel(0)[n]);
+        ASSERT_FLOAT_EQ(1.0f, buffer_4ch.channel(1)[n]);
+        ASSERT_FLOAT_EQ(-0.5f, buffer_4ch.channel(2)[n]);
+        ASSERT_FLOAT_EQ(-1.0f, buffer_4ch.channel(3)[n]);
+    }
 }
 
 TEST(TestSampleBuffer, TestInterleaving)
@@ -360,6 +371,12 @@ TEST (TestSampleBuffer, TestAddWithRamp)
     ASSERT_FLOAT_EQ(2.0f, buffer.channel(0)[AUDIO_CHUNK_SIZE - 1]);
     ASSERT_FLOAT_EQ(2.0f, buffer.channel(1)[AUDIO_CHUNK_SIZE - 1]);
 
+    // The source should be added, not the buffer itself
+    buffer.clear();
+    buffer.add_with_ramp(buffer_2, 1.0f, 1.0f);
+    ASSERT_FLOAT_EQ(1.0f, buffer.channel(0)[0]);
+    ASSERT_FLOAT_EQ(1.0f, buffer.channel(1)[AUDIO_CHUNK_SIZE - 1]);
+
     // Test adding mono buffer to stereo buffer with ramp
     SampleBuffer<AUDIO_CHUNK_SIZE> mono_buffer(1);
     for (unsigned int n = 0; n < AUDIO_CHUNK_SIZE; ++n)
@@ -384,6 +401,29 @@ TEST (TestSampleBuffer, TestAddWithRamp)
     ASSERT_FLOAT_EQ(3.0f, buffer.channel(1)[AUDIO_CHUNK_SIZE - 1]);
 }
 
+TEST (TestSampleBuffer, TestEnvelope)
+{
+    SampleBuffer<AUDIO_CHUNK_SIZE> buffer(2);
+    SampleBuffer<AUDIO_CHUNK_SIZE> mono_buffer(1);
+    float envelope[AUDIO_CHUNK_SIZE];
+    for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+    {
+        envelope[i] = static_cast<float>(i) / AUDIO_CHUNK_SIZE;
+    }
+    test_utils::fill_sample_buffer(buffer, 2.0f);
+    test_utils::fill_sample_buffer(mono_buffer, 1.0f);
+
+    buffer.apply_envelope(envelope);
+    buffer.add_with_envelope(mono_buffer, envelope);
+    for (int ch = 0; ch < buffer.channel_count(); ++ch)
+    {
+        for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+        {
+            ASSERT_FLOAT_EQ(3.0f * envelope[i], buffer.channel(ch)[i]);
+        }
+    }
+}
+
 TEST (TestSampleBuffer, TestCountClippedSamples)
 {
     SampleBuffer<AUDIO_CHUNK_SIZE> buffer(2);
@@ -396,4 +436,42 @@ TEST (TestSampleBuffer, TestCountClippedSamples)
     ASSERT_EQ(3, buffer.count_clipped_samples(0,2));
     ASSERT_EQ(2, buffer.count_clipped_samples(1,1));
     ASSERT_EQ(1, buffer.count_clipped_samples(0,1));
-}
\ No newline at end of file
+}
+TEST (TestSampleBuffer, TestSilenceDetection)
+{
+    SampleBuffer<AUDIO_CHUNK_SIZE> buffer(2);
+    ASSERT_TRUE(buffer.is_silent());
+
+    buffer.channel(1)[AUDIO_CHUNK_SIZE - 1] = SILENCE_THRESHOLD / 2;
+    ASSERT_TRUE(buffer.is_silent());
+
+    buffer.channel(1)[5] = -0.5f;
+    ASSERT_FALSE(buffer.is_silent());
+}
+
+TEST (TestSampleBuffer, TestDoublePrecision)
+{
+    SampleBuffer<AUDIO_CHUNK_SIZE, double> buffer(2);
+    SampleBuffer<AUDIO_CHUNK_SIZE, double> source(1);
+    std::fill(source.channel(0), source.channel(0) + AUDIO_CHUNK_SIZE, 0.25 + 1.0e-12);
+    buffer.add_with_gain(source, 0.5f);
+    buffer.apply_gain(2.0f);
+    for (int n = 0; n < AUDIO_CHUNK_SIZE; ++n)
+    {
+        /* A difference too small for single precision should be preserved */
+        ASSERT_DOUBLE_EQ(0.25 + 1.0e-12, buffer.channel(1)[n]);
+    }
+    EXPECT_EQ(0, buffer.count_clipped_samples(0, 1));
+    EXPECT_FALSE(buffer.is_silent());
+
+    SampleBuffer<AUDIO_CHUNK_SIZE> float_buffer(2);
+    float_buffer.convert_from(buffer);
+    test_utils::assert_buffer_value(0.25f, float_buffer);
+
+    test_utils::fill_sample_buffer(float_buffer, 0.5f);
+    buffer.convert_from(float_buffer);
+    for (int n = 0; n < AUDIO_CHUNK_SIZE; ++n)
+    {
+        ASSERT_DOUBLE_EQ(0.5, buffer.channel(0)[n]);
+    }
+}
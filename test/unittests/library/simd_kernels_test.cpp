@@ -0,0 +1,181 @@
+#include <random>
+
+#include "gtest/gtest.h"
+
+#include "library/simd_kernels.cpp"
+#include "library/constants.h"
+
+using namespace sushi;
+using namespace sushi::simd;
+
+/* Not a multiple of any vector width, so that the scalar tail is tested as well */
+constexpr int TEST_SAMPLE_COUNT = 2 * AUDIO_CHUNK_SIZE + 7;
+
+/* Every available kernel set is tested against the scalar kernels */
+class TestSimdKernels : public ::testing::Test
+{
+protected:
+    TestSimdKernels() {}
+
+    void SetUp()
+    {
+        std::mt19937 generator(1234);
+        std::uniform_real_distribution<float> distribution(-2.0f, 2.0f);
+        for (int i = 0; i < TEST_SAMPLE_COUNT; ++i)
+        {
+            _source[i] = distribution(generator);
+            _initial[i] = distribution(generator);
+        }
+    }
+
+    void reset()
+    {
+        std::copy(_initial, _initial + TEST_SAMPLE_COUNT, _dest);
+        std::copy(_initial, _initial + TEST_SAMPLE_COUNT, _expected);
+    }
+
+    void assert_expected()
+    {
+        for (int i = 0; i < TEST_SAMPLE_COUNT; ++i)
+        {
+            ASSERT_NEAR(_expected[i], _dest[i], 1.0e-5f) << "at sample " << i;
+        }
+    }
+
+    float _source[TEST_SAMPLE_COUNT];
+    float _initial[TEST_SAMPLE_COUNT];
+    float _dest[TEST_SAMPLE_COUNT];
+    float _expected[TEST_SAMPLE_COUNT];
+};
+
+TEST_F(TestSimdKernels, TestSelection)
+{
+    auto kernel_sets = available_kernels();
+    ASSERT_GE(kernel_sets.size(), 1u);
+    EXPECT_EQ(InstructionSet::SCALAR, kernel_sets.front()->instruction_set);
+    /* The last one should be the fastest */
+    EXPECT_EQ(kernel_sets.back(), &kernels());
+    EXPECT_STREQ("scalar", to_string(InstructionSet::SCALAR));
+}
+
+TEST_F(TestSimdKernels, TestGainAndRamp)
+{
+    for (auto kernel_set : available_kernels())
+    {
+        SCOPED_TRACE(to_string(kernel_set->instruction_set));
+        reset();
+        kernel_set->apply_gain(_dest, 0.5f, TEST_SAMPLE_COUNT);
+        SCALAR_KERNELS.apply_gain(_expected, 0.5f, TEST_SAMPLE_COUNT);
+        assert_expected();
+
+        reset();
+        kernel_set->ramp(_dest, 0.25f, 0.01f, TEST_SAMPLE_COUNT);
+        SCALAR_KERNELS.ramp(_expected, 0.25f, 0.01f, TEST_SAMPLE_COUNT);
+        assert_expected();
+    }
+}
+
+TEST_F(TestSimdKernels, TestCopyAndAdd)
+{
+    for (auto kernel_set : available_kernels())
+    {
+        SCOPED_TRACE(to_string(kernel_set->instruction_set));
+        reset();
+        kernel_set->copy(_dest, _source, TEST_SAMPLE_COUNT);
+        SCALAR_KERNELS.copy(_expected, _source, TEST_SAMPLE_COUNT);
+        assert_expected();
+
+        reset();
+        kernel_set->add(_dest, _source, TEST_SAMPLE_COUNT);
+        SCALAR_KERNELS.add(_expected, _source, TEST_SAMPLE_COUNT);
+        assert_expected();
+
+        reset();
+        kernel_set->add_with_gain(_dest, _source, -0.75f, TEST_SAMPLE_COUNT);
+        SCALAR_KERNELS.add_with_gain(_expected, _source, -0.75f, TEST_SAMPLE_COUNT);
+        assert_expected();
+
+        reset();
+        kernel_set->add_with_ramp(_dest, _source, 1.0f, -0.005f, TEST_SAMPLE_COUNT);
+        SCALAR_KERNELS.add_with_ramp(_expected, _source, 1.0f, -0.005f, TEST_SAMPLE_COUNT);
+        assert_expected();
+    }
+}
+
+TEST_F(TestSimdKernels, TestEnvelopes)
+{
+    /* The source doubles as envelope */
+    for (auto kernel_set : available_kernels())
+    {
+        SCOPED_TRACE(to_string(kernel_set->instruction_set));
+        reset();
+        kernel_set->apply_envelope(_dest, _source, TEST_SAMPLE_COUNT);
+        SCALAR_KERNELS.apply_envelope(_expected, _source, TEST_SAMPLE_COUNT);
+        assert_expected();
+
+        reset();
+        kernel_set->add_with_envelope(_dest, _initial, _source, TEST_SAMPLE_COUNT);
+        SCALAR_KERNELS.add_with_envelope(_expected, _initial, _source, TEST_SAMPLE_COUNT);
+        assert_expected();
+    }
+}
+
+TEST_F(TestSimdKernels, TestCountClipped)
+{
+    /* Exactly 1.0 counts as clipped */
+    _source[3] = 1.0f;
+    _source[TEST_SAMPLE_COUNT - 1] = -1.0f;
+    int expected = SCALAR_KERNELS.count_clipped(_source, TEST_SAMPLE_COUNT);
+    ASSERT_GT(expected, 0);
+    for (auto kernel_set : available_kernels())
+    {
+        SCOPED_TRACE(to_string(kernel_set->instruction_set));
+        EXPECT_EQ(expected, kernel_set->count_clipped(_source, TEST_SAMPLE_COUNT));
+    }
+}
+
+TEST_F(TestSimdKernels, TestPrecisionConversion)
+{
+    double source_64[TEST_SAMPLE_COUNT];
+    for (int i = 0; i < TEST_SAMPLE_COUNT; ++i)
+    {
+        source_64[i] = _source[i] + 1.0e-10;
+    }
+    for (auto kernel_set : available_kernels())
+    {
+        SCOPED_TRACE(to_string(kernel_set->instruction_set));
+        double dest_64[TEST_SAMPLE_COUNT] = {};
+        kernel_set->to_double(dest_64, _source, TEST_SAMPLE_COUNT);
+        for (int i = 0; i < TEST_SAMPLE_COUNT; ++i)
+        {
+            ASSERT_EQ(static_cast<double>(_source[i]), dest_64[i]) << "at sample " << i;
+        }
+        reset();
+        kernel_set->to_float(_dest, source_64, TEST_SAMPLE_COUNT);
+        for (int i = 0; i < TEST_SAMPLE_COUNT; ++i)
+        {
+            ASSERT_EQ(static_cast<float>(source_64[i]), _dest[i]) << "at sample " << i;
+        }
+    }
+}
+
+TEST_F(TestSimdKernels, TestDoubleKernels)
+{
+    const auto& kernels_64 = double_kernels();
+    double data[TEST_SAMPLE_COUNT];
+    double source_64[TEST_SAMPLE_COUNT];
+    SCALAR_KERNELS.to_double(data, _initial, TEST_SAMPLE_COUNT);
+    SCALAR_KERNELS.to_double(source_64, _source, TEST_SAMPLE_COUNT);
+    reset();
+
+    kernels_64.add_with_gain(data, source_64, 0.5, TEST_SAMPLE_COUNT);
+    SCALAR_KERNELS.add_with_gain(_expected, _source, 0.5f, TEST_SAMPLE_COUNT);
+    kernels_64.ramp(data, 1.0, -0.005, TEST_SAMPLE_COUNT);
+    SCALAR_KERNELS.ramp(_expected, 1.0f, -0.005f, TEST_SAMPLE_COUNT);
+    for (int i = 0; i < TEST_SAMPLE_COUNT; ++i)
+    {
+        ASSERT_NEAR(_expected[i], data[i], 1.0e-5) << "at sample " << i;
+    }
+    EXPECT_EQ(SCALAR_KERNELS.count_clipped(_expected, TEST_SAMPLE_COUNT),
+              kernels_64.count_clipped(data, TEST_SAMPLE_COUNT));
+}
@@ -0,0 +1,69 @@
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#define private public
+#include "library/wakeup_signal.cpp"
+#undef private
+
+using namespace sushi;
+
+constexpr auto SHORT_TIMEOUT = std::chrono::milliseconds(5);
+constexpr auto LONG_TIMEOUT = std::chrono::seconds(5);
+
+class TestWakeupSignal : public ::testing::Test
+{
+protected:
+    TestWakeupSignal() {}
+
+    WakeupSignal _module_under_test;
+};
+
+TEST_F(TestWakeupSignal, TestTimeout)
+{
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(_module_under_test.wait_until(start + SHORT_TIMEOUT));
+    EXPECT_GE(std::chrono::steady_clock::now(), start + SHORT_TIMEOUT);
+    EXPECT_FALSE(_module_under_test._waiting);
+}
+
+TEST_F(TestWakeupSignal, TestNotifyBeforeWait)
+{
+    /* Several notifications should only wake up the next wait */
+    _module_under_test.notify();
+    _module_under_test.notify();
+    EXPECT_TRUE(_module_under_test.wait_until(std::chrono::steady_clock::now() + LONG_TIMEOUT));
+    EXPECT_FALSE(_module_under_test.wait_until(std::chrono::steady_clock::now() + SHORT_TIMEOUT));
+
+    _module_under_test.notify();
+    _module_under_test.wait();
+    EXPECT_EQ(0, _module_under_test._signalled);
+}
+
+TEST_F(TestWakeupSignal, TestNotifyFromOtherThread)
+{
+    std::atomic<int> wakeups{0};
+    std::thread waiter([&]()
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            if (_module_under_test.wait_until(std::chrono::steady_clock::now() + LONG_TIMEOUT))
+            {
+                wakeups++;
+            }
+        }
+    });
+
+    /* Every notification is sent after the previous one has woken up the waiter, so
+     * none of them should be lost */
+    for (int i = 0; i < 100; ++i)
+    {
+        while (wakeups.load() < i)
+        {
+            std::this_thread::yield();
+        }
+        _module_under_test.notify();
+    }
+    waiter.join();
+    EXPECT_EQ(100, wakeups.load());
+}
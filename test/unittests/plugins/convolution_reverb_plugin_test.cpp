@@ -0,0 +1,217 @@
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "test_utils/test_utils.h"
+#include "test_utils/host_control_mockup.h"
+#include "library/rt_event_fifo.h"
+
+#define private public
+
+#include "plugins/convolution_reverb_engine.cpp"
+#include "plugins/convolution_reverb_plugin.cpp"
+
+using namespace sushi;
+using namespace sushi::convolution_reverb_plugin;
+
+constexpr float TEST_SAMPLERATE = 44100;
+static const std::string IMPULSE_RESPONSE_FILE = "mono.wav";
+
+static std::vector<float> make_random_signal(int size, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> signal(size);
+    for (auto& sample : signal)
+    {
+        sample = distribution(generator);
+    }
+    return signal;
+}
+
+/* Process input through the engine chunk by chunk, letting the background thread finish
+ * every tail block so that the result does not depend on timing */
+static std::vector<float> process_with_engine(ConvolutionEngine& engine, const std::vector<float>& input)
+{
+    ChunkSampleBuffer in_buffer(1);
+    ChunkSampleBuffer out_buffer(1);
+    std::vector<float> output(input.size());
+    for (size_t chunk = 0; chunk < input.size() / AUDIO_CHUNK_SIZE; ++chunk)
+    {
+        std::copy(input.data() + chunk * AUDIO_CHUNK_SIZE, input.data() + (chunk + 1) * AUDIO_CHUNK_SIZE, in_buffer.channel(0));
+        engine.process(in_buffer, out_buffer);
+        std::copy(out_buffer.channel(0), out_buffer.channel(0) + AUDIO_CHUNK_SIZE, output.data() + chunk * AUDIO_CHUNK_SIZE);
+        while (engine._completed.load() != engine._submitted.load())
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    return output;
+}
+
+TEST(TestConvolutionEngine, TestHeadOnly)
+{
+    std::vector<std::vector<float>> impulse_response = {{0.0f, 0.5f, 0.0f, 0.25f}};
+    ConvolutionEngine module_under_test(impulse_response, 2);
+    EXPECT_EQ(2, module_under_test.channels());
+    EXPECT_EQ(4, module_under_test.length());
+    EXPECT_FALSE(module_under_test._thread.joinable());
+
+    ChunkSampleBuffer in_buffer(2);
+    ChunkSampleBuffer out_buffer(2);
+    in_buffer.clear();
+    in_buffer.channel(0)[0] = 1.0f;
+    in_buffer.channel(1)[1] = 1.0f;
+    module_under_test.process(in_buffer, out_buffer);
+    EXPECT_NEAR(0.5f, out_buffer.channel(0)[1], 1.0e-6f);
+    EXPECT_NEAR(0.25f, out_buffer.channel(0)[3], 1.0e-6f);
+    EXPECT_NEAR(0.5f, out_buffer.channel(1)[2], 1.0e-6f);
+    EXPECT_NEAR(0.25f, out_buffer.channel(1)[4], 1.0e-6f);
+    EXPECT_NEAR(0.0f, out_buffer.channel(1)[3], 1.0e-6f);
+}
+
+TEST(TestConvolutionEngine, TestTail)
+{
+    constexpr int LENGTH = HEAD_LENGTH + 3 * TAIL_BLOCK_SIZE + 100;
+    constexpr int SAMPLES = 8 * TAIL_BLOCK_SIZE;
+    auto impulse_response = make_random_signal(LENGTH, 1);
+    auto input = make_random_signal(SAMPLES, 2);
+    /* Silence at the end, so that only the tail is left */
+    std::fill(input.begin() + SAMPLES / 2, input.end(), 0.0f);
+
+    ConvolutionEngine module_under_test({impulse_response}, 1);
+    ASSERT_TRUE(module_under_test._thread.joinable());
+    auto output = process_with_engine(module_under_test, input);
+    EXPECT_EQ(0, module_under_test.underruns());
+
+    for (int i = 0; i < SAMPLES; ++i)
+    {
+        double expected = 0.0;
+        for (int j = 0; j < LENGTH && j <= i; ++j)
+        {
+            expected += input[i - j] * impulse_response[j];
+        }
+        ASSERT_NEAR(expected, output[i], 1.0e-3) << "at sample " << i;
+    }
+}
+
+TEST(TestConvolutionEngine, TestUnderrun)
+{
+    std::vector<float> impulse_response(HEAD_LENGTH + TAIL_BLOCK_SIZE, 0.0f);
+    impulse_response[HEAD_LENGTH] = 1.0f;
+    ConvolutionEngine module_under_test({impulse_response}, 1);
+    /* Stop the background thread, so that the first block is never finished */
+    module_under_test._running = false;
+    module_under_test._thread.join();
+
+    ChunkSampleBuffer buffer(1);
+    for (int i = 0; i < 2 * TAIL_BLOCK_SIZE / AUDIO_CHUNK_SIZE; ++i)
+    {
+        test_utils::fill_sample_buffer(buffer, 1.0f);
+        module_under_test.process(buffer, buffer);
+    }
+    EXPECT_EQ(1, module_under_test.underruns());
+    EXPECT_EQ(1, module_under_test._submitted.load());
+}
+
+class TestConvolutionReverbPlugin : public ::testing::Test
+{
+protected:
+    TestConvolutionReverbPlugin()
+    {
+    }
+    void SetUp()
+    {
+        _module_under_test = new ConvolutionReverbPlugin(_host_control.make_host_control_mockup(TEST_SAMPLERATE));
+        ProcessorReturnCode status = _module_under_test->init(TEST_SAMPLERATE);
+        ASSERT_EQ(ProcessorReturnCode::OK, status);
+        _module_under_test->set_input_channels(2);
+    }
+    void TearDown()
+    {
+        delete _module_under_test;
+    }
+    HostControlMockup _host_control;
+    ConvolutionReverbPlugin* _module_under_test;
+};
+
+TEST_F(TestConvolutionReverbPlugin, TestInstantiation)
+{
+    ASSERT_TRUE(_module_under_test);
+    EXPECT_EQ("Convolution Reverb", _module_under_test->label());
+    EXPECT_EQ("sushi.testing.convolution_reverb", _module_under_test->name());
+    EXPECT_EQ(2, _module_under_test->output_channels());
+    EXPECT_EQ(0, _module_under_test->tail_length());
+}
+
+TEST_F(TestConvolutionReverbPlugin, TestProcess)
+{
+    ChunkSampleBuffer in_buffer(2);
+    ChunkSampleBuffer out_buffer(2);
+    test_utils::fill_sample_buffer(in_buffer, 1.0f);
+
+    /* Without an impulse response only the dry signal is output */
+    _module_under_test->process_audio(in_buffer, out_buffer);
+    test_utils::assert_buffer_value(1.0f, out_buffer);
+
+    /* A unit impulse makes the wet signal a copy of the input */
+    _module_under_test->_engine = new ConvolutionEngine({{1.0f}}, MAX_CHANNELS_SUPPORTED);
+    _module_under_test->_wet_parameter->set_processed(1.0f);
+    _module_under_test->_wet_smoother->set_sample_rate(TEST_SAMPLERATE);
+    _module_under_test->process_audio(in_buffer, out_buffer);
+    test_utils::assert_buffer_value(2.0f, out_buffer);
+
+    _module_under_test->set_bypassed(true);
+    _module_under_test->process_audio(in_buffer, out_buffer);
+    test_utils::assert_buffer_value(1.0f, out_buffer);
+}
+
+TEST_F(TestConvolutionReverbPlugin, TestImpulseResponseLoading)
+{
+    RtSafeRtEventFifo queue;
+    _module_under_test->set_event_output(&queue);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        std::string* path = new std::string(test_utils::get_data_dir_path());
+        path->append(IMPULSE_RESPONSE_FILE);
+        auto ir_event = RtEvent::make_string_parameter_change_event(0, 0, 0, path);
+        _module_under_test->process_event(ir_event);
+
+        /* Simulate an event dispatcher receieving the event and calling the non-rt callback */
+        RtEvent async_event;
+        ASSERT_TRUE(queue.pop(async_event));
+        auto typed_event = async_event.async_work_event();
+        int status = typed_event->callback()(typed_event->callback_data(), typed_event->event_id());
+        ASSERT_EQ(ImpulseResponseChangeStatus::SUCCESS, status);
+        RtEvent completion_event = RtEvent::make_async_work_completion_event(typed_event->processor_id(),
+                                                                             typed_event->event_id(),
+                                                                             status);
+        _module_under_test->process_event(completion_event);
+        ASSERT_NE(nullptr, _module_under_test->_engine);
+        EXPECT_GT(_module_under_test->tail_length(), 0);
+    }
+
+    /* The previous engine should be deleted outside of the rt thread */
+    RtEvent delete_event;
+    ASSERT_TRUE(queue.pop(delete_event));
+    auto typed_event = delete_event.async_work_event();
+    EXPECT_EQ(ImpulseResponseChangeStatus::SUCCESS, typed_event->callback()(typed_event->callback_data(), typed_event->event_id()));
+    EXPECT_FALSE(queue.pop(delete_event));
+}
+
+TEST(TestImpulseResponseLoading, TestResampling)
+{
+    auto path = test_utils::get_data_dir_path().append(IMPULSE_RESPONSE_FILE);
+    /* The file is 8 samples at 48 kHz */
+    auto original = load_impulse_response(path, 48000);
+    ASSERT_EQ(1u, original.size());
+    EXPECT_EQ(8u, original[0].size());
+    auto resampled = load_impulse_response(path, 96000);
+    ASSERT_EQ(1u, resampled.size());
+    EXPECT_EQ(16u, resampled[0].size());
+
+    EXPECT_TRUE(load_impulse_response("not_a_file.wav", TEST_SAMPLERATE).empty());
+}
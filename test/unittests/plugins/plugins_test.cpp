@@ -185,6 +185,42 @@ TEST_F(TestEqualizerPlugin, TestProcess)
     test_utils::assert_buffer_value(0.0f, out_buffer);
 }
 
+TEST_F(TestEqualizerPlugin, TestMultiChannelProcess)
+{
+    constexpr int CHANNELS = 6;
+    ChunkSampleBuffer in_buffer(CHANNELS);
+    ChunkSampleBuffer out_buffer(CHANNELS);
+    test_utils::fill_sample_buffer(in_buffer, 0.0f);
+    for (int c = 0; c < CHANNELS; ++c)
+    {
+        in_buffer.channel(c)[0] = 1.0f;
+    }
+    _module_under_test->set_input_channels(CHANNELS);
+    ASSERT_EQ(CHANNELS, _module_under_test->output_channels());
+
+    // All bands at 0 dB should leave the signal untouched
+    _module_under_test->process_audio(in_buffer, out_buffer);
+    for (int c = 0; c < CHANNELS; ++c)
+    {
+        for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+        {
+            ASSERT_NEAR(in_buffer.channel(c)[i], out_buffer.channel(c)[i], 1.0e-6f);
+        }
+    }
+
+    // Boost the second band, all channels, including the ones in the second filter bank, should be equally affected
+    _module_under_test->_bands[1].gain->set(1.0f);
+    _module_under_test->process_audio(in_buffer, out_buffer);
+    EXPECT_GT(std::abs(out_buffer.channel(0)[1]), 1.0e-4f);
+    for (int c = 1; c < CHANNELS; ++c)
+    {
+        for (int i = 0; i < AUDIO_CHUNK_SIZE; ++i)
+        {
+            ASSERT_FLOAT_EQ(out_buffer.channel(0)[i], out_buffer.channel(c)[i]);
+        }
+    }
+}
+
 class TestPeakMeterPlugin : public ::testing::Test
 {
 protected:
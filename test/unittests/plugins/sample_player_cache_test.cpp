@@ -0,0 +1,91 @@
+#include <filesystem>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "plugins/sample_player_cache.cpp"
+
+using namespace sushi;
+using namespace sushi::sample_player_plugin;
+
+constexpr int TEST_FILE_FRAMES = 100;
+
+class TestSampleCache : public ::testing::Test
+{
+protected:
+    TestSampleCache()
+    {
+    }
+
+    void SetUp()
+    {
+        /* Stereo file where the mono mix of every frame equals its position */
+        _path = (std::filesystem::temp_directory_path() / "sushi_sample_cache_test.wav").string();
+        SF_INFO info = {};
+        info.samplerate = 44100;
+        info.channels = 2;
+        info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+        SNDFILE* file = sf_open(_path.c_str(), SFM_WRITE, &info);
+        ASSERT_NE(nullptr, file);
+        std::vector<float> data(TEST_FILE_FRAMES * 2);
+        for (int i = 0; i < TEST_FILE_FRAMES; ++i)
+        {
+            data[2 * i] = 0.0f;
+            data[2 * i + 1] = 2.0f * i;
+        }
+        sf_writef_float(file, data.data(), TEST_FILE_FRAMES);
+        sf_close(file);
+    }
+
+    void TearDown()
+    {
+        std::filesystem::remove(_path);
+    }
+
+    std::string _path;
+    SampleCache _module_under_test;
+};
+
+TEST_F(TestSampleCache, TestLoading)
+{
+    auto sample = _module_under_test.acquire(_path);
+    ASSERT_NE(nullptr, sample);
+    EXPECT_EQ(TEST_FILE_FRAMES, sample->frames);
+    EXPECT_EQ(TEST_FILE_FRAMES, sample->total_frames);
+    for (int i = 0; i < TEST_FILE_FRAMES; ++i)
+    {
+        ASSERT_FLOAT_EQ(static_cast<float>(i), sample->data[i]);
+    }
+    _module_under_test.release(sample);
+
+    EXPECT_EQ(nullptr, _module_under_test.acquire("not_a_file.wav"));
+    EXPECT_EQ(0, _module_under_test.size());
+}
+
+TEST_F(TestSampleCache, TestSharing)
+{
+    auto sample = _module_under_test.acquire(_path);
+    auto shared_sample = _module_under_test.acquire(_path);
+    ASSERT_NE(nullptr, sample);
+    EXPECT_EQ(sample, shared_sample);
+    EXPECT_EQ(1, _module_under_test.size());
+
+    /* Loading only the head is cached separately */
+    auto head = _module_under_test.acquire(_path, 10);
+    ASSERT_NE(nullptr, head);
+    EXPECT_NE(sample, head);
+    EXPECT_EQ(10, head->frames);
+    EXPECT_EQ(TEST_FILE_FRAMES, head->total_frames);
+    EXPECT_FLOAT_EQ(9.0f, head->data[9]);
+    EXPECT_EQ(2, _module_under_test.size());
+
+    /* Samples are evicted when the last reference is released */
+    _module_under_test.release(head);
+    EXPECT_EQ(1, _module_under_test.size());
+    _module_under_test.release(sample);
+    EXPECT_EQ(1, _module_under_test.size());
+    _module_under_test.release(shared_sample);
+    EXPECT_EQ(0, _module_under_test.size());
+}
@@ -85,6 +85,73 @@ TEST_F(TestSamplerVoice, TestNoteOff)
     EXPECT_FLOAT_EQ(0.0f, buf[4]);
 }
 
+TEST_F(TestSamplerVoice, TestRetrigger)
+{
+    std::vector<float> data(4 * AUDIO_CHUNK_SIZE, 1.0f);
+    dsp::Sample sample(data.data(), static_cast<int>(data.size()));
+    _module_under_test.set_sample(&sample);
+    sushi::SampleBuffer<AUDIO_CHUNK_SIZE> buffer(1);
+    buffer.clear();
+    _module_under_test.note_on(60, 1.0f, 0);
+    _module_under_test.render(buffer);
+    test_utils::assert_buffer_value(1.0f, buffer);
+
+    /* The playing note should be faded out during one chunk instead of being cut off */
+    _module_under_test.note_on(62, 1.0f, 10);
+    EXPECT_EQ(62, _module_under_test.current_note());
+    buffer.clear();
+    _module_under_test.render(buffer);
+    float* buf = buffer.channel(0);
+    EXPECT_GT(buf[0], buf[AUDIO_CHUNK_SIZE / 2]);
+    EXPECT_GT(buf[AUDIO_CHUNK_SIZE / 2], 0.0f);
+    EXPECT_FLOAT_EQ(0.0f, buf[AUDIO_CHUNK_SIZE - 1]);
+
+    /* And the new note started in the next chunk */
+    buffer.clear();
+    _module_under_test.render(buffer);
+    EXPECT_FLOAT_EQ(0.0f, buf[9]);
+    EXPECT_FLOAT_EQ(1.0f, buf[10]);
+    EXPECT_FLOAT_EQ(1.0f, buf[AUDIO_CHUNK_SIZE - 1]);
+}
+
+TEST_F(TestSamplerVoice, TestInterpolation)
+{
+    sushi::SampleBuffer<AUDIO_CHUNK_SIZE> buffer(1);
+    buffer.clear();
+    dsp::resampler::PolyphaseTable table(dsp::resampler::Quality::HIGH);
+    _module_under_test.set_interpolation(&table);
+
+    /* An octave up plays every second sample, which the kernel returns unchanged */
+    _module_under_test.note_on(72, 1.0f, 0);
+    _module_under_test.render(buffer);
+
+    float* buf = buffer.channel(0);
+    EXPECT_NEAR(1.0f, buf[0], 1.0e-5f);
+    EXPECT_NEAR(2.0f, buf[1], 1.0e-5f);
+    EXPECT_NEAR(1.0f, buf[2], 1.0e-5f);
+    EXPECT_NEAR(0.0f, buf[3], 1.0e-5f);
+}
+
+TEST_F(TestSamplerVoice, TestStreamUnderrun)
+{
+    sushi::SampleBuffer<AUDIO_CHUNK_SIZE> buffer(1);
+    buffer.clear();
+    /* The stream is never serviced, so everything after the head is missing */
+    VoiceStream stream;
+    _module_under_test.set_stream(&stream);
+    _module_under_test.set_streamed_length(SAMPLE_DATA_LENGTH + 10);
+
+    _module_under_test.note_on(60, 1.0f, 0);
+    _module_under_test.render(buffer);
+
+    float* buf = buffer.channel(0);
+    EXPECT_FLOAT_EQ(1.0f, buf[0]);
+    EXPECT_FLOAT_EQ(2.0f, buf[1]);
+    EXPECT_FLOAT_EQ(0.0f, buf[SAMPLE_DATA_LENGTH + 1]);
+    EXPECT_TRUE(_module_under_test.underrun());
+    EXPECT_EQ(SAMPLE_DATA_LENGTH, stream._start_frame.load());
+}
+
 
 /* Test the Plugin */
 class TestSamplePlayerPlugin : public ::testing::Test
@@ -112,29 +179,45 @@ TEST_F(TestSamplePlayerPlugin, TestSampleLoading)
 {
     RtSafeRtEventFifo queue;
     _module_under_test->set_event_output(&queue);
-    std::string* path = new std::string(test_utils::get_data_dir_path());
-    path->append(SAMPLE_FILE);
-    auto sample_ev = RtEvent::make_string_parameter_change_event(0,0,5,path);
-    ASSERT_EQ(nullptr, _module_under_test->_sample_buffer);
-    _module_under_test->process_event(sample_ev);
-
-    /* Simulate an event dispatcher receieving the event and calling the non-rt callback */
-    RtEvent async_event;
-    bool got_event = queue.pop(async_event);
-    ASSERT_TRUE(got_event);
-    auto typed_event = async_event.async_work_event();
-    int status = typed_event->callback()(typed_event->callback_data(), typed_event->event_id());
-    ASSERT_EQ(SampleChangeStatus::SUCCESS, status);
-    RtEvent completion_event = RtEvent::make_async_work_completion_event(typed_event->processor_id(),
-                                                                         typed_event->event_id(),
-                                                                         status);
-    _module_under_test->process_event(completion_event);
-
-    /* Sample should now be changed */
-    ASSERT_NE(nullptr, _module_under_test->_sample_buffer);
-
-    /* Plugin should have put a delete event on the output queue, just check that it's there */
-    ASSERT_FALSE(queue.empty());
+    ASSERT_EQ(nullptr, _module_under_test->_cached_sample);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        std::string* path = new std::string(test_utils::get_data_dir_path());
+        path->append(SAMPLE_FILE);
+        auto sample_ev = RtEvent::make_string_parameter_change_event(0, 0, 5, path);
+        _module_under_test->process_event(sample_ev);
+
+        /* Simulate an event dispatcher receieving the event and calling the non-rt callback */
+        RtEvent async_event;
+        bool got_event = queue.pop(async_event);
+        ASSERT_TRUE(got_event);
+        auto typed_event = async_event.async_work_event();
+        int status = typed_event->callback()(typed_event->callback_data(), typed_event->event_id());
+        ASSERT_EQ(SampleChangeStatus::SUCCESS, status);
+        RtEvent completion_event = RtEvent::make_async_work_completion_event(typed_event->processor_id(),
+                                                                             typed_event->event_id(),
+                                                                             status);
+        _module_under_test->process_event(completion_event);
+
+        /* Sample should now be changed */
+        ASSERT_NE(nullptr, _module_under_test->_cached_sample);
+        EXPECT_EQ(STREAM_HEAD_FRAMES, _module_under_test->_sample.length());
+    }
+
+    /* The second load got the same sample from the cache, and the plugin should have put
+     * an async event on the output queue to release the previous reference */
+    EXPECT_EQ(1, SampleCache::instance().size());
+    RtEvent release_event;
+    ASSERT_TRUE(queue.pop(release_event));
+    auto typed_event = release_event.async_work_event();
+    typed_event->callback()(typed_event->callback_data(), typed_event->event_id());
+    EXPECT_EQ(1, SampleCache::instance().size());
+
+    /* And the last reference is released when the plugin is deleted */
+    delete _module_under_test;
+    _module_under_test = nullptr;
+    EXPECT_EQ(0, SampleCache::instance().size());
 }
 
 TEST_F(TestSamplePlayerPlugin, TestProcessing)
@@ -151,9 +234,9 @@ TEST_F(TestSamplePlayerPlugin, TestEventProcessing)
 {
     SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(1);
     SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(1);
-    BlobData data = _module_under_test->load_sample_file(test_utils::get_data_dir_path().append(SAMPLE_FILE));
-    ASSERT_NE(0, data.size);
-    _module_under_test->_sample.set_sample(reinterpret_cast<float*>(data.data), data.size * sizeof(float));
+    auto sample = SampleCache::instance().acquire(test_utils::get_data_dir_path().append(SAMPLE_FILE));
+    ASSERT_NE(nullptr, sample);
+    _module_under_test->_sample.set_sample(sample->data, sample->frames);
     out_buffer.clear();
     RtEvent note_on = RtEvent::make_note_on_event(0, 5, 0, 60, 1.0f);
     RtEvent note_on2 = RtEvent::make_note_on_event(0, 50, 0, 65, 1.0f);
@@ -164,6 +247,8 @@ TEST_F(TestSamplePlayerPlugin, TestEventProcessing)
     // assert that something was written to the buffer
     ASSERT_NE(0.0f, out_buffer.channel(0)[10]);
     ASSERT_NE(0.0f, out_buffer.channel(0)[15]);
+    // and that the plugin is kept awake while the notes are playing
+    EXPECT_EQ(INFINITE_TAIL_LENGTH, _module_under_test->tail_length());
 
     // Test that bypass works
     _module_under_test->set_bypassed(true);
@@ -174,5 +259,47 @@ TEST_F(TestSamplePlayerPlugin, TestEventProcessing)
     _module_under_test->set_bypassed(false);
     _module_under_test->process_audio(in_buffer, out_buffer);
     test_utils::assert_buffer_value(0.0f, out_buffer);
-    delete data.data;
+    EXPECT_EQ(0, _module_under_test->tail_length());
+    SampleCache::instance().release(sample);
+}
+
+TEST_F(TestSamplePlayerPlugin, TestVoiceStealing)
+{
+    SampleBuffer<AUDIO_CHUNK_SIZE> in_buffer(1);
+    SampleBuffer<AUDIO_CHUNK_SIZE> out_buffer(1);
+    _module_under_test->_sample.set_sample(SAMPLE_DATA, SAMPLE_DATA_LENGTH);
+    _module_under_test->_polyphony_parameter->set_processed(2);
+    auto& voices = _module_under_test->_voices;
+
+    /* The oldest note is replaced, and voices beyond the polyphony are never used */
+    _module_under_test->process_event(RtEvent::make_note_on_event(0, 0, 0, 60, 1.0f));
+    _module_under_test->process_event(RtEvent::make_note_on_event(0, 0, 0, 62, 1.0f));
+    _module_under_test->process_event(RtEvent::make_note_on_event(0, 0, 0, 64, 1.0f));
+    EXPECT_EQ(64, voices[0].current_note());
+    EXPECT_EQ(62, voices[1].current_note());
+    EXPECT_FALSE(voices[2].active());
+
+    /* Released voices are stolen before held voices */
+    _module_under_test->process_event(RtEvent::make_note_off_event(0, 0, 0, 64, 1.0f));
+    _module_under_test->process_event(RtEvent::make_note_on_event(0, 0, 0, 65, 1.0f));
+    EXPECT_EQ(65, voices[0].current_note());
+    EXPECT_EQ(62, voices[1].current_note());
+
+    /* Steal the voice with the lowest level, which is the softer note */
+    _module_under_test->_voice_stealing_parameter->set_processed(VoiceStealingPolicy::QUIETEST);
+    voices[0].note_on(67, 0.5f, 0);
+    _module_under_test->process_audio(in_buffer, out_buffer);
+    EXPECT_LT(voices[0].level(), voices[1].level());
+    _module_under_test->process_event(RtEvent::make_note_on_event(0, 0, 0, 69, 1.0f));
+    EXPECT_EQ(69, voices[0].current_note());
+    EXPECT_EQ(62, voices[1].current_note());
+
+    /* The same note is retriggered in its voice even with free voices left */
+    _module_under_test->_polyphony_parameter->set_processed(4);
+    _module_under_test->_voice_stealing_parameter->set_processed(VoiceStealingPolicy::SAME_NOTE);
+    _module_under_test->process_event(RtEvent::make_note_on_event(0, 0, 0, 62, 1.0f));
+    EXPECT_EQ(62, voices[1].current_note());
+    EXPECT_FALSE(voices[2].active());
+    _module_under_test->process_event(RtEvent::make_note_on_event(0, 0, 0, 71, 1.0f));
+    EXPECT_EQ(71, voices[2].current_note());
 }
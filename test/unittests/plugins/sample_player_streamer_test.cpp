@@ -0,0 +1,157 @@
+#include <filesystem>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#define private public
+
+#include "plugins/sample_player_streamer.cpp"
+
+using namespace sushi;
+using namespace sushi::sample_player_plugin;
+
+constexpr int TEST_FILE_FRAMES = 1000;
+constexpr int TEST_BUFFER_FRAMES = 256;
+constexpr int TEST_READ_FRAMES = 64;
+
+/* Stereo file where the mono mix of every frame equals its position times scale */
+static void write_test_file(const std::string& path, float scale)
+{
+    SF_INFO info = {};
+    info.samplerate = 44100;
+    info.channels = 2;
+    info.format = SF_FORMAT_WAV | SF_FORMAT_FLOAT;
+    SNDFILE* file = sf_open(path.c_str(), SFM_WRITE, &info);
+    ASSERT_NE(nullptr, file);
+    std::vector<float> data(TEST_FILE_FRAMES * 2);
+    for (int i = 0; i < TEST_FILE_FRAMES; ++i)
+    {
+        data[2 * i] = 2.0f * i * scale;
+        data[2 * i + 1] = 0.0f;
+    }
+    sf_writef_float(file, data.data(), TEST_FILE_FRAMES);
+    sf_close(file);
+}
+
+class TestSampleStreamer : public ::testing::Test
+{
+protected:
+    TestSampleStreamer()
+    {
+    }
+
+    void SetUp()
+    {
+        _path = (std::filesystem::temp_directory_path() / "sushi_streamer_test.wav").string();
+        write_test_file(_path, 1.0f);
+        _source = _module_under_test.add_source(_path);
+        /* Stop the thread and drive the streamer manually from the test */
+        _module_under_test._running = false;
+        _module_under_test._thread.join();
+    }
+
+    void TearDown()
+    {
+        std::filesystem::remove(_path);
+    }
+
+    std::string _path;
+    int _source;
+    SampleStreamer _module_under_test{2, TEST_BUFFER_FRAMES, TEST_READ_FRAMES};
+};
+
+TEST_F(TestSampleStreamer, TestIdle)
+{
+    EXPECT_EQ(2, _module_under_test.streams());
+    EXPECT_FALSE(_module_under_test._service());
+    EXPECT_EQ(0, _module_under_test.stream(0).available_end());
+}
+
+TEST_F(TestSampleStreamer, TestStreaming)
+{
+    auto& stream = _module_under_test.stream(0);
+    stream.start(100, _source);
+    /* Nothing is available until the streamer has served the request */
+    EXPECT_EQ(0, stream.available_end());
+
+    EXPECT_TRUE(_module_under_test._service());
+    EXPECT_EQ(100 + TEST_READ_FRAMES, stream.available_end());
+    EXPECT_FLOAT_EQ(100.0f, stream.frame(100));
+    EXPECT_FLOAT_EQ(163.0f, stream.frame(163));
+
+    /* Fill the buffer, the streamer should stop when it's full */
+    while (_module_under_test._service()) {}
+    EXPECT_EQ(100 + TEST_BUFFER_FRAMES, stream.available_end());
+    /* The other stream was not started */
+    EXPECT_EQ(0, _module_under_test.stream(1).available_end());
+
+    /* Releasing frames lets the streamer continue and wrap around the buffer */
+    stream.release(300);
+    while (_module_under_test._service()) {}
+    EXPECT_EQ(300 + TEST_BUFFER_FRAMES, stream.available_end());
+    for (int i = 300; i < 300 + TEST_BUFFER_FRAMES; ++i)
+    {
+        ASSERT_FLOAT_EQ(static_cast<float>(i), stream.frame(i));
+    }
+
+    /* Streaming stops at the end of the file */
+    stream.release(TEST_FILE_FRAMES);
+    while (_module_under_test._service()) {}
+    EXPECT_EQ(TEST_FILE_FRAMES, stream.available_end());
+    EXPECT_FLOAT_EQ(TEST_FILE_FRAMES - 1, stream.frame(TEST_FILE_FRAMES - 1));
+}
+
+TEST_F(TestSampleStreamer, TestRestart)
+{
+    auto& stream = _module_under_test.stream(1);
+    stream.start(500, _source);
+    while (_module_under_test._service()) {}
+    EXPECT_EQ(500 + TEST_BUFFER_FRAMES, stream.available_end());
+
+    stream.stop();
+    EXPECT_EQ(0, stream.available_end());
+    EXPECT_FALSE(_module_under_test._service());
+    EXPECT_EQ(0, stream.available_end());
+
+    /* The file is kept open and the stream restarts from the new position */
+    auto file = _module_under_test._find_source(_source)->file;
+    stream.start(10, _source);
+    EXPECT_TRUE(_module_under_test._service());
+    EXPECT_EQ(file, _module_under_test._find_source(_source)->file);
+    EXPECT_EQ(10 + TEST_READ_FRAMES, stream.available_end());
+    EXPECT_FLOAT_EQ(10.0f, stream.frame(10));
+}
+
+TEST_F(TestSampleStreamer, TestMultipleSources)
+{
+    auto new_path = (std::filesystem::temp_directory_path() / "sushi_streamer_test_2.wav").string();
+    write_test_file(new_path, -1.0f);
+    auto& old_stream = _module_under_test.stream(0);
+    auto& new_stream = _module_under_test.stream(1);
+    old_stream.start(100, _source);
+    EXPECT_TRUE(_module_under_test._service());
+
+    /* A stream playing the old sample keeps reading from the old file */
+    /* Pretend that the thread is running so that it's not restarted */
+    _module_under_test._running = true;
+    int new_source = _module_under_test.add_source(new_path);
+    _module_under_test._running = false;
+    _module_under_test.set_current_source(new_source);
+    new_stream.start(100, new_source);
+    while (_module_under_test._service()) {}
+    EXPECT_EQ(100 + TEST_BUFFER_FRAMES, old_stream.available_end());
+    EXPECT_EQ(100 + TEST_BUFFER_FRAMES, new_stream.available_end());
+    for (int i = 100; i < 100 + TEST_BUFFER_FRAMES; ++i)
+    {
+        ASSERT_FLOAT_EQ(static_cast<float>(i), old_stream.frame(i));
+        ASSERT_FLOAT_EQ(static_cast<float>(-i), new_stream.frame(i));
+    }
+
+    /* Streams from the same source share the file */
+    old_stream.start(200, new_source);
+    EXPECT_TRUE(_module_under_test._service());
+    ASSERT_EQ(1u, _module_under_test._sources.size());
+    EXPECT_EQ(new_source, _module_under_test._sources[0].id);
+    EXPECT_FLOAT_EQ(-200.0f, old_stream.frame(200));
+    std::filesystem::remove(new_path);
+}
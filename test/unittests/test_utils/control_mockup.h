@@ -22,6 +22,7 @@ const TrackInfo track2{1,"track 2","track 2",1,1,1,1,1};
 const std::vector<TrackInfo> tracks{track1, track2};
 
 constexpr float default_samplerate = 48000.0f;
+constexpr int default_latency = 128;
 constexpr float default_tempo = 120.0f;
 constexpr float default_parameter_value = 0.745f;
 constexpr auto default_string_property = "string property";
@@ -43,6 +44,8 @@ public:
      // Main engine controls
     virtual float get_samplerate() const override { return default_samplerate; };
 
+    virtual int get_latency() const override { return default_latency; };
+
     virtual PlayingMode get_playing_mode() const override { return default_playing_mode; };
 
     virtual void set_playing_mode(PlayingMode playing_mode) override
@@ -113,6 +116,9 @@ public:
 
     virtual std::vector<TrackInfo> get_tracks() const override { return tracks; };
 
+    virtual std::vector<EventQueueInfo> get_event_queues() const override { return {}; };
+    virtual std::vector<EventPoolInfo> get_event_pools() const override { return {}; };
+
     // Keyboard control
     virtual ControlStatus send_note_on(int track_id, int channel, int note, float velocity) override
     {
@@ -338,6 +344,21 @@ public:
 
     virtual ControlStatus set_string_property_value(int /* processor_id */, int /* parameter_id */, const std::string& /* value */) override { return default_control_status; };
 
+    // Transactions
+    virtual ControlStatus begin_transaction() override
+    {
+        _args_from_last_call.clear();
+        _recently_called = true;
+        return default_control_status;
+    };
+
+    virtual ControlStatus commit_transaction() override
+    {
+        _args_from_last_call.clear();
+        _recently_called = true;
+        return default_control_status;
+    };
+
     std::unordered_map<std::string,std::string> get_args_from_last_call()
     {
         return _args_from_last_call;